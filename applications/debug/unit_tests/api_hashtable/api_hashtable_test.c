@@ -0,0 +1,75 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+#include <toolbox/profiler.h>
+
+#include "api_hashtable_test_table.h"
+
+#define API_HASHTABLE_TEST_BENCHMARK_ROUNDS (16U)
+
+static void api_hashtable_test_resolve_all(const ElfApiInterface* api) {
+    for(uint32_t i = 0; i < API_HASHTABLE_TEST_SYMBOL_COUNT; i++) {
+        Elf32_Addr address = 0;
+        mu_assert(
+            api->resolver_callback(api, api_hashtable_test_table[i].hash, &address),
+            "symbol not resolved");
+        mu_assert_int_eq(api_hashtable_test_table[i].address, address);
+    }
+}
+
+static void api_hashtable_test_resolve_missing(const ElfApiInterface* api) {
+    for(uint32_t i = 0; i < API_HASHTABLE_TEST_SYMBOL_COUNT; i++) {
+        Elf32_Addr address = 0;
+        mu_assert(
+            !api->resolver_callback(api, api_hashtable_test_missing_hash(i), &address),
+            "missing symbol resolved");
+    }
+}
+
+MU_TEST(test_api_hashtable_sorted) {
+    api_hashtable_test_resolve_all(api_hashtable_test_sorted_interface);
+    api_hashtable_test_resolve_missing(api_hashtable_test_sorted_interface);
+}
+
+MU_TEST(test_api_hashtable_perfect_hash) {
+    api_hashtable_test_resolve_all(api_hashtable_test_perfect_hash_interface);
+    api_hashtable_test_resolve_missing(api_hashtable_test_perfect_hash_interface);
+}
+
+static void api_hashtable_test_benchmark_run(
+    Profiler* profiler,
+    const char* key,
+    const ElfApiInterface* api) {
+    Elf32_Addr address = 0;
+    profiler_start(profiler, key);
+    for(uint32_t round = 0; round < API_HASHTABLE_TEST_BENCHMARK_ROUNDS; round++) {
+        for(uint32_t i = 0; i < API_HASHTABLE_TEST_SYMBOL_COUNT; i++) {
+            api->resolver_callback(api, api_hashtable_test_table[i].hash, &address);
+        }
+    }
+    profiler_stop(profiler, key);
+}
+
+MU_TEST(test_api_hashtable_benchmark) {
+    Profiler* profiler = profiler_alloc();
+    profiler_prealloc(profiler, "sorted");
+    profiler_prealloc(profiler, "perfect_hash");
+
+    api_hashtable_test_benchmark_run(profiler, "sorted", api_hashtable_test_sorted_interface);
+    api_hashtable_test_benchmark_run(
+        profiler, "perfect_hash", api_hashtable_test_perfect_hash_interface);
+
+    profiler_dump(profiler);
+    profiler_free(profiler);
+}
+
+MU_TEST_SUITE(test_api_hashtable_suite) {
+    MU_RUN_TEST(test_api_hashtable_sorted);
+    MU_RUN_TEST(test_api_hashtable_perfect_hash);
+    MU_RUN_TEST(test_api_hashtable_benchmark);
+}
+
+int run_minunit_test_api_hashtable() {
+    MU_RUN_SUITE(test_api_hashtable_suite);
+    return MU_EXIT_CODE;
+}
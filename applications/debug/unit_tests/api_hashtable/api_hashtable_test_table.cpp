@@ -0,0 +1,67 @@
+#include <flipper_application/api_hashtable/api_hashtable.h>
+#include <flipper_application/api_hashtable/compilesort.hpp>
+
+#include "api_hashtable_test_table.h"
+
+/*
+ * Firmware API table is replaced with a mock in unit tests build,
+ * so resolvers are tested against a synthetic table of the same shape.
+ * Mixing is a bijection, so all generated hashes are unique.
+ */
+#define API_HASHTABLE_TEST_HASH_SEED (0x5EEDU)
+
+static constexpr auto api_hashtable_test_build_table() {
+    std::array<sym_entry, API_HASHTABLE_TEST_SYMBOL_COUNT> table{};
+    for(uint32_t i = 0; i < API_HASHTABLE_TEST_SYMBOL_COUNT; i++) {
+        table[i] = sym_entry{
+            .hash = elf_perfect_hash_mix(i, API_HASHTABLE_TEST_HASH_SEED),
+            .address = i + 1,
+        };
+    }
+    return sort(table);
+}
+
+static constexpr auto api_hashtable_test_sorted_table = api_hashtable_test_build_table();
+
+static_assert(
+    !has_hash_collisions(api_hashtable_test_sorted_table),
+    "Detected API method hash collision!");
+
+static constexpr auto api_hashtable_test_perfect_hash =
+    build_perfect_hash(api_hashtable_test_sorted_table);
+
+constexpr HashtableApiInterface api_hashtable_test_hashtable_api_interface{
+    {
+        .api_version_major = 0,
+        .api_version_minor = 0,
+        .resolver_callback = &elf_resolve_from_hashtable,
+    },
+    api_hashtable_test_sorted_table.cbegin(),
+    api_hashtable_test_sorted_table.cend(),
+};
+
+constexpr PerfectHashApiInterface api_hashtable_test_perfect_hash_api_interface{
+    {
+        .api_version_major = 0,
+        .api_version_minor = 0,
+        .resolver_callback = &elf_resolve_from_perfect_hash,
+    },
+    api_hashtable_test_perfect_hash.seeds.data(),
+    api_hashtable_test_perfect_hash.seeds.size(),
+    api_hashtable_test_perfect_hash.slots.data(),
+    api_hashtable_test_perfect_hash.slots.size(),
+};
+
+extern "C" const struct sym_entry* const api_hashtable_test_table =
+    api_hashtable_test_sorted_table.data();
+
+extern "C" const ElfApiInterface* const api_hashtable_test_sorted_interface =
+    &api_hashtable_test_hashtable_api_interface;
+
+extern "C" const ElfApiInterface* const api_hashtable_test_perfect_hash_interface =
+    &api_hashtable_test_perfect_hash_api_interface;
+
+extern "C" uint32_t api_hashtable_test_missing_hash(uint32_t index) {
+    return elf_perfect_hash_mix(
+        API_HASHTABLE_TEST_SYMBOL_COUNT + index, API_HASHTABLE_TEST_HASH_SEED);
+}
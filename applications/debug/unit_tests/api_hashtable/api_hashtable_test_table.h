@@ -0,0 +1,25 @@
+#pragma once
+
+#include <flipper_application/api_hashtable/api_hashtable.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define API_HASHTABLE_TEST_SYMBOL_COUNT (1024U)
+
+/* Sorted synthetic symbol table */
+extern const struct sym_entry* const api_hashtable_test_table;
+
+/* Resolver over api_hashtable_test_table using binary search */
+extern const ElfApiInterface* const api_hashtable_test_sorted_interface;
+
+/* Resolver over api_hashtable_test_table using perfect hash */
+extern const ElfApiInterface* const api_hashtable_test_perfect_hash_interface;
+
+/* Hash that is guaranteed to be absent from the table */
+uint32_t api_hashtable_test_missing_hash(uint32_t index);
+
+#ifdef __cplusplus
+}
+#endif
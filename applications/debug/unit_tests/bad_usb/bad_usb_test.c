@@ -0,0 +1,299 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+
+#include "../../../main/bad_usb/helpers/ducky_script_program.h"
+
+#define BAD_USB_TEST_REPORTS_MAX 256
+
+typedef struct {
+    uint8_t mods;
+    uint8_t keys[HID_KB_MAX_KEYS];
+} BadUsbTestReport;
+
+typedef struct {
+    BadUsbTestReport state;
+    BadUsbTestReport reports[BAD_USB_TEST_REPORTS_MAX];
+    size_t reports_count;
+    uint8_t led_state;
+} BadUsbTestHid;
+
+static BadUsbTestHid* hid;
+static BadUsbState* state;
+static uint16_t layout[128];
+static DuckyProgram* program;
+
+static void bad_usb_test_hid_send(BadUsbTestHid* test_hid) {
+    furi_check(test_hid->reports_count < BAD_USB_TEST_REPORTS_MAX);
+    test_hid->reports[test_hid->reports_count++] = test_hid->state;
+}
+
+static bool bad_usb_test_kb_press(void* context, const uint16_t* keys, size_t count) {
+    BadUsbTestHid* test_hid = context;
+    for(size_t i = 0; i < count; i++) {
+        for(size_t j = 0; j < HID_KB_MAX_KEYS; j++) {
+            if(test_hid->state.keys[j] == 0) {
+                test_hid->state.keys[j] = keys[i] & 0xFF;
+                break;
+            }
+        }
+        test_hid->state.mods |= keys[i] >> 8;
+    }
+    bad_usb_test_hid_send(test_hid);
+    return true;
+}
+
+static bool bad_usb_test_kb_release(void* context, const uint16_t* keys, size_t count) {
+    BadUsbTestHid* test_hid = context;
+    for(size_t i = 0; i < count; i++) {
+        for(size_t j = 0; j < HID_KB_MAX_KEYS; j++) {
+            if(test_hid->state.keys[j] == (keys[i] & 0xFF)) {
+                test_hid->state.keys[j] = 0;
+                break;
+            }
+        }
+        test_hid->state.mods &= ~(keys[i] >> 8);
+    }
+    bad_usb_test_hid_send(test_hid);
+    return true;
+}
+
+static bool bad_usb_test_kb_roll(void* context, uint16_t release_key, uint16_t press_key) {
+    BadUsbTestHid* test_hid = context;
+    for(size_t j = 0; j < HID_KB_MAX_KEYS; j++) {
+        if(test_hid->state.keys[j] == (release_key & 0xFF)) {
+            test_hid->state.keys[j] = press_key & 0xFF;
+            break;
+        }
+    }
+    test_hid->state.mods &= ~(release_key >> 8);
+    test_hid->state.mods |= press_key >> 8;
+    bad_usb_test_hid_send(test_hid);
+    return true;
+}
+
+static bool bad_usb_test_kb_release_all(void* context) {
+    BadUsbTestHid* test_hid = context;
+    memset(&test_hid->state, 0, sizeof(BadUsbTestReport));
+    bad_usb_test_hid_send(test_hid);
+    return true;
+}
+
+static uint8_t bad_usb_test_get_led_state(void* context) {
+    BadUsbTestHid* test_hid = context;
+    return test_hid->led_state;
+}
+
+static const DuckyHidSink bad_usb_test_sink = {
+    .kb_press = bad_usb_test_kb_press,
+    .kb_release = bad_usb_test_kb_release,
+    .kb_roll = bad_usb_test_kb_roll,
+    .kb_release_all = bad_usb_test_kb_release_all,
+    .get_led_state = bad_usb_test_get_led_state,
+};
+
+// Text typed by the reports. The HID spec gives no order to the keys of a report,
+// so a report that brings more than one new key is rejected as ambiguous.
+static bool bad_usb_test_decode(FuriString* text) {
+    BadUsbTestReport prev = {};
+    furi_string_reset(text);
+
+    for(size_t i = 0; i < hid->reports_count; i++) {
+        const BadUsbTestReport* report = &hid->reports[i];
+        size_t new_keys = 0;
+        for(size_t j = 0; j < HID_KB_MAX_KEYS; j++) {
+            uint8_t key = report->keys[j];
+            if((key == 0) || (memchr(prev.keys, key, HID_KB_MAX_KEYS) != NULL)) continue;
+            if(++new_keys > 1) return false;
+
+            uint16_t keycode = (report->mods << 8) | key;
+            char chr = '?';
+            if(keycode == HID_KEYBOARD_RETURN) {
+                chr = '\n';
+            } else {
+                for(size_t c = 0; c < COUNT_OF(layout); c++) {
+                    if(layout[c] == keycode) {
+                        chr = c;
+                        break;
+                    }
+                }
+            }
+            furi_string_push_back(text, chr);
+        }
+        prev = *report;
+    }
+
+    return true;
+}
+
+static bool bad_usb_test_compile(const char* script) {
+    FuriString* line = furi_string_alloc();
+    bool state = true;
+
+    while(state && (*script != '\0')) {
+        size_t len = strcspn(script, "\n");
+        furi_string_set_strn(line, script, len);
+        state = ducky_program_add_line(program, line);
+        script += (script[len] == '\n') ? (len + 1) : len;
+    }
+
+    furi_string_free(line);
+    return state;
+}
+
+static void bad_usb_test_setup(void) {
+    hid = malloc(sizeof(BadUsbTestHid));
+    memset(hid, 0, sizeof(BadUsbTestHid));
+    state = malloc(sizeof(BadUsbState));
+    memset(state, 0, sizeof(BadUsbState));
+    memset(layout, HID_KEYBOARD_NONE, sizeof(layout));
+    memcpy(layout, hid_asciimap, MIN(sizeof(hid_asciimap), sizeof(layout)));
+
+    program = ducky_program_alloc(state, layout);
+    ducky_program_set_hid_sink(program, &bad_usb_test_sink, hid);
+}
+
+static void bad_usb_test_teardown(void) {
+    ducky_program_free(program);
+    free(state);
+    free(hid);
+}
+
+MU_TEST(test_bad_usb_string_packing) {
+    const char* expected = "The quick brown fox jumps over the lazy dog\nHello, World!\n";
+
+    mu_assert(
+        bad_usb_test_compile("STRINGLN The quick brown fox jumps over the lazy dog\n"
+                             "STRING Hello, World!\n"
+                             "ENTER\n"),
+        "compile failed");
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(SCRIPT_STATE_END, ducky_program_step(program));
+    mu_assert_int_eq(3, state->line_cur);
+
+    FuriString* text = furi_string_alloc();
+    mu_assert(bad_usb_test_decode(text), "report with several new keys");
+    mu_assert_string_eq(expected, furi_string_get_cstr(text));
+    furi_string_free(text);
+
+    // A press and a release report per key without rolling, a report per key with it
+    size_t keys_count = strlen(expected);
+    mu_assert(hid->reports_count < keys_count * 3 / 2, "keys are not rolled");
+    mu_assert_int_eq(0, hid->state.mods);
+    mu_assert_mem_eq((uint8_t[HID_KB_MAX_KEYS]){}, hid->state.keys, HID_KB_MAX_KEYS);
+}
+
+MU_TEST(test_bad_usb_commands) {
+    mu_assert(
+        bad_usb_test_compile("REM Test\n"
+                             "DEFAULT_DELAY 10\n"
+                             "DELAY 100\n"
+                             "GUI r\n"
+                             "REPEAT 2\n"
+                             "STRINGDELAY 5\n"
+                             "STRING xy\n"
+                             "   \n"
+                             "WAIT_FOR_BUTTON_PRESS\n"),
+        "compile failed");
+
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(10, ducky_program_step(program));
+    mu_assert_int_eq(110, ducky_program_step(program));
+
+    // GUI r, then it is repeated twice
+    for(size_t i = 0; i < 4; i++) {
+        mu_assert_int_eq(10, ducky_program_step(program));
+    }
+    mu_assert_int_eq(5, state->line_cur);
+    mu_assert_int_eq(6, hid->reports_count);
+    for(size_t i = 0; i < 6; i += 2) {
+        mu_assert_int_eq(KEY_MOD_LEFT_GUI >> 8, hid->reports[i].mods);
+        mu_assert_int_eq(HID_KEYBOARD_R, hid->reports[i].keys[0]);
+    }
+
+    // String with delays is typed one key at a time
+    mu_assert_int_eq(10, ducky_program_step(program));
+    mu_assert_int_eq(5, ducky_program_get_string_delay(program));
+    mu_assert_int_eq(SCRIPT_STATE_STRING_START, ducky_program_step(program));
+    mu_assert(!ducky_program_string_next(program), "string is over too early");
+    mu_assert(!ducky_program_string_next(program), "string is over too early");
+    mu_assert(ducky_program_string_next(program), "string is not over");
+    mu_assert_int_eq(0, ducky_program_get_string_delay(program));
+    mu_assert_int_eq(10, hid->reports_count);
+
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(SCRIPT_STATE_WAIT_FOR_BTN, ducky_program_step(program));
+    mu_assert_int_eq(SCRIPT_STATE_END, ducky_program_step(program));
+}
+
+MU_TEST(test_bad_usb_errors) {
+    mu_assert(!bad_usb_test_compile("DELAY 10\nFOO\n"), "unknown command compiled");
+    mu_assert_int_eq(2, state->error_line);
+
+    ducky_program_reset(program);
+    mu_assert(!bad_usb_test_compile("DELAY x\n"), "invalid number compiled");
+    mu_assert_int_eq(1, state->error_line);
+    mu_assert_string_eq("Invalid number x", state->error);
+
+    ducky_program_reset(program);
+    mu_assert(!bad_usb_test_compile("ALTCHAR 12a\n"), "invalid altchar compiled");
+
+    // Runtime errors are reported at the line being executed
+    ducky_program_reset(program);
+    mu_assert(bad_usb_test_compile("HOLD CTRL\nRELEASE CTRL\nRELEASE SHIFT\n"), "compile failed");
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(SCRIPT_STATE_ERROR, ducky_program_step(program));
+    mu_assert_int_eq(3, state->error_line);
+    mu_assert_string_eq("No keys are hold", state->error);
+}
+
+MU_TEST(test_bad_usb_altstring) {
+    mu_assert(bad_usb_test_compile("ALTSTRING A\n"), "compile failed");
+    mu_assert_int_eq(0, ducky_program_step(program));
+
+    // Num lock, then Alt held while 6 and 5 are typed on the numpad
+    mu_assert_int_eq(8, hid->reports_count);
+    mu_assert_int_eq(HID_KEYBOARD_LOCK_NUM_LOCK, hid->reports[0].keys[0]);
+    mu_assert_int_eq(KEY_MOD_LEFT_ALT >> 8, hid->reports[2].mods);
+    mu_assert_int_eq(HID_KEYPAD_6, hid->reports[3].keys[0]);
+    mu_assert_int_eq(HID_KEYPAD_5, hid->reports[5].keys[0]);
+    mu_assert_int_eq(0, hid->reports[7].mods);
+}
+
+MU_TEST(test_bad_usb_chunks) {
+    mu_assert(bad_usb_test_compile("STRING ab\n"), "compile failed");
+    mu_assert_int_eq(0, ducky_program_step(program));
+    mu_assert_int_eq(SCRIPT_STATE_END, ducky_program_step(program));
+
+    // Next part of the script can still repeat the last line of the previous one
+    ducky_program_next_chunk(program);
+    mu_assert(bad_usb_test_compile("REPEAT 2\nSTRING c\n"), "compile failed");
+    for(size_t i = 0; i < 4; i++) {
+        mu_assert_int_eq(0, ducky_program_step(program));
+    }
+    mu_assert_int_eq(SCRIPT_STATE_END, ducky_program_step(program));
+    mu_assert_int_eq(3, state->line_cur);
+
+    FuriString* text = furi_string_alloc();
+    mu_assert(bad_usb_test_decode(text), "report with several new keys");
+    mu_assert_string_eq("abababc", furi_string_get_cstr(text));
+    furi_string_free(text);
+}
+
+MU_TEST_SUITE(test_bad_usb_suite) {
+    MU_SUITE_CONFIGURE(&bad_usb_test_setup, &bad_usb_test_teardown);
+
+    MU_RUN_TEST(test_bad_usb_string_packing);
+    MU_RUN_TEST(test_bad_usb_commands);
+    MU_RUN_TEST(test_bad_usb_errors);
+    MU_RUN_TEST(test_bad_usb_altstring);
+    MU_RUN_TEST(test_bad_usb_chunks);
+}
+
+int run_minunit_test_bad_usb() {
+    MU_RUN_SUITE(test_bad_usb_suite);
+    return MU_EXIT_CODE;
+}
@@ -708,6 +708,220 @@ MU_TEST(test_bit_lib_bytes_to_num_bcd) {
     mu_assert_int_eq(false, is_bcd_res);
 }
 
+// Bit by bit reference implementations, fast paths must match them exactly
+
+#define BIT_LIB_TEST_DATA_SIZE (24)
+#define BIT_LIB_TEST_ITERATIONS (2000)
+
+static uint32_t bit_lib_test_seed;
+
+static uint32_t bit_lib_test_random(void) {
+    bit_lib_test_seed ^= bit_lib_test_seed << 13;
+    bit_lib_test_seed ^= bit_lib_test_seed >> 17;
+    bit_lib_test_seed ^= bit_lib_test_seed << 5;
+    return bit_lib_test_seed;
+}
+
+static void bit_lib_test_random_fill(uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        data[i] = bit_lib_test_random();
+    }
+}
+
+static uint64_t bit_lib_test_ref_get_bits(const uint8_t* data, size_t position, uint8_t length) {
+    uint64_t value = 0;
+    for(uint8_t i = 0; i < length; i++) {
+        value = (value << 1) | bit_lib_get_bit(data, position + i);
+    }
+    return value;
+}
+
+static void bit_lib_test_ref_set_bits(
+    uint8_t* data,
+    size_t position,
+    uint64_t value,
+    uint8_t length) {
+    for(uint8_t i = 0; i < length; i++) {
+        bit_lib_set_bit(data, position + i, (value >> (length - 1 - i)) & 1);
+    }
+}
+
+static void bit_lib_test_ref_reverse_bits(uint8_t* data, size_t position, uint8_t length) {
+    for(size_t i = 0, j = length - 1; i < j; i++, j--) {
+        bool tmp = bit_lib_get_bit(data, position + i);
+        bit_lib_set_bit(data, position + i, bit_lib_get_bit(data, position + j));
+        bit_lib_set_bit(data, position + j, tmp);
+    }
+}
+
+static size_t bit_lib_test_ref_remove_bit_every_nth(
+    uint8_t* data,
+    size_t position,
+    uint8_t length,
+    uint8_t n) {
+    size_t result = 0;
+    for(size_t i = 0; i < length; i++) {
+        if((i + 1) % n != 0) {
+            bit_lib_set_bit(data, position + result++, bit_lib_get_bit(data, position + i));
+        }
+    }
+    return result;
+}
+
+static uint16_t bit_lib_test_ref_crc16(
+    const uint8_t* data,
+    size_t data_size,
+    uint16_t polynom,
+    uint16_t init,
+    bool ref_in,
+    bool ref_out,
+    uint16_t xor_out) {
+    uint16_t crc = init;
+    for(size_t i = 0; i < data_size; i++) {
+        for(size_t j = 0; j < 8; j++) {
+            bool c15 = crc >> 15 & 1;
+            bool bit = ref_in ? (data[i] >> j & 1) : (data[i] >> (7 - j) & 1);
+            crc <<= 1;
+            if(c15 ^ bit) crc ^= polynom;
+        }
+    }
+    if(ref_out) {
+        uint16_t reversed = 0;
+        for(size_t j = 0; j < 16; j++) {
+            reversed = (reversed << 1) | (crc >> j & 1);
+        }
+        crc = reversed;
+    }
+    return crc ^ xor_out;
+}
+
+MU_TEST(test_bit_lib_get_bits_random) {
+    uint8_t data[BIT_LIB_TEST_DATA_SIZE];
+    bit_lib_test_seed = 0x2545F491;
+
+    for(size_t i = 0; i < BIT_LIB_TEST_ITERATIONS; i++) {
+        bit_lib_test_random_fill(data, sizeof(data));
+        const uint8_t length = bit_lib_test_random() % 65;
+        const size_t position = bit_lib_test_random() % (sizeof(data) * 8 - length + 1);
+        const uint64_t expected = bit_lib_test_ref_get_bits(data, position, length);
+
+        mu_assert(bit_lib_get_bits_64(data, position, length) == expected, "get_bits_64");
+        if(length <= 32) {
+            mu_assert_int_eq(expected, bit_lib_get_bits_32(data, position, length));
+        }
+        if(length <= 16) {
+            mu_assert_int_eq(expected, bit_lib_get_bits_16(data, position, length));
+        }
+        if(length <= 8) {
+            mu_assert_int_eq(expected, bit_lib_get_bits(data, position, length));
+        }
+    }
+}
+
+MU_TEST(test_bit_lib_modify_bits_random) {
+    uint8_t source[BIT_LIB_TEST_DATA_SIZE];
+    uint8_t data[BIT_LIB_TEST_DATA_SIZE];
+    uint8_t expected[BIT_LIB_TEST_DATA_SIZE];
+    const size_t bits = sizeof(data) * 8;
+    bit_lib_test_seed = 0x9E3779B9;
+
+    for(size_t i = 0; i < BIT_LIB_TEST_ITERATIONS; i++) {
+        bit_lib_test_random_fill(source, sizeof(source));
+        bit_lib_test_random_fill(data, sizeof(data));
+
+        // set_bits
+        uint8_t length = bit_lib_test_random() % 8 + 1;
+        size_t position = bit_lib_test_random() % (bits - length + 1);
+        const uint8_t byte = bit_lib_test_random();
+        memcpy(expected, data, sizeof(data));
+        bit_lib_test_ref_set_bits(expected, position, byte & ((1U << length) - 1), length);
+        bit_lib_set_bits(data, position, byte, length);
+        mu_assert_mem_eq(expected, data, sizeof(data));
+
+        // copy_bits, byte aligned positions are tested as well
+        length = bit_lib_test_random() % (bits / 2);
+        position = bit_lib_test_random() % (bits - length + 1);
+        size_t source_position = bit_lib_test_random() % (bits - length + 1);
+        if(i % 4 == 0) {
+            position &= ~7U;
+            source_position &= ~7U;
+        }
+        memcpy(expected, data, sizeof(data));
+        for(size_t j = 0; j < length; j++) {
+            bit_lib_set_bit(expected, position + j, bit_lib_get_bit(source, source_position + j));
+        }
+        bit_lib_copy_bits(data, position, length, source, source_position);
+        mu_assert_mem_eq(expected, data, sizeof(data));
+
+        // reverse_bits
+        length = bit_lib_test_random() % (bits - 1) + 1;
+        position = bit_lib_test_random() % (bits - length + 1);
+        memcpy(expected, data, sizeof(data));
+        bit_lib_test_ref_reverse_bits(expected, position, length);
+        bit_lib_reverse_bits(data, position, length);
+        mu_assert_mem_eq(expected, data, sizeof(data));
+
+        // remove_bit_every_nth
+        length = bit_lib_test_random() % (bits - 16);
+        position = bit_lib_test_random() % (bits - length + 1);
+        const uint8_t n = bit_lib_test_random() % 40 + 2;
+        memcpy(expected, data, sizeof(data));
+        const size_t expected_length =
+            bit_lib_test_ref_remove_bit_every_nth(expected, position, length, n);
+        mu_assert_int_eq(expected_length, bit_lib_remove_bit_every_nth(data, position, length, n));
+        mu_assert_mem_eq(expected, data, sizeof(data));
+
+        // crc8 and crc16
+        const size_t size = bit_lib_test_random() % sizeof(source);
+        const bool ref_in = bit_lib_test_random() & 1;
+        const bool ref_out = bit_lib_test_random() & 1;
+        const uint16_t polynom = bit_lib_test_random();
+        const uint16_t init = bit_lib_test_random();
+        mu_assert_int_eq(
+            bit_lib_test_ref_crc16(source, size, polynom, init, ref_in, ref_out, 0x1234),
+            bit_lib_crc16(source, size, polynom, init, ref_in, ref_out, 0x1234));
+    }
+}
+
+MU_TEST(test_bit_lib_crc8) {
+    uint8_t data[9] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+    // CRC-8/SMBUS
+    mu_assert_int_eq(0xF4, bit_lib_crc8(data, sizeof(data), 0x07, 0x00, false, false, 0x00));
+    // CRC-8/MAXIM-DOW
+    mu_assert_int_eq(0xA1, bit_lib_crc8(data, sizeof(data), 0x31, 0x00, true, true, 0x00));
+    // CRC-8/ROHC
+    mu_assert_int_eq(0xD0, bit_lib_crc8(data, sizeof(data), 0x07, 0xFF, true, true, 0x00));
+}
+
+MU_TEST(test_bit_lib_performance) {
+    uint8_t data[BIT_LIB_TEST_DATA_SIZE];
+    uint64_t sink = 0;
+    bit_lib_test_seed = 0xDEADBEEF;
+    bit_lib_test_random_fill(data, sizeof(data));
+
+    // Preamble search as done by LF RFID decoders: a 32 bit window at every position
+    uint32_t start = furi_get_tick();
+    for(size_t i = 0; i < BIT_LIB_TEST_ITERATIONS / 10; i++) {
+        for(size_t position = 0; position <= (sizeof(data) - 4) * 8; position++) {
+            sink += bit_lib_test_ref_get_bits(data, position, 32);
+        }
+    }
+    const uint32_t reference_time = furi_get_tick() - start;
+
+    start = furi_get_tick();
+    for(size_t i = 0; i < BIT_LIB_TEST_ITERATIONS / 10; i++) {
+        for(size_t position = 0; position <= (sizeof(data) - 4) * 8; position++) {
+            sink -= bit_lib_get_bits_32(data, position, 32);
+        }
+    }
+    const uint32_t time = furi_get_tick() - start;
+
+    printf("\tget_bits_32: %lu ms, bit by bit: %lu ms\r\n", time, reference_time);
+    mu_assert(sink == 0, "results differ");
+    mu_assert(time < reference_time, "fast path is slower than bit by bit one");
+}
+
 MU_TEST_SUITE(test_bit_lib) {
     MU_RUN_TEST(test_bit_lib_increment_index);
     MU_RUN_TEST(test_bit_lib_is_set);
@@ -732,6 +946,10 @@ MU_TEST_SUITE(test_bit_lib) {
     MU_RUN_TEST(test_bit_lib_bytes_to_num_be);
     MU_RUN_TEST(test_bit_lib_bytes_to_num_le);
     MU_RUN_TEST(test_bit_lib_bytes_to_num_bcd);
+    MU_RUN_TEST(test_bit_lib_get_bits_random);
+    MU_RUN_TEST(test_bit_lib_modify_bits_random);
+    MU_RUN_TEST(test_bit_lib_crc8);
+    MU_RUN_TEST(test_bit_lib_performance);
 }
 
 int run_minunit_test_bit_lib() {
@@ -1,12 +1,17 @@
 #include <furi.h>
+#include <furi_hal.h>
 #include <flipper_format.h>
 #include <infrared.h>
+#include <infrared_worker.h>
 #include <common/infrared_common_i.h>
+#include <flipper_format/flipper_format_i.h>
+#include "../../../main/infrared/infrared_signal.h"
 #include "../minunit.h"
 
 #define IR_TEST_FILES_DIR EXT_PATH("unit_tests/infrared/")
 #define IR_TEST_FILE_PREFIX "test_"
 #define IR_TEST_FILE_SUFFIX ".irtest"
+#define IR_TEST_PERFORMANCE_PASSES 20
 
 typedef struct {
     InfraredDecoderHandler* decoder_handler;
@@ -522,6 +527,160 @@ MU_TEST(infrared_test_encoder_decoder_all) {
     infrared_test_run_encoder_decoder(InfraredProtocolRCA, 1);
 }
 
+/* Same edge sequence as infrared_test_run_decoder(), returns number of decoded messages */
+static uint32_t infrared_test_decode_timings(const uint32_t* timings, uint32_t timings_count) {
+    uint32_t message_counter = 0;
+    bool level = 0;
+
+    for(uint32_t i = 0; i < timings_count; ++i) {
+        if((timings[i] > INFRARED_RAW_RX_TIMING_DELAY_US) &&
+           infrared_check_decoder_ready(test->decoder_handler)) {
+            ++message_counter;
+        }
+        if(infrared_decode(test->decoder_handler, level, timings[i])) {
+            ++message_counter;
+        }
+        level = !level;
+    }
+
+    if(infrared_check_decoder_ready(test->decoder_handler)) {
+        ++message_counter;
+    }
+
+    return message_counter;
+}
+
+MU_TEST(infrared_test_decoder_performance) {
+    const struct {
+        InfraredProtocol protocol;
+        uint32_t count;
+    } inputs[] = {
+        {InfraredProtocolNEC, 3},
+        {InfraredProtocolNECext, 1},
+        {InfraredProtocolNEC42ext, 2},
+        {InfraredProtocolSamsung32, 1},
+        {InfraredProtocolRC5, 7},
+        {InfraredProtocolRC5X, 1},
+        {InfraredProtocolRC6, 2},
+        {InfraredProtocolSIRC, 5},
+        {InfraredProtocolKaseikyo, 6},
+        {InfraredProtocolRCA, 6},
+    };
+
+    FuriString* buf = furi_string_alloc();
+    uint32_t* timings[40];
+    uint32_t timings_count[40];
+    uint32_t expected_count[40];
+    size_t signal_count = 0;
+
+    for(size_t i = 0; i < COUNT_OF(inputs); ++i) {
+        for(uint32_t test_index = 1; test_index <= inputs[i].count; ++test_index) {
+            furi_check(signal_count < COUNT_OF(timings));
+            InfraredMessage* messages;
+            mu_assert(
+                infrared_test_prepare_file(infrared_get_protocol_name(inputs[i].protocol)),
+                "Failed to prepare test file");
+
+            furi_string_printf(buf, "decoder_input%ld", test_index);
+            mu_assert(
+                infrared_test_load_raw_signal(
+                    test->ff,
+                    furi_string_get_cstr(buf),
+                    &timings[signal_count],
+                    &timings_count[signal_count]),
+                "Failed to load raw signal from file");
+
+            furi_string_printf(buf, "decoder_expected%ld", test_index);
+            mu_assert(
+                infrared_test_load_messages(
+                    test->ff,
+                    furi_string_get_cstr(buf),
+                    &messages,
+                    &expected_count[signal_count]),
+                "Failed to load messages from file");
+
+            flipper_format_buffered_file_close(test->ff);
+            free(messages);
+            ++signal_count;
+        }
+    }
+    furi_string_free(buf);
+
+    uint32_t edges = 0;
+    uint32_t cycles = 0;
+    bool decoded_all = true;
+
+    for(size_t pass = 0; pass < IR_TEST_PERFORMANCE_PASSES; ++pass) {
+        for(size_t i = 0; i < signal_count; ++i) {
+            infrared_reset_decoder(test->decoder_handler);
+            const uint32_t start = DWT->CYCCNT;
+            uint32_t message_count = infrared_test_decode_timings(timings[i], timings_count[i]);
+            cycles += DWT->CYCCNT - start;
+            edges += timings_count[i];
+            decoded_all &= (message_count == expected_count[i]);
+        }
+    }
+
+    for(size_t i = 0; i < signal_count; ++i) {
+        free(timings[i]);
+    }
+
+    printf("\tdecoder: %lu edges, %lu cycles per edge\r\n", edges, cycles / edges);
+    mu_assert(decoded_all, "decoded message count differs from expected");
+}
+
+static void infrared_test_signal_stream_add(Stream* stream, const char* name, const char* data) {
+    stream_write_format(
+        stream, "name: %s\ntype: raw\nfrequency: 38000\nduty_cycle: 0.33\ndata: %s\n", name, data);
+}
+
+MU_TEST(infrared_test_signal_stream) {
+    FlipperFormat* ff = flipper_format_string_alloc();
+    Stream* stream = flipper_format_get_raw_stream(ff);
+    FuriString* data = furi_string_alloc();
+
+    // Longer than both transmit chunks together, so the reader is called while sending
+    for(size_t i = 0; i < 600; ++i) {
+        furi_string_cat_printf(data, "%u ", (i % 2) ? 560U : 1690U);
+    }
+    infrared_test_signal_stream_add(stream, "short", "9000 4500 560 560 560");
+    infrared_test_signal_stream_add(stream, "long", furi_string_get_cstr(data));
+    infrared_test_signal_stream_add(stream, "after_long", "9000 4500");
+    infrared_test_signal_stream_add(stream, "overflow", "4294967296 560");
+    infrared_test_signal_stream_add(stream, "zero", "9000 0 560");
+    infrared_test_signal_stream_add(stream, "separator", "9000, 4500");
+    infrared_test_signal_stream_add(stream, "suffix", "9000 45k0");
+    infrared_test_signal_stream_add(stream, "empty", "");
+
+    furi_string_reset(data);
+    for(size_t i = 0; i <= MAX_TIMINGS_AMOUNT; ++i) {
+        furi_string_cat_str(data, "560 ");
+    }
+    infrared_test_signal_stream_add(stream, "over_max", furi_string_get_cstr(data));
+
+    mu_check(flipper_format_rewind(ff));
+    mu_assert(infrared_signal_search_by_name_and_transmit(ff, "short"), "short not sent");
+    mu_check(flipper_format_rewind(ff));
+    mu_assert(infrared_signal_search_by_name_and_transmit(ff, "long"), "long not sent");
+    mu_assert(infrared_signal_read_name(ff, data), "stream not left after the data line");
+    mu_assert_string_eq("after_long", furi_string_get_cstr(data));
+
+    const char* const malformed[] = {"overflow", "zero", "separator", "suffix", "empty"};
+    for(size_t i = 0; i < COUNT_OF(malformed); ++i) {
+        mu_check(flipper_format_rewind(ff));
+        mu_assert(
+            !infrared_signal_search_by_name_and_transmit(ff, malformed[i]),
+            "malformed signal sent");
+    }
+
+    // Streaming is not limited to the size of a signal loaded into memory
+    mu_check(flipper_format_rewind(ff));
+    mu_assert(infrared_signal_search_by_name_and_transmit(ff, "over_max"), "over_max not sent");
+
+    furi_string_free(data);
+    flipper_format_free(ff);
+}
+
 MU_TEST_SUITE(infrared_test) {
     MU_SUITE_CONFIGURE(&infrared_test_alloc, &infrared_test_free);
 
@@ -541,6 +700,8 @@ MU_TEST_SUITE(infrared_test) {
     MU_RUN_TEST(infrared_test_decoder_rca);
     MU_RUN_TEST(infrared_test_decoder_mixed);
     MU_RUN_TEST(infrared_test_encoder_decoder_all);
+    MU_RUN_TEST(infrared_test_decoder_performance);
+    MU_RUN_TEST(infrared_test_signal_stream);
 }
 
 int run_minunit_test_infrared() {
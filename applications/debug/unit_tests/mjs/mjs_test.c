@@ -0,0 +1,177 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+#include <toolbox/profiler.h>
+
+#include <mjs_core_public.h>
+#include <mjs_exec_public.h>
+#include <mjs_object_public.h>
+#include <mjs_primitive_public.h>
+#include <mjs_array_public.h>
+#include <mjs_gc_public.h>
+
+typedef struct {
+    const char* name;
+    const char* source;
+    double checksum;
+} MjsTestBenchmark;
+
+static const MjsTestBenchmark mjs_test_benchmarks[] = {
+    {
+        .name = "property",
+        .source = "let o = {alpha: 1, beta: 2, gamma: 3, delta: 4, epsilon: 5, zeta: 6,"
+                  "eta: 7, theta: 8, iota: 9, kappa: 10, lambda: 11, mu: 12};"
+                  "let s = 0;"
+                  "for(let i = 0; i < 2000; i++) {"
+                  "  s = s + o.alpha + o.mu + o.epsilon + o.lambda;"
+                  "  o.theta = i;"
+                  "}"
+                  "s + o.theta;",
+        .checksum = 2000 * (1 + 12 + 5 + 11) + 1999,
+    },
+    {
+        .name = "method",
+        .source = "let counter = {value: 0, step: 3,"
+                  "  add: function(x) { this.value = this.value + x; return this; },"
+                  "  next: function() { return this.add(this.step); }};"
+                  "for(let i = 0; i < 1000; i++) { counter.next(); }"
+                  "counter.value;",
+        .checksum = 1000 * 3,
+    },
+    {
+        .name = "array",
+        .source = "let a = [];"
+                  "for(let i = 0; i < 100; i++) { a.push(i); }"
+                  "let s = 0;"
+                  "for(let r = 0; r < 20; r++) {"
+                  "  for(let i = 0; i < a.length; i++) { s = s + a[i]; }"
+                  "}"
+                  "s + a.length;",
+        .checksum = 20 * (99 * 100 / 2) + 100,
+    },
+};
+
+static void mjs_test_benchmark_run(Profiler* profiler, const MjsTestBenchmark* benchmark) {
+    struct mjs* mjs = mjs_create(NULL);
+    mjs_val_t result = MJS_UNDEFINED;
+
+    profiler_start(profiler, benchmark->name);
+    mjs_err_t err = mjs_exec(mjs, benchmark->source, &result);
+    profiler_stop(profiler, benchmark->name);
+
+    bool is_number = mjs_is_number(result);
+    double checksum = mjs_get_double(mjs, result);
+    mjs_destroy(mjs);
+
+    mu_assert_int_eq(MJS_OK, err);
+    mu_assert(is_number, "result is not a number");
+    mu_assert_double_eq(benchmark->checksum, checksum);
+}
+
+MU_TEST(test_mjs_property_index) {
+    struct mjs* mjs = mjs_create(NULL);
+    mjs_val_t obj = mjs_mk_object(mjs);
+    char name[16];
+
+    // Enough properties to get the object indexed
+    for(int i = 0; i < 32; i++) {
+        snprintf(name, sizeof(name), "property_%d", i);
+        mu_assert_int_eq(MJS_OK, mjs_set(mjs, obj, name, ~0, mjs_mk_number(mjs, i)));
+    }
+
+    for(int i = 0; i < 32; i++) {
+        snprintf(name, sizeof(name), "property_%d", i);
+        mu_assert_int_eq(i, mjs_get_int(mjs, mjs_get(mjs, obj, name, ~0)));
+    }
+
+    mu_assert_int_eq(0, mjs_del(mjs, obj, "property_7", ~0));
+    mu_assert(mjs_is_undefined(mjs_get(mjs, obj, "property_7", ~0)), "deleted property found");
+    mu_assert_int_eq(8, mjs_get_int(mjs, mjs_get(mjs, obj, "property_8", ~0)));
+
+    mjs_val_t arr = mjs_mk_array(mjs);
+    for(int i = 0; i < 32; i++) {
+        mjs_array_push(mjs, arr, mjs_mk_number(mjs, i));
+    }
+    mu_assert_int_eq(32, mjs_array_length(mjs, arr));
+    mjs_array_set(mjs, arr, 63, mjs_mk_number(mjs, 63));
+    mu_assert_int_eq(64, mjs_array_length(mjs, arr));
+
+    mjs_destroy(mjs);
+}
+
+MU_TEST(test_mjs_benchmark) {
+    Profiler* profiler = profiler_alloc();
+    for(size_t i = 0; i < COUNT_OF(mjs_test_benchmarks); i++) {
+        profiler_prealloc(profiler, mjs_test_benchmarks[i].name);
+    }
+
+    for(size_t i = 0; i < COUNT_OF(mjs_test_benchmarks); i++) {
+        mjs_test_benchmark_run(profiler, &mjs_test_benchmarks[i]);
+    }
+
+    profiler_dump(profiler);
+    profiler_free(profiler);
+}
+
+// Long living objects plus lots of short living temporaries
+static const char* mjs_test_gc_source = "let keep = [];"
+                                        "for(let i = 0; i < 200; i++) {"
+                                        "  keep.push({v: i, s: 'long living string'});"
+                                        "}"
+                                        "let t = 0;"
+                                        "for(let i = 0; i < 2000; i++) {"
+                                        "  let tmp = {a: i, b: {c: i}};"
+                                        "  t = t + tmp.b.c;"
+                                        "  if(i % 10 === 0) { keep[i % 200].v = {w: i}; }"
+                                        "}"
+                                        "for(let i = 0; i < 200; i += 10) { t = t + keep[i].v.w; }"
+                                        "t;";
+
+static void mjs_test_gc_run(bool incremental) {
+    struct mjs* mjs = mjs_create(NULL);
+    struct mjs_gc_stats stats;
+    mjs_val_t result = MJS_UNDEFINED;
+
+    mjs_set_gc_incremental(mjs, incremental);
+    uint32_t start = furi_get_tick();
+    mjs_err_t err = mjs_exec(mjs, mjs_test_gc_source, &result);
+    uint32_t duration = furi_get_tick() - start;
+    double checksum = mjs_get_double(mjs, result);
+    mjs_get_gc_stats(mjs, &stats);
+    mjs_destroy(mjs);
+
+    printf(
+        "\t%s: %lums, %lu minor, %lu major, %lu steps, max pause %luus, total %luus\r\n",
+        incremental ? "incremental" : "stop-the-world",
+        duration,
+        stats.minor_collections,
+        stats.major_collections,
+        stats.sweep_steps,
+        stats.max_pause_us,
+        (uint32_t)stats.total_pause_us);
+
+    mu_assert_int_eq(MJS_OK, err);
+    // sum(0..1999) + sum(1990..1999 step 10 over the kept objects)
+    mu_assert_double_eq(1999000.0 + 19 * 20 / 2 * 10 + 20 * 1800, checksum);
+    if(incremental) {
+        mu_assert(stats.minor_collections > 0, "no minor collections");
+    } else {
+        mu_assert_int_eq(0, stats.minor_collections);
+    }
+}
+
+MU_TEST(test_mjs_gc) {
+    mjs_test_gc_run(false);
+    mjs_test_gc_run(true);
+}
+
+MU_TEST_SUITE(test_mjs_suite) {
+    MU_RUN_TEST(test_mjs_property_index);
+    MU_RUN_TEST(test_mjs_benchmark);
+    MU_RUN_TEST(test_mjs_gc);
+}
+
+int run_minunit_test_mjs() {
+    MU_RUN_SUITE(test_mjs_suite);
+    return MU_EXIT_CODE;
+}
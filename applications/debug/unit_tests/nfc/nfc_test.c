@@ -4,23 +4,40 @@
 
 #include <nfc/nfc_device.h>
 #include <nfc/helpers/nfc_data_generator.h>
+#include <nfc/helpers/iso14443_4_layer.h>
+#include <nfc/helpers/iso14443_crc.h>
 #include <nfc/nfc_poller.h>
 #include <nfc/nfc_listener.h>
+#include <nfc/nfc_scanner.h>
 #include <nfc/protocols/iso14443_3a/iso14443_3a.h>
 #include <nfc/protocols/iso14443_3a/iso14443_3a_poller_sync.h>
 #include <nfc/protocols/mf_ultralight/mf_ultralight.h>
 #include <nfc/protocols/mf_ultralight/mf_ultralight_poller_sync.h>
 #include <nfc/protocols/mf_classic/mf_classic_poller_sync.h>
+#include <nfc/protocols/iso14443_4a/iso14443_4a_listener.h>
+#include <nfc/protocols/mf_desfire/mf_desfire_poller.h>
 
+#include <signal_reader/parsers/iso15693/iso15693_parser.h>
 #include <toolbox/keys_dict.h>
+#include <bit_lib/bit_lib.h>
 #include <nfc/nfc.h>
+#include <toolbox/stream/file_stream.h>
 
+#include "../../../main/nfc/helpers/nfc_supported_cards_fingerprint.h"
+
+#include "nfc_transport.h"
 #include "../minunit.h"
 
 #define TAG "NfcTest"
 
 #define NFC_TEST_NFC_DEV_PATH EXT_PATH("unit_tests/nfc/nfc_device_test.nfc")
+#define NFC_TEST_NFC_DEV_CACHE_PATH EXT_PATH("unit_tests/nfc/.cache/nfc_device_test.nfc.cache")
+#define NFC_TEST_NFC_DEV_OTHER_PATH EXT_PATH("unit_tests/nfc/nfc_device_other.nfc")
+#define NFC_TEST_NFC_DEV_OTHER_CACHE_PATH \
+    EXT_PATH("unit_tests/nfc/.cache/nfc_device_other.nfc.cache")
 #define NFC_APP_MF_CLASSIC_DICT_UNIT_TEST_PATH EXT_PATH("unit_tests/mf_dict.nfc")
+#define NFC_TEST_TRACE_PATH EXT_PATH("unit_tests/nfc/.nfc_trace_test.bin")
+#define NFC_TEST_TRACE_SIZE (8 * 1024)
 
 typedef struct {
     Storage* storage;
@@ -47,6 +64,19 @@ static void nfc_test_save_and_load(NfcDevice* nfc_device_ref) {
     mu_assert(
         nfc_device_save(nfc_device_ref, NFC_TEST_NFC_DEV_PATH), "nfc_device_save() failed\r\n");
 
+    // Binary cache is used if the protocol supports it
+    mu_assert(
+        nfc_device_load(nfc_device_dut, NFC_TEST_NFC_DEV_PATH), "nfc_device_load() failed\r\n");
+
+    mu_assert(
+        nfc_device_is_equal(nfc_device_ref, nfc_device_dut),
+        "nfc_device_data_dut != nfc_device_data_ref\r\n");
+
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH),
+        "storage_simply_remove() failed\r\n");
+
+    // Text file is parsed
     mu_assert(
         nfc_device_load(nfc_device_dut, NFC_TEST_NFC_DEV_PATH), "nfc_device_load() failed\r\n");
 
@@ -57,6 +87,9 @@ static void nfc_test_save_and_load(NfcDevice* nfc_device_ref) {
     mu_assert(
         storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_PATH),
         "storage_simply_remove() failed\r\n");
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH),
+        "storage_simply_remove() failed\r\n");
 
     nfc_device_free(nfc_device_dut);
 }
@@ -166,6 +199,84 @@ MU_TEST(mf_classic_4k_7b_file_test) {
     nfc_file_test_with_generator(NfcDataGeneratorTypeMfClassic4k_7b);
 }
 
+MU_TEST(nfc_device_cache_test) {
+    NfcDevice* nfc_device_ref = nfc_device_alloc();
+    NfcDevice* nfc_device_other = nfc_device_alloc();
+    NfcDevice* nfc_device_dut = nfc_device_alloc();
+    nfc_data_generator_fill_data(NfcDataGeneratorTypeMfClassic1k_4b, nfc_device_ref);
+    nfc_data_generator_fill_data(NfcDataGeneratorTypeMfClassic4k_4b, nfc_device_other);
+
+    mu_assert(nfc_device_save(nfc_device_ref, NFC_TEST_NFC_DEV_PATH), "nfc_device_save() failed");
+    mu_assert(
+        storage_common_exists(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH), "No cache saved");
+
+    // File replaced without nfc_device_save(), its cache is outdated
+    mu_assert(
+        nfc_device_save(nfc_device_other, NFC_TEST_NFC_DEV_OTHER_PATH),
+        "nfc_device_save() failed");
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_PATH),
+        "storage_simply_remove() failed");
+    mu_assert(
+        storage_common_copy(
+            nfc_test->storage, NFC_TEST_NFC_DEV_OTHER_PATH, NFC_TEST_NFC_DEV_PATH) == FSE_OK,
+        "storage_common_copy() failed");
+    mu_assert(nfc_device_load(nfc_device_dut, NFC_TEST_NFC_DEV_PATH), "nfc_device_load() failed");
+    mu_assert(nfc_device_is_equal(nfc_device_other, nfc_device_dut), "Outdated cache loaded");
+
+    // Loading does not write caches
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH),
+        "storage_simply_remove() failed");
+    mu_assert(nfc_device_load(nfc_device_dut, NFC_TEST_NFC_DEV_PATH), "nfc_device_load() failed");
+    mu_assert(
+        !storage_common_exists(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH),
+        "Cache saved on load");
+
+    // File without cache gets one after load
+    mu_assert(
+        nfc_device_update_cache(nfc_device_dut, NFC_TEST_NFC_DEV_PATH),
+        "nfc_device_update_cache() failed");
+    mu_assert(
+        storage_common_exists(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH), "No cache saved");
+    mu_assert(nfc_device_load(nfc_device_dut, NFC_TEST_NFC_DEV_PATH), "nfc_device_load() failed");
+    mu_assert(nfc_device_is_equal(nfc_device_other, nfc_device_dut), "Wrong cache saved");
+
+    // Caches of deleted files are removed on the next cache miss in the directory
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_OTHER_PATH),
+        "storage_simply_remove() failed");
+    mu_assert(nfc_device_save(nfc_device_ref, NFC_TEST_NFC_DEV_PATH), "nfc_device_save() failed");
+    mu_assert(
+        nfc_device_update_cache(nfc_device_ref, NFC_TEST_NFC_DEV_PATH),
+        "nfc_device_update_cache() failed");
+    mu_assert(
+        storage_common_exists(nfc_test->storage, NFC_TEST_NFC_DEV_OTHER_CACHE_PATH),
+        "Directory scanned on cache hit");
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH),
+        "storage_simply_remove() failed");
+    mu_assert(
+        nfc_device_update_cache(nfc_device_ref, NFC_TEST_NFC_DEV_PATH),
+        "nfc_device_update_cache() failed");
+    mu_assert(
+        !storage_common_exists(nfc_test->storage, NFC_TEST_NFC_DEV_OTHER_CACHE_PATH),
+        "Orphaned cache not removed");
+    mu_assert(nfc_device_load(nfc_device_dut, NFC_TEST_NFC_DEV_PATH), "nfc_device_load() failed");
+    mu_assert(nfc_device_is_equal(nfc_device_ref, nfc_device_dut), "Cache not updated");
+
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_PATH),
+        "storage_simply_remove() failed");
+    mu_assert(
+        storage_simply_remove(nfc_test->storage, NFC_TEST_NFC_DEV_CACHE_PATH),
+        "storage_simply_remove() failed");
+
+    nfc_device_free(nfc_device_dut);
+    nfc_device_free(nfc_device_other);
+    nfc_device_free(nfc_device_ref);
+}
+
 MU_TEST(iso14443_3a_reader) {
     Nfc* poller = nfc_alloc();
     Nfc* listener = nfc_alloc();
@@ -195,6 +306,78 @@ MU_TEST(iso14443_3a_reader) {
     nfc_free(poller);
 }
 
+typedef struct {
+    FuriSemaphore* detected;
+    bool is_detected;
+    size_t protocol_num;
+    NfcProtocol protocols[NfcProtocolNum];
+} NfcScannerTestContext;
+
+static void nfc_scanner_test_callback(NfcScannerEvent event, void* context) {
+    NfcScannerTestContext* ctx = context;
+
+    // Scanner keeps reporting until stopped, only the first result is kept
+    if((event.type == NfcScannerEventTypeDetected) && !ctx->is_detected) {
+        ctx->is_detected = true;
+        ctx->protocol_num = event.data.protocol_num;
+        memcpy(ctx->protocols, event.data.protocols, sizeof(NfcProtocol) * ctx->protocol_num);
+        furi_semaphore_release(ctx->detected);
+    }
+}
+
+static NfcProtocol nfc_scanner_test_scan(Nfc* poller) {
+    NfcScannerTestContext ctx = {.detected = furi_semaphore_alloc(1, 0)};
+    NfcScanner* scanner = nfc_scanner_alloc(poller);
+
+    nfc_scanner_start(scanner, nfc_scanner_test_callback, &ctx);
+    const bool detected = furi_semaphore_acquire(ctx.detected, 10000) == FuriStatusOk;
+    nfc_scanner_stop(scanner);
+
+    nfc_scanner_free(scanner);
+    furi_semaphore_free(ctx.detected);
+
+    return (detected && (ctx.protocol_num == 1)) ? ctx.protocols[0] : NfcProtocolInvalid;
+}
+
+MU_TEST(nfc_scanner_learned_subset_test) {
+    Nfc* poller = nfc_alloc();
+    Nfc* listener = nfc_alloc();
+
+    // Bare ISO14443-3A tags teach the scanner the {3A} chain
+    Iso14443_3aData iso14443_3a_data = {
+        .uid_len = 7,
+        .uid = {0x04, 0x51, 0x5C, 0xFA, 0x6F, 0x73, 0x81},
+        .atqa = {0x44, 0x00},
+        .sak = 0x00,
+    };
+    NfcListener* iso3_listener =
+        nfc_listener_alloc(listener, NfcProtocolIso14443_3a, &iso14443_3a_data);
+    nfc_listener_start(iso3_listener, NULL, NULL);
+    for(size_t i = 0; i < 3; i++) {
+        mu_assert_int_eq(NfcProtocolIso14443_3a, nfc_scanner_test_scan(poller));
+    }
+    nfc_listener_stop(iso3_listener);
+    nfc_listener_free(iso3_listener);
+
+    // Ultralight card has more protocols than the learned chain, none may be skipped
+    NfcDevice* nfc_device = nfc_device_alloc();
+    mu_assert(
+        nfc_device_load(nfc_device, EXT_PATH("unit_tests/nfc/Ultralight_11.nfc")),
+        "nfc_device_load() failed");
+    NfcListener* mfu_listener = nfc_listener_alloc(
+        listener,
+        NfcProtocolMfUltralight,
+        nfc_device_get_data(nfc_device, NfcProtocolMfUltralight));
+    nfc_listener_start(mfu_listener, NULL, NULL);
+    mu_assert_int_eq(NfcProtocolMfUltralight, nfc_scanner_test_scan(poller));
+    nfc_listener_stop(mfu_listener);
+    nfc_listener_free(mfu_listener);
+
+    nfc_device_free(nfc_device);
+    nfc_free(listener);
+    nfc_free(poller);
+}
+
 static void mf_ultralight_reader_test(const char* path) {
     FURI_LOG_I(TAG, "Testing file: %s", path);
     Nfc* poller = nfc_alloc();
@@ -292,6 +475,98 @@ MU_TEST(ntag_213_locked_reader) {
     nfc_free(poller);
 }
 
+static void nfc_test_print_replay_stats(const char* name, const NfcReplayStats* stats) {
+    printf(
+        "\t%s: %zu frames, %lu us per frame, %lu us max, %zu bytes heap max\r\n",
+        name,
+        stats->frames,
+        stats->frames ? stats->cpu_us_total / stats->frames : 0,
+        stats->cpu_us_max,
+        stats->heap_max);
+}
+
+MU_TEST(nfc_trace_replay_test) {
+    NfcDevice* nfc_device = nfc_device_alloc();
+    mu_assert(
+        nfc_device_load(nfc_device, EXT_PATH("unit_tests/nfc/Ntag215.nfc")),
+        "nfc_device_load() failed\r\n");
+    const MfUltralightData* listener_data =
+        nfc_device_get_data(nfc_device, NfcProtocolMfUltralight);
+
+    Nfc* poller = nfc_alloc();
+    Nfc* listener = nfc_alloc();
+    NfcTrace* trace = nfc_trace_alloc(NFC_TEST_TRACE_SIZE);
+
+    // Record the poller side of a read
+    NfcListener* mfu_listener =
+        nfc_listener_alloc(listener, NfcProtocolMfUltralight, listener_data);
+    nfc_listener_start(mfu_listener, NULL, NULL);
+
+    nfc_set_trace(poller, trace);
+    MfUltralightData* mfu_data = mf_ultralight_alloc();
+    MfUltralightError error = mf_ultralight_poller_sync_read_card(poller, mfu_data);
+    mu_assert(error == MfUltralightErrorNone, "mf_ultralight_poller_sync_read_card() failed");
+    nfc_set_trace(poller, NULL);
+
+    nfc_listener_stop(mfu_listener);
+    nfc_listener_free(mfu_listener);
+
+    const size_t frames = nfc_trace_get_count(trace);
+    mu_assert(frames > 0, "no frames traced");
+    mu_assert_int_eq(0, frames % 2);
+    mu_assert_int_eq(0, nfc_trace_get_lost_count(trace));
+
+    // Saved trace is loaded back as is
+    Stream* stream = file_stream_alloc(nfc_test->storage);
+    mu_assert(
+        file_stream_open(stream, NFC_TEST_TRACE_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS),
+        "file_stream_open() failed");
+    mu_assert(nfc_trace_save(trace, stream), "nfc_trace_save() failed");
+    file_stream_close(stream);
+
+    nfc_trace_reset(trace);
+    mu_assert(
+        file_stream_open(stream, NFC_TEST_TRACE_PATH, FSAM_READ, FSOM_OPEN_EXISTING),
+        "file_stream_open() failed");
+    mu_assert(nfc_trace_load(trace, stream), "nfc_trace_load() failed");
+    stream_free(stream);
+    mu_assert(storage_simply_remove(nfc_test->storage, NFC_TEST_TRACE_PATH), "remove failed");
+    mu_assert_int_eq(frames, nfc_trace_get_count(trace));
+
+    // Poller gets the same card data from the trace alone
+    NfcReplayStats stats = {};
+    nfc_set_replay(poller, trace, &stats);
+    MfUltralightData* replay_data = mf_ultralight_alloc();
+    error = mf_ultralight_poller_sync_read_card(poller, replay_data);
+    mu_assert(error == MfUltralightErrorNone, "mf_ultralight_poller_sync_read_card() failed");
+    nfc_set_replay(poller, NULL, NULL);
+
+    mu_assert(mf_ultralight_is_equal(replay_data, mfu_data), "Data not matches");
+    mu_assert_int_eq(0, stats.mismatches);
+    mu_assert_int_eq(frames / 2, stats.frames);
+    nfc_test_print_replay_stats("Poller", &stats);
+
+    // Listener answers the traced reader frames with the traced card frames
+    memset(&stats, 0, sizeof(stats));
+    nfc_set_replay(listener, trace, &stats);
+    mfu_listener = nfc_listener_alloc(listener, NfcProtocolMfUltralight, listener_data);
+    nfc_listener_start(mfu_listener, NULL, NULL);
+    nfc_listener_stop(mfu_listener);
+    nfc_listener_free(mfu_listener);
+    nfc_set_replay(listener, NULL, NULL);
+
+    mu_assert_int_eq(0, stats.mismatches);
+    mu_assert_int_eq(frames / 2, stats.frames);
+    nfc_test_print_replay_stats("Listener", &stats);
+
+    mf_ultralight_free(replay_data);
+    mf_ultralight_free(mfu_data);
+    nfc_trace_free(trace);
+    nfc_free(listener);
+    nfc_free(poller);
+    nfc_device_free(nfc_device);
+}
+
 static void mf_ultralight_write() {
     Nfc* poller = nfc_alloc();
     Nfc* listener = nfc_alloc();
@@ -504,6 +779,461 @@ MU_TEST(mf_classic_dict_test) {
         "Remove test dict failed");
 }
 
+static void nfc_test_mf_classic_set_key_a(MfClassicData* data, uint8_t sector, uint64_t key) {
+    MfClassicSectorTrailer* sec_tr =
+        (MfClassicSectorTrailer*)&data->block[mf_classic_get_sector_trailer_num_by_sector(sector)];
+    bit_lib_num_to_bytes_be(key, sizeof(MfClassicKey), sec_tr->key_a.data);
+}
+
+MU_TEST(nfc_supported_cards_fingerprint_test) {
+    const uint64_t key = 0xe56ac127dd45;
+    // Same keys as the two_cities plugin
+    const NfcSupportedCardPluginKeyFingerprint all_types[] = {
+        {.type = MfClassicTypeMini, .sector = 4, .key_type = MfClassicKeyTypeA, .key = key},
+        {.type = MfClassicType1k, .sector = 4, .key_type = MfClassicKeyTypeA, .key = key},
+        {.type = MfClassicType4k, .sector = 4, .key_type = MfClassicKeyTypeA, .key = key},
+    };
+    // Key in a sector that Mini cards do not have
+    const NfcSupportedCardPluginKeyFingerprint no_mini[] = {
+        {.type = MfClassicTypeMini, .sector = 8, .key_type = MfClassicKeyTypeA, .key = key},
+        {.type = MfClassicType1k, .sector = 8, .key_type = MfClassicKeyTypeA, .key = key},
+        {.type = MfClassicType4k, .sector = 8, .key_type = MfClassicKeyTypeA, .key = key},
+    };
+    const MfClassicType types[] = {MfClassicTypeMini, MfClassicType1k, MfClassicType4k};
+
+    MfClassicData* data = mf_classic_alloc();
+
+    for(size_t i = 0; i < COUNT_OF(types); i++) {
+        mf_classic_reset(data);
+        data->type = types[i];
+
+        mu_assert(
+            nfc_supported_cards_fingerprint_match(NULL, 0, data, true),
+            "Plugin without fingerprints skipped");
+        mu_assert(
+            nfc_supported_cards_fingerprint_match(all_types, COUNT_OF(all_types), data, false),
+            "Card type not matched");
+        mu_assert(
+            !nfc_supported_cards_fingerprint_match(all_types, COUNT_OF(all_types), data, true),
+            "Key matched before it is set");
+        mu_assert(
+            nfc_supported_cards_fingerprint_match(all_types + i, 1, data, false),
+            "Card type not matched");
+        mu_assert(
+            !nfc_supported_cards_fingerprint_match(
+                all_types + (i + 1) % COUNT_OF(all_types), 1, data, false),
+            "Other card type matched");
+
+        nfc_test_mf_classic_set_key_a(data, 4, key);
+        mu_assert(
+            nfc_supported_cards_fingerprint_match(all_types, COUNT_OF(all_types), data, true),
+            "Key not matched");
+
+        nfc_test_mf_classic_set_key_a(data, 4, key + 1);
+        mu_assert(
+            !nfc_supported_cards_fingerprint_match(all_types, COUNT_OF(all_types), data, true),
+            "Wrong key matched");
+
+        if(types[i] != MfClassicTypeMini) {
+            nfc_test_mf_classic_set_key_a(data, 8, key);
+        }
+        mu_assert(
+            nfc_supported_cards_fingerprint_match(no_mini, COUNT_OF(no_mini), data, true) ==
+                (types[i] != MfClassicTypeMini),
+            "Sector out of the card matched");
+    }
+
+    mf_classic_free(data);
+}
+
+#define NFC_TEST_ISO14443_4_PCB_CHAINING (0x10)
+#define NFC_TEST_ISO14443_4_PCB_WTX (0xF2)
+
+// Card side of ISO14443-4 block exchange: receives a chained command, asks for
+// more time once and returns a chained response
+typedef struct {
+    size_t fsd;
+    uint8_t block_number;
+    bool wtx_requested;
+    BitBuffer* command;
+    BitBuffer* response;
+    size_t response_offset;
+    size_t frames;
+    size_t bytes;
+} NfcTestIso14443_4Card;
+
+static void nfc_test_iso14443_4_card_send_response(NfcTestIso14443_4Card* card, BitBuffer* tx) {
+    const size_t response_size = bit_buffer_get_size_bytes(card->response);
+    const size_t inf_size = MIN(response_size - card->response_offset, card->fsd - 3);
+
+    uint8_t pcb = 0x02 | card->block_number;
+    if(card->response_offset + inf_size < response_size) {
+        pcb |= NFC_TEST_ISO14443_4_PCB_CHAINING;
+    }
+    bit_buffer_append_byte(tx, pcb);
+    bit_buffer_append_bytes(
+        tx, bit_buffer_get_data(card->response) + card->response_offset, inf_size);
+    card->response_offset += inf_size;
+}
+
+static void nfc_test_iso14443_4_card_exchange(
+    NfcTestIso14443_4Card* card,
+    const BitBuffer* rx,
+    BitBuffer* tx) {
+    const uint8_t pcb = bit_buffer_get_byte(rx, 0);
+    bit_buffer_reset(tx);
+    card->frames++;
+    card->bytes += bit_buffer_get_size_bytes(rx);
+
+    if((pcb & 0xC0) == 0x00) {
+        // I-block
+        card->block_number = pcb & 0x01;
+        bit_buffer_append_right(card->command, rx, 1);
+        if(pcb & NFC_TEST_ISO14443_4_PCB_CHAINING) {
+            bit_buffer_append_byte(tx, 0xA2 | card->block_number);
+        } else if(!card->wtx_requested) {
+            card->wtx_requested = true;
+            bit_buffer_append_byte(tx, NFC_TEST_ISO14443_4_PCB_WTX);
+            bit_buffer_append_byte(tx, 4);
+        } else {
+            nfc_test_iso14443_4_card_send_response(card, tx);
+        }
+    } else if(pcb == NFC_TEST_ISO14443_4_PCB_WTX) {
+        nfc_test_iso14443_4_card_send_response(card, tx);
+    } else if((pcb & 0xF0) == 0xA0) {
+        // R(ACK) for the next part of the response
+        card->block_number = pcb & 0x01;
+        nfc_test_iso14443_4_card_send_response(card, tx);
+    }
+
+    card->bytes += bit_buffer_get_size_bytes(tx);
+}
+
+MU_TEST(iso14443_4_layer_chaining_test) {
+    const size_t command_size = 300;
+    const size_t response_size = 500;
+    const size_t fsc = 64;
+    const size_t fsd = 128;
+
+    Iso14443_4Layer* layer = iso14443_4_layer_alloc();
+    BitBuffer* command = bit_buffer_alloc(command_size);
+    BitBuffer* response = bit_buffer_alloc(response_size);
+    BitBuffer* pcd_block = bit_buffer_alloc(ISO14443_4_LAYER_FSC_MAX);
+    BitBuffer* picc_block = bit_buffer_alloc(ISO14443_4_LAYER_FSC_MAX);
+
+    NfcTestIso14443_4Card card = {
+        .fsd = fsd,
+        .command = bit_buffer_alloc(command_size),
+        .response = bit_buffer_alloc(response_size),
+    };
+    for(size_t i = 0; i < command_size; i++) {
+        bit_buffer_append_byte(command, i);
+    }
+    for(size_t i = 0; i < response_size; i++) {
+        bit_buffer_append_byte(card.response, ~i);
+    }
+
+    iso14443_4_layer_set_fsc(layer, fsc);
+    iso14443_4_layer_encode_command(layer, command, pcd_block);
+
+    Iso14443_4LayerResult result = Iso14443_4LayerResultSend;
+    uint32_t wtxm_max = 1;
+    while(result == Iso14443_4LayerResultSend) {
+        mu_assert(bit_buffer_get_size_bytes(pcd_block) <= fsc - 2, "block exceeds FSC");
+        wtxm_max = MAX(wtxm_max, iso14443_4_layer_get_wtxm(layer));
+        nfc_test_iso14443_4_card_exchange(&card, pcd_block, picc_block);
+        result = iso14443_4_layer_decode_response(layer, response, picc_block, pcd_block);
+    }
+
+    // 5 command blocks, WTX response, 3 acknowledgements of response blocks
+    printf(
+        "\t%zu exchanges, %zu bytes per exchange\r\n", card.frames, card.bytes / card.frames);
+    mu_assert_int_eq(Iso14443_4LayerResultSuccess, result);
+    mu_assert_int_eq(9, card.frames);
+    mu_assert_int_eq(4, wtxm_max);
+    mu_assert_int_eq(1, iso14443_4_layer_get_wtxm(layer));
+    mu_assert_int_eq(command_size, bit_buffer_get_size_bytes(card.command));
+    mu_assert_mem_eq(
+        bit_buffer_get_data(command), bit_buffer_get_data(card.command), command_size);
+    mu_assert_int_eq(response_size, bit_buffer_get_size_bytes(response));
+    mu_assert_mem_eq(
+        bit_buffer_get_data(card.response), bit_buffer_get_data(response), response_size);
+
+    // Unexpected block number is rejected
+    bit_buffer_reset(response);
+    iso14443_4_layer_encode_command(layer, command, pcd_block);
+    bit_buffer_reset(picc_block);
+    bit_buffer_append_byte(picc_block, 0xA2 | (~bit_buffer_get_byte(pcd_block, 0) & 0x01));
+    mu_assert_int_eq(
+        Iso14443_4LayerResultError,
+        iso14443_4_layer_decode_response(layer, response, picc_block, pcd_block));
+
+    // Card that asks for more time forever
+    bit_buffer_reset(response);
+    iso14443_4_layer_encode_command(layer, command, pcd_block);
+    size_t wtx_count = 0;
+    do {
+        bit_buffer_reset(picc_block);
+        bit_buffer_append_byte(picc_block, NFC_TEST_ISO14443_4_PCB_WTX);
+        bit_buffer_append_byte(picc_block, 1);
+        result = iso14443_4_layer_decode_response(layer, response, picc_block, pcd_block);
+    } while((result == Iso14443_4LayerResultSend) && (++wtx_count <= ISO14443_4_LAYER_WTX_MAX));
+    mu_assert_int_eq(Iso14443_4LayerResultTimeout, result);
+    mu_assert_int_eq(ISO14443_4_LAYER_WTX_MAX, wtx_count);
+
+    bit_buffer_free(card.response);
+    bit_buffer_free(card.command);
+    bit_buffer_free(picc_block);
+    bit_buffer_free(pcd_block);
+    bit_buffer_free(response);
+    bit_buffer_free(command);
+    iso14443_4_layer_free(layer);
+}
+
+#define NFC_TEST_MF_DESFIRE_APP_COUNT (2U)
+#define NFC_TEST_MF_DESFIRE_BUFFER_SIZE (64U)
+#define NFC_TEST_MF_DESFIRE_STATUS_OK (0x00)
+#define NFC_TEST_MF_DESFIRE_STATUS_AUTH_ERROR (0xAE)
+#define NFC_TEST_MF_DESFIRE_POLLER_DONE (1UL << 0)
+
+// DESFire card with two applications without files, keys of application N have version N
+typedef struct {
+    Nfc* nfc;
+    BitBuffer* tx_buffer;
+    uint8_t selected_app;
+    size_t selects;
+    bool fail_last_app;
+} NfcTestMfDesfireCard;
+
+typedef struct {
+    FuriThreadId thread_id;
+    size_t failures;
+    bool success;
+    uint32_t resumed;
+} NfcTestMfDesfireReader;
+
+static NfcCommand nfc_test_mf_desfire_card_callback(NfcGenericEvent event, void* context) {
+    NfcTestMfDesfireCard* card = context;
+    const Iso14443_4aListenerEvent* iso14443_4a_event = event.event_data;
+    if(iso14443_4a_event->type != Iso14443_4aListenerEventTypeReceivedData) {
+        return NfcCommandContinue;
+    }
+
+    // I-block is answered with the same block number, CID and NAD are not used
+    const BitBuffer* rx_buffer = iso14443_4a_event->data->buffer;
+    const uint8_t cmd = bit_buffer_get_byte(rx_buffer, 1);
+    BitBuffer* tx_buffer = card->tx_buffer;
+    bit_buffer_reset(tx_buffer);
+    bit_buffer_append_byte(tx_buffer, bit_buffer_get_byte(rx_buffer, 0));
+    bit_buffer_append_byte(tx_buffer, NFC_TEST_MF_DESFIRE_STATUS_OK);
+
+    if(cmd == MF_DESFIRE_CMD_GET_VERSION) {
+        for(size_t i = 0; i < sizeof(MfDesfireVersion); i++) {
+            bit_buffer_append_byte(tx_buffer, i);
+        }
+    } else if(cmd == MF_DESFIRE_CMD_GET_FREE_MEMORY) {
+        const uint8_t free_memory[] = {0x00, 0x10, 0x00};
+        bit_buffer_append_bytes(tx_buffer, free_memory, sizeof(free_memory));
+    } else if(cmd == MF_DESFIRE_CMD_GET_KEY_SETTINGS) {
+        if(card->fail_last_app && (card->selected_app == NFC_TEST_MF_DESFIRE_APP_COUNT)) {
+            card->fail_last_app = false;
+            bit_buffer_set_byte(tx_buffer, 1, NFC_TEST_MF_DESFIRE_STATUS_AUTH_ERROR);
+        } else {
+            // All settings allowed, single key
+            bit_buffer_append_byte(tx_buffer, 0x0F);
+            bit_buffer_append_byte(tx_buffer, 0x01);
+        }
+    } else if(cmd == MF_DESFIRE_CMD_GET_KEY_VERSION) {
+        bit_buffer_append_byte(tx_buffer, card->selected_app);
+    } else if(cmd == MF_DESFIRE_CMD_GET_APPLICATION_IDS) {
+        for(uint8_t i = 1; i <= NFC_TEST_MF_DESFIRE_APP_COUNT; i++) {
+            const uint8_t app_id[MF_DESFIRE_APP_ID_SIZE] = {i, 0x00, 0x00};
+            bit_buffer_append_bytes(tx_buffer, app_id, sizeof(app_id));
+        }
+    } else if(cmd == MF_DESFIRE_CMD_SELECT_APPLICATION) {
+        card->selected_app = bit_buffer_get_byte(rx_buffer, 2);
+        card->selects++;
+    }
+    // No files, GetFileIDs gets an empty list
+
+    iso14443_crc_append(Iso14443CrcTypeA, tx_buffer);
+    nfc_listener_tx(card->nfc, tx_buffer);
+
+    return NfcCommandContinue;
+}
+
+static NfcCommand nfc_test_mf_desfire_reader_callback(NfcGenericEvent event, void* context) {
+    NfcTestMfDesfireReader* reader = context;
+    const MfDesfirePollerEvent* mf_desfire_event = event.event_data;
+    NfcCommand command = NfcCommandContinue;
+
+    if(mf_desfire_event->type == MfDesfirePollerEventTypeReadSuccess) {
+        reader->success = true;
+        reader->resumed = mf_desfire_event->data->stats->resumed;
+        command = NfcCommandStop;
+    } else if(mf_desfire_event->type == MfDesfirePollerEventTypeReadFailed) {
+        reader->failures++;
+    }
+
+    if(command == NfcCommandStop) {
+        furi_thread_flags_set(reader->thread_id, NFC_TEST_MF_DESFIRE_POLLER_DONE);
+    }
+
+    return command;
+}
+
+MU_TEST(mf_desfire_resume_test) {
+    Nfc* poller = nfc_alloc();
+    Nfc* listener = nfc_alloc();
+
+    const Iso14443_3aData iso14443_3a_data = {
+        .uid_len = 7,
+        .uid = {0x04, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC},
+        .atqa = {0x44, 0x03},
+        .sak = 0x20,
+    };
+    Iso14443_4aData* iso14443_4a_data = iso14443_4a_alloc();
+    iso14443_3a_copy(iso14443_4a_data->iso14443_3a_data, &iso14443_3a_data);
+    // FSCI 8: 256 bytes frames
+    iso14443_4a_data->ats_data.tl = 2;
+    iso14443_4a_data->ats_data.t0 = 0x08;
+
+    // Last application denies the first request, read resumes from it
+    NfcTestMfDesfireCard card = {
+        .nfc = listener,
+        .tx_buffer = bit_buffer_alloc(NFC_TEST_MF_DESFIRE_BUFFER_SIZE),
+        .fail_last_app = true,
+    };
+    NfcListener* iso14443_4a_listener =
+        nfc_listener_alloc(listener, NfcProtocolIso14443_4a, iso14443_4a_data);
+    nfc_listener_start(iso14443_4a_listener, nfc_test_mf_desfire_card_callback, &card);
+
+    NfcTestMfDesfireReader reader = {
+        .thread_id = furi_thread_get_current_id(),
+    };
+    NfcPoller* mf_desfire_poller = nfc_poller_alloc(poller, NfcProtocolMfDesfire);
+    nfc_poller_start(mf_desfire_poller, nfc_test_mf_desfire_reader_callback, &reader);
+    furi_thread_flags_wait(NFC_TEST_MF_DESFIRE_POLLER_DONE, FuriFlagWaitAny, FuriWaitForever);
+    furi_thread_flags_clear(NFC_TEST_MF_DESFIRE_POLLER_DONE);
+    nfc_poller_stop(mf_desfire_poller);
+
+    nfc_listener_stop(iso14443_4a_listener);
+    nfc_listener_free(iso14443_4a_listener);
+
+    mu_assert(reader.success, "Read not finished");
+    mu_assert_int_eq(1, reader.failures);
+    mu_assert_int_eq(1, reader.resumed);
+    // First application is not read again
+    mu_assert_int_eq(NFC_TEST_MF_DESFIRE_APP_COUNT + 1, card.selects);
+
+    const MfDesfireData* data = nfc_poller_get_data(mf_desfire_poller);
+    mu_assert_int_eq(NFC_TEST_MF_DESFIRE_APP_COUNT, simple_array_get_count(data->applications));
+    for(uint32_t i = 0; i < NFC_TEST_MF_DESFIRE_APP_COUNT; i++) {
+        const MfDesfireApplication* app = simple_array_cget(data->applications, i);
+        mu_assert_int_eq(1, app->key_settings.max_keys);
+        mu_assert_int_eq(1, simple_array_get_count(app->key_versions));
+        const MfDesfireKeyVersion* key_version = simple_array_cget(app->key_versions, 0);
+        mu_assert_int_eq(i + 1, *key_version);
+    }
+
+    nfc_poller_free(mf_desfire_poller);
+    bit_buffer_free(card.tx_buffer);
+    iso14443_4a_free(iso14443_4a_data);
+    nfc_free(listener);
+    nfc_free(poller);
+}
+
+#define NFC_TEST_ISO15693_BITSTREAM_SIZE (512)
+#define NFC_TEST_ISO15693_FRAME_SIZE (32)
+
+// Bitstream as sampled by the signal reader: a byte per 1 out of 4 symbol or 4 out of 256 slots
+static size_t nfc_test_iso15693_encode(
+    const uint8_t* data,
+    size_t data_size,
+    bool one_out_of_256,
+    uint8_t* bitstream) {
+    size_t size = 0;
+
+    bitstream[size++] = one_out_of_256 ? 0x81 : 0x21;
+    for(size_t i = 0; i < data_size; i++) {
+        if(one_out_of_256) {
+            for(size_t j = 0; j < 64; j++) {
+                bitstream[size++] = (j == data[i] / 4) ? 1 << ((data[i] % 4) * 2 + 1) : 0;
+            }
+        } else {
+            for(size_t j = 0; j < 4; j++) {
+                bitstream[size++] = 0x02 << (((data[i] >> (j * 2)) & 0x03) * 2);
+            }
+        }
+    }
+    bitstream[size++] = 0x04;
+
+    return size;
+}
+
+static bool nfc_test_iso15693_parse(
+    Iso15693Parser* parser,
+    const uint8_t* bitstream,
+    size_t bitstream_size,
+    uint32_t* cycles) {
+    bool parsed = false;
+    size_t offset = 0;
+
+    iso15693_parser_reset(parser);
+    while(!parsed && (offset < bitstream_size)) {
+        offset += iso15693_parser_feed(parser, &bitstream[offset], bitstream_size - offset);
+        const uint32_t start = DWT->CYCCNT;
+        parsed = iso15693_parser_run(parser);
+        *cycles += DWT->CYCCNT - start;
+    }
+
+    return parsed;
+}
+
+MU_TEST(iso15693_parser_test) {
+    // Inventory and read single block requests with CRC
+    const uint8_t inventory[] = {0x26, 0x01, 0x00, 0xF6, 0x0A};
+    const uint8_t read_block[] = {
+        0x22, 0x20, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x04, 0xE0, 0x05, 0x8F, 0x3B};
+    const struct {
+        const uint8_t* data;
+        size_t size;
+        bool one_out_of_256;
+    } frames[] = {
+        {inventory, sizeof(inventory), false},
+        {read_block, sizeof(read_block), false},
+        {inventory, sizeof(inventory), true},
+    };
+
+    Iso15693Parser* parser = iso15693_parser_alloc(&gpio_ext_pa7, NFC_TEST_ISO15693_FRAME_SIZE);
+    uint8_t* bitstream = malloc(NFC_TEST_ISO15693_BITSTREAM_SIZE);
+    uint8_t frame[NFC_TEST_ISO15693_FRAME_SIZE] = {};
+
+    for(size_t i = 0; i < COUNT_OF(frames); i++) {
+        const size_t bitstream_size = nfc_test_iso15693_encode(
+            frames[i].data, frames[i].size, frames[i].one_out_of_256, bitstream);
+
+        uint32_t cycles = 0;
+        mu_assert(
+            nfc_test_iso15693_parse(parser, bitstream, bitstream_size, &cycles),
+            "Frame not parsed");
+
+        size_t frame_bits = 0;
+        iso15693_parser_get_data(parser, frame, sizeof(frame), &frame_bits);
+        mu_assert_int_eq(frames[i].size * 8, frame_bits);
+        mu_assert_mem_eq(frames[i].data, frame, frames[i].size);
+
+        printf(
+            "\t%s, %zu bytes: %lu us\r\n",
+            frames[i].one_out_of_256 ? "1 out of 256" : "1 out of 4",
+            frames[i].size,
+            cycles / furi_hal_cortex_instructions_per_microsecond());
+    }
+
+    free(bitstream);
+    iso15693_parser_free(parser);
+}
+
 MU_TEST_SUITE(nfc) {
     nfc_test_alloc();
 
@@ -513,6 +1243,7 @@ MU_TEST_SUITE(nfc) {
     MU_RUN_TEST(ntag_215_reader);
     MU_RUN_TEST(ntag_216_reader);
     MU_RUN_TEST(ntag_213_locked_reader);
+    MU_RUN_TEST(nfc_trace_replay_test);
 
     MU_RUN_TEST(mf_ultralight_write);
 
@@ -538,12 +1269,19 @@ MU_TEST_SUITE(nfc) {
     MU_RUN_TEST(mf_classic_1k_7b_file_test);
     MU_RUN_TEST(mf_classic_4k_4b_file_test);
     MU_RUN_TEST(mf_classic_4k_7b_file_test);
+    MU_RUN_TEST(nfc_device_cache_test);
+    MU_RUN_TEST(nfc_scanner_learned_subset_test);
     MU_RUN_TEST(mf_classic_reader);
 
+    MU_RUN_TEST(iso14443_4_layer_chaining_test);
+    MU_RUN_TEST(mf_desfire_resume_test);
+    MU_RUN_TEST(iso15693_parser_test);
+
     MU_RUN_TEST(mf_classic_write);
     MU_RUN_TEST(mf_classic_value_block);
 
     MU_RUN_TEST(mf_classic_dict_test);
+    MU_RUN_TEST(nfc_supported_cards_fingerprint_test);
 
     nfc_test_free();
 }
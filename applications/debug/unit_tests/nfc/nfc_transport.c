@@ -5,6 +5,9 @@
 #include <lib/nfc/protocols/iso14443_3a/iso14443_3a.h>
 
 #include <furi/furi.h>
+#include <furi_hal.h>
+
+#include "nfc_transport.h"
 
 #define NFC_MAX_BUFFER_SIZE (256)
 
@@ -62,6 +65,14 @@ struct Nfc {
     NfcMode mode;
 
     FuriThread* worker_thread;
+
+    NfcTrace* trace;
+
+    NfcTrace* replay;
+    NfcReplayStats* replay_stats;
+    BitBuffer* replay_buffer;
+    bool replay_tx_pending;
+    uint32_t replay_cycles;
 };
 
 static void nfc_test_print(
@@ -159,6 +170,56 @@ void nfc_set_guard_time_us(Nfc* instance, uint32_t guard_time_us) {
     UNUSED(guard_time_us);
 }
 
+void nfc_set_trace(Nfc* instance, NfcTrace* trace) {
+    furi_check(instance);
+    furi_check(instance->worker_thread == NULL);
+
+    instance->trace = trace;
+}
+
+void nfc_set_replay(Nfc* instance, NfcTrace* trace, NfcReplayStats* stats) {
+    furi_check(instance);
+    furi_check(instance->worker_thread == NULL);
+    furi_check((trace == NULL) || stats);
+
+    instance->replay = trace;
+    instance->replay_stats = stats;
+}
+
+static inline void nfc_add_trace(
+    Nfc* instance,
+    NfcTraceDirection direction,
+    uint8_t flags,
+    const BitBuffer* data) {
+    if(instance->trace) {
+        nfc_trace_add(instance->trace, direction, flags, data);
+    }
+}
+
+static bool nfc_replay_is_frame_equal(const BitBuffer* frame, const BitBuffer* expected) {
+    return (bit_buffer_get_size(frame) == bit_buffer_get_size(expected)) &&
+           (memcmp(
+                bit_buffer_get_data(frame),
+                bit_buffer_get_data(expected),
+                bit_buffer_get_size_bytes(frame)) == 0);
+}
+
+// Time since replay_cycles is spent by the protocol, heap is sampled outside of it
+static void nfc_replay_update_stats(Nfc* instance) {
+    NfcReplayStats* stats = instance->replay_stats;
+    const uint32_t cpu_us =
+        (DWT->CYCCNT - instance->replay_cycles) / furi_hal_cortex_instructions_per_microsecond();
+
+    stats->frames++;
+    stats->cpu_us_total += cpu_us;
+    stats->cpu_us_max = MAX(stats->cpu_us_max, cpu_us);
+
+    const size_t heap = memmgr_heap_get_thread_memory(furi_thread_get_current_id());
+    if(heap != MEMMGR_HEAP_UNKNOWN) {
+        stats->heap_max = MAX(stats->heap_max, heap);
+    }
+}
+
 NfcError nfc_iso14443a_listener_set_col_res_data(
     Nfc* instance,
     uint8_t* uid,
@@ -181,6 +242,7 @@ static int32_t nfc_worker_poller(void* context) {
     instance->state = NfcStateReady;
     NfcCommand command = NfcCommandContinue;
     NfcEvent event = {};
+    instance->replay_cycles = DWT->CYCCNT;
 
     while(true) {
         event.type = NfcEventTypePollerReady;
@@ -245,7 +307,7 @@ static void nfc_worker_listener_pass_col_res(Nfc* instance, uint8_t* rx_data, ui
         }
     }
 
-    if(!processed) {
+    if(!processed && !instance->replay) {
         NfcMessage message = {.type = NfcMessageTypeTimeout};
         furi_message_queue_put(poller_queue, &message, FuriWaitForever);
     }
@@ -275,6 +337,8 @@ static int32_t nfc_worker_listener(void* context) {
         } else if(message.type == NfcMessageTypeTx) {
             nfc_test_print(
                 NfcTransportLogLevelInfo, "RDR", message.data.data, message.data.data_bits);
+            nfc_add_trace(
+                instance, NfcTraceDirectionReader, NfcTraceFlagNone, nfc_event.data.buffer);
             if(instance->col_res_status != Iso14443_3aColResStatusDone) {
                 nfc_worker_listener_pass_col_res(
                     instance, message.data.data, message.data.data_bits);
@@ -294,6 +358,65 @@ static int32_t nfc_worker_listener(void* context) {
     return 0;
 }
 
+static void nfc_worker_listener_replay_rx(Nfc* instance, NfcEvent* nfc_event) {
+    const uint8_t* rx_data = bit_buffer_get_data(nfc_event->data.buffer);
+    const size_t rx_bits = bit_buffer_get_size(nfc_event->data.buffer);
+
+    if((rx_bits == 7) && (rx_data[0] == 0x52)) {
+        instance->col_res_status = Iso14443_3aColResStatusIdle;
+    }
+
+    instance->replay_cycles = DWT->CYCCNT;
+    if(instance->col_res_status != Iso14443_3aColResStatusDone) {
+        nfc_worker_listener_pass_col_res(instance, (uint8_t*)rx_data, rx_bits);
+    } else {
+        nfc_event->type = NfcEventTypeRxEnd;
+        instance->callback(*nfc_event, instance->context);
+    }
+    nfc_replay_update_stats(instance);
+}
+
+static int32_t nfc_worker_listener_replay(void* context) {
+    Nfc* instance = context;
+    furi_check(instance->callback);
+
+    NfcEventData event_data = {};
+    event_data.buffer = bit_buffer_alloc(NFC_MAX_BUFFER_SIZE);
+    NfcEvent nfc_event = {.data = event_data};
+    NfcTraceRecord record = {};
+
+    // Anticollision is done by the hardware, so a trace may start with an active listener
+    instance->state = NfcStateReady;
+    instance->col_res_status = Iso14443_3aColResStatusDone;
+    nfc_event.type = NfcEventTypeListenerActivated;
+    instance->callback(nfc_event, instance->context);
+
+    while(nfc_trace_read(instance->replay, &record, event_data.buffer)) {
+        if(record.direction == NfcTraceDirectionReader) {
+            // Listener answered a frame that was not answered in the trace
+            if(instance->replay_tx_pending) instance->replay_stats->mismatches++;
+            instance->replay_tx_pending = false;
+            nfc_worker_listener_replay_rx(instance, &nfc_event);
+        } else {
+            const bool answered = !(record.flags & NfcTraceFlagTimeout);
+            if((answered != instance->replay_tx_pending) ||
+               (answered &&
+                !nfc_replay_is_frame_equal(instance->replay_buffer, event_data.buffer))) {
+                instance->replay_stats->mismatches++;
+            }
+            instance->replay_tx_pending = false;
+        }
+    }
+    if(instance->replay_tx_pending) instance->replay_stats->mismatches++;
+
+    instance->state = NfcStateIdle;
+    instance->col_res_status = Iso14443_3aColResStatusIdle;
+    memset(&instance->col_res_data, 0, sizeof(instance->col_res_data));
+    bit_buffer_free(event_data.buffer);
+
+    return 0;
+}
+
 void nfc_start(Nfc* instance, NfcEventCallback callback, void* context) {
     furi_check(instance);
     furi_check(instance->worker_thread == NULL);
@@ -304,8 +427,8 @@ void nfc_start(Nfc* instance, NfcEventCallback callback, void* context) {
         furi_check(poller_queue == NULL);
     } else {
         furi_check(poller_queue == NULL);
-        // Check that poller is started after listener
-        furi_check(listener_queue);
+        // Check that poller is started after listener, unless it replays a trace
+        furi_check(listener_queue || instance->replay);
     }
 
     instance->callback = callback;
@@ -322,9 +445,18 @@ void nfc_start(Nfc* instance, NfcEventCallback callback, void* context) {
     furi_thread_set_priority(instance->worker_thread, FuriThreadPriorityHigh);
     furi_thread_set_stack_size(instance->worker_thread, 8 * 1024);
 
+    if(instance->replay) {
+        instance->replay_buffer = bit_buffer_alloc(NFC_MAX_BUFFER_SIZE);
+        instance->replay_tx_pending = false;
+        nfc_trace_rewind(instance->replay);
+        furi_thread_enable_heap_trace(instance->worker_thread);
+    }
+
     if(instance->mode == NfcModeListener) {
         furi_thread_set_name(instance->worker_thread, "NfcWorkerListener");
-        furi_thread_set_callback(instance->worker_thread, nfc_worker_listener);
+        furi_thread_set_callback(
+            instance->worker_thread,
+            instance->replay ? nfc_worker_listener_replay : nfc_worker_listener);
     } else {
         furi_thread_set_name(instance->worker_thread, "NfcWorkerPoller");
         furi_thread_set_callback(instance->worker_thread, nfc_worker_poller);
@@ -356,15 +488,30 @@ void nfc_stop(Nfc* instance) {
         furi_thread_free(instance->worker_thread);
         instance->worker_thread = NULL;
     }
+
+    if(instance->replay_buffer) {
+        bit_buffer_free(instance->replay_buffer);
+        instance->replay_buffer = NULL;
+    }
 }
 
 // Called from worker thread
 
-NfcError nfc_listener_tx(Nfc* instance, const BitBuffer* tx_buffer) {
+static NfcError
+    nfc_listener_tx_with_flags(Nfc* instance, const BitBuffer* tx_buffer, uint8_t flags) {
     furi_check(instance);
+    furi_check(tx_buffer);
+
+    nfc_add_trace(instance, NfcTraceDirectionCard, flags, tx_buffer);
+
+    if(instance->replay) {
+        bit_buffer_copy(instance->replay_buffer, tx_buffer);
+        instance->replay_tx_pending = true;
+        return NfcErrorNone;
+    }
+
     furi_check(poller_queue);
     furi_check(listener_queue);
-    furi_check(tx_buffer);
 
     NfcMessage message = {};
     message.type = NfcMessageTypeTx;
@@ -376,18 +523,53 @@ NfcError nfc_listener_tx(Nfc* instance, const BitBuffer* tx_buffer) {
     return NfcErrorNone;
 }
 
+NfcError nfc_listener_tx(Nfc* instance, const BitBuffer* tx_buffer) {
+    return nfc_listener_tx_with_flags(instance, tx_buffer, NfcTraceFlagNone);
+}
+
 NfcError nfc_iso14443a_listener_tx_custom_parity(Nfc* instance, const BitBuffer* tx_buffer) {
-    return nfc_listener_tx(instance, tx_buffer);
+    return nfc_listener_tx_with_flags(instance, tx_buffer, NfcTraceFlagParity);
 }
 
-NfcError
-    nfc_poller_trx(Nfc* instance, const BitBuffer* tx_buffer, BitBuffer* rx_buffer, uint32_t fwt) {
+static NfcError
+    nfc_poller_replay_trx(Nfc* instance, const BitBuffer* tx_buffer, BitBuffer* rx_buffer) {
+    NfcTraceRecord record = {};
+    NfcError error = NfcErrorTimeout;
+
+    // Trace is made of reader frames, each followed by the card response
+    if(nfc_trace_read(instance->replay, &record, instance->replay_buffer)) {
+        nfc_replay_update_stats(instance);
+        if((record.direction != NfcTraceDirectionReader) ||
+           !nfc_replay_is_frame_equal(tx_buffer, instance->replay_buffer)) {
+            instance->replay_stats->mismatches++;
+        }
+
+        if(nfc_trace_read(instance->replay, &record, rx_buffer) &&
+           (record.direction == NfcTraceDirectionCard) &&
+           !(record.flags & NfcTraceFlagTimeout)) {
+            error = NfcErrorNone;
+        }
+    }
+    instance->replay_cycles = DWT->CYCCNT;
+
+    return error;
+}
+
+static NfcError nfc_poller_trx_with_flags(
+    Nfc* instance,
+    const BitBuffer* tx_buffer,
+    BitBuffer* rx_buffer,
+    uint8_t flags) {
     furi_check(instance);
     furi_check(tx_buffer);
     furi_check(rx_buffer);
+
+    if(instance->replay) {
+        return nfc_poller_replay_trx(instance, tx_buffer, rx_buffer);
+    }
+
     furi_check(poller_queue);
     furi_check(listener_queue);
-    UNUSED(fwt);
 
     NfcError error = NfcErrorNone;
 
@@ -395,6 +577,7 @@ NfcError
     message.type = NfcMessageTypeTx;
     message.data.data_bits = bit_buffer_get_size(tx_buffer);
     bit_buffer_write_bytes(tx_buffer, message.data.data, bit_buffer_get_size_bytes(tx_buffer));
+    nfc_add_trace(instance, NfcTraceDirectionReader, flags, tx_buffer);
     // Tx
     furi_check(furi_message_queue_put(listener_queue, &message, FuriWaitForever) == FuriStatusOk);
     // Rx
@@ -410,15 +593,28 @@ NfcError
         error = NfcErrorTimeout;
     }
 
+    if(error == NfcErrorNone) {
+        nfc_add_trace(instance, NfcTraceDirectionCard, flags, rx_buffer);
+    } else {
+        nfc_add_trace(instance, NfcTraceDirectionCard, NfcTraceFlagTimeout, NULL);
+    }
+
     return error;
 }
 
+NfcError
+    nfc_poller_trx(Nfc* instance, const BitBuffer* tx_buffer, BitBuffer* rx_buffer, uint32_t fwt) {
+    UNUSED(fwt);
+    return nfc_poller_trx_with_flags(instance, tx_buffer, rx_buffer, NfcTraceFlagNone);
+}
+
 NfcError nfc_iso14443a_poller_trx_custom_parity(
     Nfc* instance,
     const BitBuffer* tx_buffer,
     BitBuffer* rx_buffer,
     uint32_t fwt) {
-    return nfc_poller_trx(instance, tx_buffer, rx_buffer, fwt);
+    UNUSED(fwt);
+    return nfc_poller_trx_with_flags(instance, tx_buffer, rx_buffer, NfcTraceFlagParity);
 }
 
 // Technology specific API
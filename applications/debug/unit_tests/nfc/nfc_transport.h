@@ -0,0 +1,23 @@
+#pragma once
+
+#include <nfc/nfc.h>
+
+typedef struct {
+    size_t frames; /**< Frames handled by the protocol under test. */
+    size_t mismatches; /**< Frames sent by the protocol that differ from the trace. */
+    uint32_t cpu_us_total; /**< Time spent by the protocol on all frames. */
+    uint32_t cpu_us_max; /**< Longest time spent by the protocol on a single frame. */
+    size_t heap_max; /**< Largest amount of memory held by the worker thread. */
+} NfcReplayStats;
+
+/** Replay a trace instead of exchanging frames with the other side
+ *
+ * A poller gets card frames from the trace as responses, a listener gets reader frames
+ * from the trace as requests. Frames sent by the protocol are compared with the trace.
+ * The listener stops by itself at the end of the trace, a poller gets timeouts.
+ *
+ * @param      instance  Nfc instance, must not be running
+ * @param      trace     trace to be replayed, NULL to exchange frames as usual
+ * @param[out] stats     replay statistics, updated while the instance is running
+ */
+void nfc_set_replay(Nfc* instance, NfcTrace* trace, NfcReplayStats* stats);
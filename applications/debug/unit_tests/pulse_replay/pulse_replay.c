@@ -0,0 +1,466 @@
+#include "pulse_replay.h"
+
+#include <furi_hal.h>
+#include <m-array.h>
+#include <flipper_format/flipper_format.h>
+#include <toolbox/stream/stream.h>
+#include <lib/subghz/types.h>
+#include <lib/subghz/subghz_raw_file.h>
+#include <lfrfid/lfrfid_raw_file.h>
+#include <infrared.h>
+
+#define TAG "PulseReplay"
+
+#define PULSE_REPLAY_SUBGHZ_RAW_KEY "RAW_Data"
+#define PULSE_REPLAY_INFRARED_TESTS_FILE_TYPE "IR tests file"
+#define PULSE_REPLAY_INFRARED_GAP_US (INFRARED_RAW_RX_TIMING_DELAY_US + 1)
+
+typedef struct {
+    const char* name;
+    PulseReplayFeed feed;
+    PulseReplayReset reset;
+    void* context;
+    uint32_t decoded;
+    uint64_t cycles;
+} PulseReplayDecoder;
+
+ARRAY_DEF(PulseReplayDecoderArray, PulseReplayDecoder, M_POD_OPLIST);
+
+struct PulseReplay {
+    PulseReplayDecoderArray_t decoders;
+    int32_t* edges;
+    size_t edge_count;
+};
+
+typedef enum {
+    PulseReplayFileTypeNone,
+    PulseReplayFileTypeSubGhz,
+    PulseReplayFileTypeSubGhzBinary,
+    PulseReplayFileTypeLfRfid,
+    PulseReplayFileTypeInfrared,
+} PulseReplayFileType;
+
+struct PulseReplayFile {
+    Storage* storage;
+    FlipperFormat* flipper_format;
+    SubGhzRawFileReader* subghz_reader;
+    LFRFIDRawFile* lfrfid_file;
+    PulseReplayFileType type;
+    FuriString* str_data;
+    FuriString* name_prefix;
+    bool is_start_from_mark;
+    bool is_finished;
+
+    /* edges of the current record: a line, a chunk or a signal */
+    int32_t* record;
+    size_t record_capacity;
+    size_t record_count;
+    size_t record_index;
+};
+
+PulseReplay* pulse_replay_alloc(void) {
+    PulseReplay* instance = malloc(sizeof(PulseReplay));
+    PulseReplayDecoderArray_init(instance->decoders);
+    instance->edges = malloc(sizeof(int32_t) * PULSE_REPLAY_CHUNK_SIZE);
+    return instance;
+}
+
+void pulse_replay_free(PulseReplay* instance) {
+    furi_assert(instance);
+    PulseReplayDecoderArray_clear(instance->decoders);
+    free(instance->edges);
+    free(instance);
+}
+
+void pulse_replay_add_decoder(
+    PulseReplay* instance,
+    const char* name,
+    PulseReplayFeed feed,
+    PulseReplayReset reset,
+    void* context) {
+    furi_assert(instance);
+    furi_assert(name);
+    furi_assert(feed);
+
+    PulseReplayDecoder* decoder = PulseReplayDecoderArray_push_new(instance->decoders);
+    decoder->name = name;
+    decoder->feed = feed;
+    decoder->reset = reset;
+    decoder->context = context;
+}
+
+size_t pulse_replay_run(PulseReplay* instance, PulseReplayRead read, void* context) {
+    furi_assert(instance);
+    furi_assert(read);
+
+    for
+        M_EACH(decoder, instance->decoders, PulseReplayDecoderArray_t) {
+            decoder->decoded = 0;
+            decoder->cycles = 0;
+            if(decoder->reset) decoder->reset(decoder->context);
+        }
+
+    instance->edge_count = 0;
+    size_t count;
+
+    while((count = read(context, instance->edges, PULSE_REPLAY_CHUNK_SIZE)) > 0) {
+        furi_check(count <= PULSE_REPLAY_CHUNK_SIZE);
+
+        for
+            M_EACH(decoder, instance->decoders, PulseReplayDecoderArray_t) {
+                const uint32_t start = DWT->CYCCNT;
+                for(size_t i = 0; i < count; i++) {
+                    const int32_t edge = instance->edges[i];
+                    decoder->decoded += decoder->feed(decoder->context, edge > 0, abs(edge));
+                }
+                decoder->cycles += DWT->CYCCNT - start;
+            }
+
+        instance->edge_count += count;
+    }
+
+    return instance->edge_count;
+}
+
+uint32_t pulse_replay_get_decoded(PulseReplay* instance, const char* name) {
+    furi_assert(instance);
+    furi_assert(name);
+
+    for
+        M_EACH(decoder, instance->decoders, PulseReplayDecoderArray_t) {
+            if(strcmp(decoder->name, name) == 0) return decoder->decoded;
+        }
+
+    return 0;
+}
+
+uint32_t pulse_replay_get_total_decoded(PulseReplay* instance) {
+    furi_assert(instance);
+    uint32_t decoded = 0;
+
+    for
+        M_EACH(decoder, instance->decoders, PulseReplayDecoderArray_t) {
+            decoded += decoder->decoded;
+        }
+
+    return decoded;
+}
+
+static uint32_t pulse_replay_get_edges_per_second(size_t edge_count, uint64_t cycles) {
+    return cycles ? (uint64_t)edge_count * SystemCoreClock / cycles : 0;
+}
+
+static uint32_t pulse_replay_get_permille(uint64_t cycles, uint64_t total_cycles) {
+    return total_cycles ? cycles * 1000 / total_cycles : 0;
+}
+
+void pulse_replay_print_report(PulseReplay* instance, const char* title, bool verbose) {
+    furi_assert(instance);
+    furi_assert(title);
+
+    uint64_t total_cycles = 0;
+    for
+        M_EACH(decoder, instance->decoders, PulseReplayDecoderArray_t) {
+            total_cycles += decoder->cycles;
+        }
+
+    printf(
+        "\t%s: %zu edges, %lu decoded, %lu edges/s\r\n",
+        title,
+        instance->edge_count,
+        pulse_replay_get_total_decoded(instance),
+        pulse_replay_get_edges_per_second(instance->edge_count, total_cycles));
+
+    size_t idle_count = 0;
+    uint64_t idle_cycles = 0;
+
+    for
+        M_EACH(decoder, instance->decoders, PulseReplayDecoderArray_t) {
+            if(!verbose && !decoder->decoded) {
+                idle_count++;
+                idle_cycles += decoder->cycles;
+                continue;
+            }
+
+            const uint32_t permille = pulse_replay_get_permille(decoder->cycles, total_cycles);
+            printf(
+                "\t\t%-24s %6lu decoded %9lu edges/s %3lu.%lu%%\r\n",
+                decoder->name,
+                decoder->decoded,
+                pulse_replay_get_edges_per_second(instance->edge_count, decoder->cycles),
+                permille / 10,
+                permille % 10);
+        }
+
+    if(idle_count) {
+        const uint32_t permille = pulse_replay_get_permille(idle_cycles, total_cycles);
+        printf(
+            "\t\t%zu decoders with nothing decoded %3lu.%lu%%\r\n",
+            idle_count,
+            permille / 10,
+            permille % 10);
+    }
+}
+
+PulseReplayFile* pulse_replay_file_alloc(Storage* storage) {
+    furi_assert(storage);
+
+    PulseReplayFile* file = malloc(sizeof(PulseReplayFile));
+    file->storage = storage;
+    file->flipper_format = flipper_format_file_alloc(storage);
+    file->str_data = furi_string_alloc();
+    file->name_prefix = furi_string_alloc();
+    file->type = PulseReplayFileTypeNone;
+
+    return file;
+}
+
+void pulse_replay_file_free(PulseReplayFile* file) {
+    furi_assert(file);
+
+    pulse_replay_file_close(file);
+    flipper_format_free(file->flipper_format);
+    furi_string_free(file->str_data);
+    furi_string_free(file->name_prefix);
+    free(file->record);
+    free(file);
+}
+
+static void pulse_replay_file_reserve(PulseReplayFile* file, size_t count) {
+    if(count > file->record_capacity) {
+        free(file->record);
+        file->record = malloc(sizeof(int32_t) * count);
+        file->record_capacity = count;
+    }
+}
+
+static void pulse_replay_file_reset(PulseReplayFile* file, PulseReplayFileType type) {
+    file->type = type;
+    file->is_finished = false;
+    file->record_count = 0;
+    file->record_index = 0;
+}
+
+bool pulse_replay_file_open_subghz(PulseReplayFile* file, const char* path) {
+    furi_assert(file);
+    furi_assert(file->type == PulseReplayFileTypeNone);
+
+    bool success = false;
+    uint32_t version;
+
+    do {
+        if(!flipper_format_file_open_existing(file->flipper_format, path)) break;
+        if(!flipper_format_read_header(file->flipper_format, file->str_data, &version)) break;
+
+        PulseReplayFileType type;
+        if(!furi_string_cmp_str(file->str_data, SUBGHZ_RAW_FILE_TYPE)) {
+            type = PulseReplayFileTypeSubGhz;
+        } else if(!furi_string_cmp_str(file->str_data, SUBGHZ_RAW_BIN_FILE_TYPE)) {
+            type = PulseReplayFileTypeSubGhzBinary;
+        } else {
+            FURI_LOG_E(TAG, "Not a RAW file: %s", path);
+            break;
+        }
+
+        if(!flipper_format_read_string(file->flipper_format, "Protocol", file->str_data)) break;
+
+        if(type == PulseReplayFileTypeSubGhzBinary) {
+            Stream* stream = flipper_format_get_raw_stream(file->flipper_format);
+            // skip the end of the previous line "\n"
+            stream_seek(stream, 1, StreamOffsetFromCurrent);
+            file->subghz_reader = subghz_raw_file_reader_alloc(stream);
+        }
+
+        pulse_replay_file_reset(file, type);
+        success = true;
+    } while(false);
+
+    if(!success) flipper_format_file_close(file->flipper_format);
+
+    return success;
+}
+
+bool pulse_replay_file_open_lfrfid(PulseReplayFile* file, const char* path) {
+    furi_assert(file);
+    furi_assert(file->type == PulseReplayFileTypeNone);
+
+    float frequency;
+    float duty_cycle;
+    file->lfrfid_file = lfrfid_raw_file_alloc(file->storage);
+
+    if(!lfrfid_raw_file_open_read(file->lfrfid_file, path) ||
+       !lfrfid_raw_file_read_header(file->lfrfid_file, &frequency, &duty_cycle)) {
+        lfrfid_raw_file_free(file->lfrfid_file);
+        file->lfrfid_file = NULL;
+        return false;
+    }
+
+    pulse_replay_file_reset(file, PulseReplayFileTypeLfRfid);
+    return true;
+}
+
+bool pulse_replay_file_open_infrared(
+    PulseReplayFile* file,
+    const char* path,
+    const char* name_prefix) {
+    furi_assert(file);
+    furi_assert(file->type == PulseReplayFileTypeNone);
+
+    uint32_t version;
+
+    if(!flipper_format_file_open_existing(file->flipper_format, path) ||
+       !flipper_format_read_header(file->flipper_format, file->str_data, &version)) {
+        flipper_format_file_close(file->flipper_format);
+        return false;
+    }
+
+    file->is_start_from_mark =
+        (furi_string_cmp_str(file->str_data, PULSE_REPLAY_INFRARED_TESTS_FILE_TYPE) != 0);
+    furi_string_set(file->name_prefix, name_prefix ? name_prefix : "");
+
+    pulse_replay_file_reset(file, PulseReplayFileTypeInfrared);
+    return true;
+}
+
+void pulse_replay_file_close(PulseReplayFile* file) {
+    furi_assert(file);
+
+    if(file->subghz_reader) {
+        subghz_raw_file_reader_free(file->subghz_reader);
+        file->subghz_reader = NULL;
+    }
+
+    if(file->lfrfid_file) {
+        lfrfid_raw_file_free(file->lfrfid_file);
+        file->lfrfid_file = NULL;
+    }
+
+    if(file->type != PulseReplayFileTypeNone && file->type != PulseReplayFileTypeLfRfid) {
+        flipper_format_file_close(file->flipper_format);
+    }
+
+    file->type = PulseReplayFileTypeNone;
+}
+
+static size_t pulse_replay_file_load_subghz(PulseReplayFile* file) {
+    uint32_t count;
+
+    if(!flipper_format_get_value_count(file->flipper_format, PULSE_REPLAY_SUBGHZ_RAW_KEY, &count))
+        return 0;
+
+    pulse_replay_file_reserve(file, count);
+    if(!flipper_format_read_int32(
+           file->flipper_format, PULSE_REPLAY_SUBGHZ_RAW_KEY, file->record, count)) {
+        FURI_LOG_E(TAG, "Failed to read RAW data");
+        return 0;
+    }
+
+    return count;
+}
+
+static size_t pulse_replay_file_load_subghz_binary(PulseReplayFile* file) {
+    pulse_replay_file_reserve(file, PULSE_REPLAY_CHUNK_SIZE);
+    return subghz_raw_file_reader_read(file->subghz_reader, file->record, PULSE_REPLAY_CHUNK_SIZE);
+}
+
+static size_t pulse_replay_file_load_lfrfid(PulseReplayFile* file) {
+    pulse_replay_file_reserve(file, PULSE_REPLAY_CHUNK_SIZE);
+    size_t count = 0;
+
+    while(count + 2 <= PULSE_REPLAY_CHUNK_SIZE) {
+        uint32_t duration;
+        uint32_t pulse;
+        bool pass_end = false;
+
+        // The reader starts over at the end of the file, stop instead
+        if(!lfrfid_raw_file_read_pair(file->lfrfid_file, &duration, &pulse, &pass_end) ||
+           pass_end) {
+            file->is_finished = true;
+            break;
+        }
+
+        if(pulse == 0 || pulse >= duration) continue;
+
+        file->record[count++] = pulse;
+        file->record[count++] = -(int32_t)(duration - pulse);
+    }
+
+    return count;
+}
+
+static size_t pulse_replay_file_load_infrared(PulseReplayFile* file) {
+    FlipperFormat* ff = file->flipper_format;
+    uint32_t count = 0;
+
+    while(!count && flipper_format_read_string(ff, "name", file->str_data)) {
+        if(!furi_string_start_with(file->str_data, file->name_prefix)) continue;
+        if(!flipper_format_read_string(ff, "type", file->str_data)) break;
+        if(furi_string_cmp_str(file->str_data, "raw")) continue;
+        if(!flipper_format_get_value_count(ff, "data", &count)) break;
+
+        // one more for the gap after the signal
+        pulse_replay_file_reserve(file, count + 1);
+        uint32_t* timings = (uint32_t*)file->record;
+        if(!flipper_format_read_uint32(ff, "data", timings, count)) {
+            FURI_LOG_E(TAG, "Failed to read raw signal");
+            count = 0;
+            break;
+        }
+
+        bool level = file->is_start_from_mark;
+        for(size_t i = 0; i < count; i++) {
+            const int32_t duration = MIN(timings[i], (uint32_t)INT32_MAX);
+            file->record[i] = level ? duration : -duration;
+            level = !level;
+        }
+        file->record[count++] = -PULSE_REPLAY_INFRARED_GAP_US;
+    }
+
+    return count;
+}
+
+static bool pulse_replay_file_load_record(PulseReplayFile* file) {
+    size_t count = 0;
+
+    if(!file->is_finished) {
+        switch(file->type) {
+        case PulseReplayFileTypeSubGhz:
+            count = pulse_replay_file_load_subghz(file);
+            break;
+        case PulseReplayFileTypeSubGhzBinary:
+            count = pulse_replay_file_load_subghz_binary(file);
+            break;
+        case PulseReplayFileTypeLfRfid:
+            count = pulse_replay_file_load_lfrfid(file);
+            break;
+        case PulseReplayFileTypeInfrared:
+            count = pulse_replay_file_load_infrared(file);
+            break;
+        default:
+            break;
+        }
+    }
+
+    file->record_count = count;
+    file->record_index = 0;
+    return count > 0;
+}
+
+size_t pulse_replay_file_read(void* context, int32_t* edges, size_t count) {
+    furi_assert(context);
+    PulseReplayFile* file = context;
+    size_t read = 0;
+
+    while(read < count) {
+        if(file->record_index == file->record_count && !pulse_replay_file_load_record(file)) {
+            break;
+        }
+
+        const size_t chunk = MIN(count - read, file->record_count - file->record_index);
+        memcpy(&edges[read], &file->record[file->record_index], sizeof(int32_t) * chunk);
+        file->record_index += chunk;
+        read += chunk;
+    }
+
+    return read;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file pulse_replay.h
+ * @brief Replay of captured level/duration streams through pulse decoders.
+ *
+ * Captures are read in chunks and every chunk is fed to each decoder in turn,
+ * so storage speed does not affect the measured decoding time. Each decoder
+ * gets the whole capture, the report shows decoded messages, decoding speed
+ * and the share of the total decoding time per decoder.
+ */
+#pragma once
+
+#include <furi.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of edges requested from a capture at once */
+#define PULSE_REPLAY_CHUNK_SIZE (512U)
+
+typedef struct PulseReplay PulseReplay;
+
+typedef struct PulseReplayFile PulseReplayFile;
+
+/**
+ * @brief Read next edges of a capture
+ *
+ * Edges are durations in microseconds, positive for high level and
+ * negative for low level.
+ *
+ * @param context capture context
+ * @param edges buffer to fill
+ * @param count buffer size
+ * @return number of edges read, 0 at the end of the capture
+ */
+typedef size_t (*PulseReplayRead)(void* context, int32_t* edges, size_t count);
+
+/**
+ * @brief Feed one edge to a decoder
+ *
+ * @param context decoder context
+ * @param level edge level
+ * @param duration edge duration in microseconds
+ * @return number of messages decoded
+ */
+typedef uint32_t (*PulseReplayFeed)(void* context, bool level, uint32_t duration);
+
+/**
+ * @brief Reset a decoder before a new capture
+ *
+ * @param context decoder context
+ */
+typedef void (*PulseReplayReset)(void* context);
+
+/**
+ * @brief Allocate PulseReplay instance
+ *
+ * @return PulseReplay*
+ */
+PulseReplay* pulse_replay_alloc(void);
+
+/**
+ * @brief Free PulseReplay instance, decoder contexts are not freed
+ *
+ * @param instance
+ */
+void pulse_replay_free(PulseReplay* instance);
+
+/**
+ * @brief Add a decoder
+ *
+ * @param instance
+ * @param name decoder name for the report, must stay valid
+ * @param feed edge feed callback
+ * @param reset reset callback, can be NULL
+ * @param context decoder context
+ */
+void pulse_replay_add_decoder(
+    PulseReplay* instance,
+    const char* name,
+    PulseReplayFeed feed,
+    PulseReplayReset reset,
+    void* context);
+
+/**
+ * @brief Replay a capture through all decoders, previous results are cleared
+ *
+ * @param instance
+ * @param read capture read callback
+ * @param context capture context
+ * @return number of edges replayed
+ */
+size_t pulse_replay_run(PulseReplay* instance, PulseReplayRead read, void* context);
+
+/**
+ * @brief Get number of messages decoded by a decoder in the last run
+ *
+ * @param instance
+ * @param name decoder name
+ * @return number of messages, 0 if there is no such decoder
+ */
+uint32_t pulse_replay_get_decoded(PulseReplay* instance, const char* name);
+
+/**
+ * @brief Get number of messages decoded by all decoders in the last run
+ *
+ * @param instance
+ * @return number of messages
+ */
+uint32_t pulse_replay_get_total_decoded(PulseReplay* instance);
+
+/**
+ * @brief Print results of the last run
+ *
+ * Decoders that did not decode anything are summarized in one line unless
+ * verbose is set.
+ *
+ * @param instance
+ * @param title report title, e.g. capture name
+ * @param verbose print every decoder
+ */
+void pulse_replay_print_report(PulseReplay* instance, const char* title, bool verbose);
+
+/**
+ * @brief Allocate capture file reader
+ *
+ * @param storage
+ * @return PulseReplayFile*
+ */
+PulseReplayFile* pulse_replay_file_alloc(Storage* storage);
+
+/**
+ * @brief Free capture file reader
+ *
+ * @param file
+ */
+void pulse_replay_file_free(PulseReplayFile* file);
+
+/**
+ * @brief Open Sub-GHz RAW file, text or binary
+ *
+ * @param file
+ * @param path
+ * @return bool
+ */
+bool pulse_replay_file_open_subghz(PulseReplayFile* file, const char* path);
+
+/**
+ * @brief Open LF RFID RAW file
+ *
+ * The file is read once, edges are high pulse and low rest of each period.
+ *
+ * @param file
+ * @param path
+ * @return bool
+ */
+bool pulse_replay_file_open_lfrfid(PulseReplayFile* file, const char* path);
+
+/**
+ * @brief Open infrared file and replay its raw signals one after another
+ *
+ * Signals start from mark, except in infrared unit test files where they
+ * start from space. Every signal is followed by a space longer than the
+ * receiver timeout.
+ *
+ * @param file
+ * @param path
+ * @param name_prefix replay only signals whose name starts with it, can be NULL
+ * @return bool
+ */
+bool pulse_replay_file_open_infrared(
+    PulseReplayFile* file,
+    const char* path,
+    const char* name_prefix);
+
+/**
+ * @brief Close capture file
+ *
+ * @param file
+ */
+void pulse_replay_file_close(PulseReplayFile* file);
+
+/**
+ * @brief PulseReplayRead implementation for PulseReplayFile context
+ */
+size_t pulse_replay_file_read(void* context, int32_t* edges, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,395 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+#include <infrared.h>
+#include <lib/subghz/environment.h>
+#include <lib/subghz/registry.h>
+#include <lib/subghz/protocols/protocol_items.h>
+#include <lib/subghz/protocols/public_api.h>
+#include <lfrfid/lfrfid_raw_file.h>
+#include <lfrfid/protocols/lfrfid_protocols.h>
+#include <lfrfid/tools/varint_pair.h>
+#include <toolbox/protocols/protocol_dict.h>
+#include <toolbox/pulse_protocols/pulse_glue.h>
+#include "pulse_replay.h"
+#include "../minunit.h"
+
+#define PULSE_REPLAY_TEST_SUBGHZ_DIR EXT_PATH("unit_tests/subghz/")
+#define PULSE_REPLAY_TEST_INFRARED_DIR EXT_PATH("unit_tests/infrared/")
+#define PULSE_REPLAY_TEST_LFRFID_PATH EXT_PATH("unit_tests/.pulse_replay_test.raw")
+
+#define PULSE_REPLAY_TEST_BIN_RAW_SILENCE_US 20000
+#define PULSE_REPLAY_TEST_BIN_RAW_SIGNAL (-60.0f)
+#define PULSE_REPLAY_TEST_BIN_RAW_NOISE (-100.0f)
+
+#define PULSE_REPLAY_TEST_LFRFID_READ_TIMING_MULTIPLIER 8
+#define PULSE_REPLAY_TEST_LFRFID_BUFFER_SIZE 512
+#define PULSE_REPLAY_TEST_EM4100_DATA \
+    { 0x58, 0x00, 0x85, 0x64, 0x02 }
+#define PULSE_REPLAY_TEST_EM4100_TIMINGS_COUNT (64 * 2 * 10)
+
+typedef struct {
+    SubGhzProtocolDecoderBase* base;
+    uint32_t decoded;
+} PulseReplayTestSubGhzDecoder;
+
+typedef struct {
+    ProtocolDict* dict;
+    size_t protocol;
+} PulseReplayTestLfRfidDecoder;
+
+static Storage* storage;
+static PulseReplayFile* replay_file;
+static FuriString* path;
+
+static void pulse_replay_test_alloc(void) {
+    storage = furi_record_open(RECORD_STORAGE);
+    replay_file = pulse_replay_file_alloc(storage);
+    path = furi_string_alloc();
+}
+
+static void pulse_replay_test_free(void) {
+    furi_string_free(path);
+    pulse_replay_file_free(replay_file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+/* Same handling of long spaces as the infrared worker receive timeout */
+static uint32_t pulse_replay_test_infrared_feed(void* context, bool level, uint32_t duration) {
+    InfraredDecoderHandler* handler = context;
+    uint32_t decoded = 0;
+
+    if(!level && (duration > INFRARED_RAW_RX_TIMING_DELAY_US) &&
+       infrared_check_decoder_ready(handler)) {
+        ++decoded;
+    }
+    if(infrared_decode(handler, level, duration)) {
+        ++decoded;
+    }
+
+    return decoded;
+}
+
+static void pulse_replay_test_infrared_reset(void* context) {
+    infrared_reset_decoder(context);
+}
+
+static void pulse_replay_test_subghz_callback(SubGhzProtocolDecoderBase* base, void* context) {
+    UNUSED(base);
+    PulseReplayTestSubGhzDecoder* decoder = context;
+    decoder->decoded++;
+}
+
+static uint32_t pulse_replay_test_subghz_feed(void* context, bool level, uint32_t duration) {
+    PulseReplayTestSubGhzDecoder* decoder = context;
+    decoder->decoded = 0;
+    decoder->base->protocol->decoder->feed(decoder->base, level, duration);
+    return decoder->decoded;
+}
+
+static void pulse_replay_test_subghz_reset(void* context) {
+    PulseReplayTestSubGhzDecoder* decoder = context;
+    decoder->base->protocol->decoder->reset(decoder->base);
+}
+
+/* BinRAW records while RSSI is high, a long silence stands for the signal fading out */
+static void pulse_replay_test_bin_raw_rearm(PulseReplayTestSubGhzDecoder* decoder) {
+    SubGhzProtocolDecoderBinRAW* bin_raw = (SubGhzProtocolDecoderBinRAW*)decoder->base;
+    subghz_protocol_decoder_bin_raw_data_input_rssi(bin_raw, PULSE_REPLAY_TEST_BIN_RAW_NOISE);
+    subghz_protocol_decoder_bin_raw_data_input_rssi(bin_raw, PULSE_REPLAY_TEST_BIN_RAW_SIGNAL);
+}
+
+static uint32_t pulse_replay_test_bin_raw_feed(void* context, bool level, uint32_t duration) {
+    PulseReplayTestSubGhzDecoder* decoder = context;
+    decoder->decoded = 0;
+    if(!level && (duration > PULSE_REPLAY_TEST_BIN_RAW_SILENCE_US)) {
+        pulse_replay_test_bin_raw_rearm(decoder);
+    } else {
+        subghz_protocol_decoder_bin_raw_feed(decoder->base, level, duration);
+    }
+    return decoder->decoded;
+}
+
+static void pulse_replay_test_bin_raw_reset(void* context) {
+    PulseReplayTestSubGhzDecoder* decoder = context;
+    subghz_protocol_decoder_bin_raw_reset(decoder->base);
+    pulse_replay_test_bin_raw_rearm(decoder);
+}
+
+static uint32_t pulse_replay_test_lfrfid_feed(void* context, bool level, uint32_t duration) {
+    PulseReplayTestLfRfidDecoder* decoder = context;
+    return protocol_dict_decoders_feed_by_id(
+               decoder->dict, decoder->protocol, level, duration) != PROTOCOL_NO;
+}
+
+static void pulse_replay_test_lfrfid_reset(void* context) {
+    PulseReplayTestLfRfidDecoder* decoder = context;
+    protocol_dict_decoders_start(decoder->dict);
+}
+
+MU_TEST(pulse_replay_test_infrared) {
+    /* Sums of the decoder_expected counts in each file */
+    const struct {
+        const char* name;
+        uint32_t decoded;
+    } captures[] = {
+        {"test_kaseikyo.irtest", 6},
+        {"test_nec.irtest", 70},
+        {"test_nec42ext.irtest", 2},
+        {"test_necext.irtest", 108},
+        {"test_rc5.irtest", 17},
+        {"test_rc5x.irtest", 1},
+        {"test_rc6.irtest", 14},
+        {"test_rca.irtest", 6},
+        {"test_samsung32.irtest", 78},
+        {"test_sirc.irtest", 171},
+    };
+
+    InfraredDecoderHandler* handler = infrared_alloc_decoder();
+    PulseReplay* replay = pulse_replay_alloc();
+    pulse_replay_add_decoder(
+        replay,
+        "infrared",
+        pulse_replay_test_infrared_feed,
+        pulse_replay_test_infrared_reset,
+        handler);
+
+    for(size_t i = 0; i < COUNT_OF(captures); ++i) {
+        furi_string_printf(path, "%s%s", PULSE_REPLAY_TEST_INFRARED_DIR, captures[i].name);
+        mu_assert(
+            pulse_replay_file_open_infrared(
+                replay_file, furi_string_get_cstr(path), "decoder_input"),
+            "Failed to open infrared capture");
+
+        pulse_replay_run(replay, pulse_replay_file_read, replay_file);
+        pulse_replay_file_close(replay_file);
+
+        pulse_replay_print_report(replay, captures[i].name, true);
+        mu_assert_int_eq(captures[i].decoded, pulse_replay_get_total_decoded(replay));
+    }
+
+    pulse_replay_free(replay);
+    infrared_free_decoder(handler);
+}
+
+MU_TEST(pulse_replay_test_subghz) {
+    const struct {
+        const char* name;
+        const char* decoder;
+    } captures[] = {
+        {"came_raw.sub", SUBGHZ_PROTOCOL_CAME_NAME},
+        {"gate_tx_raw.sub", SUBGHZ_PROTOCOL_GATE_TX_NAME},
+        {"holtek_raw.sub", SUBGHZ_PROTOCOL_HOLTEK_NAME},
+        {"linear_raw.sub", SUBGHZ_PROTOCOL_LINEAR_NAME},
+        {"nice_flo_raw.sub", SUBGHZ_PROTOCOL_NICE_FLO_NAME},
+        {"princeton_raw.sub", SUBGHZ_PROTOCOL_PRINCETON_NAME},
+        {"test_random_raw.sub", NULL},
+    };
+
+    SubGhzEnvironment* environment = subghz_environment_alloc();
+    subghz_environment_set_came_atomo_rainbow_table_file_name(
+        environment, EXT_PATH("subghz/assets/came_atomo"));
+    subghz_environment_set_nice_flor_s_rainbow_table_file_name(
+        environment, EXT_PATH("subghz/assets/nice_flor_s"));
+    subghz_environment_set_alutech_at_4n_rainbow_table_file_name(
+        environment, EXT_PATH("subghz/assets/alutech_at_4n"));
+    subghz_environment_set_protocol_registry(environment, (void*)&subghz_protocol_registry);
+
+    const size_t protocol_count = subghz_protocol_registry_count(&subghz_protocol_registry);
+    PulseReplayTestSubGhzDecoder* decoders =
+        malloc(sizeof(PulseReplayTestSubGhzDecoder) * protocol_count);
+    size_t decoder_count = 0;
+    PulseReplay* replay = pulse_replay_alloc();
+
+    for(size_t i = 0; i < protocol_count; ++i) {
+        const SubGhzProtocol* protocol =
+            subghz_protocol_registry_get_by_index(&subghz_protocol_registry, i);
+        if(!protocol->decoder || !protocol->decoder->alloc ||
+           !(protocol->flag & SubGhzProtocolFlag_Decodable)) {
+            continue;
+        }
+
+        PulseReplayTestSubGhzDecoder* decoder = &decoders[decoder_count++];
+        decoder->base = protocol->decoder->alloc(environment);
+        subghz_protocol_decoder_base_set_decoder_callback(
+            decoder->base, pulse_replay_test_subghz_callback, decoder);
+        pulse_replay_add_decoder(
+            replay,
+            protocol->name,
+            pulse_replay_test_subghz_feed,
+            pulse_replay_test_subghz_reset,
+            decoder);
+    }
+
+    for(size_t i = 0; i < COUNT_OF(captures); ++i) {
+        furi_string_printf(path, "%s%s", PULSE_REPLAY_TEST_SUBGHZ_DIR, captures[i].name);
+        mu_assert(
+            pulse_replay_file_open_subghz(replay_file, furi_string_get_cstr(path)),
+            "Failed to open Sub-GHz capture");
+
+        pulse_replay_run(replay, pulse_replay_file_read, replay_file);
+        pulse_replay_file_close(replay_file);
+
+        pulse_replay_print_report(replay, captures[i].name, false);
+        if(captures[i].decoder) {
+            mu_assert(
+                pulse_replay_get_decoded(replay, captures[i].decoder) > 0,
+                "Expected decoder did not decode the capture");
+        } else {
+            mu_assert(pulse_replay_get_total_decoded(replay) > 0, "Nothing decoded");
+        }
+    }
+
+    pulse_replay_free(replay);
+    for(size_t i = 0; i < decoder_count; ++i) {
+        decoders[i].base->protocol->decoder->free(decoders[i].base);
+    }
+    free(decoders);
+    subghz_environment_free(environment);
+}
+
+MU_TEST(pulse_replay_test_bin_raw) {
+    /* Protocols without a dedicated decoder or with rolling codes */
+    const char* captures[] = {
+        "cenmax_raw.sub",
+        "clemsa_raw.sub",
+        "nero_radio_raw.sub",
+        "security_pls_1_0_raw.sub",
+        "somfy_telis_raw.sub",
+        "test_random_raw.sub",
+    };
+
+    SubGhzEnvironment* environment = subghz_environment_alloc();
+    PulseReplayTestSubGhzDecoder decoder = {
+        .base = subghz_protocol_decoder_bin_raw_alloc(environment),
+    };
+    subghz_protocol_decoder_base_set_decoder_callback(
+        decoder.base, pulse_replay_test_subghz_callback, &decoder);
+
+    PulseReplay* replay = pulse_replay_alloc();
+    pulse_replay_add_decoder(
+        replay,
+        SUBGHZ_PROTOCOL_BIN_RAW_NAME,
+        pulse_replay_test_bin_raw_feed,
+        pulse_replay_test_bin_raw_reset,
+        &decoder);
+
+    for(size_t i = 0; i < COUNT_OF(captures); ++i) {
+        furi_string_printf(path, "%s%s", PULSE_REPLAY_TEST_SUBGHZ_DIR, captures[i]);
+        mu_assert(
+            pulse_replay_file_open_subghz(replay_file, furi_string_get_cstr(path)),
+            "Failed to open Sub-GHz capture");
+
+        pulse_replay_run(replay, pulse_replay_file_read, replay_file);
+        pulse_replay_file_close(replay_file);
+
+        pulse_replay_print_report(replay, captures[i], true);
+        mu_assert(pulse_replay_get_total_decoded(replay) > 0, "BinRAW found no sequence");
+    }
+
+    pulse_replay_free(replay);
+    subghz_protocol_decoder_bin_raw_free(decoder.base);
+    subghz_environment_free(environment);
+}
+
+static bool pulse_replay_test_lfrfid_write_em4100(ProtocolDict* dict, const char* file_path) {
+    const uint8_t data[] = PULSE_REPLAY_TEST_EM4100_DATA;
+    protocol_dict_set_data(dict, LFRFIDProtocolEM4100, data, sizeof(data));
+    if(!protocol_dict_encoder_start(dict, LFRFIDProtocolEM4100)) return false;
+
+    LFRFIDRawFile* file = lfrfid_raw_file_alloc(storage);
+    PulseGlue* pulse_glue = pulse_glue_alloc();
+    VarintPair* pair = varint_pair_alloc();
+    uint8_t* buffer = malloc(PULSE_REPLAY_TEST_LFRFID_BUFFER_SIZE);
+    size_t buffer_size = 0;
+
+    bool success = lfrfid_raw_file_open_write(file, file_path) &&
+                   lfrfid_raw_file_write_header(
+                       file, 125000.0f, 0.5f, PULSE_REPLAY_TEST_LFRFID_BUFFER_SIZE);
+
+    for(size_t i = 0; success && i < PULSE_REPLAY_TEST_EM4100_TIMINGS_COUNT; i++) {
+        LevelDuration level_duration = protocol_dict_encoder_yield(dict, LFRFIDProtocolEM4100);
+        const bool pulse_pop = pulse_glue_push(
+            pulse_glue,
+            level_duration_get_level(level_duration),
+            level_duration_get_duration(level_duration) *
+                PULSE_REPLAY_TEST_LFRFID_READ_TIMING_MULTIPLIER);
+        if(!pulse_pop) continue;
+
+        // Same pairs as captured by the raw worker: high pulse, then whole period
+        uint32_t length, period;
+        pulse_glue_pop(pulse_glue, &length, &period);
+        varint_pair_pack(pair, true, period);
+        varint_pair_pack(pair, false, length);
+
+        const size_t pair_size = varint_pair_get_size(pair);
+        if(buffer_size + pair_size > PULSE_REPLAY_TEST_LFRFID_BUFFER_SIZE) {
+            success = lfrfid_raw_file_write_buffer(file, buffer, buffer_size);
+            buffer_size = 0;
+        }
+        memcpy(&buffer[buffer_size], varint_pair_get_data(pair), pair_size);
+        buffer_size += pair_size;
+        varint_pair_reset(pair);
+    }
+
+    if(success && buffer_size) {
+        success = lfrfid_raw_file_write_buffer(file, buffer, buffer_size);
+    }
+
+    free(buffer);
+    varint_pair_free(pair);
+    pulse_glue_free(pulse_glue);
+    lfrfid_raw_file_free(file);
+
+    return success;
+}
+
+MU_TEST(pulse_replay_test_lfrfid) {
+    ProtocolDict* dict = protocol_dict_alloc(lfrfid_protocols, LFRFIDProtocolMax);
+    mu_assert(
+        pulse_replay_test_lfrfid_write_em4100(dict, PULSE_REPLAY_TEST_LFRFID_PATH),
+        "Failed to write LF RFID capture");
+
+    PulseReplayTestLfRfidDecoder decoders[LFRFIDProtocolMax];
+    PulseReplay* replay = pulse_replay_alloc();
+
+    for(size_t i = 0; i < LFRFIDProtocolMax; ++i) {
+        decoders[i].dict = dict;
+        decoders[i].protocol = i;
+        pulse_replay_add_decoder(
+            replay,
+            protocol_dict_get_name(dict, i),
+            pulse_replay_test_lfrfid_feed,
+            pulse_replay_test_lfrfid_reset,
+            &decoders[i]);
+    }
+
+    mu_assert(
+        pulse_replay_file_open_lfrfid(replay_file, PULSE_REPLAY_TEST_LFRFID_PATH),
+        "Failed to open LF RFID capture");
+    pulse_replay_run(replay, pulse_replay_file_read, replay_file);
+    pulse_replay_file_close(replay_file);
+
+    pulse_replay_print_report(replay, "em4100", false);
+    mu_assert(
+        pulse_replay_get_decoded(replay, protocol_dict_get_name(dict, LFRFIDProtocolEM4100)) > 0,
+        "EM4100 was not decoded");
+
+    pulse_replay_free(replay);
+    protocol_dict_free(dict);
+    storage_simply_remove(storage, PULSE_REPLAY_TEST_LFRFID_PATH);
+}
+
+MU_TEST_SUITE(pulse_replay_test) {
+    MU_SUITE_CONFIGURE(&pulse_replay_test_alloc, &pulse_replay_test_free);
+
+    MU_RUN_TEST(pulse_replay_test_infrared);
+    MU_RUN_TEST(pulse_replay_test_subghz);
+    MU_RUN_TEST(pulse_replay_test_bin_raw);
+    MU_RUN_TEST(pulse_replay_test_lfrfid);
+}
+
+int run_minunit_test_pulse_replay() {
+    MU_RUN_SUITE(pulse_replay_test);
+    return MU_EXIT_CODE;
+}
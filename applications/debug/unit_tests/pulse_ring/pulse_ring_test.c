@@ -0,0 +1,232 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+#include <toolbox/pulse_ring.h>
+
+#define PULSE_RING_TEST_RING_SIZE (4096U)
+#define PULSE_RING_TEST_BATCH_SIZE (64U)
+#define PULSE_RING_TEST_STRESS_EDGES (200000U)
+#define PULSE_RING_TEST_BENCH_EDGES (100000U)
+
+typedef struct {
+    PulseRing* ring;
+    size_t pushed;
+    volatile bool done;
+} PulseRingTestProducer;
+
+static uint32_t pulse_ring_test_edges_per_second(size_t edges, uint32_t cycles) {
+    const uint32_t us = cycles / furi_hal_cortex_instructions_per_microsecond();
+    return us ? (uint64_t)edges * 1000000U / us : UINT32_MAX;
+}
+
+MU_TEST(pulse_ring_test_basic) {
+    // Capacity is rounded up to 8
+    PulseRing* ring = pulse_ring_alloc(5);
+    LevelDuration items[8];
+
+    for(uint32_t i = 0; i < 8; i++) {
+        mu_assert_int_eq(i + 1, pulse_ring_push(ring, level_duration_make(i % 2, 100 + i)));
+    }
+    mu_assert_int_eq(0, pulse_ring_push(ring, level_duration_make(false, 200)));
+    mu_assert_int_eq(1, pulse_ring_get_overrun_count(ring));
+    mu_assert_int_eq(8, pulse_ring_get_count(ring));
+
+    mu_assert_int_eq(4, pulse_ring_pop(ring, items, 4));
+    for(uint32_t i = 0; i < 4; i++) {
+        mu_assert_int_eq(100 + i, level_duration_get_duration(items[i]));
+        mu_assert_int_eq(i % 2, level_duration_get_level(items[i]));
+    }
+
+    // Overrun marker goes in front of the next edge, but is not counted
+    mu_assert_int_eq(5, pulse_ring_push(ring, level_duration_make(true, 300)));
+    mu_assert_int_eq(6, pulse_ring_pop(ring, items, COUNT_OF(items)));
+    mu_assert_int_eq(107, level_duration_get_duration(items[3]));
+    mu_assert(level_duration_is_reset(items[4]), "overrun marker expected");
+    mu_assert_int_eq(300, level_duration_get_duration(items[5]));
+    mu_assert_int_eq(0, pulse_ring_pop(ring, items, COUNT_OF(items)));
+
+    // Edges keep their order across the wrap
+    uint32_t expected = 0;
+    for(uint32_t i = 0; i < 300; i++) {
+        for(uint32_t j = 0; j < 3; j++) {
+            pulse_ring_push(ring, level_duration_make(true, i * 3 + j + 1));
+        }
+        mu_assert_int_eq(3, pulse_ring_pop(ring, items, COUNT_OF(items)));
+        for(uint32_t j = 0; j < 3; j++) {
+            mu_assert_int_eq(++expected, level_duration_get_duration(items[j]));
+        }
+    }
+    mu_assert_int_eq(1, pulse_ring_get_overrun_count(ring));
+
+    pulse_ring_reset(ring);
+    mu_assert_int_eq(0, pulse_ring_get_count(ring));
+    mu_assert_int_eq(0, pulse_ring_get_overrun_count(ring));
+
+    pulse_ring_free(ring);
+}
+
+MU_TEST(pulse_ring_test_wake_after_overrun) {
+    // Producer wakes the consumer when push returns 1, as the capture workers do
+    PulseRing* ring = pulse_ring_alloc(8);
+    LevelDuration items[8];
+    size_t wakes = 0;
+
+    for(uint32_t round = 0; round < 3; round++) {
+        for(uint32_t i = 0; i < 10; i++) {
+            const size_t count = pulse_ring_push(ring, level_duration_make(i % 2, 100 + i));
+            if(count == 1) wakes++;
+        }
+        mu_assert_int_eq(round + 1, wakes);
+        mu_assert_int_eq((round + 1) * 2, pulse_ring_get_overrun_count(ring));
+
+        // Consumer drains the ring, the next edge goes in with a marker and must wake it
+        while(pulse_ring_pop(ring, items, COUNT_OF(items))) {
+        }
+        mu_assert_int_eq(1, pulse_ring_push(ring, level_duration_make(true, 300)));
+        mu_assert_int_eq(2, pulse_ring_pop(ring, items, COUNT_OF(items)));
+        mu_assert(level_duration_is_reset(items[0]), "overrun marker expected");
+        mu_assert_int_eq(300, level_duration_get_duration(items[1]));
+    }
+
+    pulse_ring_free(ring);
+}
+
+static int32_t pulse_ring_test_producer(void* context) {
+    PulseRingTestProducer* producer = context;
+
+    for(uint32_t i = 1; i <= PULSE_RING_TEST_STRESS_EDGES; i++) {
+        if(pulse_ring_push(producer->ring, level_duration_make(i % 2, i))) {
+            producer->pushed++;
+        }
+        // Let the consumer in now and then, at random ring levels
+        if((rand() % 512) == 0) furi_thread_yield();
+    }
+    producer->done = true;
+
+    return 0;
+}
+
+MU_TEST(pulse_ring_test_concurrent) {
+    PulseRingTestProducer producer = {
+        .ring = pulse_ring_alloc(PULSE_RING_TEST_RING_SIZE),
+    };
+
+    FuriThread* thread =
+        furi_thread_alloc_ex("PulseRingProducer", 1024, pulse_ring_test_producer, &producer);
+    furi_thread_start(thread);
+
+    LevelDuration batch[PULSE_RING_TEST_BATCH_SIZE];
+    uint32_t last = 0;
+    size_t popped = 0;
+    size_t markers = 0;
+    bool gap_allowed = false;
+    bool order_valid = true;
+
+    while(true) {
+        const bool done = producer.done;
+        const size_t count = pulse_ring_pop(producer.ring, batch, COUNT_OF(batch));
+        for(size_t i = 0; i < count; i++) {
+            if(level_duration_is_reset(batch[i])) {
+                markers++;
+                gap_allowed = true;
+                continue;
+            }
+            // Edges may only be missing right before a marker
+            const uint32_t duration = level_duration_get_duration(batch[i]);
+            if(duration != last + 1 && !(gap_allowed && duration > last)) order_valid = false;
+            last = duration;
+            gap_allowed = false;
+            popped++;
+        }
+        if(count == 0) {
+            if(done) break;
+            furi_thread_yield();
+        }
+    }
+
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+
+    mu_assert(order_valid, "edges out of order");
+    mu_assert_int_eq(producer.pushed, popped);
+    mu_assert_int_eq(
+        PULSE_RING_TEST_STRESS_EDGES, popped + pulse_ring_get_overrun_count(producer.ring));
+    // Marker of the last overrun may still be pending
+    mu_assert(markers <= pulse_ring_get_overrun_count(producer.ring), "too many overrun markers");
+
+    pulse_ring_free(producer.ring);
+}
+
+MU_TEST(pulse_ring_test_benchmark) {
+    PulseRing* ring = pulse_ring_alloc(PULSE_RING_TEST_RING_SIZE);
+    FuriStreamBuffer* stream = furi_stream_buffer_alloc(
+        sizeof(LevelDuration) * PULSE_RING_TEST_RING_SIZE, sizeof(LevelDuration));
+    LevelDuration batch[PULSE_RING_TEST_BATCH_SIZE];
+    LevelDuration level_duration = level_duration_make(true, 500);
+    volatile uint32_t sink = 0;
+
+    // Ring: edges pushed one by one, popped in batches
+    uint32_t start = DWT->CYCCNT;
+    for(size_t i = 0; i < PULSE_RING_TEST_BENCH_EDGES; i += PULSE_RING_TEST_BATCH_SIZE) {
+        for(size_t j = 0; j < PULSE_RING_TEST_BATCH_SIZE; j++) {
+            pulse_ring_push(ring, level_duration);
+        }
+        const size_t count = pulse_ring_pop(ring, batch, COUNT_OF(batch));
+        for(size_t j = 0; j < count; j++) {
+            sink += level_duration_get_duration(batch[j]);
+        }
+    }
+    const uint32_t ring_cycles = DWT->CYCCNT - start;
+
+    // Ring: full, every edge is dropped
+    while(pulse_ring_push(ring, level_duration)) {
+    }
+    start = DWT->CYCCNT;
+    for(size_t i = 0; i < PULSE_RING_TEST_BENCH_EDGES; i++) {
+        pulse_ring_push(ring, level_duration);
+    }
+    const uint32_t overrun_cycles = DWT->CYCCNT - start;
+    mu_assert_int_eq(PULSE_RING_TEST_BENCH_EDGES + 1, pulse_ring_get_overrun_count(ring));
+
+    // Stream buffer, as used by the workers before: one edge per call on both sides
+    start = DWT->CYCCNT;
+    for(size_t i = 0; i < PULSE_RING_TEST_BENCH_EDGES; i += PULSE_RING_TEST_BATCH_SIZE) {
+        for(size_t j = 0; j < PULSE_RING_TEST_BATCH_SIZE; j++) {
+            furi_stream_buffer_send(stream, &level_duration, sizeof(LevelDuration), 0);
+        }
+        while(furi_stream_buffer_receive(stream, batch, sizeof(LevelDuration), 0) ==
+              sizeof(LevelDuration)) {
+            sink += level_duration_get_duration(batch[0]);
+        }
+    }
+    const uint32_t stream_cycles = DWT->CYCCNT - start;
+
+    const uint32_t ring_rate = pulse_ring_test_edges_per_second(
+        PULSE_RING_TEST_BENCH_EDGES, ring_cycles);
+    const uint32_t stream_rate = pulse_ring_test_edges_per_second(
+        PULSE_RING_TEST_BENCH_EDGES, stream_cycles);
+
+    printf(
+        "\tpulse ring: %lu edges/s, with overruns: %lu edges/s, stream buffer: %lu edges/s\r\n",
+        ring_rate,
+        pulse_ring_test_edges_per_second(PULSE_RING_TEST_BENCH_EDGES, overrun_cycles),
+        stream_rate);
+
+    mu_assert(ring_rate > stream_rate, "pulse ring is slower than stream buffer");
+
+    furi_stream_buffer_free(stream);
+    pulse_ring_free(ring);
+    (void)sink;
+}
+
+MU_TEST_SUITE(test_pulse_ring_suite) {
+    MU_RUN_TEST(pulse_ring_test_basic);
+    MU_RUN_TEST(pulse_ring_test_wake_after_overrun);
+    MU_RUN_TEST(pulse_ring_test_concurrent);
+    MU_RUN_TEST(pulse_ring_test_benchmark);
+}
+
+int run_minunit_test_pulse_ring() {
+    MU_RUN_SUITE(test_pulse_ring_suite);
+    return MU_EXIT_CODE;
+}
@@ -5,10 +5,14 @@
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/subghz_keystore.h>
 #include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/subghz_raw_file.h>
+#include <lib/subghz/subghz_hopper.h>
 #include <lib/subghz/protocols/protocol_items.h>
 #include <flipper_format/flipper_format_i.h>
+#include <toolbox/stream/string_stream.h>
 #include <lib/subghz/devices/devices.h>
 #include <lib/subghz/devices/cc1101_configs.h>
+#include "../../../main/subghz/subghz_history.h"
 
 #define TAG "SubGhzTest"
 #define KEYSTORE_DIR_NAME EXT_PATH("subghz/assets/keeloq_mfcodes")
@@ -17,7 +21,15 @@
 #define ALUTECH_AT_4N_DIR_NAME EXT_PATH("subghz/assets/alutech_at_4n")
 #define TEST_RANDOM_DIR_NAME EXT_PATH("unit_tests/subghz/test_random_raw.sub")
 #define TEST_RANDOM_COUNT_PARSE 329
+#define TEST_RAW_BIN_FILE_NAME EXT_PATH("unit_tests/subghz/test_random_raw_bin.sub")
+#define TEST_RAW_TEXT_FILE_NAME EXT_PATH("unit_tests/subghz/test_random_raw_text.sub")
+#define TEST_HISTORY_LOG_NAME EXT_PATH("unit_tests/subghz/history.log")
+// Longer than the window in which receptions count as one transmission
+#define TEST_HISTORY_REPEAT_MS 600
 #define TEST_TIMEOUT 10000
+#define TEST_HOPPER_TICKS 10000
+#define TEST_HOPPER_SLOT_TICKS 40
+#define TEST_HOPPER_BURST_TICKS 2
 
 static SubGhzEnvironment* environment_handler;
 static SubGhzReceiver* receiver_handler;
@@ -825,6 +837,389 @@ MU_TEST(subghz_random_test) {
     mu_assert(subghz_decode_random_test(TEST_RANDOM_DIR_NAME), "Random test error\r\n");
 }
 
+static bool subghz_raw_file_seek_test(Storage* storage, const char* path) {
+    FlipperFormat* fff_data_file = flipper_format_file_alloc(storage);
+    FuriString* temp_str = furi_string_alloc();
+    SubGhzRawFileReader* reader = NULL;
+    bool result = false;
+
+    do {
+        if(!flipper_format_file_open_existing(fff_data_file, path)) break;
+        if(!flipper_format_read_string(fff_data_file, "Protocol", temp_str)) break;
+        Stream* stream = flipper_format_get_raw_stream(fff_data_file);
+        stream_seek(stream, 1, StreamOffsetFromCurrent);
+        reader = subghz_raw_file_reader_alloc(stream);
+
+        const size_t sample_count = subghz_raw_file_reader_get_sample_count(reader);
+        if(sample_count == 0) break;
+
+        // Remember a sample from the middle, reading sequentially
+        const size_t target = sample_count / 2 + 1;
+        int32_t samples[SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX];
+        int32_t expected = 0;
+        size_t total = 0;
+        size_t count;
+        while((count = subghz_raw_file_reader_read(reader, samples, COUNT_OF(samples))) > 0) {
+            if(target >= total && target < total + count) expected = samples[target - total];
+            total += count;
+        }
+        if(total != sample_count) break;
+
+        int32_t sample = 0;
+        if(!subghz_raw_file_reader_seek(reader, target)) break;
+        if(subghz_raw_file_reader_read(reader, &sample, 1) != 1) break;
+        if(sample != expected) break;
+
+        result = !subghz_raw_file_reader_seek(reader, sample_count);
+    } while(false);
+
+    if(reader) subghz_raw_file_reader_free(reader);
+    furi_string_free(temp_str);
+    flipper_format_free(fff_data_file);
+
+    return result;
+}
+
+MU_TEST(subghz_raw_file_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    mu_assert(
+        subghz_raw_file_text_to_binary(storage, TEST_RANDOM_DIR_NAME, TEST_RAW_BIN_FILE_NAME),
+        "Text to binary conversion error\r\n");
+    mu_assert(
+        subghz_raw_file_binary_to_text(storage, TEST_RAW_BIN_FILE_NAME, TEST_RAW_TEXT_FILE_NAME),
+        "Binary to text conversion error\r\n");
+
+    FileInfo text_info;
+    FileInfo bin_info;
+    mu_assert(
+        storage_common_stat(storage, TEST_RANDOM_DIR_NAME, &text_info) == FSE_OK &&
+            storage_common_stat(storage, TEST_RAW_BIN_FILE_NAME, &bin_info) == FSE_OK,
+        "Unable to stat RAW files\r\n");
+    // Measured 2.26x on this file
+    mu_assert(bin_info.size * 11 < text_info.size * 5, "Binary RAW file is too large\r\n");
+
+    mu_assert(
+        subghz_raw_file_seek_test(storage, TEST_RAW_BIN_FILE_NAME), "Binary RAW seek error\r\n");
+
+    // Both files must decode exactly like the original one
+    mu_assert(subghz_decode_random_test(TEST_RAW_BIN_FILE_NAME), "Binary RAW decode error\r\n");
+    mu_assert(
+        subghz_decode_random_test(TEST_RAW_TEXT_FILE_NAME), "Converted RAW decode error\r\n");
+
+    storage_simply_remove(storage, TEST_RAW_BIN_FILE_NAME);
+    storage_simply_remove(storage, TEST_RAW_TEXT_FILE_NAME);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static bool subghz_raw_file_chunk_test(const uint8_t* chunk, size_t size, int32_t* sample) {
+    Stream* stream = string_stream_alloc();
+    stream_write(stream, chunk, size);
+    stream_rewind(stream);
+    SubGhzRawFileReader* reader = subghz_raw_file_reader_alloc(stream);
+
+    // One sample per chunk, the whole file must be read without errors
+    bool result = subghz_raw_file_reader_read(reader, sample, 1) == 1 &&
+                  subghz_raw_file_reader_read(reader, sample, 1) == 0 &&
+                  !subghz_raw_file_reader_is_failed(reader);
+
+    subghz_raw_file_reader_free(reader);
+    stream_free(stream);
+
+    return result;
+}
+
+MU_TEST(subghz_raw_file_malformed_test) {
+    int32_t sample = 0;
+
+    // Header: sample count and data size, little endian
+    const uint8_t valid[] = {0x01, 0x00, 0x05, 0x00, 0xFE, 0xFF, 0xFF, 0xFF, 0x0F};
+    mu_assert(subghz_raw_file_chunk_test(valid, sizeof(valid), &sample), "Valid chunk error\r\n");
+    mu_assert_int_eq(INT32_MAX, sample);
+
+    const uint8_t truncated[] = {0x01, 0x00, 0x02, 0x00, 0x80, 0x80};
+    mu_assert(
+        !subghz_raw_file_chunk_test(truncated, sizeof(truncated), &sample),
+        "Truncated varint accepted\r\n");
+
+    const uint8_t overlong[] = {0x01, 0x00, 0x02, 0x00, 0x82, 0x00};
+    mu_assert(
+        !subghz_raw_file_chunk_test(overlong, sizeof(overlong), &sample),
+        "Overlong varint accepted\r\n");
+
+    const uint8_t too_large[] = {0x01, 0x00, 0x05, 0x00, 0xFE, 0xFF, 0xFF, 0xFF, 0x1F};
+    mu_assert(
+        !subghz_raw_file_chunk_test(too_large, sizeof(too_large), &sample),
+        "Out of range varint accepted\r\n");
+
+    const uint8_t too_long[] = {0x01, 0x00, 0x06, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01};
+    mu_assert(
+        !subghz_raw_file_chunk_test(too_long, sizeof(too_long), &sample),
+        "Six byte varint accepted\r\n");
+
+    const uint8_t trailing[] = {0x01, 0x00, 0x02, 0x00, 0x02, 0x02};
+    mu_assert(
+        !subghz_raw_file_chunk_test(trailing, sizeof(trailing), &sample),
+        "Chunk with trailing data accepted\r\n");
+
+    const uint8_t short_size[] = {0x02, 0x00, 0x01, 0x00, 0x02};
+    mu_assert(
+        !subghz_raw_file_chunk_test(short_size, sizeof(short_size), &sample),
+        "Chunk smaller than its samples accepted\r\n");
+}
+
+static const uint8_t subghz_test_history_preset_data[] = {0x02, 0x0D, 0x03, 0x07, 0x00, 0x00};
+
+static SubGhzHistoryAddResult
+    subghz_history_test_add(SubGhzHistory* history, uint32_t key, SubGhzRadioPreset* preset) {
+    SubGhzProtocolDecoderBase* decoder = subghz_receiver_search_decoder_base_by_name(
+        receiver_handler, SUBGHZ_PROTOCOL_PRINCETON_NAME);
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    const uint32_t bit = 24;
+    const uint32_t te = 400;
+    const uint8_t key_data[sizeof(uint64_t)] = {
+        0, 0, 0, 0, 0, (uint8_t)(key >> 16), (uint8_t)(key >> 8), (uint8_t)key};
+    flipper_format_write_uint32(flipper_format, "Bit", &bit, 1);
+    flipper_format_write_hex(flipper_format, "Key", key_data, sizeof(key_data));
+    flipper_format_write_uint32(flipper_format, "TE", &te, 1);
+
+    SubGhzHistoryAddResult result = SubGhzHistoryAddResultIgnored;
+    if(subghz_protocol_decoder_base_deserialize(decoder, flipper_format) ==
+       SubGhzProtocolStatusOk) {
+        result = subghz_history_add_to_history(history, decoder, preset);
+    }
+
+    flipper_format_free(flipper_format);
+    return result;
+}
+
+MU_TEST(subghz_history_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_remove(storage, TEST_HISTORY_LOG_NAME);
+
+    SubGhzRadioPreset preset = {
+        .name = furi_string_alloc_set("AM650"),
+        .frequency = 433920000,
+        .data = (uint8_t*)subghz_test_history_preset_data,
+        .data_size = sizeof(subghz_test_history_preset_data),
+    };
+    SubGhzHistory* history = subghz_history_alloc(TEST_HISTORY_LOG_NAME);
+    subghz_history_set_spill_enabled(history, true);
+
+    // Repeats within a transmission are dropped, later ones are counted
+    mu_assert_int_eq(SubGhzHistoryAddResultNew, subghz_history_test_add(history, 0, &preset));
+    mu_assert_int_eq(SubGhzHistoryAddResultIgnored, subghz_history_test_add(history, 0, &preset));
+    furi_delay_ms(TEST_HISTORY_REPEAT_MS);
+    mu_assert_int_eq(SubGhzHistoryAddResultUpdated, subghz_history_test_add(history, 0, &preset));
+    mu_assert_int_eq(1, subghz_history_get_item(history));
+    mu_assert_int_eq(2, subghz_history_get_hit_count(history, 0));
+
+    // Full live page is moved out and only written by the flush
+    for(uint32_t i = 1; i < SUBGHZ_HISTORY_MAX; i++) {
+        mu_assert_int_eq(SubGhzHistoryAddResultNew, subghz_history_test_add(history, i, &preset));
+    }
+    mu_assert_int_eq(
+        SubGhzHistoryAddResultUpdated,
+        subghz_history_test_add(history, SUBGHZ_HISTORY_MAX, &preset));
+    mu_assert_int_eq(1, subghz_history_get_item(history));
+    mu_assert_int_eq(1, subghz_history_get_page_count(history));
+    subghz_history_flush(history);
+    mu_assert_int_eq(2, subghz_history_get_page_count(history));
+
+    // Records in the log are still matched
+    furi_delay_ms(TEST_HISTORY_REPEAT_MS);
+    mu_assert_int_eq(SubGhzHistoryAddResultUpdated, subghz_history_test_add(history, 0, &preset));
+    mu_assert_int_eq(1, subghz_history_get_item(history));
+    subghz_history_flush(history);
+
+    mu_assert(subghz_history_set_page(history, 1), "Unable to load log page\r\n");
+    mu_assert_int_eq(SUBGHZ_HISTORY_MAX, subghz_history_get_item(history));
+    mu_assert_int_eq(3, subghz_history_get_hit_count(history, 0));
+    mu_assert_string_eq(
+        SUBGHZ_PROTOCOL_PRINCETON_NAME, subghz_history_get_protocol_name(history, 0));
+    mu_assert_not_null(subghz_history_get_raw_data(history, 0));
+    mu_assert(subghz_history_set_page(history, 0), "Unable to load live page\r\n");
+    mu_assert_int_eq(1, subghz_history_get_item(history));
+
+    // Next session starts with the pages of the previous one
+    subghz_history_free(history);
+    history = subghz_history_alloc(TEST_HISTORY_LOG_NAME);
+    subghz_history_set_spill_enabled(history, true);
+    mu_assert_int_eq(3, subghz_history_get_page_count(history));
+    mu_assert_int_eq(0, subghz_history_get_item(history));
+
+    mu_assert(subghz_history_set_page(history, 1), "Unable to reload log page\r\n");
+    mu_assert_int_eq(SUBGHZ_HISTORY_MAX, subghz_history_get_item(history));
+    mu_assert_int_eq(3, subghz_history_get_hit_count(history, 0));
+    mu_assert_string_eq("AM650", subghz_history_get_preset(history, 0));
+    SubGhzRadioPreset* radio_preset = subghz_history_get_radio_preset(history, 0);
+    mu_assert_int_eq(preset.data_size, radio_preset->data_size);
+    mu_assert_mem_eq(preset.data, radio_preset->data, preset.data_size);
+    mu_assert(subghz_history_set_page(history, 2), "Unable to reload last page\r\n");
+    mu_assert_int_eq(1, subghz_history_get_item(history));
+    mu_assert(subghz_history_set_page(history, 0), "Unable to load live page\r\n");
+
+    mu_assert_int_eq(SubGhzHistoryAddResultUpdated, subghz_history_test_add(history, 0, &preset));
+    mu_assert_int_eq(0, subghz_history_get_item(history));
+
+    // Only the newest records in the log are matched
+    const uint32_t count = SUBGHZ_HISTORY_LOG_INDEX_SIZE + SUBGHZ_HISTORY_MAX;
+    for(uint32_t i = 0; i < count; i++) {
+        if(subghz_history_test_add(history, 0x1000 + i, &preset) ==
+           SubGhzHistoryAddResultUpdated) {
+            subghz_history_flush(history);
+        }
+    }
+    furi_delay_ms(TEST_HISTORY_REPEAT_MS);
+    mu_assert_int_eq(SubGhzHistoryAddResultNew, subghz_history_test_add(history, 0, &preset));
+
+    // Record with a preset that does not fit is dropped and reported, the table holds 16
+    SubGhzRadioPreset other_preset = {
+        .name = furi_string_alloc(),
+        .frequency = 433920000,
+    };
+    SubGhzHistoryAddResult result = SubGhzHistoryAddResultIgnored;
+    for(uint32_t i = 0; i < 16; i++) {
+        furi_string_printf(other_preset.name, "Preset%lu", i);
+        result = subghz_history_test_add(history, 0x2000 + i, &other_preset);
+        if(result == SubGhzHistoryAddResultUpdated) subghz_history_flush(history);
+    }
+    mu_assert_int_eq(SubGhzHistoryAddResultIgnored, result);
+    mu_assert(subghz_history_get_text_space_left(history, NULL), "Preset overflow not shown\r\n");
+    result = subghz_history_test_add(history, 0x3000, &preset);
+    mu_assert(result != SubGhzHistoryAddResultIgnored, "Known preset not accepted\r\n");
+    mu_assert(
+        !subghz_history_get_text_space_left(history, NULL), "Preset overflow still shown\r\n");
+    furi_string_free(other_preset.name);
+
+    subghz_history_free(history);
+    furi_string_free(preset.name);
+    storage_simply_remove(storage, TEST_HISTORY_LOG_NAME);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static const uint32_t subghz_test_hopper_frequencies[] = {
+    310000000,
+    315000000,
+    318000000,
+    390000000,
+    418000000,
+    433075000,
+    433420000,
+    433920000,
+    434420000,
+    868350000,
+};
+
+// Remotes on these frequencies send one short burst per slot at a pseudo-random time
+static const uint32_t subghz_test_hopper_active_frequencies[] = {433920000, 868350000};
+
+static struct {
+    uint32_t frequency;
+    uint32_t tick;
+} subghz_test_radio;
+
+static int32_t subghz_test_radio_get_remote(uint32_t frequency) {
+    for(size_t i = 0; i < COUNT_OF(subghz_test_hopper_active_frequencies); i++) {
+        if(subghz_test_hopper_active_frequencies[i] == frequency) return i;
+    }
+    return -1;
+}
+
+static uint32_t subghz_test_radio_set_frequency(uint32_t frequency) {
+    subghz_test_radio.frequency = frequency;
+    return frequency;
+}
+
+static float subghz_test_radio_get_rssi(void) {
+    if(subghz_test_radio_get_remote(subghz_test_radio.frequency) < 0) return -100.0f;
+
+    uint32_t slot = subghz_test_radio.tick / TEST_HOPPER_SLOT_TICKS;
+    uint32_t hash = (slot * 2654435761U) ^ subghz_test_radio.frequency;
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995U;
+    hash ^= hash >> 15;
+
+    uint32_t start = hash % (TEST_HOPPER_SLOT_TICKS - TEST_HOPPER_BURST_TICKS);
+    uint32_t offset = subghz_test_radio.tick % TEST_HOPPER_SLOT_TICKS;
+    bool burst = (offset >= start) && (offset < start + TEST_HOPPER_BURST_TICKS);
+
+    return burst ? -60.0f : -100.0f;
+}
+
+static const SubGhzDeviceInterconnect subghz_test_radio_interconnect = {
+    .set_frequency = subghz_test_radio_set_frequency,
+    .get_rssi = subghz_test_radio_get_rssi,
+};
+
+static const SubGhzDevice subghz_test_radio_device = {
+    .name = "test_radio",
+    .interconnect = &subghz_test_radio_interconnect,
+};
+
+static uint32_t subghz_hopper_detect_test(SubGhzHopper* hopper) {
+    const SubGhzDevice* device = &subghz_test_radio_device;
+    uint32_t last_slot[COUNT_OF(subghz_test_hopper_active_frequencies)];
+    memset(last_slot, 0xFF, sizeof(last_slot));
+    uint32_t detected = 0;
+
+    subghz_hopper_reset(hopper);
+    subghz_devices_set_frequency(device, subghz_hopper_get_frequency(hopper));
+
+    for(uint32_t tick = 0; tick < TEST_HOPPER_TICKS; tick++) {
+        subghz_test_radio.tick = tick;
+        float rssi = subghz_devices_get_rssi(device);
+
+        // Count every burst once, however long the hopper stays on it
+        int32_t remote = subghz_test_radio_get_remote(subghz_test_radio.frequency);
+        uint32_t slot = tick / TEST_HOPPER_SLOT_TICKS;
+        if(rssi > SUBGHZ_HOPPER_RSSI_THRESHOLD && last_slot[remote] != slot) {
+            last_slot[remote] = slot;
+            detected++;
+        }
+
+        if(subghz_hopper_tick(hopper, rssi) == SubGhzHopperStepRetune) {
+            subghz_devices_set_frequency(device, subghz_hopper_get_frequency(hopper));
+        }
+    }
+
+    return detected;
+}
+
+MU_TEST(subghz_hopper_test) {
+    SubGhzHopper* hopper = subghz_hopper_alloc(
+        subghz_test_hopper_frequencies, COUNT_OF(subghz_test_hopper_frequencies));
+
+    subghz_hopper_set_adaptive(hopper, false);
+    uint32_t detected_fixed = subghz_hopper_detect_test(hopper);
+
+    subghz_hopper_set_adaptive(hopper, true);
+    uint32_t detected_adaptive = subghz_hopper_detect_test(hopper);
+
+    const uint32_t bursts = TEST_HOPPER_TICKS / TEST_HOPPER_SLOT_TICKS *
+                            COUNT_OF(subghz_test_hopper_active_frequencies);
+    FURI_LOG_I(
+        TAG,
+        "Hopper detected %lu of %lu bursts, %lu with fixed dwell",
+        detected_adaptive,
+        bursts,
+        detected_fixed);
+    mu_assert(detected_fixed > 0, "Fixed dwell hopper detected nothing\r\n");
+    mu_assert(
+        detected_adaptive > detected_fixed * 2, "Adaptive hopper detects too few bursts\r\n");
+
+    // Idle frequencies still get scanned, only the active ones see activity
+    for(size_t i = 0; i < subghz_hopper_get_count(hopper); i++) {
+        SubGhzHopperStats stats;
+        subghz_hopper_get_stats(hopper, i, &stats);
+        bool remote = subghz_test_radio_get_remote(stats.frequency) >= 0;
+        mu_assert(stats.visits > 0, "Frequency was never scanned\r\n");
+        mu_assert((stats.active_ticks > 0) == remote, "Wrong frequency activity\r\n");
+    }
+
+    subghz_hopper_free(hopper);
+}
+
 MU_TEST_SUITE(subghz) {
     subghz_test_init();
     MU_RUN_TEST(subghz_keystore_test);
@@ -901,6 +1296,10 @@ MU_TEST_SUITE(subghz) {
     MU_RUN_TEST(subghz_encoder_mastercode_test);
 
     MU_RUN_TEST(subghz_random_test);
+    MU_RUN_TEST(subghz_raw_file_test);
+    MU_RUN_TEST(subghz_raw_file_malformed_test);
+    MU_RUN_TEST(subghz_history_test);
+    MU_RUN_TEST(subghz_hopper_test);
     subghz_test_deinit();
 }
 
@@ -31,6 +31,11 @@ int run_minunit_test_float_tools();
 int run_minunit_test_bt();
 int run_minunit_test_dialogs_file_browser_options();
 int run_minunit_test_expansion();
+int run_minunit_test_api_hashtable();
+int run_minunit_test_mjs();
+int run_minunit_test_bad_usb();
+int run_minunit_test_pulse_ring();
+int run_minunit_test_pulse_replay();
 
 typedef int (*UnitTestEntry)();
 
@@ -64,6 +69,11 @@ const UnitTest unit_tests[] = {
     {.name = "dialogs_file_browser_options",
      .entry = run_minunit_test_dialogs_file_browser_options},
     {.name = "expansion", .entry = run_minunit_test_expansion},
+    {.name = "api_hashtable", .entry = run_minunit_test_api_hashtable},
+    {.name = "mjs", .entry = run_minunit_test_mjs},
+    {.name = "bad_usb", .entry = run_minunit_test_bad_usb},
+    {.name = "pulse_ring", .entry = run_minunit_test_pulse_ring},
+    {.name = "pulse_replay", .entry = run_minunit_test_pulse_replay},
 };
 
 void minunit_print_progress() {
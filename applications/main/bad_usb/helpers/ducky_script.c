@@ -12,9 +12,6 @@
 #define TAG "BadUsb"
 #define WORKER_TAG TAG "Worker"
 
-#define BADUSB_ASCII_TO_KEY(script, x) \
-    (((uint8_t)x < 128) ? (script->layout[(uint8_t)x]) : HID_KEYBOARD_NONE)
-
 typedef enum {
     WorkerEvtStartStop = (1 << 0),
     WorkerEvtPauseResume = (1 << 1),
@@ -25,187 +22,6 @@ typedef enum {
 
 static const char ducky_cmd_id[] = {"ID"};
 
-static const uint8_t numpad_keys[10] = {
-    HID_KEYPAD_0,
-    HID_KEYPAD_1,
-    HID_KEYPAD_2,
-    HID_KEYPAD_3,
-    HID_KEYPAD_4,
-    HID_KEYPAD_5,
-    HID_KEYPAD_6,
-    HID_KEYPAD_7,
-    HID_KEYPAD_8,
-    HID_KEYPAD_9,
-};
-
-uint32_t ducky_get_command_len(const char* line) {
-    uint32_t len = strlen(line);
-    for(uint32_t i = 0; i < len; i++) {
-        if(line[i] == ' ') return i;
-    }
-    return 0;
-}
-
-bool ducky_is_line_end(const char chr) {
-    return ((chr == ' ') || (chr == '\0') || (chr == '\r') || (chr == '\n'));
-}
-
-uint16_t ducky_get_keycode(BadUsbScript* bad_usb, const char* param, bool accept_chars) {
-    uint16_t keycode = ducky_get_keycode_by_name(param);
-    if(keycode != HID_KEYBOARD_NONE) {
-        return keycode;
-    }
-
-    if((accept_chars) && (strlen(param) > 0)) {
-        return (BADUSB_ASCII_TO_KEY(bad_usb, param[0]) & 0xFF);
-    }
-    return 0;
-}
-
-bool ducky_get_number(const char* param, uint32_t* val) {
-    uint32_t value = 0;
-    if(sscanf(param, "%lu", &value) == 1) {
-        *val = value;
-        return true;
-    }
-    return false;
-}
-
-void ducky_numlock_on() {
-    if((furi_hal_hid_get_led_state() & HID_KB_LED_NUM) == 0) {
-        furi_hal_hid_kb_press(HID_KEYBOARD_LOCK_NUM_LOCK);
-        furi_hal_hid_kb_release(HID_KEYBOARD_LOCK_NUM_LOCK);
-    }
-}
-bool ducky_numpad_press(const char num) {
-    if((num < '0') || (num > '9')) return false;
-
-    uint16_t key = numpad_keys[num - '0'];
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release(key);
-
-    return true;
-}
-
-bool ducky_altchar(const char* charcode) {
-    uint8_t i = 0;
-    bool state = false;
-
-    furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT);
-
-    while(!ducky_is_line_end(charcode[i])) {
-        state = ducky_numpad_press(charcode[i]);
-        if(state == false) break;
-        i++;
-    }
-
-    furi_hal_hid_kb_release(KEY_MOD_LEFT_ALT);
-    return state;
-}
-
-bool ducky_altstring(const char* param) {
-    uint32_t i = 0;
-    bool state = false;
-
-    while(param[i] != '\0') {
-        if((param[i] < ' ') || (param[i] > '~')) {
-            i++;
-            continue; // Skip non-printable chars
-        }
-
-        char temp_str[4];
-        snprintf(temp_str, 4, "%u", param[i]);
-
-        state = ducky_altchar(temp_str);
-        if(state == false) break;
-        i++;
-    }
-    return state;
-}
-
-int32_t ducky_error(BadUsbScript* bad_usb, const char* text, ...) {
-    va_list args;
-    va_start(args, text);
-
-    vsnprintf(bad_usb->st.error, sizeof(bad_usb->st.error), text, args);
-
-    va_end(args);
-    return SCRIPT_STATE_ERROR;
-}
-
-bool ducky_string(BadUsbScript* bad_usb, const char* param) {
-    uint32_t i = 0;
-
-    while(param[i] != '\0') {
-        if(param[i] != '\n') {
-            uint16_t keycode = BADUSB_ASCII_TO_KEY(bad_usb, param[i]);
-            if(keycode != HID_KEYBOARD_NONE) {
-                furi_hal_hid_kb_press(keycode);
-                furi_hal_hid_kb_release(keycode);
-            }
-        } else {
-            furi_hal_hid_kb_press(HID_KEYBOARD_RETURN);
-            furi_hal_hid_kb_release(HID_KEYBOARD_RETURN);
-        }
-        i++;
-    }
-    bad_usb->stringdelay = 0;
-    return true;
-}
-
-static bool ducky_string_next(BadUsbScript* bad_usb) {
-    if(bad_usb->string_print_pos >= furi_string_size(bad_usb->string_print)) {
-        return true;
-    }
-
-    char print_char = furi_string_get_char(bad_usb->string_print, bad_usb->string_print_pos);
-
-    if(print_char != '\n') {
-        uint16_t keycode = BADUSB_ASCII_TO_KEY(bad_usb, print_char);
-        if(keycode != HID_KEYBOARD_NONE) {
-            furi_hal_hid_kb_press(keycode);
-            furi_hal_hid_kb_release(keycode);
-        }
-    } else {
-        furi_hal_hid_kb_press(HID_KEYBOARD_RETURN);
-        furi_hal_hid_kb_release(HID_KEYBOARD_RETURN);
-    }
-
-    bad_usb->string_print_pos++;
-
-    return false;
-}
-
-static int32_t ducky_parse_line(BadUsbScript* bad_usb, FuriString* line) {
-    uint32_t line_len = furi_string_size(line);
-    const char* line_tmp = furi_string_get_cstr(line);
-
-    if(line_len == 0) {
-        return SCRIPT_STATE_NEXT_LINE; // Skip empty lines
-    }
-    FURI_LOG_D(WORKER_TAG, "line:%s", line_tmp);
-
-    // Ducky Lang Functions
-    int32_t cmd_result = ducky_execute_cmd(bad_usb, line_tmp);
-    if(cmd_result != SCRIPT_STATE_CMD_UNKNOWN) {
-        return cmd_result;
-    }
-
-    // Special keys + modifiers
-    uint16_t key = ducky_get_keycode(bad_usb, line_tmp, false);
-    if(key == HID_KEYBOARD_NONE) {
-        return ducky_error(bad_usb, "No keycode defined for %s", line_tmp);
-    }
-    if((key & 0xFF00) != 0) {
-        // It's a modifier key
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        key |= ducky_get_keycode(bad_usb, line_tmp, true);
-    }
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release(key);
-    return 0;
-}
-
 static bool ducky_set_usb_id(BadUsbScript* bad_usb, const char* line) {
     if(sscanf(line, "%lX:%lX", &bad_usb->hid_cfg.vid, &bad_usb->hid_cfg.pid) == 2) {
         bad_usb->hid_cfg.manuf[0] = '\0';
@@ -276,32 +92,11 @@ static bool ducky_script_preload(BadUsbScript* bad_usb, File* script_file) {
     return true;
 }
 
-static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_file) {
-    int32_t delay_val = 0;
-
-    if(bad_usb->repeat_cnt > 0) {
-        bad_usb->repeat_cnt--;
-        delay_val = ducky_parse_line(bad_usb, bad_usb->line_prev);
-        if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-            return 0;
-        } else if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
-            return delay_val;
-        } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
-            return delay_val;
-        } else if(delay_val < 0) { // Script error
-            bad_usb->st.error_line = bad_usb->st.line_cur - 1;
-            FURI_LOG_E(WORKER_TAG, "Unknown command at line %zu", bad_usb->st.line_cur - 1U);
-            return SCRIPT_STATE_ERROR;
-        } else {
-            return (delay_val + bad_usb->defdelay);
-        }
-    }
-
-    furi_string_set(bad_usb->line_prev, bad_usb->line);
-    furi_string_reset(bad_usb->line);
-
+static bool ducky_script_compile(BadUsbScript* bad_usb, File* script_file) {
     while(1) {
         if(bad_usb->buf_len == 0) {
+            if(bad_usb->file_end) break;
+
             bad_usb->buf_len = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
             if(storage_file_eof(script_file)) {
                 if((bad_usb->buf_len < FILE_BUFFER_LEN) && (bad_usb->file_end == false)) {
@@ -312,37 +107,59 @@ static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_fil
             }
 
             bad_usb->buf_start = 0;
-            if(bad_usb->buf_len == 0) return SCRIPT_STATE_END;
+            if(bad_usb->buf_len == 0) break;
         }
-        for(uint8_t i = bad_usb->buf_start; i < (bad_usb->buf_start + bad_usb->buf_len); i++) {
+
+        uint8_t buf_end = bad_usb->buf_start + bad_usb->buf_len;
+        uint8_t i = bad_usb->buf_start;
+        bool line_end = false;
+        for(; (i < buf_end) && (!line_end); i++) {
             if(bad_usb->file_buf[i] == '\n' && furi_string_size(bad_usb->line) > 0) {
-                bad_usb->st.line_cur++;
-                bad_usb->buf_len = bad_usb->buf_len + bad_usb->buf_start - (i + 1);
-                bad_usb->buf_start = i + 1;
-                furi_string_trim(bad_usb->line);
-                delay_val = ducky_parse_line(bad_usb, bad_usb->line);
-                if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-                    return 0;
-                } else if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
-                    return delay_val;
-                } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
-                    return delay_val;
-                } else if(delay_val < 0) {
-                    bad_usb->st.error_line = bad_usb->st.line_cur;
-                    FURI_LOG_E(WORKER_TAG, "Unknown command at line %zu", bad_usb->st.line_cur);
-                    return SCRIPT_STATE_ERROR;
-                } else {
-                    return (delay_val + bad_usb->defdelay);
-                }
+                line_end = true;
             } else {
                 furi_string_push_back(bad_usb->line, bad_usb->file_buf[i]);
             }
         }
-        bad_usb->buf_len = 0;
-        if(bad_usb->file_end) return SCRIPT_STATE_END;
+        bad_usb->buf_len = buf_end - i;
+        bad_usb->buf_start = i;
+
+        if(line_end) {
+            bool state = ducky_program_add_line(bad_usb->program, bad_usb->line);
+            furi_string_reset(bad_usb->line);
+            if(!state) return false;
+            if(ducky_program_get_size(bad_usb->program) >= DUCKY_PROGRAM_SIZE_MAX) break;
+        }
     }
 
-    return 0;
+    return true;
+}
+
+static bool ducky_script_prepare(BadUsbScript* bad_usb, File* script_file) {
+    bad_usb->buf_len = 0;
+    bad_usb->st.line_cur = 0;
+    bad_usb->file_end = false;
+    storage_file_seek(script_file, 0, true);
+    furi_string_reset(bad_usb->line);
+    ducky_program_reset(bad_usb->program);
+
+    bool compiled = ducky_script_compile(bad_usb, script_file);
+    FURI_LOG_D(WORKER_TAG, "Compiled: %zu bytes", ducky_program_get_size(bad_usb->program));
+    return compiled;
+}
+
+static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_file) {
+    int32_t delay_val = ducky_program_step(bad_usb->program);
+
+    if((delay_val == SCRIPT_STATE_END) && ((bad_usb->buf_len > 0) || (!bad_usb->file_end))) {
+        // Script doesn't fit in memory, compile the next part
+        ducky_program_next_chunk(bad_usb->program);
+        if(!ducky_script_compile(bad_usb, script_file)) {
+            return SCRIPT_STATE_ERROR;
+        }
+        delay_val = ducky_program_step(bad_usb->program);
+    }
+
+    return delay_val;
 }
 
 static void bad_usb_hid_state_callback(bool state, void* context) {
@@ -379,8 +196,7 @@ static int32_t bad_usb_worker(void* context) {
     FURI_LOG_I(WORKER_TAG, "Init");
     File* script_file = storage_file_alloc(furi_record_open(RECORD_STORAGE));
     bad_usb->line = furi_string_alloc();
-    bad_usb->line_prev = furi_string_alloc();
-    bad_usb->string_print = furi_string_alloc();
+    bad_usb->program = ducky_program_alloc(&bad_usb->st, bad_usb->layout);
 
     furi_hal_hid_set_state_callback(bad_usb_hid_state_callback, bad_usb);
 
@@ -428,15 +244,11 @@ static int32_t bad_usb_worker(void* context) {
             } else if(flags & WorkerEvtStartStop) { // Start executing script
                 dolphin_deed(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
-                bad_usb->buf_len = 0;
-                bad_usb->st.line_cur = 0;
-                bad_usb->defdelay = 0;
-                bad_usb->stringdelay = 0;
-                bad_usb->repeat_cnt = 0;
-                bad_usb->key_hold_nb = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
-                worker_state = BadUsbStateRunning;
+                if(ducky_script_prepare(bad_usb, script_file)) {
+                    worker_state = BadUsbStateRunning;
+                } else {
+                    worker_state = BadUsbStateScriptError; // Script compile error
+                }
             } else if(flags & WorkerEvtDisconnect) {
                 worker_state = BadUsbStateNotConnected; // USB disconnected
             }
@@ -451,13 +263,11 @@ static int32_t bad_usb_worker(void* context) {
             } else if(flags & WorkerEvtConnect) { // Start executing script
                 dolphin_deed(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
-                bad_usb->buf_len = 0;
-                bad_usb->st.line_cur = 0;
-                bad_usb->defdelay = 0;
-                bad_usb->stringdelay = 0;
-                bad_usb->repeat_cnt = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
+                if(!ducky_script_prepare(bad_usb, script_file)) {
+                    worker_state = BadUsbStateScriptError; // Script compile error
+                    bad_usb->st.state = worker_state;
+                    continue;
+                }
                 // extra time for PC to recognize Flipper as keyboard
                 flags = furi_thread_flags_wait(
                     WorkerEvtEnd | WorkerEvtDisconnect | WorkerEvtStartStop,
@@ -519,8 +329,7 @@ static int32_t bad_usb_worker(void* context) {
                     furi_hal_hid_kb_release_all();
                     continue;
                 } else if(delay_val == SCRIPT_STATE_STRING_START) { // Start printing string with delays
-                    delay_val = bad_usb->defdelay;
-                    bad_usb->string_print_pos = 0;
+                    delay_val = ducky_program_get_default_delay(bad_usb->program);
                     worker_state = BadUsbStateStringDelay;
                 } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // set state to wait for user input
                     worker_state = BadUsbStateWaitForBtn;
@@ -584,7 +393,7 @@ static int32_t bad_usb_worker(void* context) {
         } else if(worker_state == BadUsbStateStringDelay) { // State: print string with delays
             uint32_t flags = bad_usb_flags_get(
                 WorkerEvtEnd | WorkerEvtStartStop | WorkerEvtPauseResume | WorkerEvtDisconnect,
-                bad_usb->stringdelay);
+                ducky_program_get_string_delay(bad_usb->program));
 
             if(!(flags & FuriFlagError)) {
                 if(flags & WorkerEvtEnd) {
@@ -604,9 +413,8 @@ static int32_t bad_usb_worker(void* context) {
             } else if(
                 (flags == (unsigned)FuriFlagErrorTimeout) ||
                 (flags == (unsigned)FuriFlagErrorResource)) {
-                bool string_end = ducky_string_next(bad_usb);
+                bool string_end = ducky_program_string_next(bad_usb->program);
                 if(string_end) {
-                    bad_usb->stringdelay = 0;
                     worker_state = BadUsbStateRunning;
                 }
             } else {
@@ -629,8 +437,7 @@ static int32_t bad_usb_worker(void* context) {
     storage_file_close(script_file);
     storage_file_free(script_file);
     furi_string_free(bad_usb->line);
-    furi_string_free(bad_usb->line_prev);
-    furi_string_free(bad_usb->string_print);
+    ducky_program_free(bad_usb->program);
 
     FURI_LOG_I(WORKER_TAG, "End");
 
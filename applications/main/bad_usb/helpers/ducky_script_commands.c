@@ -3,7 +3,7 @@
 #include "ducky_script.h"
 #include "ducky_script_i.h"
 
-typedef int32_t (*DuckyCmdCallback)(BadUsbScript* bad_usb, const char* line, int32_t param);
+typedef int32_t (*DuckyCmdCallback)(DuckyProgram* program, const char* line, int32_t param);
 
 typedef struct {
     char* name;
@@ -11,144 +11,199 @@ typedef struct {
     int32_t param;
 } DuckyCmd;
 
-static int32_t ducky_fnc_delay(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static const uint8_t numpad_keys[10] = {
+    HID_KEYPAD_0,
+    HID_KEYPAD_1,
+    HID_KEYPAD_2,
+    HID_KEYPAD_3,
+    HID_KEYPAD_4,
+    HID_KEYPAD_5,
+    HID_KEYPAD_6,
+    HID_KEYPAD_7,
+    HID_KEYPAD_8,
+    HID_KEYPAD_9,
+};
+
+uint32_t ducky_get_command_len(const char* line) {
+    uint32_t len = strlen(line);
+    for(uint32_t i = 0; i < len; i++) {
+        if(line[i] == ' ') return i;
+    }
+    return 0;
+}
+
+bool ducky_get_number(const char* param, uint32_t* val) {
+    uint32_t value = 0;
+    if(sscanf(param, "%lu", &value) == 1) {
+        *val = value;
+        return true;
+    }
+    return false;
+}
+
+static int32_t ducky_fnc_delay(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
     uint32_t delay_val = 0;
     bool state = ducky_get_number(line, &delay_val);
     if((state) && (delay_val > 0)) {
-        return (int32_t)delay_val;
+        return ducky_emit(program, DuckyOpDelay, delay_val);
     }
 
-    return ducky_error(bad_usb, "Invalid number %s", line);
+    return ducky_error(program, "Invalid number %s", line);
 }
 
-static int32_t ducky_fnc_defdelay(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_defdelay(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_usb->defdelay);
+    uint32_t delay_val = 0;
+    bool state = ducky_get_number(line, &delay_val);
     if(!state) {
-        return ducky_error(bad_usb, "Invalid number %s", line);
+        return ducky_error(program, "Invalid number %s", line);
     }
-    return 0;
+    return ducky_emit(program, DuckyOpDefaultDelay, delay_val);
 }
 
-static int32_t ducky_fnc_strdelay(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_strdelay(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_usb->stringdelay);
+    uint32_t delay_val = 0;
+    bool state = ducky_get_number(line, &delay_val);
     if(!state) {
-        return ducky_error(bad_usb, "Invalid number %s", line);
+        return ducky_error(program, "Invalid number %s", line);
     }
-    return 0;
+    return ducky_emit(program, DuckyOpStringDelay, delay_val);
 }
 
-static int32_t ducky_fnc_string(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_string(DuckyProgram* program, const char* line, int32_t param) {
     line = &line[ducky_get_command_len(line) + 1];
-    furi_string_set_str(bad_usb->string_print, line);
-    if(param == 1) {
-        furi_string_cat(bad_usb->string_print, "\n");
+    size_t len = strlen(line);
+    if(len >= UINT16_MAX) {
+        return ducky_error(program, "String is too long");
     }
 
-    if(bad_usb->stringdelay == 0) { // stringdelay not set - run command immediately
-        bool state = ducky_string(bad_usb, furi_string_get_cstr(bad_usb->string_print));
-        if(!state) {
-            return ducky_error(bad_usb, "Invalid string %s", line);
+    // Keycodes are resolved here, characters missing in the layout are skipped
+    uint16_t* keys = malloc((len + 1) * sizeof(uint16_t));
+    size_t keys_len = 0;
+    for(size_t i = 0; i < len; i++) {
+        uint16_t keycode = BADUSB_ASCII_TO_KEY(program, line[i]);
+        if(keycode != HID_KEYBOARD_NONE) {
+            keys[keys_len++] = keycode;
         }
-    } else { // stringdelay is set - run command in thread to keep handling external events
-        return SCRIPT_STATE_STRING_START;
+    }
+    if(param == 1) {
+        keys[keys_len++] = HID_KEYBOARD_RETURN;
     }
 
-    return 0;
+    int32_t ret = ducky_emit_keys(program, DuckyOpString, keys, keys_len);
+    free(keys);
+    return ret;
 }
 
-static int32_t ducky_fnc_repeat(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_repeat(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_usb->repeat_cnt);
-    if((!state) || (bad_usb->repeat_cnt == 0)) {
-        return ducky_error(bad_usb, "Invalid number %s", line);
+    uint32_t repeat_cnt = 0;
+    bool state = ducky_get_number(line, &repeat_cnt);
+    if((!state) || (repeat_cnt == 0)) {
+        return ducky_error(program, "Invalid number %s", line);
     }
-    return 0;
+    return ducky_emit(program, DuckyOpRepeat, repeat_cnt);
 }
 
-static int32_t ducky_fnc_sysrq(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_sysrq(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    uint16_t key = ducky_get_keycode(bad_usb, line, true);
-    furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release_all();
-    return 0;
+    uint16_t key = ducky_get_keycode(program, line, true);
+    return ducky_emit(program, DuckyOpSysrq, key);
 }
 
-static int32_t ducky_fnc_altchar(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_altchar(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    ducky_numlock_on();
-    bool state = ducky_altchar(line);
-    if(!state) {
-        return ducky_error(bad_usb, "Invalid altchar %s", line);
+    uint16_t keys[8];
+    size_t keys_len = 0;
+    for(; !ducky_is_line_end(line[keys_len]); keys_len++) {
+        char num = line[keys_len];
+        if((num < '0') || (num > '9') || (keys_len == COUNT_OF(keys))) {
+            return ducky_error(program, "Invalid altchar %s", line);
+        }
+        keys[keys_len] = numpad_keys[num - '0'];
     }
-    return 0;
+    if(keys_len == 0) {
+        return ducky_error(program, "Invalid altchar %s", line);
+    }
+    return ducky_emit_keys(program, DuckyOpAltChar, keys, keys_len);
 }
 
-static int32_t ducky_fnc_altstring(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_altstring(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    ducky_numlock_on();
-    bool state = ducky_altstring(line);
-    if(!state) {
-        return ducky_error(bad_usb, "Invalid altstring %s", line);
+    size_t len = strlen(line);
+    if(len >= UINT16_MAX) {
+        return ducky_error(program, "String is too long");
     }
-    return 0;
+
+    // Alt codes are typed as numpad digits, one group per character
+    uint16_t* keys = malloc(len * 4 * sizeof(uint16_t));
+    size_t keys_len = 0;
+    for(size_t i = 0; i < len; i++) {
+        if((line[i] < ' ') || (line[i] > '~')) {
+            continue; // Skip non-printable chars
+        }
+
+        char temp_str[4];
+        size_t digits = snprintf(temp_str, sizeof(temp_str), "%u", line[i]);
+        keys[keys_len++] = digits;
+        for(size_t j = 0; j < digits; j++) {
+            keys[keys_len++] = numpad_keys[temp_str[j] - '0'];
+        }
+    }
+
+    int32_t ret;
+    if((keys_len == 0) || (keys_len > UINT16_MAX)) {
+        ret = ducky_error(program, "Invalid altstring %s", line);
+    } else {
+        ret = ducky_emit_keys(program, DuckyOpAltString, keys, keys_len);
+    }
+    free(keys);
+    return ret;
 }
 
-static int32_t ducky_fnc_hold(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_hold(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    uint16_t key = ducky_get_keycode(bad_usb, line, true);
+    uint16_t key = ducky_get_keycode(program, line, true);
     if(key == HID_KEYBOARD_NONE) {
-        return ducky_error(bad_usb, "No keycode defined for %s", line);
-    }
-    bad_usb->key_hold_nb++;
-    if(bad_usb->key_hold_nb > (HID_KB_MAX_KEYS - 1)) {
-        return ducky_error(bad_usb, "Too many keys are hold");
+        return ducky_error(program, "No keycode defined for %s", line);
     }
-    furi_hal_hid_kb_press(key);
-    return 0;
+    return ducky_emit(program, DuckyOpHold, key);
 }
 
-static int32_t ducky_fnc_release(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_release(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    uint16_t key = ducky_get_keycode(bad_usb, line, true);
+    uint16_t key = ducky_get_keycode(program, line, true);
     if(key == HID_KEYBOARD_NONE) {
-        return ducky_error(bad_usb, "No keycode defined for %s", line);
-    }
-    if(bad_usb->key_hold_nb == 0) {
-        return ducky_error(bad_usb, "No keys are hold");
+        return ducky_error(program, "No keycode defined for %s", line);
     }
-    bad_usb->key_hold_nb--;
-    furi_hal_hid_kb_release(key);
-    return 0;
+    return ducky_emit(program, DuckyOpRelease, key);
 }
 
-static int32_t ducky_fnc_waitforbutton(BadUsbScript* bad_usb, const char* line, int32_t param) {
+static int32_t ducky_fnc_waitforbutton(DuckyProgram* program, const char* line, int32_t param) {
     UNUSED(param);
-    UNUSED(bad_usb);
     UNUSED(line);
 
-    return SCRIPT_STATE_WAIT_FOR_BTN;
+    return ducky_emit(program, DuckyOpWaitForButton, 0);
 }
 
 static const DuckyCmd ducky_commands[] = {
@@ -171,10 +226,7 @@ static const DuckyCmd ducky_commands[] = {
     {"WAIT_FOR_BUTTON_PRESS", ducky_fnc_waitforbutton, -1},
 };
 
-#define TAG "BadUsb"
-#define WORKER_TAG TAG "Worker"
-
-int32_t ducky_execute_cmd(BadUsbScript* bad_usb, const char* line) {
+int32_t ducky_compile_cmd(DuckyProgram* program, const char* line) {
     size_t cmd_word_len = strcspn(line, " ");
     for(size_t i = 0; i < COUNT_OF(ducky_commands); i++) {
         size_t cmd_compare_len = strlen(ducky_commands[i].name);
@@ -185,9 +237,9 @@ int32_t ducky_execute_cmd(BadUsbScript* bad_usb, const char* line) {
 
         if(strncmp(line, ducky_commands[i].name, cmd_compare_len) == 0) {
             if(ducky_commands[i].callback == NULL) {
-                return 0;
+                return ducky_emit(program, DuckyOpNop, 0);
             } else {
-                return ((ducky_commands[i].callback)(bad_usb, line, ducky_commands[i].param));
+                return ((ducky_commands[i].callback)(program, line, ducky_commands[i].param));
             }
         }
     }
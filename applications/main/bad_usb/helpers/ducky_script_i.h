@@ -7,16 +7,61 @@ extern "C" {
 #include <furi.h>
 #include <furi_hal.h>
 #include "ducky_script.h"
-
-#define SCRIPT_STATE_ERROR (-1)
-#define SCRIPT_STATE_END (-2)
-#define SCRIPT_STATE_NEXT_LINE (-3)
-#define SCRIPT_STATE_CMD_UNKNOWN (-4)
-#define SCRIPT_STATE_STRING_START (-5)
-#define SCRIPT_STATE_WAIT_FOR_BTN (-6)
+#include "ducky_script_program.h"
 
 #define FILE_BUFFER_LEN 16
 
+#define BADUSB_ASCII_TO_KEY(script, x) \
+    (((uint8_t)x < 128) ? (script->layout[(uint8_t)x]) : HID_KEYBOARD_NONE)
+
+typedef enum {
+    DuckyOpNone, // Blank line
+    DuckyOpNop, // REM, ID
+    DuckyOpDelay,
+    DuckyOpDefaultDelay,
+    DuckyOpStringDelay,
+    DuckyOpString,
+    DuckyOpKey,
+    DuckyOpSysrq,
+    DuckyOpAltChar,
+    DuckyOpAltString,
+    DuckyOpRepeat,
+    DuckyOpHold,
+    DuckyOpRelease,
+    DuckyOpWaitForButton,
+} DuckyOpCode;
+
+/** Compiled script line. Ops carrying key sequences refer to the key pool */
+typedef struct {
+    uint8_t code;
+    uint16_t keys_len;
+    uint32_t arg;
+} DuckyOp;
+
+struct DuckyProgram {
+    BadUsbState* st;
+    const uint16_t* layout;
+    const DuckyHidSink* sink;
+    void* sink_context;
+
+    DuckyOp* ops;
+    size_t ops_count;
+    size_t ops_size;
+    uint16_t* keys;
+    size_t keys_count;
+    size_t keys_size;
+    size_t line_base;
+
+    size_t pc;
+    uint32_t defdelay;
+    uint32_t stringdelay;
+    uint32_t repeat_cnt;
+    size_t repeat_op;
+    uint8_t key_hold_nb;
+    size_t string_op;
+    size_t string_pos;
+};
+
 struct BadUsbScript {
     FuriHalUsbHidConfig hid_cfg;
     FuriThread* thread;
@@ -28,20 +73,13 @@ struct BadUsbScript {
     uint8_t buf_len;
     bool file_end;
 
-    uint32_t defdelay;
-    uint32_t stringdelay;
     uint16_t layout[128];
 
     FuriString* line;
-    FuriString* line_prev;
-    uint32_t repeat_cnt;
-    uint8_t key_hold_nb;
-
-    FuriString* string_print;
-    size_t string_print_pos;
+    DuckyProgram* program;
 };
 
-uint16_t ducky_get_keycode(BadUsbScript* bad_usb, const char* param, bool accept_chars);
+uint16_t ducky_get_keycode(DuckyProgram* program, const char* param, bool accept_chars);
 
 uint32_t ducky_get_command_len(const char* line);
 
@@ -51,19 +89,17 @@ uint16_t ducky_get_keycode_by_name(const char* param);
 
 bool ducky_get_number(const char* param, uint32_t* val);
 
-void ducky_numlock_on(void);
-
-bool ducky_numpad_press(const char num);
-
-bool ducky_altchar(const char* charcode);
-
-bool ducky_altstring(const char* param);
+int32_t ducky_compile_cmd(DuckyProgram* program, const char* line);
 
-bool ducky_string(BadUsbScript* bad_usb, const char* param);
+int32_t ducky_emit(DuckyProgram* program, DuckyOpCode code, uint32_t arg);
 
-int32_t ducky_execute_cmd(BadUsbScript* bad_usb, const char* line);
+int32_t ducky_emit_keys(
+    DuckyProgram* program,
+    DuckyOpCode code,
+    const uint16_t* keys,
+    size_t keys_len);
 
-int32_t ducky_error(BadUsbScript* bad_usb, const char* text, ...);
+int32_t ducky_error(DuckyProgram* program, const char* text, ...);
 
 #ifdef __cplusplus
 }
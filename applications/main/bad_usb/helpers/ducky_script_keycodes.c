@@ -66,6 +66,10 @@ static const DuckyKey ducky_keys[] = {
     {"F12", HID_KEYBOARD_F12},
 };
 
+bool ducky_is_line_end(const char chr) {
+    return ((chr == ' ') || (chr == '\0') || (chr == '\r') || (chr == '\n'));
+}
+
 uint16_t ducky_get_keycode_by_name(const char* param) {
     for(size_t i = 0; i < COUNT_OF(ducky_keys); i++) {
         size_t key_cmd_len = strlen(ducky_keys[i].name);
@@ -77,3 +81,15 @@ uint16_t ducky_get_keycode_by_name(const char* param) {
 
     return HID_KEYBOARD_NONE;
 }
+
+uint16_t ducky_get_keycode(DuckyProgram* program, const char* param, bool accept_chars) {
+    uint16_t keycode = ducky_get_keycode_by_name(param);
+    if(keycode != HID_KEYBOARD_NONE) {
+        return keycode;
+    }
+
+    if((accept_chars) && (strlen(param) > 0)) {
+        return (BADUSB_ASCII_TO_KEY(program, param[0]) & 0xFF);
+    }
+    return 0;
+}
@@ -0,0 +1,378 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_hal_usb_hid.h>
+#include "ducky_script.h"
+#include "ducky_script_i.h"
+
+#define TAG "BadUsb"
+#define WORKER_TAG TAG "Worker"
+
+static bool ducky_hid_usb_kb_press(void* context, const uint16_t* keys, size_t count) {
+    UNUSED(context);
+    return furi_hal_hid_kb_press_multi(keys, count);
+}
+
+static bool ducky_hid_usb_kb_release(void* context, const uint16_t* keys, size_t count) {
+    UNUSED(context);
+    return furi_hal_hid_kb_release_multi(keys, count);
+}
+
+static bool ducky_hid_usb_kb_roll(void* context, uint16_t release_key, uint16_t press_key) {
+    UNUSED(context);
+    return furi_hal_hid_kb_roll(release_key, press_key);
+}
+
+static bool ducky_hid_usb_kb_release_all(void* context) {
+    UNUSED(context);
+    return furi_hal_hid_kb_release_all();
+}
+
+static uint8_t ducky_hid_usb_get_led_state(void* context) {
+    UNUSED(context);
+    return furi_hal_hid_get_led_state();
+}
+
+const DuckyHidSink ducky_hid_sink_usb = {
+    .kb_press = ducky_hid_usb_kb_press,
+    .kb_release = ducky_hid_usb_kb_release,
+    .kb_roll = ducky_hid_usb_kb_roll,
+    .kb_release_all = ducky_hid_usb_kb_release_all,
+    .get_led_state = ducky_hid_usb_get_led_state,
+};
+
+DuckyProgram* ducky_program_alloc(BadUsbState* st, const uint16_t* layout) {
+    furi_assert(st);
+    furi_assert(layout);
+
+    DuckyProgram* program = malloc(sizeof(DuckyProgram));
+    program->st = st;
+    program->layout = layout;
+    program->sink = &ducky_hid_sink_usb;
+    program->sink_context = NULL;
+    program->ops = NULL;
+    program->ops_size = 0;
+    program->keys = NULL;
+    program->keys_size = 0;
+    ducky_program_reset(program);
+    return program;
+}
+
+void ducky_program_free(DuckyProgram* program) {
+    furi_assert(program);
+    free(program->ops);
+    free(program->keys);
+    free(program);
+}
+
+void ducky_program_set_hid_sink(DuckyProgram* program, const DuckyHidSink* sink, void* context) {
+    furi_assert(program);
+    furi_assert(sink);
+    program->sink = sink;
+    program->sink_context = context;
+}
+
+void ducky_program_reset(DuckyProgram* program) {
+    furi_assert(program);
+    program->ops_count = 0;
+    program->keys_count = 0;
+    program->line_base = 0;
+
+    program->pc = 0;
+    program->defdelay = 0;
+    program->stringdelay = 0;
+    program->repeat_cnt = 0;
+    program->key_hold_nb = 0;
+}
+
+void ducky_program_next_chunk(DuckyProgram* program) {
+    furi_assert(program);
+    furi_assert(program->pc == program->ops_count);
+    furi_assert(program->repeat_cnt == 0);
+
+    if(program->ops_count == 0) return;
+
+    // Keep the last line as the first one of the chunk, so it can be repeated
+    DuckyOp* last = &program->ops[program->ops_count - 1];
+    if(last->keys_len > 0) {
+        memmove(program->keys, &program->keys[last->arg], last->keys_len * sizeof(uint16_t));
+        last->arg = 0;
+    }
+    program->keys_count = last->keys_len;
+    program->ops[0] = *last;
+
+    program->line_base += program->ops_count - 1;
+    program->ops_count = 1;
+    program->pc = 1;
+}
+
+int32_t ducky_emit(DuckyProgram* program, DuckyOpCode code, uint32_t arg) {
+    if(program->ops_count == program->ops_size) {
+        program->ops_size = MAX(program->ops_size * 2, 16U);
+        program->ops = realloc(program->ops, program->ops_size * sizeof(DuckyOp)); //-V701
+    }
+
+    DuckyOp* op = &program->ops[program->ops_count++];
+    op->code = code;
+    op->keys_len = 0;
+    op->arg = arg;
+    return 0;
+}
+
+int32_t ducky_emit_keys(
+    DuckyProgram* program,
+    DuckyOpCode code,
+    const uint16_t* keys,
+    size_t keys_len) {
+    furi_check(keys_len <= UINT16_MAX);
+
+    if(program->keys_count + keys_len > program->keys_size) {
+        program->keys_size = MAX(program->keys_size * 2, program->keys_count + keys_len);
+        program->keys = realloc(program->keys, program->keys_size * sizeof(uint16_t)); //-V701
+    }
+    if(keys_len > 0) {
+        memcpy(&program->keys[program->keys_count], keys, keys_len * sizeof(uint16_t));
+    }
+
+    ducky_emit(program, code, program->keys_count);
+    program->ops[program->ops_count - 1].keys_len = keys_len;
+    program->keys_count += keys_len;
+    return 0;
+}
+
+int32_t ducky_error(DuckyProgram* program, const char* text, ...) {
+    va_list args;
+    va_start(args, text);
+
+    vsnprintf(program->st->error, sizeof(program->st->error), text, args);
+
+    va_end(args);
+    return SCRIPT_STATE_ERROR;
+}
+
+static int32_t ducky_compile_keys(DuckyProgram* program, const char* line) {
+    // Special keys + modifiers
+    uint16_t key = ducky_get_keycode(program, line, false);
+    if(key == HID_KEYBOARD_NONE) {
+        return ducky_error(program, "No keycode defined for %s", line);
+    }
+    if((key & 0xFF00) != 0) {
+        // It's a modifier key
+        line = &line[ducky_get_command_len(line) + 1];
+        key |= ducky_get_keycode(program, line, true);
+    }
+    return ducky_emit(program, DuckyOpKey, key);
+}
+
+bool ducky_program_add_line(DuckyProgram* program, FuriString* line) {
+    furi_assert(program);
+    furi_assert(line);
+
+    furi_string_trim(line);
+    const char* line_tmp = furi_string_get_cstr(line);
+
+    int32_t ret = 0;
+    if(furi_string_empty(line)) {
+        ret = ducky_emit(program, DuckyOpNone, 0);
+    } else {
+        // Ducky Lang Functions
+        ret = ducky_compile_cmd(program, line_tmp);
+        if(ret == SCRIPT_STATE_CMD_UNKNOWN) {
+            ret = ducky_compile_keys(program, line_tmp);
+        }
+    }
+
+    if(ret == SCRIPT_STATE_ERROR) {
+        program->st->error_line = program->line_base + program->ops_count + 1;
+        FURI_LOG_E(WORKER_TAG, "Unknown command at line %zu", program->st->error_line);
+        return false;
+    }
+    return true;
+}
+
+size_t ducky_program_get_size(const DuckyProgram* program) {
+    furi_assert(program);
+    return program->ops_count * sizeof(DuckyOp) + program->keys_count * sizeof(uint16_t);
+}
+
+static void
+    ducky_program_press_release(DuckyProgram* program, const uint16_t* keys, size_t count) {
+    program->sink->kb_press(program->sink_context, keys, count);
+    program->sink->kb_release(program->sink_context, keys, count);
+}
+
+static void ducky_program_type(DuckyProgram* program, const uint16_t* keys, size_t count) {
+    const DuckyHidSink* sink = program->sink;
+
+    // Every report brings one new key, so the host cannot reorder them. The next key
+    // replaces the previous one in the same report unless it repeats it or needs
+    // other modifiers, then the previous key is released on its own.
+    for(size_t i = 0; i < count; i++) {
+        if(i == 0) {
+            sink->kb_press(program->sink_context, &keys[i], 1);
+        } else if(
+            ((keys[i - 1] & 0xFF00) == (keys[i] & 0xFF00)) &&
+            ((keys[i - 1] & 0xFF) != (keys[i] & 0xFF))) {
+            sink->kb_roll(program->sink_context, keys[i - 1], keys[i]);
+        } else {
+            sink->kb_release(program->sink_context, &keys[i - 1], 1);
+            sink->kb_press(program->sink_context, &keys[i], 1);
+        }
+    }
+
+    if(count > 0) {
+        sink->kb_release(program->sink_context, &keys[count - 1], 1);
+    }
+}
+
+static void ducky_program_numlock_on(DuckyProgram* program) {
+    if((program->sink->get_led_state(program->sink_context) & HID_KB_LED_NUM) == 0) {
+        const uint16_t key = HID_KEYBOARD_LOCK_NUM_LOCK;
+        ducky_program_press_release(program, &key, 1);
+    }
+}
+
+static void ducky_program_altchar(DuckyProgram* program, const uint16_t* keys, size_t count) {
+    const uint16_t alt = KEY_MOD_LEFT_ALT;
+
+    program->sink->kb_press(program->sink_context, &alt, 1);
+    for(size_t i = 0; i < count; i++) {
+        ducky_program_press_release(program, &keys[i], 1);
+    }
+    program->sink->kb_release(program->sink_context, &alt, 1);
+}
+
+static int32_t ducky_program_exec(DuckyProgram* program, size_t index) {
+    const DuckyOp* op = &program->ops[index];
+    const uint16_t* keys = (op->keys_len > 0) ? &program->keys[op->arg] : NULL;
+    const DuckyHidSink* sink = program->sink;
+
+    switch(op->code) {
+    case DuckyOpNone:
+        return SCRIPT_STATE_NEXT_LINE;
+    case DuckyOpNop:
+        return 0;
+    case DuckyOpDelay:
+        return op->arg;
+    case DuckyOpDefaultDelay:
+        program->defdelay = op->arg;
+        return 0;
+    case DuckyOpStringDelay:
+        program->stringdelay = op->arg;
+        return 0;
+    case DuckyOpString:
+        if(program->stringdelay == 0) { // stringdelay not set - run command immediately
+            ducky_program_type(program, keys, op->keys_len);
+        } else { // stringdelay is set - run command in thread to keep handling external events
+            program->string_op = index;
+            program->string_pos = 0;
+            return SCRIPT_STATE_STRING_START;
+        }
+        return 0;
+    case DuckyOpKey: {
+        const uint16_t key = op->arg;
+        ducky_program_press_release(program, &key, 1);
+        return 0;
+    }
+    case DuckyOpSysrq: {
+        const uint16_t sysrq = KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN;
+        const uint16_t key = op->arg;
+        sink->kb_press(program->sink_context, &sysrq, 1);
+        sink->kb_press(program->sink_context, &key, 1);
+        sink->kb_release_all(program->sink_context);
+        return 0;
+    }
+    case DuckyOpAltChar:
+        ducky_program_numlock_on(program);
+        ducky_program_altchar(program, keys, op->keys_len);
+        return 0;
+    case DuckyOpAltString:
+        ducky_program_numlock_on(program);
+        for(size_t i = 0; i < op->keys_len; i += keys[i] + 1) {
+            ducky_program_altchar(program, &keys[i + 1], keys[i]);
+        }
+        return 0;
+    case DuckyOpRepeat:
+        // Repeating the first line or another REPEAT does nothing
+        if((index > 0) && (program->ops[index - 1].code != DuckyOpRepeat)) {
+            program->repeat_cnt = op->arg;
+            program->repeat_op = index - 1;
+        }
+        return 0;
+    case DuckyOpHold: {
+        const uint16_t key = op->arg;
+        program->key_hold_nb++;
+        if(program->key_hold_nb > (HID_KB_MAX_KEYS - 1)) {
+            return ducky_error(program, "Too many keys are hold");
+        }
+        sink->kb_press(program->sink_context, &key, 1);
+        return 0;
+    }
+    case DuckyOpRelease: {
+        const uint16_t key = op->arg;
+        if(program->key_hold_nb == 0) {
+            return ducky_error(program, "No keys are hold");
+        }
+        program->key_hold_nb--;
+        sink->kb_release(program->sink_context, &key, 1);
+        return 0;
+    }
+    case DuckyOpWaitForButton:
+        return SCRIPT_STATE_WAIT_FOR_BTN;
+    }
+
+    furi_crash();
+}
+
+int32_t ducky_program_step(DuckyProgram* program) {
+    furi_assert(program);
+
+    size_t index = 0;
+    if(program->repeat_cnt > 0) {
+        program->repeat_cnt--;
+        index = program->repeat_op;
+    } else if(program->pc < program->ops_count) {
+        index = program->pc++;
+        program->st->line_cur = program->line_base + index + 1;
+    } else {
+        return SCRIPT_STATE_END;
+    }
+
+    int32_t delay_val = ducky_program_exec(program, index);
+    if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
+        return 0;
+    } else if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
+        return delay_val;
+    } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
+        return delay_val;
+    } else if(delay_val < 0) { // Script error
+        program->st->error_line = program->line_base + index + 1;
+        FURI_LOG_E(WORKER_TAG, "Script error at line %zu", program->st->error_line);
+        return SCRIPT_STATE_ERROR;
+    }
+    return (delay_val + program->defdelay);
+}
+
+bool ducky_program_string_next(DuckyProgram* program) {
+    furi_assert(program);
+
+    const DuckyOp* op = &program->ops[program->string_op];
+    if(program->string_pos >= op->keys_len) {
+        program->stringdelay = 0;
+        return true;
+    }
+
+    ducky_program_press_release(program, &program->keys[op->arg + program->string_pos], 1);
+    program->string_pos++;
+
+    return false;
+}
+
+uint32_t ducky_program_get_default_delay(const DuckyProgram* program) {
+    furi_assert(program);
+    return program->defdelay;
+}
+
+uint32_t ducky_program_get_string_delay(const DuckyProgram* program) {
+    furi_assert(program);
+    return program->stringdelay;
+}
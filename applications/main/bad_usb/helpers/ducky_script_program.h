@@ -0,0 +1,126 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <furi.h>
+#include "ducky_script.h"
+
+#define SCRIPT_STATE_ERROR (-1)
+#define SCRIPT_STATE_END (-2)
+#define SCRIPT_STATE_NEXT_LINE (-3)
+#define SCRIPT_STATE_CMD_UNKNOWN (-4)
+#define SCRIPT_STATE_STRING_START (-5)
+#define SCRIPT_STATE_WAIT_FOR_BTN (-6)
+
+/** Compiled code size after which the script is compiled and executed in chunks */
+#define DUCKY_PROGRAM_SIZE_MAX (16 * 1024)
+
+/** HID keyboard output of the script executor
+ *
+ * Every call sends one report. Roll releases a key and presses the next one
+ * in the same report, so each report brings at most one new key.
+ */
+typedef struct {
+    bool (*kb_press)(void* context, const uint16_t* keys, size_t count);
+    bool (*kb_release)(void* context, const uint16_t* keys, size_t count);
+    bool (*kb_roll)(void* context, uint16_t release_key, uint16_t press_key);
+    bool (*kb_release_all)(void* context);
+    uint8_t (*get_led_state)(void* context);
+} DuckyHidSink;
+
+/** USB HID keyboard sink */
+extern const DuckyHidSink ducky_hid_sink_usb;
+
+typedef struct DuckyProgram DuckyProgram;
+
+/** Allocate program
+ *
+ * @param      st      script state, receives current line and errors
+ * @param      layout  keyboard layout used to resolve characters, 128 entries
+ *
+ * @return     DuckyProgram instance
+ */
+DuckyProgram* ducky_program_alloc(BadUsbState* st, const uint16_t* layout);
+
+/** Free program
+ *
+ * @param      program  DuckyProgram instance
+ */
+void ducky_program_free(DuckyProgram* program);
+
+/** Set HID output, USB HID is used by default
+ *
+ * @param      program  DuckyProgram instance
+ * @param      sink     DuckyHidSink instance
+ * @param      context  sink context
+ */
+void ducky_program_set_hid_sink(DuckyProgram* program, const DuckyHidSink* sink, void* context);
+
+/** Drop compiled code and reset execution state
+ *
+ * @param      program  DuckyProgram instance
+ */
+void ducky_program_reset(DuckyProgram* program);
+
+/** Drop executed code before compiling the next chunk of the script
+ *
+ * Execution state is kept, the last line stays available for REPEAT.
+ *
+ * @param      program  DuckyProgram instance
+ */
+void ducky_program_next_chunk(DuckyProgram* program);
+
+/** Compile script line and append it to the program
+ *
+ * @param      program  DuckyProgram instance
+ * @param      line     script line, trimmed in place
+ *
+ * @return     true on success, false on syntax error (see BadUsbState error)
+ */
+bool ducky_program_add_line(DuckyProgram* program, FuriString* line);
+
+/** Get compiled code size
+ *
+ * @param      program  DuckyProgram instance
+ *
+ * @return     size in bytes
+ */
+size_t ducky_program_get_size(const DuckyProgram* program);
+
+/** Execute next line
+ *
+ * @param      program  DuckyProgram instance
+ *
+ * @return     delay before the next line in ms or SCRIPT_STATE_* code
+ */
+int32_t ducky_program_step(DuckyProgram* program);
+
+/** Type next character of the STRING started with delays
+ *
+ * @param      program  DuckyProgram instance
+ *
+ * @return     true if the string is over
+ */
+bool ducky_program_string_next(DuckyProgram* program);
+
+/** Get DEFAULT_DELAY value
+ *
+ * @param      program  DuckyProgram instance
+ *
+ * @return     delay in ms
+ */
+uint32_t ducky_program_get_default_delay(const DuckyProgram* program);
+
+/** Get STRINGDELAY value
+ *
+ * @param      program  DuckyProgram instance
+ *
+ * @return     delay in ms
+ */
+uint32_t ducky_program_get_string_delay(const DuckyProgram* program);
+
+#ifdef __cplusplus
+}
+#endif
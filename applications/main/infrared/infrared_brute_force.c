@@ -22,7 +22,6 @@ struct InfraredBruteForce {
     FlipperFormat* ff;
     const char* db_filename;
     FuriString* current_record_name;
-    InfraredSignal* current_signal;
     InfraredBruteForceRecordDict_t records;
     bool is_started;
 };
@@ -31,7 +30,6 @@ InfraredBruteForce* infrared_brute_force_alloc() {
     InfraredBruteForce* brute_force = malloc(sizeof(InfraredBruteForce));
     brute_force->ff = NULL;
     brute_force->db_filename = NULL;
-    brute_force->current_signal = NULL;
     brute_force->is_started = false;
     brute_force->current_record_name = furi_string_alloc();
     InfraredBruteForceRecordDict_init(brute_force->records);
@@ -113,7 +111,6 @@ bool infrared_brute_force_start(
     if(*record_count) {
         Storage* storage = furi_record_open(RECORD_STORAGE);
         brute_force->ff = flipper_format_buffered_file_alloc(storage);
-        brute_force->current_signal = infrared_signal_alloc();
         brute_force->is_started = true;
         success =
             flipper_format_buffered_file_open_existing(brute_force->ff, brute_force->db_filename);
@@ -129,9 +126,7 @@ bool infrared_brute_force_is_started(const InfraredBruteForce* brute_force) {
 void infrared_brute_force_stop(InfraredBruteForce* brute_force) {
     furi_assert(brute_force->is_started);
     furi_string_reset(brute_force->current_record_name);
-    infrared_signal_free(brute_force->current_signal);
     flipper_format_free(brute_force->ff);
-    brute_force->current_signal = NULL;
     brute_force->ff = NULL;
     brute_force->is_started = false;
     furi_record_close(RECORD_STORAGE);
@@ -139,14 +134,8 @@ void infrared_brute_force_stop(InfraredBruteForce* brute_force) {
 
 bool infrared_brute_force_send_next(InfraredBruteForce* brute_force) {
     furi_assert(brute_force->is_started);
-    const bool success = infrared_signal_search_by_name_and_read(
-        brute_force->current_signal,
-        brute_force->ff,
-        furi_string_get_cstr(brute_force->current_record_name));
-    if(success) {
-        infrared_signal_transmit(brute_force->current_signal);
-    }
-    return success;
+    return infrared_signal_search_by_name_and_transmit(
+        brute_force->ff, furi_string_get_cstr(brute_force->current_record_name));
 }
 
 void infrared_brute_force_add_record(
@@ -5,6 +5,7 @@
 #include <furi_hal_infrared.h>
 #include <flipper_format.h>
 #include <toolbox/args.h>
+#include <toolbox/dir_walk.h>
 #include <m-dict.h>
 
 #include "infrared_signal.h"
@@ -12,7 +13,10 @@
 
 #define INFRARED_CLI_BUF_SIZE 10
 #define INFRARED_ASSETS_FOLDER "infrared/assets"
+#define INFRARED_CLI_FILE_EXTENSION ".ir"
 #define INFRARED_BRUTE_FORCE_DUMMY_INDEX 0
+#define INFRARED_CLI_DECODE_TOLERANCE_PERCENT 25
+#define INFRARED_CLI_DECODE_TOLERANCE_US 200U
 
 DICT_DEF2(dict_signals, FuriString*, FURI_STRING_OPLIST, int, M_DEFAULT_OPLIST)
 
@@ -83,6 +87,7 @@ static void infrared_cli_print_usage(void) {
         INFRARED_MIN_FREQUENCY,
         INFRARED_MAX_FREQUENCY);
     printf("\tir decode <input_file> [<output_file>]\r\n");
+    printf("\tir decode <input_dir> <output_dir>\r\n");
     printf("\tir universal <remote_name> <signal_name>\r\n");
     printf("\tir universal list <remote_name>\r\n");
     // TODO FL-3496: Do not hardcode universal remote names
@@ -201,63 +206,146 @@ static bool
     return ret;
 }
 
-static bool infrared_cli_decode_raw_signal(
-    const InfraredRawSignal* raw_signal,
-    InfraredDecoderHandler* decoder,
-    FlipperFormat* output_file,
-    const char* signal_name) {
-    InfraredSignal* signal = infrared_signal_alloc();
-    bool ret = false, level = true, is_decoded = false;
+typedef struct {
+    uint32_t files;
+    uint32_t raw_signals;
+    uint32_t decoded_signals;
+    uint32_t duplicate_signals;
+} InfraredCliDecodeStats;
 
-    size_t i;
-    for(i = 0; i < raw_signal->timings_size; ++i) {
-        // TODO FL-3523: Any infrared_check_decoder_ready() magic?
-        const InfraredMessage* message = infrared_decode(decoder, level, raw_signal->timings[i]);
+static void infrared_cli_add_decoded_message(
+    const InfraredMessage* message,
+    InfraredMessage* first_message,
+    size_t* message_count,
+    bool* is_single) {
+    if(!message) return;
 
-        if(message) {
-            is_decoded = true;
-            printf(
-                "Protocol: %s address: 0x%lX command: 0x%lX %s\r\n",
-                infrared_get_protocol_name(message->protocol),
-                message->address,
-                message->command,
-                (message->repeat ? "R" : ""));
-            if(output_file && !message->repeat) {
-                infrared_signal_set_message(signal, message);
-                if(!infrared_cli_save_signal(signal, output_file, signal_name)) break;
-            }
+    printf(
+        "Protocol: %s address: 0x%lX command: 0x%lX %s\r\n",
+        infrared_get_protocol_name(message->protocol),
+        message->address,
+        message->command,
+        (message->repeat ? "R" : ""));
+
+    if(!*message_count) {
+        *first_message = *message;
+        first_message->repeat = false;
+    } else if(
+        (message->protocol != first_message->protocol) ||
+        (message->address != first_message->address) ||
+        (message->command != first_message->command)) {
+        *is_single = false;
+    }
+    ++(*message_count);
+}
+
+static bool infrared_cli_timing_matches(uint32_t raw_timing, uint32_t encoded_timing) {
+    const uint32_t tolerance = MAX(
+        encoded_timing * INFRARED_CLI_DECODE_TOLERANCE_PERCENT / 100,
+        INFRARED_CLI_DECODE_TOLERANCE_US);
+    const uint32_t difference = (raw_timing > encoded_timing) ? raw_timing - encoded_timing :
+                                                                encoded_timing - raw_timing;
+    return difference <= tolerance;
+}
+
+/* Message is encoded as many times as it is sent, without leading and trailing silence */
+static bool infrared_cli_raw_signal_matches(
+    const InfraredRawSignal* raw_signal,
+    const InfraredMessage* message) {
+    InfraredEncoderHandler* encoder = infrared_alloc_encoder();
+    infrared_reset_encoder(encoder, message);
+
+    size_t frames_left = MAX(infrared_get_protocol_min_repeat_count(message->protocol), 1U);
+    size_t index = 0;
+    uint32_t timing = 0;
+    bool timing_level = false;
+    bool is_matching = true;
+
+    while(is_matching && frames_left) {
+        uint32_t duration;
+        bool level;
+        const InfraredStatus status = infrared_encode(encoder, &duration, &level);
+        if(status == InfraredStatusError) {
+            is_matching = false;
+            break;
         }
+        if(status == InfraredStatusDone) --frames_left;
 
-        level = !level;
+        /* Timings of the same level are merged, as the receiver sees them */
+        if(level == timing_level) {
+            timing += duration;
+            continue;
+        }
+        if(timing && (index || timing_level)) {
+            is_matching = (index < raw_signal->timings_size) &&
+                          infrared_cli_timing_matches(raw_signal->timings[index], timing);
+            ++index;
+        }
+        timing = duration;
+        timing_level = level;
     }
 
-    if(i == raw_signal->timings_size) {
-        if(!is_decoded && output_file) {
-            infrared_signal_set_raw_signal(
-                signal,
-                raw_signal->timings,
-                raw_signal->timings_size,
-                raw_signal->frequency,
-                raw_signal->duty_cycle);
-            ret = infrared_cli_save_signal(signal, output_file, signal_name);
-        } else {
-            ret = true;
+    if(is_matching && timing_level) {
+        is_matching = (index < raw_signal->timings_size) &&
+                      infrared_cli_timing_matches(raw_signal->timings[index], timing);
+        ++index;
+    }
+
+    infrared_free_encoder(encoder);
+
+    return is_matching && (index == raw_signal->timings_size);
+}
+
+/* Raw signal is replaced only if the message encodes back to its timings, so nothing is lost */
+static bool infrared_cli_decode_raw_signal(
+    const InfraredRawSignal* raw_signal,
+    InfraredDecoderHandler* decoder,
+    InfraredMessage* message) {
+    bool level = true, is_single = true;
+    size_t message_count = 0;
+
+    for(size_t i = 0; i < raw_signal->timings_size; ++i) {
+        const uint32_t timing = raw_signal->timings[i];
+        if(timing > INFRARED_RAW_RX_TIMING_DELAY_US) {
+            infrared_cli_add_decoded_message(
+                infrared_check_decoder_ready(decoder), message, &message_count, &is_single);
         }
+        infrared_cli_add_decoded_message(
+            infrared_decode(decoder, level, timing), message, &message_count, &is_single);
+        level = !level;
     }
+    infrared_cli_add_decoded_message(
+        infrared_check_decoder_ready(decoder), message, &message_count, &is_single);
 
     infrared_reset_decoder(decoder);
-    infrared_signal_free(signal);
-    return ret;
+
+    if(!message_count) return false;
+    if(!is_single) {
+        printf("Different messages, keeping raw signal\r\n");
+        return false;
+    }
+    if(!infrared_cli_raw_signal_matches(raw_signal, message)) {
+        printf("Timings or frame count differ from the message, keeping raw signal\r\n");
+        return false;
+    }
+    return true;
 }
 
-static bool infrared_cli_decode_file(FlipperFormat* input_file, FlipperFormat* output_file) {
+static bool infrared_cli_decode_file(
+    FlipperFormat* input_file,
+    FlipperFormat* output_file,
+    InfraredCliDecodeStats* stats) {
     bool ret = false;
 
     InfraredSignal* signal = infrared_signal_alloc();
     InfraredDecoderHandler* decoder = infrared_alloc_decoder();
 
-    FuriString* tmp;
+    FuriString *tmp, *key;
     tmp = furi_string_alloc();
+    key = furi_string_alloc();
+
+    dict_signals_t saved_signals;
+    dict_signals_init(saved_signals);
 
     while(infrared_signal_read(signal, input_file, tmp)) {
         ret = false;
@@ -265,94 +353,220 @@ static bool infrared_cli_decode_file(FlipperFormat* input_file, FlipperFormat* o
             printf("Invalid signal\r\n");
             break;
         }
-        if(!infrared_signal_is_raw(signal)) {
-            if(output_file &&
-               !infrared_cli_save_signal(signal, output_file, furi_string_get_cstr(tmp))) {
-                break;
-            } else {
-                printf("Skipping decoded signal\r\n");
+        if(infrared_signal_is_raw(signal)) {
+            const InfraredRawSignal* raw_signal = infrared_signal_get_raw_signal(signal);
+            printf(
+                "Raw signal: %s, %zu samples\r\n",
+                furi_string_get_cstr(tmp),
+                raw_signal->timings_size);
+            ++stats->raw_signals;
+
+            InfraredMessage message;
+            if(infrared_cli_decode_raw_signal(raw_signal, decoder, &message)) {
+                infrared_signal_set_message(signal, &message);
+                ++stats->decoded_signals;
+            }
+        } else if(!output_file) {
+            printf("Skipping decoded signal\r\n");
+        }
+
+        if(output_file && !infrared_signal_is_raw(signal)) {
+            const InfraredMessage* message = infrared_signal_get_message(signal);
+            furi_string_printf(
+                key,
+                "%s %s %lX %lX",
+                furi_string_get_cstr(tmp),
+                infrared_get_protocol_name(message->protocol),
+                message->address,
+                message->command);
+            if(dict_signals_get(saved_signals, key)) {
+                printf("Skipping duplicate signal: %s\r\n", furi_string_get_cstr(tmp));
+                ++stats->duplicate_signals;
+                ret = true;
                 continue;
             }
+            dict_signals_set_at(saved_signals, key, 1);
         }
-        const InfraredRawSignal* raw_signal = infrared_signal_get_raw_signal(signal);
-        printf(
-            "Raw signal: %s, %zu samples\r\n",
-            furi_string_get_cstr(tmp),
-            raw_signal->timings_size);
-        if(!infrared_cli_decode_raw_signal(
-               raw_signal, decoder, output_file, furi_string_get_cstr(tmp)))
+
+        if(output_file &&
+           !infrared_cli_save_signal(signal, output_file, furi_string_get_cstr(tmp))) {
             break;
+        }
         ret = true;
     }
 
+    dict_signals_clear(saved_signals);
     infrared_free_decoder(decoder);
     infrared_signal_free(signal);
     furi_string_free(tmp);
+    furi_string_free(key);
 
     return ret;
 }
 
-static void infrared_cli_process_decode(Cli* cli, FuriString* args) {
-    UNUSED(cli);
-    Storage* storage = furi_record_open(RECORD_STORAGE);
+static bool infrared_cli_decode_file_path(
+    Storage* storage,
+    const char* input_path,
+    const char* output_path,
+    InfraredCliDecodeStats* stats) {
     FlipperFormat* input_file = flipper_format_buffered_file_alloc(storage);
     FlipperFormat* output_file = NULL;
-
+    FuriString* header = furi_string_alloc();
     uint32_t version;
-    FuriString *tmp, *header, *input_path, *output_path;
-    tmp = furi_string_alloc();
-    header = furi_string_alloc();
-    input_path = furi_string_alloc();
-    output_path = furi_string_alloc();
+    bool ret = false;
 
     do {
-        if(!args_read_probably_quoted_string_and_trim(args, input_path)) {
-            printf("Wrong arguments.\r\n");
-            infrared_cli_print_usage();
-            break;
-        }
-        args_read_probably_quoted_string_and_trim(args, output_path);
-        if(!flipper_format_buffered_file_open_existing(
-               input_file, furi_string_get_cstr(input_path))) {
-            printf(
-                "Failed to open file for reading: \"%s\"\r\n", furi_string_get_cstr(input_path));
+        if(!flipper_format_buffered_file_open_existing(input_file, input_path)) {
+            printf("Failed to open file for reading: \"%s\"\r\n", input_path);
             break;
         }
         if(!flipper_format_read_header(input_file, header, &version) ||
            (!furi_string_start_with_str(header, "IR")) || version != 1) {
-            printf(
-                "Invalid or corrupted input file: \"%s\"\r\n", furi_string_get_cstr(input_path));
+            printf("Invalid or corrupted input file: \"%s\"\r\n", input_path);
             break;
         }
-        if(!furi_string_empty(output_path)) {
-            printf("Writing output to file: \"%s\"\r\n", furi_string_get_cstr(output_path));
+        if(output_path) {
+            printf("Writing output to file: \"%s\"\r\n", output_path);
             output_file = flipper_format_file_alloc(storage);
         }
-        if(output_file &&
-           !flipper_format_file_open_always(output_file, furi_string_get_cstr(output_path))) {
-            printf(
-                "Failed to open file for writing: \"%s\"\r\n", furi_string_get_cstr(output_path));
+        if(output_file && !flipper_format_file_open_always(output_file, output_path)) {
+            printf("Failed to open file for writing: \"%s\"\r\n", output_path);
             break;
         }
         if(output_file && !flipper_format_write_header(output_file, header, version)) {
-            printf(
-                "Failed to write to the output file: \"%s\"\r\n",
-                furi_string_get_cstr(output_path));
+            printf("Failed to write to the output file: \"%s\"\r\n", output_path);
             break;
         }
-        if(!infrared_cli_decode_file(input_file, output_file)) {
+        if(!infrared_cli_decode_file(input_file, output_file, stats)) {
             break;
         }
-        printf("File successfully decoded.\r\n");
+        ++stats->files;
+        ret = true;
     } while(false);
 
-    furi_string_free(tmp);
     furi_string_free(header);
+    flipper_format_free(input_file);
+    if(output_file) flipper_format_free(output_file);
+
+    return ret;
+}
+
+/* Output tree mirrors the input one, files with errors are reported and skipped */
+static bool infrared_cli_decode_dir(
+    Storage* storage,
+    FuriString* input_path,
+    FuriString* output_path,
+    InfraredCliDecodeStats* stats) {
+    const size_t input_path_size = furi_string_size(input_path);
+    if(furi_string_start_with(output_path, input_path) &&
+       ((furi_string_size(output_path) == input_path_size) ||
+        (furi_string_get_char(output_path, input_path_size) == '/'))) {
+        printf("Output directory can't be inside of the input one\r\n");
+        return false;
+    }
+    if(!storage_simply_mkdir(storage, furi_string_get_cstr(output_path))) {
+        printf("Failed to create directory: \"%s\"\r\n", furi_string_get_cstr(output_path));
+        return false;
+    }
+
+    DirWalk* dir_walk = dir_walk_alloc(storage);
+    FuriString *path, *output_file_path;
+    path = furi_string_alloc();
+    output_file_path = furi_string_alloc();
+    FileInfo fileinfo;
+    bool ret = dir_walk_open(dir_walk, furi_string_get_cstr(input_path));
+    uint32_t failed_files = 0;
+
+    while(ret && (dir_walk_read(dir_walk, path, &fileinfo) == DirWalkOK)) {
+        furi_string_set(output_file_path, output_path);
+        furi_string_cat_str(
+            output_file_path, furi_string_get_cstr(path) + furi_string_size(input_path));
+
+        if(file_info_is_dir(&fileinfo)) {
+            if(!storage_simply_mkdir(storage, furi_string_get_cstr(output_file_path))) {
+                printf(
+                    "Failed to create directory: \"%s\"\r\n",
+                    furi_string_get_cstr(output_file_path));
+                ret = false;
+            }
+        } else if(furi_string_end_with_str(path, INFRARED_CLI_FILE_EXTENSION)) {
+            if(!infrared_cli_decode_file_path(
+                   storage,
+                   furi_string_get_cstr(path),
+                   furi_string_get_cstr(output_file_path),
+                   stats)) {
+                ++failed_files;
+            }
+        }
+    }
+
+    if(failed_files) {
+        printf("Failed to decode %lu file(s)\r\n", failed_files);
+    }
+
+    dir_walk_free(dir_walk);
+    furi_string_free(path);
+    furi_string_free(output_file_path);
+
+    return ret;
+}
+
+static void infrared_cli_trim_path(FuriString* path) {
+    size_t size = furi_string_size(path);
+    while((size > 1) && (furi_string_get_char(path, size - 1) == '/')) {
+        furi_string_left(path, --size);
+    }
+}
+
+static void infrared_cli_process_decode(Cli* cli, FuriString* args) {
+    UNUSED(cli);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    InfraredCliDecodeStats stats = {0};
+
+    FuriString *input_path, *output_path;
+    input_path = furi_string_alloc();
+    output_path = furi_string_alloc();
+
+    do {
+        if(!args_read_probably_quoted_string_and_trim(args, input_path)) {
+            printf("Wrong arguments.\r\n");
+            infrared_cli_print_usage();
+            break;
+        }
+        args_read_probably_quoted_string_and_trim(args, output_path);
+
+        if(storage_dir_exists(storage, furi_string_get_cstr(input_path))) {
+            if(furi_string_empty(output_path)) {
+                printf("Output directory is required.\r\n");
+                break;
+            }
+            infrared_cli_trim_path(input_path);
+            infrared_cli_trim_path(output_path);
+            if(!infrared_cli_decode_dir(storage, input_path, output_path, &stats)) {
+                break;
+            }
+            printf("Directory successfully decoded.\r\n");
+        } else {
+            if(!infrared_cli_decode_file_path(
+                   storage,
+                   furi_string_get_cstr(input_path),
+                   furi_string_empty(output_path) ? NULL : furi_string_get_cstr(output_path),
+                   &stats)) {
+                break;
+            }
+            printf("File successfully decoded.\r\n");
+        }
+        printf(
+            "Files: %lu, raw signals: %lu, decoded: %lu, duplicates removed: %lu\r\n",
+            stats.files,
+            stats.raw_signals,
+            stats.decoded_signals,
+            stats.duplicate_signals);
+    } while(false);
+
     furi_string_free(input_path);
     furi_string_free(output_path);
 
-    flipper_format_free(input_file);
-    if(output_file) flipper_format_free(output_file);
     furi_record_close(RECORD_STORAGE);
 }
 
@@ -5,6 +5,8 @@
 #include <core/check.h>
 #include <infrared_worker.h>
 #include <infrared_transmit.h>
+#include <flipper_format/flipper_format_i.h>
+#include <toolbox/stream/stream.h>
 
 #define TAG "InfraredSignal"
 
@@ -26,6 +28,8 @@
 #define INFRARED_SIGNAL_ADDRESS_KEY "address"
 #define INFRARED_SIGNAL_COMMAND_KEY "command"
 
+#define INFRARED_SIGNAL_STREAM_BUFFER_SIZE 64
+
 struct InfraredSignal {
     bool is_raw;
     union {
@@ -34,6 +38,15 @@ struct InfraredSignal {
     } payload;
 };
 
+typedef struct {
+    Stream* stream;
+    uint8_t buffer[INFRARED_SIGNAL_STREAM_BUFFER_SIZE];
+    size_t size;
+    size_t index;
+    bool is_finished;
+    bool is_error;
+} InfraredSignalStreamReader;
+
 static void infrared_signal_clear_timings(InfraredSignal* signal) {
     if(signal->is_raw) {
         free(signal->payload.raw.timings);
@@ -75,18 +88,26 @@ static bool infrared_signal_is_message_valid(const InfraredMessage* message) {
     return true;
 }
 
-static bool infrared_signal_is_raw_valid(const InfraredRawSignal* raw) {
-    if((raw->frequency > INFRARED_MAX_FREQUENCY) || (raw->frequency < INFRARED_MIN_FREQUENCY)) {
+static bool infrared_signal_is_carrier_valid(uint32_t frequency, float duty_cycle) {
+    if((frequency > INFRARED_MAX_FREQUENCY) || (frequency < INFRARED_MIN_FREQUENCY)) {
         FURI_LOG_E(
             TAG,
             "Frequency is out of range (%X - %X): %lX",
             INFRARED_MIN_FREQUENCY,
             INFRARED_MAX_FREQUENCY,
-            raw->frequency);
+            frequency);
         return false;
 
-    } else if((raw->duty_cycle <= 0) || (raw->duty_cycle > 1)) {
-        FURI_LOG_E(TAG, "Duty cycle is out of range (0 - 1): %f", (double)raw->duty_cycle);
+    } else if((duty_cycle <= 0) || (duty_cycle > 1)) {
+        FURI_LOG_E(TAG, "Duty cycle is out of range (0 - 1): %f", (double)duty_cycle);
+        return false;
+    }
+
+    return true;
+}
+
+static bool infrared_signal_is_raw_valid(const InfraredRawSignal* raw) {
+    if(!infrared_signal_is_carrier_valid(raw->frequency, raw->duty_cycle)) {
         return false;
 
     } else if((raw->timings_size <= 0) || (raw->timings_size > MAX_TIMINGS_AMOUNT)) {
@@ -348,3 +369,180 @@ void infrared_signal_transmit(const InfraredSignal* signal) {
         infrared_send(message, 1);
     }
 }
+
+static bool infrared_signal_stream_peek(InfraredSignalStreamReader* reader, char* c) {
+    if(reader->index == reader->size) {
+        reader->size = stream_read(reader->stream, reader->buffer, sizeof(reader->buffer));
+        reader->index = 0;
+        if(reader->size == 0) return false;
+    }
+
+    *c = reader->buffer[reader->index];
+    return true;
+}
+
+static bool infrared_signal_stream_getc(InfraredSignalStreamReader* reader, char* c) {
+    const bool success = infrared_signal_stream_peek(reader, c);
+    if(success) ++reader->index;
+    return success;
+}
+
+static void infrared_signal_stream_reader_finish(InfraredSignalStreamReader* reader) {
+    // Return read ahead bytes, so that the next FlipperFormat call starts after the data line
+    const int32_t unread = reader->size - reader->index;
+    if(unread) stream_seek(reader->stream, -unread, StreamOffsetFromCurrent);
+}
+
+static bool infrared_signal_stream_seek_to_data(InfraredSignalStreamReader* reader) {
+    const size_t data_key_length = strlen(INFRARED_SIGNAL_DATA_KEY);
+    char key[sizeof(INFRARED_SIGNAL_DATA_KEY)];
+    size_t key_length = 0;
+    bool is_key = true;
+    char c;
+
+    while(infrared_signal_stream_getc(reader, &c)) {
+        if(c == '\n') {
+            is_key = true;
+            key_length = 0;
+        } else if(!is_key) {
+            continue;
+        } else if(c == ':') {
+            is_key = false;
+            if((key_length == data_key_length) &&
+               !strncmp(key, INFRARED_SIGNAL_DATA_KEY, key_length)) {
+                return infrared_signal_stream_getc(reader, &c) && (c == ' ');
+            } else if(
+                (key_length == strlen(INFRARED_SIGNAL_NAME_KEY)) &&
+                !strncmp(key, INFRARED_SIGNAL_NAME_KEY, key_length)) {
+                // Next signal begins, this one has no data
+                return false;
+            }
+        } else if(key_length < data_key_length) {
+            key[key_length++] = c;
+        } else {
+            is_key = false;
+        }
+    }
+
+    return false;
+}
+
+static size_t
+    infrared_signal_stream_read_timings(void* context, uint32_t* timings, size_t timings_cnt) {
+    InfraredSignalStreamReader* reader = context;
+    size_t count = 0;
+    char c;
+
+    while((count < timings_cnt) && !reader->is_finished && !reader->is_error) {
+        while(infrared_signal_stream_peek(reader, &c) && (c == ' ')) {
+            ++reader->index;
+        }
+
+        if(!infrared_signal_stream_peek(reader, &c) || (c == '\r') || (c == '\n')) {
+            reader->is_finished = true;
+            break;
+        }
+
+        uint32_t timing = 0;
+        size_t digits = 0;
+        while(infrared_signal_stream_peek(reader, &c) && (c >= '0') && (c <= '9')) {
+            const uint32_t digit = c - '0';
+            if(timing > (UINT32_MAX - digit) / 10) {
+                FURI_LOG_E(TAG, "Timing is out of range");
+                reader->is_error = true;
+                break;
+            }
+            timing = timing * 10 + digit;
+            ++reader->index;
+            ++digits;
+        }
+
+        if(reader->is_error) {
+            break;
+        } else if(!digits || (infrared_signal_stream_peek(reader, &c) && (c != ' ') &&
+                              (c != '\r') && (c != '\n'))) {
+            FURI_LOG_E(TAG, "Unexpected character in raw data: %c", c);
+            reader->is_error = true;
+        } else if(timing == 0) {
+            FURI_LOG_E(TAG, "Zero timing in raw data");
+            reader->is_error = true;
+        } else {
+            timings[count++] = timing;
+        }
+    }
+
+    if(reader->is_error) {
+        reader->is_finished = true;
+    }
+
+    return count;
+}
+
+static bool infrared_signal_transmit_raw_from_file(FlipperFormat* ff) {
+    bool success = false;
+
+    do {
+        uint32_t frequency;
+        if(!flipper_format_read_uint32(ff, INFRARED_SIGNAL_FREQUENCY_KEY, &frequency, 1)) break;
+
+        float duty_cycle;
+        if(!flipper_format_read_float(ff, INFRARED_SIGNAL_DUTY_CYCLE_KEY, &duty_cycle, 1)) break;
+
+        if(!infrared_signal_is_carrier_valid(frequency, duty_cycle)) break;
+
+        InfraredSignalStreamReader reader = {.stream = flipper_format_get_raw_stream(ff)};
+
+        // Timings are checked as they are sent, unlike infrared_signal_read_raw() the
+        // length is not limited. Malformed data ends the signal and fails the transmit.
+        if(infrared_signal_stream_seek_to_data(&reader)) {
+            success = infrared_send_raw_stream(
+                infrared_signal_stream_read_timings, &reader, true, frequency, duty_cycle);
+            success &= !reader.is_error;
+        }
+
+        infrared_signal_stream_reader_finish(&reader);
+    } while(false);
+
+    return success;
+}
+
+static bool infrared_signal_transmit_body(FlipperFormat* ff) {
+    FuriString* tmp = furi_string_alloc();
+
+    bool success = false;
+
+    do {
+        if(!flipper_format_read_string(ff, INFRARED_SIGNAL_TYPE_KEY, tmp)) break;
+
+        if(furi_string_equal(tmp, INFRARED_SIGNAL_TYPE_RAW)) {
+            if(!infrared_signal_transmit_raw_from_file(ff)) break;
+        } else if(furi_string_equal(tmp, INFRARED_SIGNAL_TYPE_PARSED)) {
+            InfraredSignal signal = {.is_raw = false};
+            if(!infrared_signal_read_message(&signal, ff)) break;
+            infrared_send(&signal.payload.message, 1);
+        } else {
+            FURI_LOG_E(TAG, "Unknown signal type: %s", furi_string_get_cstr(tmp));
+            break;
+        }
+
+        success = true;
+    } while(false);
+
+    furi_string_free(tmp);
+    return success;
+}
+
+bool infrared_signal_search_by_name_and_transmit(FlipperFormat* ff, const char* name) {
+    bool success = false;
+    FuriString* tmp = furi_string_alloc();
+
+    while(infrared_signal_read_name(ff, tmp)) {
+        if(furi_string_equal(tmp, name)) {
+            success = infrared_signal_transmit_body(ff);
+            break;
+        }
+    }
+
+    furi_string_free(tmp);
+    return success;
+}
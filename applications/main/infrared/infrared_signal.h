@@ -194,6 +194,19 @@ bool infrared_signal_search_by_index_and_read(
     FlipperFormat* ff,
     size_t index);
 
+/**
+ * @brief Transmit a signal with a particular name from a FlipperFormat file.
+ *
+ * Same considerations apply as to infrared_signal_search_by_name_and_read(), but the signal
+ * is not kept in memory: raw timings are streamed from the file in fixed-size chunks while
+ * being transmitted, so the memory usage does not depend on the signal length.
+ *
+ * @param[in,out] ff pointer to the FlipperFormat file instance to read from.
+ * @param[in] name pointer to a zero-terminated string containing the requested signal name.
+ * @returns true if a signal was found and successfully transmitted, false otherwise.
+ */
+bool infrared_signal_search_by_name_and_transmit(FlipperFormat* ff, const char* name);
+
 /**
  * @brief Save a signal contained in an InfraredSignal instance to a FlipperFormat file.
  *
@@ -1,4 +1,5 @@
 #include "nfc_supported_cards.h"
+#include "nfc_supported_cards_fingerprint.h"
 #include "../api/nfc_app_api_interface.h"
 
 #include "../plugins/supported_cards/nfc_supported_card_plugin.h"
@@ -7,6 +8,8 @@
 #include <flipper_application/plugins/plugin_manager.h>
 #include <flipper_application/plugins/composite_resolver.h>
 #include <loader/firmware_api/firmware_api.h>
+#include <flipper_format/flipper_format.h>
+#include <bit_lib/bit_lib.h>
 
 #include <furi.h>
 #include <path.h>
@@ -17,6 +20,16 @@
 #define NFC_SUPPORTED_CARDS_PLUGINS_PATH APP_DATA_PATH("plugins")
 #define NFC_SUPPORTED_CARDS_PLUGIN_SUFFIX "_parser.fal"
 
+#define NFC_SUPPORTED_CARDS_INDEX_PATH APP_DATA_PATH(".plugins_index")
+#define NFC_SUPPORTED_CARDS_INDEX_FILE_TYPE "Flipper NFC plugins index"
+#define NFC_SUPPORTED_CARDS_INDEX_VERSION (1)
+
+#define NFC_SUPPORTED_CARDS_FINGERPRINT_SIZE (9)
+#define NFC_SUPPORTED_CARDS_FINGERPRINTS_MAX (16)
+
+// Plugins kept loaded between reads, the least recently used one is unloaded first
+#define NFC_SUPPORTED_CARDS_RESIDENT_PLUGINS_MAX (3)
+
 typedef enum {
     NfcSupportedCardsPluginFeatureHasVerify = (1U << 0),
     NfcSupportedCardsPluginFeatureHasRead = (1U << 1),
@@ -25,8 +38,15 @@ typedef enum {
 
 typedef struct {
     FuriString* path;
+    uint64_t size;
+    uint32_t timestamp;
     NfcProtocol protocol;
     NfcSupportedCardsPluginFeature feature;
+    NfcSupportedCardPluginKeyFingerprint* fingerprints;
+    size_t fingerprints_count;
+    FlipperApplication* app;
+    const NfcSupportedCardsPlugin* plugin;
+    uint32_t last_used;
 } NfcSupportedCardsPluginCache;
 
 ARRAY_DEF(NfcSupportedCardsPluginCache, NfcSupportedCardsPluginCache, M_POD_OPLIST);
@@ -38,96 +58,73 @@ typedef enum {
     NfcSupportedCardsLoadStateFail,
 } NfcSupportedCardsLoadState;
 
-typedef struct {
-    Storage* storage;
-    File* directory;
-    FuriString* file_path;
-    char file_name[256];
-    FlipperApplication* app;
-} NfcSupportedCardsLoadContext;
-
 struct NfcSupportedCards {
+    Storage* storage;
     CompositeApiResolver* api_resolver;
     NfcSupportedCardsPluginCache_t plugins_cache_arr;
     NfcSupportedCardsLoadState load_state;
-    NfcSupportedCardsLoadContext* load_context;
+    uint32_t use_counter;
 };
 
 NfcSupportedCards* nfc_supported_cards_alloc() {
     NfcSupportedCards* instance = malloc(sizeof(NfcSupportedCards));
 
+    instance->storage = furi_record_open(RECORD_STORAGE);
     instance->api_resolver = composite_api_resolver_alloc();
     composite_api_resolver_add(instance->api_resolver, firmware_api_interface);
     composite_api_resolver_add(instance->api_resolver, nfc_application_api_interface);
 
     NfcSupportedCardsPluginCache_init(instance->plugins_cache_arr);
+    instance->load_state = NfcSupportedCardsLoadStateIdle;
+    instance->use_counter = 0;
 
     return instance;
 }
 
-void nfc_supported_cards_free(NfcSupportedCards* instance) {
-    furi_assert(instance);
+static void nfc_supported_cards_plugin_cache_clear(NfcSupportedCardsPluginCache* plugin_cache) {
+    if(plugin_cache->app) {
+        flipper_application_free(plugin_cache->app);
+    }
+    free(plugin_cache->fingerprints);
+    furi_string_free(plugin_cache->path);
+}
 
+static void nfc_supported_cards_cache_reset(NfcSupportedCardsPluginCache_t cache_arr) {
     NfcSupportedCardsPluginCache_it_t iter;
-    for(NfcSupportedCardsPluginCache_it(iter, instance->plugins_cache_arr);
+    for(NfcSupportedCardsPluginCache_it(iter, cache_arr);
         !NfcSupportedCardsPluginCache_end_p(iter);
         NfcSupportedCardsPluginCache_next(iter)) {
-        NfcSupportedCardsPluginCache* plugin_cache = NfcSupportedCardsPluginCache_ref(iter);
-        furi_string_free(plugin_cache->path);
+        nfc_supported_cards_plugin_cache_clear(NfcSupportedCardsPluginCache_ref(iter));
     }
-    NfcSupportedCardsPluginCache_clear(instance->plugins_cache_arr);
-
-    composite_api_resolver_free(instance->api_resolver);
-    free(instance);
-}
-
-static NfcSupportedCardsLoadContext* nfc_supported_cards_load_context_alloc() {
-    NfcSupportedCardsLoadContext* instance = malloc(sizeof(NfcSupportedCardsLoadContext));
-
-    instance->storage = furi_record_open(RECORD_STORAGE);
-    instance->directory = storage_file_alloc(instance->storage);
-    instance->file_path = furi_string_alloc();
-
-    if(!storage_dir_open(instance->directory, NFC_SUPPORTED_CARDS_PLUGINS_PATH)) {
-        FURI_LOG_D(TAG, "Failed to open directory: %s", NFC_SUPPORTED_CARDS_PLUGINS_PATH);
-    }
-
-    return instance;
+    NfcSupportedCardsPluginCache_reset(cache_arr);
 }
 
-static void nfc_supported_cards_load_context_free(NfcSupportedCardsLoadContext* instance) {
-    if(instance->app) {
-        flipper_application_free(instance->app);
-    }
-
-    furi_string_free(instance->file_path);
+void nfc_supported_cards_free(NfcSupportedCards* instance) {
+    furi_assert(instance);
 
-    storage_dir_close(instance->directory);
-    storage_file_free(instance->directory);
+    nfc_supported_cards_cache_reset(instance->plugins_cache_arr);
+    NfcSupportedCardsPluginCache_clear(instance->plugins_cache_arr);
 
+    composite_api_resolver_free(instance->api_resolver);
     furi_record_close(RECORD_STORAGE);
     free(instance);
 }
 
 static const NfcSupportedCardsPlugin* nfc_supported_cards_get_plugin(
-    NfcSupportedCardsLoadContext* instance,
-    const FuriString* path,
-    const ElfApiInterface* api_interface) {
-    furi_assert(instance);
+    FlipperApplication* app,
+    const FuriString* path) {
+    furi_assert(app);
     furi_assert(path);
 
     const NfcSupportedCardsPlugin* plugin = NULL;
     do {
-        if(instance->app) flipper_application_free(instance->app);
-        instance->app = flipper_application_alloc(instance->storage, api_interface);
-        if(flipper_application_preload(instance->app, furi_string_get_cstr(path)) !=
+        if(flipper_application_preload(app, furi_string_get_cstr(path)) !=
            FlipperApplicationPreloadStatusSuccess)
             break;
-        if(!flipper_application_is_plugin(instance->app)) break;
-        if(flipper_application_map_to_memory(instance->app) != FlipperApplicationLoadStatusSuccess)
-            break;
+        if(!flipper_application_is_plugin(app)) break;
+        if(flipper_application_map_to_memory(app) != FlipperApplicationLoadStatusSuccess) break;
         const FlipperAppPluginDescriptor* descriptor =
-            flipper_application_plugin_get_descriptor(instance->app);
+            flipper_application_plugin_get_descriptor(app);
 
         if(descriptor == NULL) break;
 
@@ -140,27 +137,256 @@ static const NfcSupportedCardsPlugin* nfc_supported_cards_get_plugin(
     return plugin;
 }
 
-static const NfcSupportedCardsPlugin* nfc_supported_cards_get_next_plugin(
-    NfcSupportedCardsLoadContext* instance,
-    const ElfApiInterface* api_interface) {
-    const NfcSupportedCardsPlugin* plugin = NULL;
+static void nfc_supported_cards_unload_plugin(NfcSupportedCardsPluginCache* plugin_cache) {
+    flipper_application_free(plugin_cache->app);
+    plugin_cache->app = NULL;
+    plugin_cache->plugin = NULL;
+}
+
+static const NfcSupportedCardsPlugin* nfc_supported_cards_load_plugin(
+    NfcSupportedCards* instance,
+    NfcSupportedCardsPluginCache* plugin_cache) {
+    if(plugin_cache->plugin == NULL) {
+        NfcSupportedCardsPluginCache* lru = NULL;
+        size_t resident_count = 0;
+
+        NfcSupportedCardsPluginCache_it_t iter;
+        for(NfcSupportedCardsPluginCache_it(iter, instance->plugins_cache_arr);
+            !NfcSupportedCardsPluginCache_end_p(iter);
+            NfcSupportedCardsPluginCache_next(iter)) {
+            NfcSupportedCardsPluginCache* resident = NfcSupportedCardsPluginCache_ref(iter);
+            if(resident->app == NULL) continue;
+            resident_count++;
+            if((lru == NULL) || (resident->last_used < lru->last_used)) lru = resident;
+        }
+        if(resident_count >= NFC_SUPPORTED_CARDS_RESIDENT_PLUGINS_MAX) {
+            nfc_supported_cards_unload_plugin(lru);
+        }
+
+        const ElfApiInterface* api_interface = composite_api_resolver_get(instance->api_resolver);
+        plugin_cache->app = flipper_application_alloc(instance->storage, api_interface);
+        plugin_cache->plugin =
+            nfc_supported_cards_get_plugin(plugin_cache->app, plugin_cache->path);
+
+        if(plugin_cache->plugin == NULL) {
+            FURI_LOG_W(TAG, "Failed to load %s", furi_string_get_cstr(plugin_cache->path));
+            nfc_supported_cards_unload_plugin(plugin_cache);
+            // Index is outdated, do not try again in this session
+            plugin_cache->feature = 0;
+        }
+    }
+
+    plugin_cache->last_used = ++instance->use_counter;
+
+    return plugin_cache->plugin;
+}
+
+static bool nfc_supported_cards_fill_cache(
+    NfcSupportedCards* instance,
+    NfcSupportedCardsPluginCache* plugin_cache) {
+    const ElfApiInterface* api_interface = composite_api_resolver_get(instance->api_resolver);
+    FlipperApplication* app = flipper_application_alloc(instance->storage, api_interface);
+
+    const NfcSupportedCardsPlugin* plugin =
+        nfc_supported_cards_get_plugin(app, plugin_cache->path);
+
+    if(plugin) {
+        plugin_cache->protocol = plugin->protocol;
+        if(plugin->verify) {
+            plugin_cache->feature |= NfcSupportedCardsPluginFeatureHasVerify;
+        }
+        if(plugin->read) {
+            plugin_cache->feature |= NfcSupportedCardsPluginFeatureHasRead;
+        }
+        if(plugin->parse) {
+            plugin_cache->feature |= NfcSupportedCardsPluginFeatureHasParse;
+        }
+        if(plugin->fingerprints_count > NFC_SUPPORTED_CARDS_FINGERPRINTS_MAX) {
+            FURI_LOG_W(
+                TAG, "Too many fingerprints in %s", furi_string_get_cstr(plugin_cache->path));
+        } else if(plugin->fingerprints_count > 0) {
+            size_t size =
+                sizeof(NfcSupportedCardPluginKeyFingerprint) * plugin->fingerprints_count;
+            plugin_cache->fingerprints = malloc(size);
+            memcpy(plugin_cache->fingerprints, plugin->fingerprints, size);
+            plugin_cache->fingerprints_count = plugin->fingerprints_count;
+        }
+    }
+
+    flipper_application_free(app);
+
+    return plugin != NULL;
+}
+
+static bool nfc_supported_cards_index_read_entry(
+    FlipperFormat* ff,
+    FuriString* name,
+    NfcSupportedCardsPluginCache* plugin_cache) {
+    bool success = false;
+    uint8_t buf[NFC_SUPPORTED_CARDS_FINGERPRINT_SIZE * NFC_SUPPORTED_CARDS_FINGERPRINTS_MAX];
 
     do {
-        if(!storage_file_is_open(instance->directory)) break;
-        if(!storage_dir_read(
-               instance->directory, NULL, instance->file_name, sizeof(instance->file_name)))
+        if(!flipper_format_read_string(ff, "Plugin", name)) break;
+
+        uint32_t size = 0;
+        if(!flipper_format_read_uint32(ff, "Size", &size, 1)) break;
+        plugin_cache->size = size;
+        if(!flipper_format_read_uint32(ff, "Timestamp", &plugin_cache->timestamp, 1)) break;
+
+        uint32_t value = 0;
+        if(!flipper_format_read_uint32(ff, "Protocol", &value, 1)) break;
+        if(value >= NfcProtocolNum) break;
+        plugin_cache->protocol = value;
+        if(!flipper_format_read_uint32(ff, "Features", &value, 1)) break;
+        plugin_cache->feature = value;
+
+        uint32_t count = 0;
+        if(!flipper_format_read_uint32(ff, "Fingerprints count", &count, 1)) break;
+        if(count > NFC_SUPPORTED_CARDS_FINGERPRINTS_MAX) break;
+        if(count > 0) {
+            if(!flipper_format_read_hex(
+                   ff, "Fingerprints", buf, count * NFC_SUPPORTED_CARDS_FINGERPRINT_SIZE))
+                break;
+
+            plugin_cache->fingerprints =
+                malloc(sizeof(NfcSupportedCardPluginKeyFingerprint) * count);
+            for(size_t i = 0; i < count; i++) {
+                const uint8_t* data = &buf[i * NFC_SUPPORTED_CARDS_FINGERPRINT_SIZE];
+                plugin_cache->fingerprints[i].type = data[0];
+                plugin_cache->fingerprints[i].sector = data[1];
+                plugin_cache->fingerprints[i].key_type = data[2];
+                plugin_cache->fingerprints[i].key = bit_lib_bytes_to_num_be(&data[3], 6);
+            }
+            plugin_cache->fingerprints_count = count;
+        }
+
+        success = true;
+    } while(false);
+
+    return success;
+}
+
+static void nfc_supported_cards_index_load(
+    NfcSupportedCards* instance,
+    NfcSupportedCardsPluginCache_t index_arr) {
+    FlipperFormat* ff = flipper_format_buffered_file_alloc(instance->storage);
+    FuriString* temp_str = furi_string_alloc();
+
+    do {
+        if(!flipper_format_buffered_file_open_existing(ff, NFC_SUPPORTED_CARDS_INDEX_PATH)) break;
+
+        uint32_t version = 0;
+        if(!flipper_format_read_header(ff, temp_str, &version)) break;
+        if(!furi_string_equal(temp_str, NFC_SUPPORTED_CARDS_INDEX_FILE_TYPE)) break;
+        if(version != NFC_SUPPORTED_CARDS_INDEX_VERSION) break;
+
+        uint32_t api_version = 0;
+        if(!flipper_format_read_uint32(ff, "Api version", &api_version, 1)) break;
+        if(api_version != NFC_SUPPORTED_CARD_PLUGIN_API_VERSION) break;
+
+        while(true) {
+            NfcSupportedCardsPluginCache plugin_cache = {};
+            if(!nfc_supported_cards_index_read_entry(ff, temp_str, &plugin_cache)) {
+                free(plugin_cache.fingerprints);
+                break;
+            }
+            plugin_cache.path = furi_string_alloc();
+            path_concat(
+                NFC_SUPPORTED_CARDS_PLUGINS_PATH,
+                furi_string_get_cstr(temp_str),
+                plugin_cache.path);
+            NfcSupportedCardsPluginCache_push_back(index_arr, plugin_cache);
+        }
+    } while(false);
+
+    furi_string_free(temp_str);
+    flipper_format_free(ff);
+}
+
+static bool nfc_supported_cards_index_save(NfcSupportedCards* instance) {
+    FlipperFormat* ff = flipper_format_buffered_file_alloc(instance->storage);
+    FuriString* name = furi_string_alloc();
+    uint8_t buf[NFC_SUPPORTED_CARDS_FINGERPRINT_SIZE * NFC_SUPPORTED_CARDS_FINGERPRINTS_MAX];
+    bool saved = false;
+
+    do {
+        if(!flipper_format_buffered_file_open_always(ff, NFC_SUPPORTED_CARDS_INDEX_PATH)) break;
+        if(!flipper_format_write_header_cstr(
+               ff, NFC_SUPPORTED_CARDS_INDEX_FILE_TYPE, NFC_SUPPORTED_CARDS_INDEX_VERSION))
             break;
 
-        furi_string_set(instance->file_path, instance->file_name);
-        if(!furi_string_end_with_str(instance->file_path, NFC_SUPPORTED_CARDS_PLUGIN_SUFFIX))
-            continue;
+        uint32_t api_version = NFC_SUPPORTED_CARD_PLUGIN_API_VERSION;
+        if(!flipper_format_write_uint32(ff, "Api version", &api_version, 1)) break;
+
+        NfcSupportedCardsPluginCache_it_t iter;
+        for(NfcSupportedCardsPluginCache_it(iter, instance->plugins_cache_arr);
+            !NfcSupportedCardsPluginCache_end_p(iter);
+            NfcSupportedCardsPluginCache_next(iter)) {
+            NfcSupportedCardsPluginCache* plugin_cache = NfcSupportedCardsPluginCache_ref(iter);
+
+            path_extract_filename(plugin_cache->path, name, false);
+            if(!flipper_format_write_string(ff, "Plugin", name)) break;
+            uint32_t size = plugin_cache->size;
+            if(!flipper_format_write_uint32(ff, "Size", &size, 1)) break;
+            if(!flipper_format_write_uint32(ff, "Timestamp", &plugin_cache->timestamp, 1)) break;
+            uint32_t value = plugin_cache->protocol;
+            if(!flipper_format_write_uint32(ff, "Protocol", &value, 1)) break;
+            value = plugin_cache->feature;
+            if(!flipper_format_write_uint32(ff, "Features", &value, 1)) break;
+            value = plugin_cache->fingerprints_count;
+            if(!flipper_format_write_uint32(ff, "Fingerprints count", &value, 1)) break;
+            if(plugin_cache->fingerprints_count == 0) continue;
+
+            for(size_t i = 0; i < plugin_cache->fingerprints_count; i++) {
+                uint8_t* data = &buf[i * NFC_SUPPORTED_CARDS_FINGERPRINT_SIZE];
+                data[0] = plugin_cache->fingerprints[i].type;
+                data[1] = plugin_cache->fingerprints[i].sector;
+                data[2] = plugin_cache->fingerprints[i].key_type;
+                bit_lib_num_to_bytes_be(plugin_cache->fingerprints[i].key, 6, &data[3]);
+            }
+            if(!flipper_format_write_hex(
+                   ff,
+                   "Fingerprints",
+                   buf,
+                   plugin_cache->fingerprints_count * NFC_SUPPORTED_CARDS_FINGERPRINT_SIZE))
+                break;
+        }
+        if(!NfcSupportedCardsPluginCache_end_p(iter)) break;
 
-        path_concat(NFC_SUPPORTED_CARDS_PLUGINS_PATH, instance->file_name, instance->file_path);
+        saved = true;
+    } while(false);
 
-        plugin = nfc_supported_cards_get_plugin(instance, instance->file_path, api_interface);
-    } while(plugin == NULL); //-V654
+    furi_string_free(name);
+    flipper_format_free(ff);
 
-    return plugin;
+    return saved;
+}
+
+static bool nfc_supported_cards_index_take(
+    NfcSupportedCardsPluginCache_t index_arr,
+    NfcSupportedCardsPluginCache* plugin_cache) {
+    bool found = false;
+
+    NfcSupportedCardsPluginCache_it_t iter;
+    for(NfcSupportedCardsPluginCache_it(iter, index_arr);
+        !NfcSupportedCardsPluginCache_end_p(iter);
+        NfcSupportedCardsPluginCache_next(iter)) {
+        NfcSupportedCardsPluginCache* entry = NfcSupportedCardsPluginCache_ref(iter);
+        if(!furi_string_equal(entry->path, plugin_cache->path)) continue;
+
+        // Plugin file is the same as when it was indexed
+        if((entry->size == plugin_cache->size) && (entry->timestamp == plugin_cache->timestamp)) {
+            furi_string_free(plugin_cache->path);
+            *plugin_cache = *entry;
+            found = true;
+        } else {
+            nfc_supported_cards_plugin_cache_clear(entry);
+        }
+        NfcSupportedCardsPluginCache_remove(index_arr, iter);
+        break;
+    }
+
+    return found;
 }
 
 void nfc_supported_cards_load_cache(NfcSupportedCards* instance) {
@@ -171,44 +397,88 @@ void nfc_supported_cards_load_cache(NfcSupportedCards* instance) {
            (instance->load_state == NfcSupportedCardsLoadStateFail))
             break;
 
-        instance->load_context = nfc_supported_cards_load_context_alloc();
+        NfcSupportedCardsPluginCache_t index_arr;
+        NfcSupportedCardsPluginCache_init(index_arr);
+        nfc_supported_cards_index_load(instance, index_arr);
+        size_t plugins_indexed = NfcSupportedCardsPluginCache_size(index_arr);
+        bool index_changed = false;
 
-        while(true) {
-            const ElfApiInterface* api_interface =
-                composite_api_resolver_get(instance->api_resolver);
-            const NfcSupportedCardsPlugin* plugin =
-                nfc_supported_cards_get_next_plugin(instance->load_context, api_interface);
-            if(plugin == NULL) break; //-V547
+        File* directory = storage_file_alloc(instance->storage);
+        char file_name[256];
+        FileInfo file_info;
 
-            NfcSupportedCardsPluginCache plugin_cache = {}; //-V779
-            plugin_cache.path = furi_string_alloc_set(instance->load_context->file_path);
-            plugin_cache.protocol = plugin->protocol;
-            if(plugin->verify) {
-                plugin_cache.feature |= NfcSupportedCardsPluginFeatureHasVerify;
-            }
-            if(plugin->read) {
-                plugin_cache.feature |= NfcSupportedCardsPluginFeatureHasRead;
+        if(!storage_dir_open(directory, NFC_SUPPORTED_CARDS_PLUGINS_PATH)) {
+            FURI_LOG_D(TAG, "Failed to open directory: %s", NFC_SUPPORTED_CARDS_PLUGINS_PATH);
+        }
+
+        while(storage_file_is_open(directory) &&
+              storage_dir_read(directory, &file_info, file_name, sizeof(file_name))) {
+            if(file_info_is_dir(&file_info)) continue;
+
+            NfcSupportedCardsPluginCache plugin_cache = {};
+            plugin_cache.path = furi_string_alloc_set(file_name);
+            if(!furi_string_end_with_str(plugin_cache.path, NFC_SUPPORTED_CARDS_PLUGIN_SUFFIX)) {
+                furi_string_free(plugin_cache.path);
+                continue;
             }
-            if(plugin->parse) {
-                plugin_cache.feature |= NfcSupportedCardsPluginFeatureHasParse;
+            path_concat(NFC_SUPPORTED_CARDS_PLUGINS_PATH, file_name, plugin_cache.path);
+            plugin_cache.size = file_info.size;
+            storage_common_timestamp(
+                instance->storage,
+                furi_string_get_cstr(plugin_cache.path),
+                &plugin_cache.timestamp);
+
+            if(!nfc_supported_cards_index_take(index_arr, &plugin_cache)) {
+                index_changed = true;
+                // Broken plugins are indexed without features to not load them again
+                if(!nfc_supported_cards_fill_cache(instance, &plugin_cache)) {
+                    FURI_LOG_W(TAG, "Failed to load %s", file_name);
+                }
             }
+
             NfcSupportedCardsPluginCache_push_back(instance->plugins_cache_arr, plugin_cache);
         }
 
-        nfc_supported_cards_load_context_free(instance->load_context);
+        storage_dir_close(directory);
+        storage_file_free(directory);
+
+        // Plugins which are gone
+        if(NfcSupportedCardsPluginCache_size(index_arr) > 0) index_changed = true;
+        nfc_supported_cards_cache_reset(index_arr);
+        NfcSupportedCardsPluginCache_clear(index_arr);
 
         size_t plugins_loaded = NfcSupportedCardsPluginCache_size(instance->plugins_cache_arr);
+        if(index_changed) {
+            if(!nfc_supported_cards_index_save(instance)) {
+                FURI_LOG_W(TAG, "Failed to save plugins index");
+                storage_simply_remove(instance->storage, NFC_SUPPORTED_CARDS_INDEX_PATH);
+            }
+        }
+
         if(plugins_loaded == 0) {
             FURI_LOG_D(TAG, "Plugins not found");
             instance->load_state = NfcSupportedCardsLoadStateFail;
         } else {
-            FURI_LOG_D(TAG, "Loaded %zu plugins", plugins_loaded);
+            FURI_LOG_D(TAG, "Loaded %zu plugins, %zu indexed", plugins_loaded, plugins_indexed);
             instance->load_state = NfcSupportedCardsLoadStateSuccess;
         }
 
     } while(false);
 }
 
+static bool nfc_supported_cards_plugin_match(
+    const NfcSupportedCardsPluginCache* plugin_cache,
+    const NfcDevice* device,
+    bool check_keys) {
+    if(plugin_cache->protocol != NfcProtocolMfClassic) return true;
+
+    return nfc_supported_cards_fingerprint_match(
+        plugin_cache->fingerprints,
+        plugin_cache->fingerprints_count,
+        nfc_device_get_data(device, NfcProtocolMfClassic),
+        check_keys);
+}
+
 bool nfc_supported_cards_read(NfcSupportedCards* instance, NfcDevice* device, Nfc* nfc) {
     furi_assert(instance);
     furi_assert(device);
@@ -220,8 +490,6 @@ bool nfc_supported_cards_read(NfcSupportedCards* instance, NfcDevice* device, Nf
     do {
         if(instance->load_state != NfcSupportedCardsLoadStateSuccess) break;
 
-        instance->load_context = nfc_supported_cards_load_context_alloc();
-
         NfcSupportedCardsPluginCache_it_t iter;
         for(NfcSupportedCardsPluginCache_it(iter, instance->plugins_cache_arr);
             !NfcSupportedCardsPluginCache_end_p(iter);
@@ -229,11 +497,10 @@ bool nfc_supported_cards_read(NfcSupportedCards* instance, NfcDevice* device, Nf
             NfcSupportedCardsPluginCache* plugin_cache = NfcSupportedCardsPluginCache_ref(iter);
             if(plugin_cache->protocol != protocol) continue;
             if((plugin_cache->feature & NfcSupportedCardsPluginFeatureHasRead) == 0) continue;
+            if(!nfc_supported_cards_plugin_match(plugin_cache, device, false)) continue;
 
-            const ElfApiInterface* api_interface =
-                composite_api_resolver_get(instance->api_resolver);
-            const NfcSupportedCardsPlugin* plugin = nfc_supported_cards_get_plugin(
-                instance->load_context, plugin_cache->path, api_interface);
+            const NfcSupportedCardsPlugin* plugin =
+                nfc_supported_cards_load_plugin(instance, plugin_cache);
             if(plugin == NULL) continue;
 
             if(plugin->verify) {
@@ -247,8 +514,6 @@ bool nfc_supported_cards_read(NfcSupportedCards* instance, NfcDevice* device, Nf
                 }
             }
         }
-
-        nfc_supported_cards_load_context_free(instance->load_context);
     } while(false);
 
     return card_read;
@@ -268,8 +533,6 @@ bool nfc_supported_cards_parse(
     do {
         if(instance->load_state != NfcSupportedCardsLoadStateSuccess) break;
 
-        instance->load_context = nfc_supported_cards_load_context_alloc();
-
         NfcSupportedCardsPluginCache_it_t iter;
         for(NfcSupportedCardsPluginCache_it(iter, instance->plugins_cache_arr);
             !NfcSupportedCardsPluginCache_end_p(iter);
@@ -277,11 +540,10 @@ bool nfc_supported_cards_parse(
             NfcSupportedCardsPluginCache* plugin_cache = NfcSupportedCardsPluginCache_ref(iter);
             if(plugin_cache->protocol != protocol) continue;
             if((plugin_cache->feature & NfcSupportedCardsPluginFeatureHasParse) == 0) continue;
+            if(!nfc_supported_cards_plugin_match(plugin_cache, device, true)) continue;
 
-            const ElfApiInterface* api_interface =
-                composite_api_resolver_get(instance->api_resolver);
-            const NfcSupportedCardsPlugin* plugin = nfc_supported_cards_get_plugin(
-                instance->load_context, plugin_cache->path, api_interface);
+            const NfcSupportedCardsPlugin* plugin =
+                nfc_supported_cards_load_plugin(instance, plugin_cache);
             if(plugin == NULL) continue;
 
             if(plugin->parse) {
@@ -291,8 +553,6 @@ bool nfc_supported_cards_parse(
                 }
             }
         }
-
-        nfc_supported_cards_load_context_free(instance->load_context);
     } while(false);
 
     return card_parsed;
@@ -37,6 +37,11 @@ void nfc_supported_cards_free(NfcSupportedCards* instance);
 /**
  * @brief Load plugins information to cache.
  *
+ * Plugin information is kept in an index file on the SD card, only plugins
+ * added or changed since the index was written are loaded to refresh it.
+ * Plugins loaded by read and parse functions stay resident until the instance is freed
+ * or they are replaced by other plugins.
+ *
  * @note This function must be called before calling read and parse fanctions.
  *
  * @param[in, out] instance pointer to NfcSupportedCards instance.
@@ -0,0 +1,36 @@
+#include "nfc_supported_cards_fingerprint.h"
+
+#include <bit_lib/bit_lib.h>
+
+bool nfc_supported_cards_fingerprint_match(
+    const NfcSupportedCardPluginKeyFingerprint* fingerprints,
+    size_t count,
+    const MfClassicData* data,
+    bool check_keys) {
+    furi_assert(data);
+
+    if(count == 0) return true;
+
+    bool match = false;
+
+    for(size_t i = 0; i < count; i++) {
+        const NfcSupportedCardPluginKeyFingerprint* fingerprint = &fingerprints[i];
+        if(fingerprint->type != data->type) continue;
+        if(!check_keys) {
+            match = true;
+            break;
+        }
+        if(fingerprint->sector >= mf_classic_get_total_sectors_num(data->type)) continue;
+
+        const MfClassicSectorTrailer* sec_tr =
+            mf_classic_get_sector_trailer_by_sector(data, fingerprint->sector);
+        const MfClassicKey* key = (fingerprint->key_type == MfClassicKeyTypeA) ? &sec_tr->key_a :
+                                                                               &sec_tr->key_b;
+        if(bit_lib_bytes_to_num_be(key->data, COUNT_OF(key->data)) == fingerprint->key) {
+            match = true;
+            break;
+        }
+    }
+
+    return match;
+}
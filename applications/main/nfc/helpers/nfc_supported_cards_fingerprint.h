@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../plugins/supported_cards/nfc_supported_card_plugin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check Mifare Classic card data against plugin key fingerprints.
+ *
+ * @param[in] fingerprints pointer to the fingerprints declared by a plugin.
+ * @param[in] count number of fingerprints, a plugin without fingerprints matches any card.
+ * @param[in] data pointer to the card data.
+ * @param[in] check_keys false to only match the card type, true to also match the keys.
+ * @returns true if the plugin may handle the card, false otherwise.
+ */
+bool nfc_supported_cards_fingerprint_match(
+    const NfcSupportedCardPluginKeyFingerprint* fingerprints,
+    size_t count,
+    const MfClassicData* data,
+    bool check_keys);
+
+#ifdef __cplusplus
+}
+#endif
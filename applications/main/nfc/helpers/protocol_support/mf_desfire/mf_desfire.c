@@ -9,6 +9,17 @@
 #include "../nfc_protocol_support_gui_common.h"
 #include "../iso14443_4a/iso14443_4a_i.h"
 
+#define TAG "MfDesfireApp"
+
+static const char* const nfc_mf_desfire_phase_names[MfDesfirePollerPhaseNum] = {
+    [MfDesfirePollerPhaseCard] = "card",
+    [MfDesfirePollerPhaseApplicationIds] = "app ids",
+    [MfDesfirePollerPhaseApplicationSelect] = "app select",
+    [MfDesfirePollerPhaseApplicationKeys] = "app keys",
+    [MfDesfirePollerPhaseFileSettings] = "file settings",
+    [MfDesfirePollerPhaseFileData] = "file data",
+};
+
 static void nfc_scene_info_on_enter_mf_desfire(NfcApp* instance) {
     const NfcDevice* device = instance->nfc_device;
     const MfDesfireData* data = nfc_device_get_data(device, NfcProtocolMfDesfire);
@@ -31,6 +42,25 @@ static void nfc_scene_more_info_on_enter_mf_desfire(NfcApp* instance) {
     scene_manager_next_scene(instance->scene_manager, NfcSceneMfDesfireMoreInfo);
 }
 
+static void nfc_scene_read_log_stats_mf_desfire(const MfDesfirePollerStats* stats) {
+    uint32_t time_ms = 0;
+    for(size_t i = 0; i < MfDesfirePollerPhaseNum; i++) {
+        FURI_LOG_I(
+            TAG,
+            "%s: %lu ms, %lu frames",
+            nfc_mf_desfire_phase_names[i],
+            stats->time_ms[i],
+            stats->frames[i]);
+        time_ms += stats->time_ms[i];
+    }
+    FURI_LOG_I(
+        TAG,
+        "Read in %lu ms, %lu files skipped, %lu resumes",
+        time_ms,
+        stats->files_skipped,
+        stats->resumed);
+}
+
 static NfcCommand nfc_scene_read_poller_callback_mf_desfire(NfcGenericEvent event, void* context) {
     furi_assert(event.protocol == NfcProtocolMfDesfire);
 
@@ -38,6 +68,7 @@ static NfcCommand nfc_scene_read_poller_callback_mf_desfire(NfcGenericEvent even
     const MfDesfirePollerEvent* mf_desfire_event = event.event_data;
 
     if(mf_desfire_event->type == MfDesfirePollerEventTypeReadSuccess) {
+        nfc_scene_read_log_stats_mf_desfire(mf_desfire_event->data->stats);
         nfc_device_set_data(
             instance->nfc_device, NfcProtocolMfDesfire, nfc_poller_get_data(instance->poller));
         view_dispatcher_send_custom_event(instance->view_dispatcher, NfcCustomEventPollerSuccess);
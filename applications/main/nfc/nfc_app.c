@@ -359,6 +359,7 @@ bool nfc_load_file(NfcApp* instance, FuriString* path, bool show_dialog) {
     result = nfc_device_load(instance->nfc_device, furi_string_get_cstr(load_path));
 
     if(result) {
+        nfc_device_update_cache(instance->nfc_device, furi_string_get_cstr(load_path));
         path_extract_filename(load_path, instance->file_name, true);
     }
 
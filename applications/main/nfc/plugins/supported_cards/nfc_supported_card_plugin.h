@@ -27,6 +27,7 @@
 
 #include <nfc/nfc.h>
 #include <nfc/nfc_device.h>
+#include <nfc/protocols/mf_classic/mf_classic.h>
 
 /**
  * @brief Unique string identifier for supported card plugins.
@@ -36,7 +37,7 @@
 /**
  * @brief Currently supported plugin API version.
  */
-#define NFC_SUPPORTED_CARD_PLUGIN_API_VERSION 1
+#define NFC_SUPPORTED_CARD_PLUGIN_API_VERSION 2
 
 /**
  * @brief Verify that the card is of a supported type.
@@ -81,6 +82,26 @@ typedef bool (*NfcSupportedCardPluginRead)(Nfc* nfc, NfcDevice* device);
  */
 typedef bool (*NfcSupportedCardPluginParse)(const NfcDevice* device, FuriString* parsed_data);
 
+/**
+ * @brief Mifare Classic sector key a card is known to use.
+ *
+ * Fingerprints are an optional declarative pre-check, which is stored in the
+ * plugin index and evaluated without loading the plugin. If a plugin declares any:
+ * - verify() and read() are only called for cards of one of the listed types,
+ * - parse() is only called if the key of at least one fingerprint is present
+ *   in the sector trailer of the card data.
+ *
+ * Only declare fingerprints if parse() would fail without a matching key anyway.
+ * List every card type the plugin handles, Mini included: types without a
+ * fingerprint are skipped.
+ */
+typedef struct {
+    MfClassicType type; /**< Card type the key applies to. */
+    uint8_t sector; /**< Sector number. */
+    MfClassicKeyType key_type; /**< Key type. */
+    uint64_t key; /**< Key value. */
+} NfcSupportedCardPluginKeyFingerprint;
+
 /**
  * @brief Supported card plugin interface.
  *
@@ -91,4 +112,7 @@ typedef struct {
     NfcSupportedCardPluginVerify verify; /**< Pointer to the verify() function. */
     NfcSupportedCardPluginRead read; /**< Pointer to the read() function. */
     NfcSupportedCardPluginParse parse; /**< Pointer to the parse() function. */
+    const NfcSupportedCardPluginKeyFingerprint*
+        fingerprints; /**< Optional Mifare Classic key fingerprints, may be NULL. */
+    size_t fingerprints_count; /**< Number of fingerprints. */
 } NfcSupportedCardsPlugin;
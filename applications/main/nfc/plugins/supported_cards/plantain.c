@@ -199,12 +199,20 @@ static bool plantain_parse(const NfcDevice* device, FuriString* parsed_data) {
     return parsed;
 }
 
+/* Keys checked by parse() */
+static const NfcSupportedCardPluginKeyFingerprint plantain_fingerprints[] = {
+    {.type = MfClassicType1k, .sector = 8, .key_type = MfClassicKeyTypeA, .key = 0x26973ea74321},
+    {.type = MfClassicType4k, .sector = 8, .key_type = MfClassicKeyTypeA, .key = 0x26973ea74321},
+};
+
 /* Actual implementation of app<>plugin interface */
 static const NfcSupportedCardsPlugin plantain_plugin = {
     .protocol = NfcProtocolMfClassic,
     .verify = plantain_verify,
     .read = plantain_read,
     .parse = plantain_parse,
+    .fingerprints = plantain_fingerprints,
+    .fingerprints_count = COUNT_OF(plantain_fingerprints),
 };
 
 /* Plugin descriptor to comply with basic plugin specification */
@@ -228,12 +228,20 @@ static bool troika_parse(const NfcDevice* device, FuriString* parsed_data) {
     return parsed;
 }
 
+/* Keys checked by parse() */
+static const NfcSupportedCardPluginKeyFingerprint troika_fingerprints[] = {
+    {.type = MfClassicType1k, .sector = 11, .key_type = MfClassicKeyTypeA, .key = 0x08b386463229},
+    {.type = MfClassicType4k, .sector = 8, .key_type = MfClassicKeyTypeA, .key = 0xa73f5dc1d333},
+};
+
 /* Actual implementation of app<>plugin interface */
 static const NfcSupportedCardsPlugin troika_plugin = {
     .protocol = NfcProtocolMfClassic,
     .verify = troika_verify,
     .read = troika_read,
     .parse = troika_parse,
+    .fingerprints = troika_fingerprints,
+    .fingerprints_count = COUNT_OF(troika_fingerprints),
 };
 
 /* Plugin descriptor to comply with basic plugin specification */
@@ -170,12 +170,21 @@ static bool two_cities_parse(const NfcDevice* device, FuriString* parsed_data) {
     return parsed;
 }
 
+/* Keys checked by parse() */
+static const NfcSupportedCardPluginKeyFingerprint two_cities_fingerprints[] = {
+    {.type = MfClassicTypeMini, .sector = 4, .key_type = MfClassicKeyTypeA, .key = 0xe56ac127dd45},
+    {.type = MfClassicType1k, .sector = 4, .key_type = MfClassicKeyTypeA, .key = 0xe56ac127dd45},
+    {.type = MfClassicType4k, .sector = 4, .key_type = MfClassicKeyTypeA, .key = 0xe56ac127dd45},
+};
+
 /* Actual implementation of app<>plugin interface */
 static const NfcSupportedCardsPlugin two_cities_plugin = {
     .protocol = NfcProtocolMfClassic,
     .verify = two_cities_verify,
     .read = two_cities_read,
     .parse = two_cities_parse,
+    .fingerprints = two_cities_fingerprints,
+    .fingerprints_count = COUNT_OF(two_cities_fingerprints),
 };
 
 /* Plugin descriptor to comply with basic plugin specification */
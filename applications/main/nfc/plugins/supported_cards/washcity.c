@@ -176,12 +176,21 @@ static bool washcity_parse(const NfcDevice* device, FuriString* parsed_data) {
     return parsed;
 }
 
+/* Keys checked by parse() */
+static const NfcSupportedCardPluginKeyFingerprint washcity_fingerprints[] = {
+    {.type = MfClassicTypeMini, .sector = 1, .key_type = MfClassicKeyTypeA, .key = 0xc78a3d0e1bcd},
+    {.type = MfClassicType1k, .sector = 1, .key_type = MfClassicKeyTypeA, .key = 0xc78a3d0e1bcd},
+    {.type = MfClassicType4k, .sector = 1, .key_type = MfClassicKeyTypeA, .key = 0xc78a3d0e1bcd},
+};
+
 /* Actual implementation of app<>plugin interface */
 static const NfcSupportedCardsPlugin washcity_plugin = {
     .protocol = NfcProtocolMfClassic,
     .verify = washcity_verify,
     .read = washcity_read,
     .parse = washcity_parse,
+    .fingerprints = washcity_fingerprints,
+    .fingerprints_count = COUNT_OF(washcity_fingerprints),
 };
 
 /* Plugin descriptor to comply with basic plugin specification */
@@ -32,6 +32,14 @@ SubGhzTxRx* subghz_txrx_alloc() {
     instance->setting = subghz_setting_alloc();
     subghz_setting_load(instance->setting, EXT_PATH("subghz/assets/setting_user"));
 
+    size_t hopper_frequency_count = subghz_setting_get_hopper_frequency_count(instance->setting);
+    uint32_t* hopper_frequencies = malloc(sizeof(uint32_t) * hopper_frequency_count);
+    for(size_t i = 0; i < hopper_frequency_count; i++) {
+        hopper_frequencies[i] = subghz_setting_get_hopper_frequency(instance->setting, i);
+    }
+    instance->hopper = subghz_hopper_alloc(hopper_frequencies, hopper_frequency_count);
+    free(hopper_frequencies);
+
     instance->preset = malloc(sizeof(SubGhzRadioPreset));
     instance->preset->name = furi_string_alloc();
     subghz_txrx_set_preset(
@@ -89,6 +97,7 @@ void subghz_txrx_free(SubGhzTxRx* instance) {
     subghz_environment_free(instance->environment);
     flipper_format_free(instance->fff_data);
     furi_string_free(instance->preset->name);
+    subghz_hopper_free(instance->hopper);
     subghz_setting_free(instance->setting);
 
     free(instance->preset);
@@ -372,44 +381,32 @@ void subghz_txrx_hopper_update(SubGhzTxRx* instance) {
     case SubGhzHopperStateOFF:
     case SubGhzHopperStatePause:
         return;
-    case SubGhzHopperStateRSSITimeOut:
-        if(instance->hopper_timeout != 0) {
-            instance->hopper_timeout--;
-            return;
-        }
-        break;
     default:
         break;
     }
-    float rssi = -127.0f;
-    if(instance->hopper_state != SubGhzHopperStateRSSITimeOut) {
-        // See RSSI Calculation timings in CC1101 17.3 RSSI
-        rssi = subghz_devices_get_rssi(instance->radio_device);
 
-        // Stay if RSSI is high enough
-        if(rssi > -90.0f) {
-            instance->hopper_timeout = 10;
-            instance->hopper_state = SubGhzHopperStateRSSITimeOut;
-            return;
-        }
-    } else {
-        instance->hopper_state = SubGhzHopperStateRunnig;
+    SubGhzHopperStep step = SubGhzHopperStepRetune;
+    // Hopping was just enabled if the radio is elsewhere, start from the scheduler frequency
+    if(instance->preset->frequency == subghz_hopper_get_frequency(instance->hopper)) {
+        // See RSSI Calculation timings in CC1101 17.3 RSSI
+        float rssi = subghz_devices_get_rssi(instance->radio_device);
+        step = subghz_hopper_tick(instance->hopper, rssi);
     }
-    // Select next frequency
-    if(instance->hopper_idx_frequency <
-       subghz_setting_get_hopper_frequency_count(instance->setting) - 1) {
-        instance->hopper_idx_frequency++;
-    } else {
-        instance->hopper_idx_frequency = 0;
+
+    // Stay while the scheduler holds the frequency with activity
+    if(step == SubGhzHopperStepHold) {
+        instance->hopper_state = SubGhzHopperStateRSSITimeOut;
+        return;
     }
+    instance->hopper_state = SubGhzHopperStateRunnig;
+    if(step == SubGhzHopperStepStay) return;
 
     if(instance->txrx_state == SubGhzTxRxStateRx) {
         subghz_txrx_rx_end(instance);
     };
     if(instance->txrx_state == SubGhzTxRxStateIDLE) {
         subghz_receiver_reset(instance->receiver);
-        instance->preset->frequency =
-            subghz_setting_get_hopper_frequency(instance->setting, instance->hopper_idx_frequency);
+        instance->preset->frequency = subghz_hopper_get_frequency(instance->hopper);
         subghz_txrx_rx(instance, instance->preset->frequency);
     }
 }
@@ -2,6 +2,8 @@
 
 #include "subghz_txrx.h"
 
+#include <lib/subghz/subghz_hopper.h>
+
 struct SubGhzTxRx {
     SubGhzWorker* worker;
 
@@ -14,8 +16,7 @@ struct SubGhzTxRx {
     SubGhzRadioPreset* preset;
     SubGhzSetting* setting;
 
-    uint8_t hopper_timeout;
-    uint8_t hopper_idx_frequency;
+    SubGhzHopper* hopper;
     bool is_database_loaded;
     SubGhzHopperState hopper_state;
 
@@ -267,6 +267,7 @@ bool subghz_scene_read_raw_on_event(void* context, SceneManagerEvent event) {
                 scene_manager_next_scene(subghz->scene_manager, SubGhzSceneNeedSaving);
             } else {
                 SubGhzRadioPreset preset = subghz_txrx_get_preset(subghz->txrx);
+                subghz_protocol_raw_save_to_file_set_format(decoder_raw, subghz->raw_file_format);
                 if(subghz_protocol_raw_save_to_file_init(decoder_raw, RAW_FILE_NAME, &preset)) {
                     dolphin_deed(DolphinDeedSubGhzRawRec);
                     subghz_txrx_rx_start(subghz->txrx);
@@ -306,6 +307,10 @@ bool subghz_scene_read_raw_on_event(void* context, SceneManagerEvent event) {
 
             subghz_read_raw_update_sample_write(
                 subghz->subghz_read_raw, subghz_protocol_raw_get_sample_write(decoder_raw));
+            SubGhzProtocolRawWriteStats write_stats;
+            subghz_protocol_raw_get_write_stats(decoder_raw, &write_stats);
+            subghz_read_raw_update_write_stats(
+                subghz->subghz_read_raw, write_stats.samples_dropped, write_stats.write_ms_max);
 
             SubGhzThresholdRssiData ret_rssi = subghz_threshold_get_rssi_data(
                 subghz->threshold_rssi, subghz_txrx_radio_device_get_rssi(subghz->txrx));
@@ -67,33 +67,49 @@ void subghz_scene_receiver_callback(SubGhzCustomEvent event, void* context) {
     view_dispatcher_send_custom_event(subghz->view_dispatcher, event);
 }
 
+static void subghz_scene_receiver_load_history(SubGhz* subghz, uint16_t idx) {
+    SubGhzHistory* history = subghz->history;
+    FuriString* str_buff = furi_string_alloc();
+
+    subghz_view_receiver_reset_menu(subghz->subghz_receiver);
+    for(uint16_t i = 0; i < subghz_history_get_item(history); i++) {
+        subghz_history_get_text_item_menu(history, str_buff, i);
+        subghz_view_receiver_add_item_to_menu(
+            subghz->subghz_receiver,
+            furi_string_get_cstr(str_buff),
+            subghz_history_get_type_protocol(history, i));
+    }
+    if(subghz_history_get_item(history)) {
+        subghz_view_receiver_set_idx_menu(
+            subghz->subghz_receiver, MIN(idx, subghz_history_get_item(history) - 1));
+    }
+
+    furi_string_free(str_buff);
+}
+
+// Runs in the worker thread, the list is updated by the scene
 static void subghz_scene_add_to_history_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
     void* context) {
     furi_assert(context);
     SubGhz* subghz = context;
-    SubGhzHistory* history = subghz->history;
-    FuriString* str_buff = furi_string_alloc();
 
     SubGhzRadioPreset preset = subghz_txrx_get_preset(subghz->txrx);
 
-    if(subghz_history_add_to_history(history, decoder_base, &preset)) {
-        furi_string_reset(str_buff);
-
+    SubGhzHistoryAddResult result =
+        subghz_history_add_to_history(subghz->history, decoder_base, &preset);
+    subghz_receiver_reset(receiver);
+    if(result != SubGhzHistoryAddResultIgnored) {
         subghz->state_notifications = SubGhzNotificationStateRxDone;
-        uint16_t item_history = subghz_history_get_item(history);
-        subghz_history_get_text_item_menu(history, str_buff, item_history - 1);
-        subghz_view_receiver_add_item_to_menu(
-            subghz->subghz_receiver,
-            furi_string_get_cstr(str_buff),
-            subghz_history_get_type_protocol(history, item_history - 1));
-
-        subghz_scene_receiver_update_statusbar(subghz);
+        subghz_rx_key_state_set(subghz, SubGhzRxKeyStateAddKey);
+        view_dispatcher_send_custom_event(
+            subghz->view_dispatcher, SubGhzCustomEventSceneReceiverUpdate);
+    } else if(subghz_history_get_text_space_left(subghz->history, NULL)) {
+        // Status bar shows that memory is full
+        view_dispatcher_send_custom_event(
+            subghz->view_dispatcher, SubGhzCustomEventSceneReceiverUpdate);
     }
-    subghz_receiver_reset(receiver);
-    furi_string_free(str_buff);
-    subghz_rx_key_state_set(subghz, SubGhzRxKeyStateAddKey);
 }
 
 void subghz_scene_receiver_on_enter(void* context) {
@@ -112,8 +128,9 @@ void subghz_scene_receiver_on_enter(void* context) {
     subghz_view_receiver_set_lock(subghz->subghz_receiver, subghz_is_locked(subghz));
 
     //Load history to receiver
+    subghz_history_flush(history);
     subghz_view_receiver_exit(subghz->subghz_receiver);
-    for(uint8_t i = 0; i < subghz_history_get_item(history); i++) {
+    for(uint16_t i = 0; i < subghz_history_get_item(history); i++) {
         furi_string_reset(str_buff);
         subghz_history_get_text_item_menu(history, str_buff, i);
         subghz_view_receiver_add_item_to_menu(
@@ -127,6 +144,7 @@ void subghz_scene_receiver_on_enter(void* context) {
     subghz_view_receiver_set_callback(
         subghz->subghz_receiver, subghz_scene_receiver_callback, subghz);
     subghz_txrx_set_rx_calback(subghz->txrx, subghz_scene_add_to_history_callback, subghz);
+    subghz_history_set_spill_enabled(history, true);
 
     subghz->state_notifications = SubGhzNotificationStateRx;
     subghz_txrx_rx_start(subghz->txrx);
@@ -185,6 +203,28 @@ bool subghz_scene_receiver_on_event(void* context, SceneManagerEvent event) {
             subghz_unlock(subghz);
             consumed = true;
             break;
+        case SubGhzCustomEventSceneReceiverUpdate:
+            subghz_history_flush(subghz->history);
+            // Log pages shown in the list do not change, unless the flush started the log over
+            if(subghz_history_get_page(subghz->history) == 0) {
+                subghz_scene_receiver_load_history(
+                    subghz, subghz_view_receiver_get_idx_menu(subghz->subghz_receiver));
+            }
+            subghz_scene_receiver_update_statusbar(subghz);
+            consumed = true;
+            break;
+        case SubGhzCustomEventViewReceiverPage: {
+            // Live page, then log pages from the newest to the oldest
+            uint16_t page = subghz_history_get_page(subghz->history);
+            page = (page ? page : subghz_history_get_page_count(subghz->history)) - 1;
+            if(!subghz_history_set_page(subghz->history, page)) {
+                subghz_history_set_page(subghz->history, 0);
+            }
+            subghz_scene_receiver_load_history(subghz, 0);
+            subghz_scene_receiver_update_statusbar(subghz);
+            consumed = true;
+            break;
+        }
         default:
             break;
         }
@@ -221,5 +261,7 @@ bool subghz_scene_receiver_on_event(void* context, SceneManagerEvent event) {
 }
 
 void subghz_scene_receiver_on_exit(void* context) {
-    UNUSED(context);
+    SubGhz* subghz = context;
+    // Record indexes are used by the next scenes
+    subghz_history_set_spill_enabled(subghz->history, false);
 }
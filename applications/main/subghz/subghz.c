@@ -133,10 +133,11 @@ SubGhz* subghz_alloc() {
 
     //init threshold rssi
     subghz->threshold_rssi = subghz_threshold_rssi_alloc();
+    subghz->raw_file_format = SubGhzProtocolRawFileFormatText;
 
     subghz_unlock(subghz);
     subghz_rx_key_state_set(subghz, SubGhzRxKeyStateIDLE);
-    subghz->history = subghz_history_alloc();
+    subghz->history = subghz_history_alloc(SUBGHZ_HISTORY_LOG_PATH);
     subghz->filter = SubGhzProtocolFlag_Decodable;
 
     //init TxRx & History & KeyBoard
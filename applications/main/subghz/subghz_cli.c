@@ -9,6 +9,7 @@
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/subghz_raw_file.h>
 #include <lib/subghz/protocols/protocol_items.h>
 #include <applications/drivers/subghz/cc1101_ext/cc1101_ext_interconnect.h>
 #include <lib/subghz/devices/cc1101_int/cc1101_int_interconnect.h>
@@ -512,7 +513,8 @@ void subghz_cli_command_decode_raw(Cli* cli, FuriString* args, void* context) {
             break;
         }
 
-        if(!strcmp(furi_string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE) &&
+        if(((!strcmp(furi_string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE)) ||
+            (!strcmp(furi_string_get_cstr(temp_str), SUBGHZ_RAW_BIN_FILE_TYPE))) &&
            temp_data32 == SUBGHZ_KEY_FILE_VERSION) {
         } else {
             printf("subghz decode_raw \033[0;31mType or version mismatch\033[0m\r\n");
@@ -659,7 +661,8 @@ void subghz_cli_command_tx_from_file(Cli* cli, FuriString* args, void* context)
         }
 
         if(((!strcmp(furi_string_get_cstr(temp_str), SUBGHZ_KEY_FILE_TYPE)) ||
-            (!strcmp(furi_string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE))) &&
+            (!strcmp(furi_string_get_cstr(temp_str), SUBGHZ_RAW_FILE_TYPE)) ||
+            (!strcmp(furi_string_get_cstr(temp_str), SUBGHZ_RAW_BIN_FILE_TYPE))) &&
            temp_data32 == SUBGHZ_KEY_FILE_VERSION) {
         } else {
             printf("subghz tx_from_file: \033[0;31mType or version mismatch\033[0m\r\n");
@@ -843,6 +846,8 @@ static void subghz_cli_command_print_usage() {
     printf("\trx <frequency:in Hz> <device: 0 - CC1101_INT, 1 - CC1101_EXT>\t - Receive\r\n");
     printf("\trx_raw <frequency:in Hz>\t - Receive RAW\r\n");
     printf("\tdecode_raw <file_name: path_RAW_file>\t - Testing\r\n");
+    printf(
+        "\tconvert_raw <format: bin or text> <path_RAW_file> <path_converted_file>\t - Convert RAW file\r\n");
     printf(
         "\ttx_from_file <file_name: path_file> <repeat: count> <device: 0 - CC1101_INT, 1 - CC1101_EXT>\t - Transmitting from file\r\n");
 
@@ -938,6 +943,58 @@ static void subghz_cli_command_encrypt_raw(Cli* cli, FuriString* args) {
     furi_string_free(source);
 }
 
+static void subghz_cli_command_convert_raw(Cli* cli, FuriString* args) {
+    UNUSED(cli);
+
+    FuriString* format;
+    FuriString* source;
+    FuriString* destination;
+    format = furi_string_alloc();
+    source = furi_string_alloc();
+    destination = furi_string_alloc();
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    do {
+        if(!args_read_string_and_trim(args, format)) {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        if(!args_read_string_and_trim(args, source)) {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        if(!args_read_string_and_trim(args, destination)) {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        bool converted;
+        if(furi_string_cmp_str(format, "bin") == 0) {
+            converted = subghz_raw_file_text_to_binary(
+                storage, furi_string_get_cstr(source), furi_string_get_cstr(destination));
+        } else if(furi_string_cmp_str(format, "text") == 0) {
+            converted = subghz_raw_file_binary_to_text(
+                storage, furi_string_get_cstr(source), furi_string_get_cstr(destination));
+        } else {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        if(!converted) {
+            printf("subghz convert_raw \033[0;31mConversion failed\033[0m\r\n");
+            break;
+        }
+    } while(false);
+
+    furi_record_close(RECORD_STORAGE);
+    furi_string_free(destination);
+    furi_string_free(source);
+    furi_string_free(format);
+}
+
 static void subghz_cli_command_chat(Cli* cli, FuriString* args) {
     uint32_t frequency = 433920000;
     uint32_t device_ind = 0; // 0 - CC1101_INT, 1 - CC1101_EXT
@@ -1173,6 +1230,11 @@ static void subghz_cli_command(Cli* cli, FuriString* args, void* context) {
             break;
         }
 
+        if(furi_string_cmp_str(cmd, "convert_raw") == 0) {
+            subghz_cli_command_convert_raw(cli, args);
+            break;
+        }
+
         if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
             if(furi_string_cmp_str(cmd, "encrypt_keeloq") == 0) {
                 subghz_cli_command_encrypt_keeloq(cli, args);
@@ -1,211 +1,823 @@
 #include "subghz_history.h"
 #include <lib/subghz/receiver.h>
-#include <lib/subghz/protocols/came.h>
+#include <lib/subghz/blocks/generic.h>
+#include <lib/toolbox/stream/stream.h>
+#include <flipper_format/flipper_format_i.h>
+#include <storage/storage.h>
+#include <m-array.h>
 
 #include <furi.h>
 
-#define SUBGHZ_HISTORY_MAX 50
+#define SUBGHZ_HISTORY_ARENA_SIZE 8192
+#define SUBGHZ_HISTORY_PRESET_MAX 16
 #define SUBGHZ_HISTORY_FREE_HEAP 20480
+#define SUBGHZ_HISTORY_REPEAT_MS 500
+#define SUBGHZ_HISTORY_LOG_SIZE_MAX (1024 * 1024)
 #define TAG "SubGhzHistory"
 
-typedef struct {
-    FuriString* item_str;
-    FlipperFormat* flipper_string;
+// Part of a record that changes when the signal is received again
+typedef struct FURI_PACKED {
+    uint32_t frequency;
+    uint32_t last_seen;
+    uint32_t last_tick;
+    uint16_t hit_count;
+} SubGhzHistoryRecordStats;
+
+/*
+ * Record as stored in the arena and in the log: header, menu text with its
+ * terminator, then the serialized signal from the Protocol line on. Frequency
+ * and preset lines are rebuilt from the header when the data is requested.
+ */
+typedef struct FURI_PACKED {
+    uint32_t hash;
+    uint32_t first_seen;
+    SubGhzHistoryRecordStats stats;
+    uint16_t text_size;
+    uint16_t data_size;
     uint8_t type;
-    SubGhzRadioPreset* preset;
-} SubGhzHistoryItem;
+    uint8_t preset;
+} SubGhzHistoryRecord;
 
-ARRAY_DEF(SubGhzHistoryItemArray, SubGhzHistoryItem, M_POD_OPLIST)
+/*
+ * The log is a sequence of blocks. A page block is a live page as it was in RAM,
+ * a preset block is the preset name with its terminator followed by the preset
+ * data. Preset blocks come in the order of the preset indexes used by records.
+ */
+typedef enum {
+    SubGhzHistoryLogBlockTypePage,
+    SubGhzHistoryLogBlockTypePreset,
+} SubGhzHistoryLogBlockType;
 
-#define M_OPL_SubGhzHistoryItemArray_t() ARRAY_OPLIST(SubGhzHistoryItemArray, M_POD_OPLIST)
+typedef struct FURI_PACKED {
+    uint16_t type;
+    uint16_t size;
+} SubGhzHistoryLogBlock;
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    uint16_t offsets[SUBGHZ_HISTORY_MAX];
+    uint16_t count;
+} SubGhzHistoryPage;
 
 typedef struct {
-    SubGhzHistoryItemArray_t data;
-} SubGhzHistoryStruct;
+    uint32_t offset;
+    uint32_t size;
+} SubGhzHistoryLogPage;
+
+ARRAY_DEF(SubGhzHistoryLogPageArray, SubGhzHistoryLogPage, M_POD_OPLIST)
+
+// Record in the log, its stats are updated here and written back when flushing
+typedef struct {
+    uint32_t hash;
+    uint32_t offset;
+    SubGhzHistoryRecordStats stats;
+    uint8_t type;
+    bool dirty;
+} SubGhzHistoryIndexEntry;
 
 struct SubGhzHistory {
-    uint32_t last_update_timestamp;
-    uint16_t last_index_write;
-    uint8_t code_last_hash_data;
+    FuriMutex* mutex;
+
+    SubGhzHistoryPage live;
+    SubGhzHistoryPage pending;
+    SubGhzHistoryPage log_page;
+    uint16_t page;
+    bool is_full;
+    bool is_preset_full;
+    bool spill_enabled;
+
+    SubGhzRadioPreset presets[SUBGHZ_HISTORY_PRESET_MAX];
+    size_t preset_count;
+    size_t preset_log_count;
+    SubGhzRadioPreset preset;
+
+    Storage* storage;
+    File* log_file;
+    uint32_t log_size;
+    SubGhzHistoryLogPageArray_t log_pages;
+
+    // Ring of the newest records in the log
+    SubGhzHistoryIndexEntry* index;
+    size_t index_start;
+    size_t index_count;
+
     FuriString* tmp_string;
-    SubGhzHistoryStruct* history;
+    FlipperFormat* flipper_string;
+    FlipperFormat* raw_data;
 };
 
-SubGhzHistory* subghz_history_alloc(void) {
+static inline void subghz_history_lock(SubGhzHistory* instance) {
+    furi_check(furi_mutex_acquire(instance->mutex, FuriWaitForever) == FuriStatusOk);
+}
+
+static inline void subghz_history_unlock(SubGhzHistory* instance) {
+    furi_check(furi_mutex_release(instance->mutex) == FuriStatusOk);
+}
+
+static inline size_t subghz_history_record_get_size(const SubGhzHistoryRecord* record) {
+    return sizeof(SubGhzHistoryRecord) + record->text_size + record->data_size;
+}
+
+static inline const char* subghz_history_record_get_text(const SubGhzHistoryRecord* record) {
+    return (const char*)record + sizeof(SubGhzHistoryRecord);
+}
+
+static inline const uint8_t* subghz_history_record_get_data(const SubGhzHistoryRecord* record) {
+    return (const uint8_t*)record + sizeof(SubGhzHistoryRecord) + record->text_size;
+}
+
+static inline SubGhzHistoryIndexEntry*
+    subghz_history_index_get(SubGhzHistory* instance, size_t i) {
+    return &instance->index[(instance->index_start + i) % SUBGHZ_HISTORY_LOG_INDEX_SIZE];
+}
+
+static SubGhzHistoryRecord* subghz_history_get_record(SubGhzHistory* instance, uint16_t idx) {
+    SubGhzHistoryPage* page = instance->page ? &instance->log_page : &instance->live;
+    furi_check(idx < page->count);
+    return (SubGhzHistoryRecord*)&page->data[page->offsets[idx]];
+}
+
+// Records must fill the page exactly and only use known presets
+static bool subghz_history_page_index(SubGhzHistoryPage* page, size_t preset_count) {
+    size_t offset = 0;
+    page->count = 0;
+    while(offset + sizeof(SubGhzHistoryRecord) <= page->size && page->count < SUBGHZ_HISTORY_MAX) {
+        const SubGhzHistoryRecord* record = (const SubGhzHistoryRecord*)&page->data[offset];
+        const size_t record_size = subghz_history_record_get_size(record);
+        if(offset + record_size > page->size || record->preset >= preset_count) break;
+        page->offsets[page->count++] = offset;
+        offset += record_size;
+    }
+    if(offset != page->size) {
+        FURI_LOG_E(TAG, "Log page is damaged");
+        return false;
+    }
+    return true;
+}
+
+// Oldest entries make room for the new ones
+static void subghz_history_index_add(
+    SubGhzHistory* instance,
+    const SubGhzHistoryRecord* record,
+    uint32_t offset) {
+    if(!instance->index) {
+        instance->index =
+            malloc(sizeof(SubGhzHistoryIndexEntry) * SUBGHZ_HISTORY_LOG_INDEX_SIZE);
+    }
+
+    SubGhzHistoryIndexEntry* entry;
+    if(instance->index_count == SUBGHZ_HISTORY_LOG_INDEX_SIZE) {
+        entry = subghz_history_index_get(instance, 0);
+        instance->index_start = (instance->index_start + 1) % SUBGHZ_HISTORY_LOG_INDEX_SIZE;
+    } else {
+        entry = subghz_history_index_get(instance, instance->index_count++);
+    }
+
+    entry->hash = record->hash;
+    entry->offset = offset;
+    entry->stats = record->stats;
+    entry->type = record->type;
+    entry->dirty = false;
+}
+
+static void subghz_history_index_add_page(
+    SubGhzHistory* instance,
+    const SubGhzHistoryPage* page,
+    uint32_t page_offset) {
+    for(size_t i = 0; i < page->count; i++) {
+        const uint16_t offset = page->offsets[i];
+        subghz_history_index_add(
+            instance, (const SubGhzHistoryRecord*)&page->data[offset], page_offset + offset);
+    }
+}
+
+// Move the whole live page out, so that indexes of log records never change
+static bool subghz_history_swap(SubGhzHistory* instance) {
+    // Previous page is not written yet
+    if(!instance->log_file || instance->pending.size) return false;
+
+    if(!instance->pending.data) {
+        if(memmgr_get_free_heap() < SUBGHZ_HISTORY_ARENA_SIZE + SUBGHZ_HISTORY_FREE_HEAP) {
+            FURI_LOG_E(TAG, "Not enough memory for spill");
+            return false;
+        }
+        instance->pending.data = malloc(SUBGHZ_HISTORY_ARENA_SIZE);
+    }
+
+    // Page is written at the end of the log by the next flush
+    subghz_history_index_add_page(
+        instance, &instance->live, instance->log_size + sizeof(SubGhzHistoryLogBlock));
+
+    const SubGhzHistoryPage page = instance->pending;
+    instance->pending = instance->live;
+    instance->live = page;
+    instance->live.size = 0;
+    instance->live.count = 0;
+
+    return true;
+}
+
+static bool subghz_history_preset_equal(const SubGhzRadioPreset* a, const SubGhzRadioPreset* b) {
+    return a->data_size == b->data_size && furi_string_equal(a->name, b->name) &&
+           (!a->data_size || !memcmp(a->data, b->data, a->data_size));
+}
+
+static bool subghz_history_preset_add(
+    SubGhzHistory* instance,
+    const char* name,
+    const uint8_t* data,
+    size_t data_size) {
+    if(instance->preset_count == SUBGHZ_HISTORY_PRESET_MAX) return false;
+
+    // Preset data is copied, records from the log outlive the settings it came from
+    SubGhzRadioPreset* entry = &instance->presets[instance->preset_count++];
+    entry->name = furi_string_alloc_set(name);
+    entry->data = data_size ? malloc(data_size) : NULL;
+    entry->data_size = data_size;
+    if(data_size) memcpy(entry->data, data, data_size);
+
+    return true;
+}
+
+static int32_t
+    subghz_history_get_preset_index(SubGhzHistory* instance, SubGhzRadioPreset* preset) {
+    for(size_t i = 0; i < instance->preset_count; i++) {
+        if(subghz_history_preset_equal(&instance->presets[i], preset)) return i;
+    }
+    if(!subghz_history_preset_add(
+           instance, furi_string_get_cstr(preset->name), preset->data, preset->data_size)) {
+        return -1;
+    }
+    return instance->preset_count - 1;
+}
+
+static size_t subghz_history_preset_get_log_size(const SubGhzRadioPreset* preset) {
+    return sizeof(SubGhzHistoryLogBlock) + furi_string_size(preset->name) + 1 +
+           preset->data_size;
+}
+
+// Presets of records in the log are dropped with the log, indexes of the rest are compacted
+static void subghz_history_preset_recycle(SubGhzHistory* instance) {
+    SubGhzHistoryPage* pages[] = {&instance->live, &instance->pending};
+    uint8_t remap[SUBGHZ_HISTORY_PRESET_MAX];
+    memset(remap, UINT8_MAX, sizeof(remap));
+
+    for(size_t i = 0; i < COUNT_OF(pages); i++) {
+        for(size_t j = 0; j < pages[i]->count; j++) {
+            const SubGhzHistoryRecord* record =
+                (const SubGhzHistoryRecord*)&pages[i]->data[pages[i]->offsets[j]];
+            remap[record->preset] = 0;
+        }
+    }
+
+    size_t preset_count = 0;
+    for(size_t i = 0; i < instance->preset_count; i++) {
+        if(remap[i] == UINT8_MAX) {
+            furi_string_free(instance->presets[i].name);
+            free(instance->presets[i].data);
+            continue;
+        }
+        remap[i] = preset_count;
+        instance->presets[preset_count++] = instance->presets[i];
+    }
+    instance->preset_count = preset_count;
+
+    for(size_t i = 0; i < COUNT_OF(pages); i++) {
+        for(size_t j = 0; j < pages[i]->count; j++) {
+            SubGhzHistoryRecord* record =
+                (SubGhzHistoryRecord*)&pages[i]->data[pages[i]->offsets[j]];
+            record->preset = remap[record->preset];
+        }
+    }
+}
+
+// Pending page becomes the first page of the log, the shown log page goes away with the log
+static void subghz_history_log_restart(SubGhzHistory* instance) {
+    free(instance->log_page.data);
+    instance->log_page.data = NULL;
+    instance->log_page.count = 0;
+    instance->page = 0;
+
+    SubGhzHistoryLogPageArray_reset(instance->log_pages);
+    instance->index_start = 0;
+    instance->index_count = 0;
+    subghz_history_index_add_page(instance, &instance->pending, sizeof(SubGhzHistoryLogBlock));
+
+    subghz_history_preset_recycle(instance);
+    instance->preset_log_count = 0;
+    instance->is_preset_full = false;
+    instance->log_size = 0;
+}
+
+static bool subghz_history_log_write_block(
+    SubGhzHistory* instance,
+    uint32_t* offset,
+    SubGhzHistoryLogBlockType type,
+    const uint8_t* data,
+    size_t size,
+    const uint8_t* extra_data,
+    size_t extra_size) {
+    const SubGhzHistoryLogBlock block = {.type = type, .size = size + extra_size};
+    if(!storage_file_seek(instance->log_file, *offset, true) ||
+       storage_file_write(instance->log_file, &block, sizeof(block)) != sizeof(block) ||
+       storage_file_write(instance->log_file, data, size) != size ||
+       (extra_size &&
+        storage_file_write(instance->log_file, extra_data, extra_size) != extra_size)) {
+        return false;
+    }
+    *offset += sizeof(block) + size + extra_size;
+    return true;
+}
+
+static void subghz_history_log_load(SubGhzHistory* instance, const char* log_path) {
+    instance->log_file = storage_file_alloc(instance->storage);
+    if(!storage_file_open(instance->log_file, log_path, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+        FURI_LOG_E(TAG, "Unable to open log");
+        storage_file_free(instance->log_file);
+        instance->log_file = NULL;
+        return;
+    }
+
+    const bool is_too_large = storage_file_size(instance->log_file) > SUBGHZ_HISTORY_LOG_SIZE_MAX;
+    uint8_t* data = malloc(SUBGHZ_HISTORY_ARENA_SIZE);
+    const uint32_t tick = furi_get_tick() - SUBGHZ_HISTORY_REPEAT_MS;
+    uint32_t offset = 0;
+
+    // Stops at the first damaged block, everything after it is overwritten
+    while(!is_too_large) {
+        SubGhzHistoryLogBlock block;
+        if(storage_file_read(instance->log_file, &block, sizeof(block)) != sizeof(block)) break;
+        if(block.size > SUBGHZ_HISTORY_ARENA_SIZE ||
+           storage_file_read(instance->log_file, data, block.size) != block.size) {
+            break;
+        }
+
+        if(block.type == SubGhzHistoryLogBlockTypePage) {
+            // Presets are checked when the page is shown, they follow the page
+            SubGhzHistoryPage page = {.data = data, .size = block.size};
+            if(!page.size || !subghz_history_page_index(&page, SUBGHZ_HISTORY_PRESET_MAX)) break;
+
+            const uint32_t page_offset = offset + sizeof(block);
+            for(size_t i = 0; i < page.count; i++) {
+                SubGhzHistoryRecord* record = (SubGhzHistoryRecord*)&data[page.offsets[i]];
+                record->stats.last_tick = tick;
+                subghz_history_index_add(instance, record, page_offset + page.offsets[i]);
+            }
+            const SubGhzHistoryLogPage log_page = {.offset = page_offset, .size = page.size};
+            SubGhzHistoryLogPageArray_push_back(instance->log_pages, log_page);
+        } else if(block.type == SubGhzHistoryLogBlockTypePreset) {
+            const size_t name_size = strnlen((const char*)data, block.size) + 1;
+            if(name_size > block.size ||
+               !subghz_history_preset_add(
+                   instance, (const char*)data, data + name_size, block.size - name_size)) {
+                break;
+            }
+        } else {
+            break;
+        }
+
+        offset += sizeof(block) + block.size;
+    }
+
+    free(data);
+
+    if(is_too_large) FURI_LOG_I(TAG, "Log is too large, starting over");
+    if(!storage_file_seek(instance->log_file, offset, true) ||
+       !storage_file_truncate(instance->log_file)) {
+        FURI_LOG_E(TAG, "Unable to truncate log");
+    }
+    instance->log_size = offset;
+    instance->preset_log_count = instance->preset_count;
+}
+
+SubGhzHistory* subghz_history_alloc(const char* log_path) {
+    furi_assert(log_path);
     SubGhzHistory* instance = malloc(sizeof(SubGhzHistory));
+    instance->mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    instance->live.data = malloc(SUBGHZ_HISTORY_ARENA_SIZE);
+    instance->storage = furi_record_open(RECORD_STORAGE);
+    SubGhzHistoryLogPageArray_init(instance->log_pages);
     instance->tmp_string = furi_string_alloc();
-    instance->history = malloc(sizeof(SubGhzHistoryStruct));
-    SubGhzHistoryItemArray_init(instance->history->data);
+    instance->flipper_string = flipper_format_string_alloc();
+    instance->raw_data = flipper_format_string_alloc();
+    subghz_history_log_load(instance, log_path);
     return instance;
 }
 
 void subghz_history_free(SubGhzHistory* instance) {
     furi_assert(instance);
+    subghz_history_reset(instance);
+    if(instance->log_file) {
+        storage_file_close(instance->log_file);
+        storage_file_free(instance->log_file);
+    }
+    for(size_t i = 0; i < instance->preset_count; i++) {
+        furi_string_free(instance->presets[i].name);
+        free(instance->presets[i].data);
+    }
+    flipper_format_free(instance->raw_data);
+    flipper_format_free(instance->flipper_string);
     furi_string_free(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            furi_string_free(item->item_str);
-            furi_string_free(item->preset->name);
-            free(item->preset);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
-        }
-    SubGhzHistoryItemArray_clear(instance->history->data);
-    free(instance->history);
+    free(instance->index);
+    SubGhzHistoryLogPageArray_clear(instance->log_pages);
+    furi_record_close(RECORD_STORAGE);
+    free(instance->pending.data);
+    free(instance->live.data);
+    furi_mutex_free(instance->mutex);
     free(instance);
 }
 
-uint32_t subghz_history_get_frequency(SubGhzHistory* instance, uint16_t idx) {
+void subghz_history_reset(SubGhzHistory* instance) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->preset->frequency;
+
+    // Records of the session go to the log, the page before them first
+    subghz_history_flush(instance);
+
+    subghz_history_lock(instance);
+    if(instance->live.count && !subghz_history_swap(instance)) {
+        FURI_LOG_E(TAG, "Live page is lost");
+    }
+    furi_string_reset(instance->tmp_string);
+    instance->live.size = 0;
+    instance->live.count = 0;
+    free(instance->log_page.data);
+    instance->log_page.data = NULL;
+    instance->log_page.count = 0;
+    instance->page = 0;
+    instance->is_full = false;
+    subghz_history_unlock(instance);
+
+    subghz_history_flush(instance);
 }
 
-SubGhzRadioPreset* subghz_history_get_radio_preset(SubGhzHistory* instance, uint16_t idx) {
+void subghz_history_flush(SubGhzHistory* instance) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->preset;
+    if(!instance->log_file) return;
+
+    // Only the pending page and the dirty copies are used without the lock
+    subghz_history_lock(instance);
+    const size_t page_size = instance->pending.size;
+    size_t append_size = page_size ? sizeof(SubGhzHistoryLogBlock) + page_size : 0;
+    for(size_t i = instance->preset_log_count; page_size && i < instance->preset_count; i++) {
+        append_size += subghz_history_preset_get_log_size(&instance->presets[i]);
+    }
+    const bool is_restart = instance->log_size + append_size > SUBGHZ_HISTORY_LOG_SIZE_MAX;
+    if(is_restart) subghz_history_log_restart(instance);
+    const uint32_t log_size = instance->log_size;
+    const size_t preset_count = instance->preset_count;
+    size_t dirty_count = 0;
+    for(size_t i = 0; i < instance->index_count; i++) {
+        if(subghz_history_index_get(instance, i)->dirty) dirty_count++;
+    }
+    SubGhzHistoryIndexEntry* dirty = NULL;
+    if(dirty_count) {
+        dirty = malloc(sizeof(SubGhzHistoryIndexEntry) * dirty_count);
+        dirty_count = 0;
+        for(size_t i = 0; i < instance->index_count; i++) {
+            SubGhzHistoryIndexEntry* entry = subghz_history_index_get(instance, i);
+            if(!entry->dirty) continue;
+            dirty[dirty_count++] = *entry;
+            entry->dirty = false;
+        }
+    }
+    subghz_history_unlock(instance);
+
+    if(is_restart) {
+        FURI_LOG_I(TAG, "Log is full, starting over");
+        if(!storage_file_seek(instance->log_file, 0, true) ||
+           !storage_file_truncate(instance->log_file)) {
+            FURI_LOG_E(TAG, "Unable to truncate log");
+        }
+    }
+
+    uint32_t offset = log_size;
+    bool page_written = true;
+    if(page_size) {
+        page_written = subghz_history_log_write_block(
+            instance,
+            &offset,
+            SubGhzHistoryLogBlockTypePage,
+            instance->pending.data,
+            page_size,
+            NULL,
+            0);
+        for(size_t i = instance->preset_log_count; page_written && i < preset_count; i++) {
+            const SubGhzRadioPreset* preset = &instance->presets[i];
+            page_written = subghz_history_log_write_block(
+                instance,
+                &offset,
+                SubGhzHistoryLogBlockTypePreset,
+                (const uint8_t*)furi_string_get_cstr(preset->name),
+                furi_string_size(preset->name) + 1,
+                preset->data,
+                preset->data_size);
+        }
+        if(!page_written) FURI_LOG_E(TAG, "Unable to write log");
+    }
+
+    // Records of a page that failed to be written are updated with the next attempt
+    for(size_t i = 0; i < dirty_count; i++) {
+        if(dirty[i].offset >= log_size && !page_written) continue;
+        if(!storage_file_seek(
+               instance->log_file, dirty[i].offset + offsetof(SubGhzHistoryRecord, stats), true) ||
+           storage_file_write(instance->log_file, &dirty[i].stats, sizeof(dirty[i].stats)) !=
+               sizeof(dirty[i].stats)) {
+            FURI_LOG_E(TAG, "Unable to update log");
+        }
+    }
+    free(dirty);
+
+    subghz_history_lock(instance);
+    if(page_size && page_written) {
+        const SubGhzHistoryLogPage log_page = {
+            .offset = log_size + sizeof(SubGhzHistoryLogBlock),
+            .size = page_size,
+        };
+        SubGhzHistoryLogPageArray_push_back(instance->log_pages, log_page);
+        instance->log_size = offset;
+        instance->preset_log_count = preset_count;
+        instance->pending.size = 0;
+        instance->pending.count = 0;
+    } else if(page_size) {
+        for(size_t i = 0; i < instance->index_count; i++) {
+            SubGhzHistoryIndexEntry* entry = subghz_history_index_get(instance, i);
+            if(entry->offset >= log_size) entry->dirty = true;
+        }
+    }
+    subghz_history_unlock(instance);
 }
 
-const char* subghz_history_get_preset(SubGhzHistory* instance, uint16_t idx) {
+void subghz_history_set_spill_enabled(SubGhzHistory* instance, bool enable) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return furi_string_get_cstr(item->preset->name);
+    subghz_history_lock(instance);
+    instance->spill_enabled = enable;
+    subghz_history_unlock(instance);
 }
 
-void subghz_history_reset(SubGhzHistory* instance) {
+uint16_t subghz_history_get_page_count(SubGhzHistory* instance) {
     furi_assert(instance);
-    furi_string_reset(instance->tmp_string);
-    for
-        M_EACH(item, instance->history->data, SubGhzHistoryItemArray_t) {
-            furi_string_free(item->item_str);
-            furi_string_free(item->preset->name);
-            free(item->preset);
-            flipper_format_free(item->flipper_string);
-            item->type = 0;
+    subghz_history_lock(instance);
+    const uint16_t count = SubGhzHistoryLogPageArray_size(instance->log_pages) + 1;
+    subghz_history_unlock(instance);
+    return count;
+}
+
+uint16_t subghz_history_get_page(SubGhzHistory* instance) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    const uint16_t page = instance->page;
+    subghz_history_unlock(instance);
+    return page;
+}
+
+bool subghz_history_set_page(SubGhzHistory* instance, uint16_t page) {
+    furi_assert(instance);
+    furi_check(page < subghz_history_get_page_count(instance));
+
+    // The live page is shown while the log page is read without the lock
+    subghz_history_lock(instance);
+    uint8_t* data = instance->log_page.data;
+    instance->log_page.data = NULL;
+    instance->log_page.count = 0;
+    instance->page = 0;
+    SubGhzHistoryLogPage log_page = {0};
+    if(page) log_page = *SubGhzHistoryLogPageArray_get(instance->log_pages, page - 1);
+    subghz_history_unlock(instance);
+
+    if(page == 0) {
+        free(data);
+        return true;
+    }
+
+    if(!data) {
+        if(memmgr_get_free_heap() < SUBGHZ_HISTORY_ARENA_SIZE + SUBGHZ_HISTORY_FREE_HEAP) {
+            FURI_LOG_E(TAG, "Not enough memory for log page");
+            return false;
+        }
+        data = malloc(SUBGHZ_HISTORY_ARENA_SIZE);
+    }
+
+    if(!storage_file_seek(instance->log_file, log_page.offset, true) ||
+       storage_file_read(instance->log_file, data, log_page.size) != log_page.size) {
+        FURI_LOG_E(TAG, "Unable to read log");
+        free(data);
+        return false;
+    }
+
+    subghz_history_lock(instance);
+    instance->log_page.data = data;
+    instance->log_page.size = log_page.size;
+    subghz_history_page_index(&instance->log_page, instance->preset_count);
+
+    // Stats in the index are newer than the ones in the log
+    for(size_t i = 0; i < instance->index_count; i++) {
+        const SubGhzHistoryIndexEntry* entry = subghz_history_index_get(instance, i);
+        if(entry->offset < log_page.offset ||
+           entry->offset + sizeof(SubGhzHistoryRecord) > log_page.offset + log_page.size) {
+            continue;
         }
-    SubGhzHistoryItemArray_reset(instance->history->data);
-    instance->last_index_write = 0;
-    instance->code_last_hash_data = 0;
+        SubGhzHistoryRecord* record = (SubGhzHistoryRecord*)&data[entry->offset - log_page.offset];
+        record->stats = entry->stats;
+    }
+    instance->page = page;
+    subghz_history_unlock(instance);
+
+    return true;
+}
+
+uint32_t subghz_history_get_frequency(SubGhzHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    const uint32_t frequency = subghz_history_get_record(instance, idx)->stats.frequency;
+    subghz_history_unlock(instance);
+    return frequency;
+}
+
+SubGhzRadioPreset* subghz_history_get_radio_preset(SubGhzHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    const SubGhzHistoryRecord* record = subghz_history_get_record(instance, idx);
+    instance->preset = instance->presets[record->preset];
+    instance->preset.frequency = record->stats.frequency;
+    subghz_history_unlock(instance);
+    return &instance->preset;
+}
+
+const char* subghz_history_get_preset(SubGhzHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    const SubGhzHistoryRecord* record = subghz_history_get_record(instance, idx);
+    const char* name = furi_string_get_cstr(instance->presets[record->preset].name);
+    subghz_history_unlock(instance);
+    return name;
 }
 
 uint16_t subghz_history_get_item(SubGhzHistory* instance) {
     furi_assert(instance);
-    return instance->last_index_write;
+    subghz_history_lock(instance);
+    const uint16_t count = instance->page ? instance->log_page.count : instance->live.count;
+    subghz_history_unlock(instance);
+    return count;
 }
 
 uint8_t subghz_history_get_type_protocol(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    return item->type;
+    subghz_history_lock(instance);
+    const uint8_t type = subghz_history_get_record(instance, idx)->type;
+    subghz_history_unlock(instance);
+    return type;
 }
 
 const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    flipper_format_rewind(item->flipper_string);
-    if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
-        FURI_LOG_E(TAG, "Missing Protocol");
-        furi_string_reset(instance->tmp_string);
+    subghz_history_lock(instance);
+    const SubGhzHistoryRecord* record = subghz_history_get_record(instance, idx);
+    const char* data = (const char*)subghz_history_record_get_data(record);
+    const size_t key_size = strlen("Protocol: ");
+
+    // Data always starts with the Protocol line
+    furi_string_reset(instance->tmp_string);
+    for(size_t i = key_size; i < record->data_size && data[i] != '\n'; i++) {
+        if(data[i] != '\r') furi_string_push_back(instance->tmp_string, data[i]);
     }
+    subghz_history_unlock(instance);
     return furi_string_get_cstr(instance->tmp_string);
 }
 
+uint16_t subghz_history_get_hit_count(SubGhzHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    const uint16_t hit_count = subghz_history_get_record(instance, idx)->stats.hit_count;
+    subghz_history_unlock(instance);
+    return hit_count;
+}
+
+uint32_t subghz_history_get_last_seen(SubGhzHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+    subghz_history_lock(instance);
+    const uint32_t last_seen = subghz_history_get_record(instance, idx)->stats.last_seen;
+    subghz_history_unlock(instance);
+    return last_seen;
+}
+
 FlipperFormat* subghz_history_get_raw_data(SubGhzHistory* instance, uint16_t idx) {
     furi_assert(instance);
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    if(item->flipper_string) {
-        return item->flipper_string;
-    } else {
+    subghz_history_lock(instance);
+    const SubGhzHistoryRecord* record = subghz_history_get_record(instance, idx);
+    SubGhzRadioPreset* preset = subghz_history_get_radio_preset(instance, idx);
+    Stream* stream = flipper_format_get_raw_stream(instance->raw_data);
+    FuriString* preset_str = furi_string_alloc();
+    bool result = false;
+
+    // Same header as subghz_block_generic_serialize
+    do {
+        stream_clean(stream);
+        if(!flipper_format_write_header_cstr(
+               instance->raw_data, SUBGHZ_KEY_FILE_TYPE, SUBGHZ_KEY_FILE_VERSION))
+            break;
+        if(!flipper_format_write_uint32(instance->raw_data, "Frequency", &preset->frequency, 1))
+            break;
+        subghz_block_generic_get_preset_name(furi_string_get_cstr(preset->name), preset_str);
+        if(!flipper_format_write_string(instance->raw_data, "Preset", preset_str)) break;
+        if(!furi_string_cmp_str(preset_str, "FuriHalSubGhzPresetCustom")) {
+            if(!flipper_format_write_string_cstr(
+                   instance->raw_data, "Custom_preset_module", "CC1101"))
+                break;
+            if(!flipper_format_write_hex(
+                   instance->raw_data, "Custom_preset_data", preset->data, preset->data_size))
+                break;
+        }
+        if(stream_write(stream, subghz_history_record_get_data(record), record->data_size) !=
+           record->data_size)
+            break;
+        result = flipper_format_rewind(instance->raw_data);
+    } while(false);
+
+    subghz_history_unlock(instance);
+    furi_string_free(preset_str);
+
+    if(!result) {
+        FURI_LOG_E(TAG, "Unable to restore record");
         return NULL;
     }
+    return instance->raw_data;
 }
+
 bool subghz_history_get_text_space_left(SubGhzHistory* instance, FuriString* output) {
     furi_assert(instance);
-    if(memmgr_get_free_heap() < SUBGHZ_HISTORY_FREE_HEAP) {
-        if(output != NULL) furi_string_printf(output, "    Free heap LOW");
+    subghz_history_lock(instance);
+    const uint16_t page = instance->page;
+    const uint16_t log_page_count = SubGhzHistoryLogPageArray_size(instance->log_pages);
+    const bool is_full = instance->is_full;
+    const bool is_preset_full = instance->is_preset_full;
+    const uint16_t count = instance->live.count;
+    subghz_history_unlock(instance);
+
+    if(page) {
+        if(output != NULL) furi_string_printf(output, "P%u/%u", page, log_page_count);
+        return false;
+    }
+    if(is_preset_full) {
+        if(output != NULL) furi_string_printf(output, "  Too many presets");
         return true;
     }
-    if(instance->last_index_write == SUBGHZ_HISTORY_MAX) {
+    if(is_full) {
         if(output != NULL) furi_string_printf(output, "   Memory is FULL");
         return true;
     }
-    if(output != NULL)
-        furi_string_printf(output, "%02u/%02u", instance->last_index_write, SUBGHZ_HISTORY_MAX);
+    if(output != NULL) furi_string_printf(output, "%02u/%02u", count, SUBGHZ_HISTORY_MAX);
     return false;
 }
 
 void subghz_history_get_text_item_menu(SubGhzHistory* instance, FuriString* output, uint16_t idx) {
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_get(instance->history->data, idx);
-    furi_string_set(output, item->item_str);
-}
-
-bool subghz_history_add_to_history(
-    SubGhzHistory* instance,
-    void* context,
-    SubGhzRadioPreset* preset) {
     furi_assert(instance);
-    furi_assert(context);
-
-    if(memmgr_get_free_heap() < SUBGHZ_HISTORY_FREE_HEAP) return false;
-    if(instance->last_index_write >= SUBGHZ_HISTORY_MAX) return false;
-
-    SubGhzProtocolDecoderBase* decoder_base = context;
-    if((instance->code_last_hash_data ==
-        subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
-       ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
-        instance->last_update_timestamp = furi_get_tick();
-        return false;
+    subghz_history_lock(instance);
+    const SubGhzHistoryRecord* record = subghz_history_get_record(instance, idx);
+    // Hit count goes first, long names are cut at the end
+    if(record->stats.hit_count > 1) {
+        furi_string_printf(
+            output, "%ux %s", record->stats.hit_count, subghz_history_record_get_text(record));
+    } else {
+        furi_string_set(output, subghz_history_record_get_text(record));
     }
+    subghz_history_unlock(instance);
+}
 
-    instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
-    instance->last_update_timestamp = furi_get_tick();
-
-    FuriString* text;
-    text = furi_string_alloc();
-    SubGhzHistoryItem* item = SubGhzHistoryItemArray_push_raw(instance->history->data);
-    item->preset = malloc(sizeof(SubGhzRadioPreset));
-    item->type = decoder_base->protocol->type;
-    item->preset->frequency = preset->frequency;
-    item->preset->name = furi_string_alloc();
-    furi_string_set(item->preset->name, preset->name);
-    item->preset->data = preset->data;
-    item->preset->data_size = preset->data_size;
-
-    item->item_str = furi_string_alloc();
-    item->flipper_string = flipper_format_string_alloc();
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, preset);
+static void subghz_history_get_text_item(FlipperFormat* flipper_string, FuriString* output) {
+    FuriString* protocol = furi_string_alloc();
+    FuriString* text = furi_string_alloc();
 
     do {
-        if(!flipper_format_rewind(item->flipper_string)) {
+        if(!flipper_format_rewind(flipper_string)) {
             FURI_LOG_E(TAG, "Rewind error");
             break;
         }
-        if(!flipper_format_read_string(item->flipper_string, "Protocol", instance->tmp_string)) {
+        if(!flipper_format_read_string(flipper_string, "Protocol", protocol)) {
             FURI_LOG_E(TAG, "Missing Protocol");
             break;
         }
-        if(!strcmp(furi_string_get_cstr(instance->tmp_string), "KeeLoq")) {
-            furi_string_set(instance->tmp_string, "KL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
+        if(!strcmp(furi_string_get_cstr(protocol), "KeeLoq")) {
+            furi_string_set(protocol, "KL ");
+            if(!flipper_format_read_string(flipper_string, "Manufacture", text)) {
                 FURI_LOG_E(TAG, "Missing Protocol");
                 break;
             }
-            furi_string_cat(instance->tmp_string, text);
-        } else if(!strcmp(furi_string_get_cstr(instance->tmp_string), "Star Line")) {
-            furi_string_set(instance->tmp_string, "SL ");
-            if(!flipper_format_read_string(item->flipper_string, "Manufacture", text)) {
+            furi_string_cat(protocol, text);
+        } else if(!strcmp(furi_string_get_cstr(protocol), "Star Line")) {
+            furi_string_set(protocol, "SL ");
+            if(!flipper_format_read_string(flipper_string, "Manufacture", text)) {
                 FURI_LOG_E(TAG, "Missing Protocol");
                 break;
             }
-            furi_string_cat(instance->tmp_string, text);
+            furi_string_cat(protocol, text);
         }
-        if(!flipper_format_rewind(item->flipper_string)) {
+        if(!flipper_format_rewind(flipper_string)) {
             FURI_LOG_E(TAG, "Rewind error");
             break;
         }
         uint8_t key_data[sizeof(uint64_t)] = {0};
-        if(!flipper_format_read_hex(item->flipper_string, "Key", key_data, sizeof(uint64_t))) {
+        if(!flipper_format_read_hex(flipper_string, "Key", key_data, sizeof(uint64_t))) {
             FURI_LOG_D(TAG, "No Key");
         }
         uint64_t data = 0;
@@ -215,25 +827,176 @@ bool subghz_history_add_to_history(
         if(data != 0) {
             if(!(uint32_t)(data >> 32)) {
                 furi_string_printf(
-                    item->item_str,
+                    output,
                     "%s %lX",
-                    furi_string_get_cstr(instance->tmp_string),
+                    furi_string_get_cstr(protocol),
                     (uint32_t)(data & 0xFFFFFFFF));
             } else {
                 furi_string_printf(
-                    item->item_str,
+                    output,
                     "%s %lX%08lX",
-                    furi_string_get_cstr(instance->tmp_string),
+                    furi_string_get_cstr(protocol),
                     (uint32_t)(data >> 32),
                     (uint32_t)(data & 0xFFFFFFFF));
             }
         } else {
-            furi_string_printf(item->item_str, "%s", furi_string_get_cstr(instance->tmp_string));
+            furi_string_printf(output, "%s", furi_string_get_cstr(protocol));
+        }
+    } while(false);
+
+    furi_string_free(text);
+    furi_string_free(protocol);
+}
+
+/*
+ * Hash of the serialized signal without the radio settings and the measured TE,
+ * so that the same key received again matches its record.
+ */
+static uint32_t subghz_history_get_hash(FlipperFormat* flipper_string, size_t* data_offset) {
+    Stream* stream = flipper_format_get_raw_stream(flipper_string);
+    FuriString* line = furi_string_alloc();
+    uint32_t hash = 2166136261UL; // FNV-1a
+    *data_offset = SIZE_MAX;
+
+    stream_rewind(stream);
+    while(true) {
+        const size_t line_offset = stream_tell(stream);
+        if(!stream_read_line(stream, line)) break;
+
+        if(*data_offset == SIZE_MAX) {
+            if(!furi_string_start_with_str(line, "Protocol:")) continue;
+            *data_offset = line_offset;
+        }
+        if(furi_string_start_with_str(line, "TE:")) continue;
+
+        const char* str = furi_string_get_cstr(line);
+        for(size_t i = 0; i < furi_string_size(line); i++) {
+            hash = (hash ^ (uint8_t)str[i]) * 16777619UL;
+        }
+    }
+
+    furi_string_free(line);
+    return hash;
+}
+
+// Records in the log are matched through the index, their stats change on every match
+static SubGhzHistoryRecordStats*
+    subghz_history_find_stats(SubGhzHistory* instance, uint32_t hash, uint8_t type) {
+    for(size_t i = 0; i < instance->live.count; i++) {
+        SubGhzHistoryRecord* record =
+            (SubGhzHistoryRecord*)&instance->live.data[instance->live.offsets[i]];
+        if(record->hash == hash && record->type == type) return &record->stats;
+    }
+    for(size_t i = instance->index_count; i > 0; i--) {
+        SubGhzHistoryIndexEntry* entry = subghz_history_index_get(instance, i - 1);
+        if(entry->hash == hash && entry->type == type) {
+            entry->dirty = true;
+            return &entry->stats;
+        }
+    }
+    return NULL;
+}
+
+SubGhzHistoryAddResult subghz_history_add_to_history(
+    SubGhzHistory* instance,
+    void* context,
+    SubGhzRadioPreset* preset) {
+    furi_assert(instance);
+    furi_assert(context);
+
+    SubGhzProtocolDecoderBase* decoder_base = context;
+    if(subghz_protocol_decoder_base_serialize(decoder_base, instance->flipper_string, preset) !=
+       SubGhzProtocolStatusOk) {
+        FURI_LOG_E(TAG, "Unable to serialize");
+        return SubGhzHistoryAddResultIgnored;
+    }
+
+    size_t data_offset;
+    const uint32_t hash = subghz_history_get_hash(instance->flipper_string, &data_offset);
+    if(data_offset == SIZE_MAX) {
+        FURI_LOG_E(TAG, "Missing Protocol");
+        return SubGhzHistoryAddResultIgnored;
+    }
+
+    const uint32_t tick = furi_get_tick();
+    const uint32_t timestamp = furi_hal_rtc_get_timestamp();
+    SubGhzHistoryAddResult result = SubGhzHistoryAddResultIgnored;
+    FuriString* text = furi_string_alloc();
+
+    subghz_history_lock(instance);
+
+    do {
+        SubGhzHistoryRecordStats* stats =
+            subghz_history_find_stats(instance, hash, decoder_base->protocol->type);
+        if(stats) {
+            // Repeats within one transmission are not counted
+            const bool is_repeat = (tick - stats->last_tick) < SUBGHZ_HISTORY_REPEAT_MS;
+            stats->last_tick = tick;
+            if(is_repeat) break;
+
+            stats->last_seen = timestamp;
+            stats->frequency = preset->frequency;
+            if(stats->hit_count < UINT16_MAX) stats->hit_count++;
+            result = SubGhzHistoryAddResultUpdated;
+            break;
+        }
+
+        // Preset slots are recycled when the log starts over
+        const int32_t preset_index = subghz_history_get_preset_index(instance, preset);
+        if(preset_index < 0) {
+            FURI_LOG_E(TAG, "Too many presets");
+            instance->is_preset_full = true;
+            break;
+        }
+
+        subghz_history_get_text_item(instance->flipper_string, text);
+
+        Stream* stream = flipper_format_get_raw_stream(instance->flipper_string);
+        const size_t text_size = furi_string_size(text) + 1;
+        const size_t data_size = stream_size(stream) - data_offset;
+        const size_t record_size = sizeof(SubGhzHistoryRecord) + text_size + data_size;
+        if(record_size > SUBGHZ_HISTORY_ARENA_SIZE) {
+            FURI_LOG_E(TAG, "Record is too large");
+            break;
         }
 
+        result = SubGhzHistoryAddResultNew;
+        if(instance->live.count == SUBGHZ_HISTORY_MAX ||
+           instance->live.size + record_size > SUBGHZ_HISTORY_ARENA_SIZE) {
+            if(!instance->spill_enabled || !subghz_history_swap(instance)) {
+                // Not full if the page only has to wait for spilling or for the flush
+                instance->is_full = instance->spill_enabled && !instance->pending.size;
+                result = SubGhzHistoryAddResultIgnored;
+                break;
+            }
+            instance->is_full = false;
+            result = SubGhzHistoryAddResultUpdated;
+        }
+
+        uint8_t* data = &instance->live.data[instance->live.size];
+        SubGhzHistoryRecord* record = (SubGhzHistoryRecord*)data;
+        record->hash = hash;
+        record->first_seen = timestamp;
+        record->stats.frequency = preset->frequency;
+        record->stats.last_seen = timestamp;
+        record->stats.last_tick = tick;
+        record->stats.hit_count = 1;
+        record->text_size = text_size;
+        record->data_size = data_size;
+        record->type = decoder_base->protocol->type;
+        record->preset = preset_index;
+
+        memcpy(data + sizeof(SubGhzHistoryRecord), furi_string_get_cstr(text), text_size);
+        stream_seek(stream, data_offset, StreamOffsetFromStart);
+        stream_read(stream, data + sizeof(SubGhzHistoryRecord) + text_size, data_size);
+
+        instance->live.offsets[instance->live.count++] = instance->live.size;
+        instance->live.size += record_size;
+        instance->is_preset_full = false;
     } while(false);
 
+    subghz_history_unlock(instance);
     furi_string_free(text);
-    instance->last_index_write++;
-    return true;
+
+    return result;
 }
@@ -1,75 +1,152 @@
-
 #pragma once
 
 #include <math.h>
 #include <furi.h>
 #include <furi_hal.h>
 #include <lib/flipper_format/flipper_format.h>
+#include <storage/storage.h>
 #include <lib/subghz/types.h>
 
+#define SUBGHZ_HISTORY_MAX 50
+#define SUBGHZ_HISTORY_LOG_PATH EXT_PATH("subghz/.history.log")
+/** Number of the newest records in the log that repeats are still matched with */
+#define SUBGHZ_HISTORY_LOG_INDEX_SIZE 256
+
 typedef struct SubGhzHistory SubGhzHistory;
 
+/** Result of adding a signal to history */
+typedef enum {
+    SubGhzHistoryAddResultIgnored, /**< Repeat of the same transmission or no space left */
+    SubGhzHistoryAddResultNew, /**< New record appended to the live page */
+    SubGhzHistoryAddResultUpdated, /**< Hit count changed or the live page was moved to the log */
+} SubGhzHistoryAddResult;
+
 /** Allocate SubGhzHistory
- * 
- * @return SubGhzHistory* 
+ * Pages from previous sessions are loaded from the log, a log over 1 MiB is started over.
+ * The log is also started over when a flush would make it grow over 1 MiB.
+ *
+ * @param log_path  - log file path, SUBGHZ_HISTORY_LOG_PATH in the application
+ * @return SubGhzHistory*
  */
-SubGhzHistory* subghz_history_alloc(void);
+SubGhzHistory* subghz_history_alloc(const char* log_path);
 
-/** Free SubGhzHistory
- * 
+/** Free SubGhzHistory, records of the live page are moved to the log
+ *
  * @param instance - SubGhzHistory instance
  */
 void subghz_history_free(SubGhzHistory* instance);
 
-/** Clear history
- * 
+/** Start a new session, records of the live page are moved to the log
+ *
  * @param instance - SubGhzHistory instance
  */
 void subghz_history_reset(SubGhzHistory* instance);
 
+/** Write the page moved out of the live page and the updated hit counts to the log
+ * Adding never touches the SD card, call this from the GUI thread after
+ * SubGhzHistoryAddResultUpdated. When the log starts over, the live page is shown again
+ * and presets only used by the dropped pages are freed.
+ *
+ * @param instance - SubGhzHistory instance
+ */
+void subghz_history_flush(SubGhzHistory* instance);
+
+/** Allow moving the full live page to the log on the SD card
+ * Must be disabled while a record index is in use outside of the receiver list.
+ *
+ * @param instance  - SubGhzHistory instance
+ * @param enable    - true to allow
+ */
+void subghz_history_set_spill_enabled(SubGhzHistory* instance, bool enable);
+
+/** Get number of pages, the live page and the pages in the log
+ *
+ * @param instance  - SubGhzHistory instance
+ * @return count    - page count, at least 1
+ */
+uint16_t subghz_history_get_page_count(SubGhzHistory* instance);
+
+/** Get current page, record indexes below refer to it
+ *
+ * @param instance  - SubGhzHistory instance
+ * @return page     - 0 for the live page, oldest log page is 1
+ */
+uint16_t subghz_history_get_page(SubGhzHistory* instance);
+
+/** Set current page, log pages are loaded from the SD card
+ *
+ * @param instance  - SubGhzHistory instance
+ * @param page      - 0 for the live page, oldest log page is 1
+ * @return bool     - true if the page is loaded
+ */
+bool subghz_history_set_page(SubGhzHistory* instance, uint16_t page);
+
 /** Get frequency to history[idx]
- * 
+ *
  * @param instance  - SubGhzHistory instance
- * @param idx       - record index  
+ * @param idx       - record index
  * @return frequency - frequency Hz
  */
 uint32_t subghz_history_get_frequency(SubGhzHistory* instance, uint16_t idx);
 
+/** Get radio preset to history[idx]
+ * Returned preset is valid until the next call.
+ *
+ * @param instance  - SubGhzHistory instance
+ * @param idx       - record index
+ * @return preset   - SubGhzRadioPreset*
+ */
 SubGhzRadioPreset* subghz_history_get_radio_preset(SubGhzHistory* instance, uint16_t idx);
 
 /** Get preset to history[idx]
- * 
+ *
  * @param instance  - SubGhzHistory instance
- * @param idx       - record index  
+ * @param idx       - record index
  * @return preset   - preset name
  */
 const char* subghz_history_get_preset(SubGhzHistory* instance, uint16_t idx);
 
-/** Get history index write 
- * 
+/** Get number of records in the current page
+ *
  * @param instance  - SubGhzHistory instance
- * @return idx      - current record index  
+ * @return count    - record count
  */
 uint16_t subghz_history_get_item(SubGhzHistory* instance);
 
 /** Get type protocol to history[idx]
- * 
+ *
  * @param instance  - SubGhzHistory instance
- * @param idx       - record index  
- * @return type      - type protocol  
+ * @param idx       - record index
+ * @return type      - type protocol
  */
 uint8_t subghz_history_get_type_protocol(SubGhzHistory* instance, uint16_t idx);
 
 /** Get name protocol to history[idx]
- * 
+ *
  * @param instance  - SubGhzHistory instance
- * @param idx       - record index  
- * @return name      - const char* name protocol  
+ * @param idx       - record index
+ * @return name      - const char* name protocol
  */
 const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t idx);
 
+/** Get number of receptions to history[idx]
+ *
+ * @param instance  - SubGhzHistory instance
+ * @param idx       - record index
+ * @return count    - hit count
+ */
+uint16_t subghz_history_get_hit_count(SubGhzHistory* instance, uint16_t idx);
+
+/** Get last reception time to history[idx]
+ *
+ * @param instance  - SubGhzHistory instance
+ * @param idx       - record index
+ * @return timestamp - RTC timestamp
+ */
+uint32_t subghz_history_get_last_seen(SubGhzHistory* instance, uint16_t idx);
+
 /** Get string item menu to history[idx]
- * 
+ *
  * @param instance  - SubGhzHistory instance
  * @param output    - FuriString* output
  * @param idx       - record index
@@ -77,7 +154,8 @@ const char* subghz_history_get_protocol_name(SubGhzHistory* instance, uint16_t i
 void subghz_history_get_text_item_menu(SubGhzHistory* instance, FuriString* output, uint16_t idx);
 
 /** Get string the remaining number of records to history
- * 
+ * Also reports when a record was dropped because its preset did not fit the preset table.
+ *
  * @param instance  - SubGhzHistory instance
  * @param output    - FuriString* output
  * @return bool - is FUUL
@@ -85,19 +163,22 @@ void subghz_history_get_text_item_menu(SubGhzHistory* instance, FuriString* outp
 bool subghz_history_get_text_space_left(SubGhzHistory* instance, FuriString* output);
 
 /** Add protocol to history
- * 
+ * Repeats of a known signal only update its hit count and last seen time, records in
+ * the log are matched while they are among the last SUBGHZ_HISTORY_LOG_INDEX_SIZE.
+ *
  * @param instance  - SubGhzHistory instance
  * @param context    - SubGhzProtocolCommon context
  * @param preset    - SubGhzRadioPreset preset
- * @return bool;
+ * @return SubGhzHistoryAddResult
  */
-bool subghz_history_add_to_history(
+SubGhzHistoryAddResult subghz_history_add_to_history(
     SubGhzHistory* instance,
     void* context,
     SubGhzRadioPreset* preset);
 
 /** Get SubGhzProtocolCommonLoad to load into the protocol decoder bin data
- * 
+ * Returned data is valid until the next call.
+ *
  * @param instance  - SubGhzHistory instance
  * @param idx       - record index
  * @return SubGhzProtocolCommonLoad*
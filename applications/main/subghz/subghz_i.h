@@ -65,6 +65,7 @@ struct SubGhz {
     FuriString* error_str;
     SubGhzLock lock;
     SubGhzThresholdRssi* threshold_rssi;
+    SubGhzProtocolRawFileFormat raw_file_format;
     SubGhzRxKeyState rx_key_state;
     SubGhzHistory* history;
     uint16_t idx_menu_chosen;
@@ -361,6 +361,8 @@ bool subghz_view_receiver_input(InputEvent* event, void* context) {
             true);
     } else if(event->key == InputKeyLeft && event->type == InputTypeShort) {
         subghz_receiver->callback(SubGhzCustomEventViewReceiverConfig, subghz_receiver->context);
+    } else if(event->key == InputKeyRight && event->type == InputTypeShort) {
+        subghz_receiver->callback(SubGhzCustomEventViewReceiverPage, subghz_receiver->context);
     } else if(event->key == InputKeyOk && event->type == InputTypeShort) {
         with_view_model(
             subghz_receiver->view,
@@ -383,6 +385,25 @@ void subghz_view_receiver_enter(void* context) {
     furi_assert(context);
 }
 
+void subghz_view_receiver_reset_menu(SubGhzViewReceiver* subghz_receiver) {
+    furi_assert(subghz_receiver);
+    with_view_model(
+        subghz_receiver->view,
+        SubGhzViewReceiverModel * model,
+        {
+            for
+                M_EACH(item_menu, model->history->data, SubGhzReceiverMenuItemArray_t) {
+                    furi_string_free(item_menu->item_str);
+                    item_menu->type = 0;
+                }
+            SubGhzReceiverMenuItemArray_reset(model->history->data);
+            model->idx = 0;
+            model->list_offset = 0;
+            model->history_item = 0;
+        },
+        false);
+}
+
 void subghz_view_receiver_exit(void* context) {
     furi_assert(context);
     SubGhzViewReceiver* subghz_receiver = context;
@@ -393,17 +414,9 @@ void subghz_view_receiver_exit(void* context) {
             furi_string_reset(model->frequency_str);
             furi_string_reset(model->preset_str);
             furi_string_reset(model->history_stat_str);
-                for
-                    M_EACH(item_menu, model->history->data, SubGhzReceiverMenuItemArray_t) {
-                        furi_string_free(item_menu->item_str);
-                        item_menu->type = 0;
-                    }
-                SubGhzReceiverMenuItemArray_reset(model->history->data);
-                model->idx = 0;
-                model->list_offset = 0;
-                model->history_item = 0;
         },
         false);
+    subghz_view_receiver_reset_menu(subghz_receiver);
     furi_timer_stop(subghz_receiver->timer);
 }
 
@@ -22,6 +22,8 @@ typedef struct {
     FuriString* preset_str;
     FuriString* sample_write;
     FuriString* file_name;
+    size_t samples_dropped;
+    uint32_t write_ms_max;
     uint8_t* rssi_history;
     uint8_t rssi_curret;
     bool rssi_history_end;
@@ -104,6 +106,22 @@ void subghz_read_raw_update_sample_write(SubGhzReadRAW* instance, size_t sample)
         false);
 }
 
+void subghz_read_raw_update_write_stats(
+    SubGhzReadRAW* instance,
+    size_t samples_dropped,
+    uint32_t write_ms_max) {
+    furi_assert(instance);
+
+    with_view_model(
+        instance->view,
+        SubGhzReadRAWModel * model,
+        {
+            model->samples_dropped = samples_dropped;
+            model->write_ms_max = write_ms_max;
+        },
+        false);
+}
+
 void subghz_read_raw_stop_send(SubGhzReadRAW* instance) {
     furi_assert(instance);
 
@@ -284,6 +302,16 @@ void subghz_read_raw_draw_threshold_rssi(Canvas* canvas, SubGhzReadRAWModel* mod
     canvas_draw_dot(canvas, x - 2, y);
 }
 
+static void subghz_read_raw_draw_write_stats(Canvas* canvas, SubGhzReadRAWModel* model) {
+    char buffer[16];
+
+    // Samples lost while waiting for the SD card, slowest write to it
+    snprintf(buffer, sizeof(buffer), "D:%zu", model->samples_dropped);
+    canvas_draw_str(canvas, 0, 62, buffer);
+    snprintf(buffer, sizeof(buffer), "W:%lums", model->write_ms_max);
+    canvas_draw_str_aligned(canvas, 115, 62, AlignRight, AlignBottom, buffer);
+}
+
 void subghz_read_raw_draw(Canvas* canvas, SubGhzReadRAWModel* model) {
     uint8_t graphics_mode = 1;
     canvas_set_color(canvas, ColorBlack);
@@ -337,6 +365,11 @@ void subghz_read_raw_draw(Canvas* canvas, SubGhzReadRAWModel* model) {
         elements_button_center(canvas, "REC");
         break;
 
+    case SubGhzReadRAWStatusREC:
+        elements_button_center(canvas, "Stop");
+        subghz_read_raw_draw_write_stats(canvas, model);
+        break;
+
     default:
         elements_button_center(canvas, "Stop");
         break;
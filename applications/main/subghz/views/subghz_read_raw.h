@@ -43,6 +43,11 @@ void subghz_read_raw_set_radio_device_type(
 
 void subghz_read_raw_update_sample_write(SubGhzReadRAW* instance, size_t sample);
 
+void subghz_read_raw_update_write_stats(
+    SubGhzReadRAW* instance,
+    size_t samples_dropped,
+    uint32_t write_ms_max);
+
 void subghz_read_raw_stop_send(SubGhzReadRAW* instance);
 
 void subghz_read_raw_update_sin(SubGhzReadRAW* instance);
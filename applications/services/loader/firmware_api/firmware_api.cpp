@@ -23,14 +23,19 @@ constexpr HashtableApiInterface mock_elf_api_interface{
 
 const ElfApiInterface* const firmware_api_interface = &mock_elf_api_interface;
 #else
-constexpr HashtableApiInterface elf_api_interface{
+/* Collision-free lookup table, built at compile time from sorted API table */
+static constexpr auto elf_api_perfect_hash = build_perfect_hash(elf_api_table);
+
+constexpr PerfectHashApiInterface elf_api_interface{
     {
         .api_version_major = (elf_api_version >> 16),
         .api_version_minor = (elf_api_version & 0xFFFF),
-        .resolver_callback = &elf_resolve_from_hashtable,
+        .resolver_callback = &elf_resolve_from_perfect_hash,
     },
-    elf_api_table.cbegin(),
-    elf_api_table.cend(),
+    elf_api_perfect_hash.seeds.data(),
+    elf_api_perfect_hash.seeds.size(),
+    elf_api_perfect_hash.slots.data(),
+    elf_api_perfect_hash.slots.size(),
 };
 const ElfApiInterface* const firmware_api_interface = &elf_api_interface;
 #endif
@@ -255,6 +255,11 @@ static int32_t js_thread(void* arg) {
 
     mjs_set_exec_flags_poller(mjs, js_exit_flag_poll);
 
+    // Keep precompiled bytecode in .jsc files next to the scripts
+    mjs_set_generate_jsc(mjs, 1);
+    // Collect garbage in small steps to avoid noticeable pauses
+    mjs_set_gc_incremental(mjs, 1);
+
     mjs_err_t err = mjs_exec_file(mjs, furi_string_get_cstr(worker->path), NULL);
 
 #ifdef JS_DEBUG
@@ -278,6 +283,16 @@ static int32_t js_thread(void* arg) {
     }
 #endif
 
+    struct mjs_gc_stats gc_stats;
+    mjs_get_gc_stats(mjs, &gc_stats);
+    FURI_LOG_I(
+        TAG,
+        "GC: %lu minor, %lu major, max pause %luus, total %luus",
+        gc_stats.minor_collections,
+        gc_stats.major_collections,
+        gc_stats.max_pause_us,
+        (uint32_t)gc_stats.total_pause_us);
+
     if(err != MJS_OK) {
         FURI_LOG_E(TAG, "Exec error: %s", mjs_strerror(mjs, err));
         if(worker->app_callback) {
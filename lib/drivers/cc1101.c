@@ -126,9 +126,20 @@ uint32_t cc1101_set_frequency(FuriHalSpiBusHandle* handle, uint32_t value) {
     // Sanity check
     assert((real_value & CC1101_FMASK) == real_value);
 
-    cc1101_write_reg(handle, CC1101_FREQ2, (real_value >> 16) & 0xFF);
-    cc1101_write_reg(handle, CC1101_FREQ1, (real_value >> 8) & 0xFF);
-    cc1101_write_reg(handle, CC1101_FREQ0, (real_value >> 0) & 0xFF);
+    // FREQ2, FREQ1 and FREQ0 are consecutive, write them in one burst
+    uint8_t tx[4] = {
+        CC1101_FREQ2 | CC1101_BURST,
+        (real_value >> 16) & 0xFF,
+        (real_value >> 8) & 0xFF,
+        (real_value >> 0) & 0xFF,
+    };
+    CC1101Status rx[4] = {0};
+    rx[0].CHIP_RDYn = 1;
+    rx[3].CHIP_RDYn = 1;
+
+    cc1101_spi_trx(handle, tx, (uint8_t*)rx, sizeof(rx));
+
+    assert((rx[0].CHIP_RDYn | rx[3].CHIP_RDYn) == 0);
 
     uint64_t real_frequency = real_value * CC1101_QUARTZ / CC1101_FDIV;
 
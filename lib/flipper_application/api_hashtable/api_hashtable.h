@@ -28,6 +28,18 @@ bool elf_resolve_from_hashtable(
     uint32_t hash,
     Elf32_Addr* address);
 
+/**
+ * @brief Resolver for API entries using a minimal perfect hash table
+ * @param interface pointer to PerfectHashApiInterface
+ * @param hash gnu hash of function name
+ * @param address output for function address
+ * @return true if the table contains a function
+ */
+bool elf_resolve_from_perfect_hash(
+    const ElfApiInterface* interface,
+    uint32_t hash,
+    Elf32_Addr* address);
+
 uint32_t elf_symbolname_hash(const char* s);
 
 #ifdef __cplusplus
@@ -45,6 +57,18 @@ struct HashtableApiInterface : public ElfApiInterface {
     const sym_entry *table_cbegin, *table_cend;
 };
 
+/**
+ * @brief  PerfectHashApiInterface is an implementation of ElfApiInterface
+ * that uses a minimal perfect hash to resolve function addresses in O(1).
+ * seeds and slots must be built with build_perfect_hash() from compilesort.hpp
+ */
+struct PerfectHashApiInterface : public ElfApiInterface {
+    const uint16_t* seeds;
+    uint32_t bucket_count;
+    const sym_entry* slots;
+    uint32_t slot_count;
+};
+
 #define API_METHOD(x, ret_type, args_type)                                                     \
     sym_entry {                                                                                \
         .hash = elf_gnu_hash(#x), .address = (uint32_t)(static_cast<ret_type(*) args_type>(x)) \
@@ -72,6 +96,41 @@ constexpr uint32_t elf_gnu_hash(const char* s) {
     return h;
 }
 
+/**
+ * @brief Scramble symbol hash with a seed for perfect hash placement
+ * @param hash gnu hash of symbol name
+ * @param seed bucket seed, 0 is used for bucket selection
+ * @return mixed value
+ */
+constexpr uint32_t elf_perfect_hash_mix(uint32_t hash, uint32_t seed) {
+    uint32_t h = hash ^ (seed * 0x9E3779B9UL);
+    h ^= h >> 16;
+    h *= 0x85EBCA6BUL;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35UL;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * @brief Map mixed value to [0, range) without division
+ * @param value mixed value
+ * @param range range size
+ * @return index in range
+ */
+constexpr uint32_t elf_perfect_hash_reduce(uint32_t value, uint32_t range) {
+    return (uint32_t)(((uint64_t)value * range) >> 32);
+}
+
+/**
+ * @brief Number of buckets (seeds) for a perfect hash table with N entries
+ * @param count number of entries
+ * @return bucket count
+ */
+constexpr std::size_t elf_perfect_hash_bucket_count(std::size_t count) {
+    return (count + 1) / 2;
+}
+
 /* Compile-time check for hash collisions in API table.
  * Usage: static_assert(!has_hash_collisions(api_methods), "Hash collision detected"); 
  */
@@ -1,11 +1,14 @@
 /**
- * Implementation of compile-time sort for symbol table entries.
+ * Implementation of compile-time sort and perfect hash construction
+ * for symbol table entries.
  */
 
 #pragma once
 
 #ifdef __cplusplus
 
+#include "api_hashtable.h"
+
 #include <iterator>
 #include <array>
 
@@ -112,4 +115,97 @@ constexpr auto create_array_t(const Ts&&... values) {
     return std::array<array_type, sizeof...(Ts)>{static_cast<T>(values)...};
 }
 
+/**
+ * @brief Minimal perfect hash table for symbol entries.
+ * Entry for a hash is located at
+ * slots[reduce(mix(hash, seeds[reduce(mix(hash, 0), bucket_count)]), N)]
+ */
+template <std::size_t N>
+struct sym_perfect_hash {
+    std::array<uint16_t, elf_perfect_hash_bucket_count(N)> seeds;
+    std::array<sym_entry, N> slots;
+};
+
+/* Not constexpr on purpose: reaching it during constant evaluation fails the build */
+inline void perfect_hash_construction_failed(const char* reason) {
+    (void)reason;
+}
+
+/* Compile-time construction of minimal perfect hash (hash and displace).
+ * Entries are split into buckets, then buckets are placed largest first,
+ * searching for a seed that maps all bucket entries into free slots.
+ * Usage: static constexpr auto api_hash = build_perfect_hash(api_methods);
+ */
+template <std::size_t N>
+constexpr auto build_perfect_hash(const std::array<sym_entry, N>& entries) {
+    static_assert(N > 0, "perfect hash table must have at least one element");
+    constexpr std::size_t bucket_count = elf_perfect_hash_bucket_count(N);
+    constexpr std::size_t bucket_size_max = 32;
+
+    sym_perfect_hash<N> result{};
+    std::array<uint32_t, bucket_count + 1> bucket_start{};
+    std::array<uint32_t, bucket_count> bucket_fill{};
+    std::array<uint32_t, N> bucket_entries{};
+    std::array<bool, N> slot_used{};
+
+    /* Distribute entries into buckets (counting sort) */
+    for(std::size_t i = 0; i < N; i++) {
+        uint32_t bucket = elf_perfect_hash_reduce(
+            elf_perfect_hash_mix(entries[i].hash, 0), bucket_count);
+        bucket_start[bucket + 1]++;
+    }
+
+    uint32_t largest_bucket = 0;
+    for(std::size_t i = 0; i < bucket_count; i++) {
+        if(bucket_start[i + 1] > largest_bucket) largest_bucket = bucket_start[i + 1];
+        bucket_start[i + 1] += bucket_start[i];
+    }
+
+    if(largest_bucket > bucket_size_max) {
+        perfect_hash_construction_failed("Bucket overflow, check for hash collisions");
+    }
+
+    for(std::size_t i = 0; i < N; i++) {
+        uint32_t bucket = elf_perfect_hash_reduce(
+            elf_perfect_hash_mix(entries[i].hash, 0), bucket_count);
+        bucket_entries[bucket_start[bucket] + bucket_fill[bucket]++] = i;
+    }
+
+    /* Place buckets starting from the largest ones */
+    for(uint32_t size = largest_bucket; size > 0; size--) {
+        for(std::size_t bucket = 0; bucket < bucket_count; bucket++) {
+            if(bucket_fill[bucket] != size) continue;
+
+            std::array<uint32_t, bucket_size_max> bucket_slots{};
+            uint32_t seed = 1;
+            for(; seed <= UINT16_MAX; seed++) {
+                bool seed_fits = true;
+                for(uint32_t j = 0; (j < size) && seed_fits; j++) {
+                    const sym_entry& entry = entries[bucket_entries[bucket_start[bucket] + j]];
+                    uint32_t slot =
+                        elf_perfect_hash_reduce(elf_perfect_hash_mix(entry.hash, seed), N);
+                    if(slot_used[slot]) seed_fits = false;
+                    for(uint32_t k = 0; (k < j) && seed_fits; k++) {
+                        if(bucket_slots[k] == slot) seed_fits = false;
+                    }
+                    bucket_slots[j] = slot;
+                }
+                if(seed_fits) break;
+            }
+
+            if(seed > UINT16_MAX) {
+                perfect_hash_construction_failed("No seed found, check for hash collisions");
+            }
+
+            result.seeds[bucket] = seed;
+            for(uint32_t j = 0; j < size; j++) {
+                slot_used[bucket_slots[j]] = true;
+                result.slots[bucket_slots[j]] = entries[bucket_entries[bucket_start[bucket] + j]];
+            }
+        }
+    }
+
+    return result;
+}
+
 #endif
@@ -6,11 +6,13 @@
 
 static void infrared_common_decoder_reset_state(InfraredCommonDecoder* decoder);
 
-static inline size_t consume_samples(uint32_t* array, size_t len, size_t shift) {
+static inline size_t consume_samples(InfraredCommonDecoder* decoder, size_t shift) {
+    size_t len = decoder->timings_cnt;
     furi_assert(len >= shift);
     len -= shift;
     for(size_t i = 0; i < len; ++i) {
-        array[i] = array[i + shift];
+        decoder->timings[i] = decoder->timings[i + shift];
+        decoder->symbols[i] = decoder->symbols[i + shift];
     }
 
     return len;
@@ -41,7 +43,7 @@ static bool infrared_check_preamble(InfraredCommonDecoder* decoder) {
 
     // align to start at Mark timing
     if(!start_level) {
-        decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 1);
+        decoder->timings_cnt = consume_samples(decoder, 1);
     }
 
     if(decoder->protocol->timings.preamble_mark == 0) {
@@ -49,16 +51,12 @@ static bool infrared_check_preamble(InfraredCommonDecoder* decoder) {
     }
 
     while((!result) && (decoder->timings_cnt >= 2)) {
-        float preamble_tolerance = decoder->protocol->timings.preamble_tolerance;
-        uint16_t preamble_mark = decoder->protocol->timings.preamble_mark;
-        uint16_t preamble_space = decoder->protocol->timings.preamble_space;
-
-        if((MATCH_TIMING(decoder->timings[0], preamble_mark, preamble_tolerance)) &&
-           (MATCH_TIMING(decoder->timings[1], preamble_space, preamble_tolerance))) {
+        if((decoder->symbols[0] & InfraredSymbolPreambleMark) &&
+           (decoder->symbols[1] & InfraredSymbolPreambleSpace)) {
             result = true;
         }
 
-        decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 2);
+        decoder->timings_cnt = consume_samples(decoder, 2);
     }
 
     return result;
@@ -78,9 +76,10 @@ static InfraredStatus infrared_common_decode_bits(InfraredCommonDecoder* decoder
     while(decoder->timings_cnt && (status == InfraredStatusOk)) {
         bool level = (decoder->level + decoder->timings_cnt + 1) % 2;
         uint32_t timing = decoder->timings[0];
+        InfraredSymbol symbol = decoder->symbols[0];
 
         if(timings->min_split_time && !level) {
-            if(timing > timings->min_split_time) {
+            if(symbol & InfraredSymbolSplit) {
                 /* long low timing - check if we're ready for any of protocol modification */
                 for(size_t i = 0; i < COUNT_OF(decoder->protocol->databit_len) &&
                                   decoder->protocol->databit_len[i];
@@ -95,13 +94,13 @@ static InfraredStatus infrared_common_decode_bits(InfraredCommonDecoder* decoder
             }
         }
 
-        status = decoder->protocol->decode(decoder, level, timing);
+        status = decoder->protocol->decode(decoder, level, timing, symbol);
         furi_check(decoder->databit_cnt <= decoder->protocol->databit_len[0]);
         furi_assert(status == InfraredStatusError || status == InfraredStatusOk);
         if(status == InfraredStatusError) {
             break;
         }
-        decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 1);
+        decoder->timings_cnt = consume_samples(decoder, 1);
 
         /* check if largest protocol version can be decoded */
         if(level && (decoder->protocol->databit_len[0] == decoder->databit_cnt) && //-V1051
@@ -115,32 +114,33 @@ static InfraredStatus infrared_common_decode_bits(InfraredCommonDecoder* decoder
 }
 
 /* Pulse Distance-Width Modulation */
-InfraredStatus
-    infrared_common_decode_pdwm(InfraredCommonDecoder* decoder, bool level, uint32_t timing) {
+InfraredStatus infrared_common_decode_pdwm(
+    InfraredCommonDecoder* decoder,
+    bool level,
+    uint32_t timing,
+    InfraredSymbol symbol) {
     furi_assert(decoder);
+    UNUSED(timing);
 
     InfraredStatus status = InfraredStatusOk;
-    uint32_t bit_tolerance = decoder->protocol->timings.bit_tolerance;
-    uint16_t bit1_mark = decoder->protocol->timings.bit1_mark;
-    uint16_t bit1_space = decoder->protocol->timings.bit1_space;
-    uint16_t bit0_mark = decoder->protocol->timings.bit0_mark;
-    uint16_t bit0_space = decoder->protocol->timings.bit0_space;
+    bool same_marks =
+        (decoder->protocol->timings.bit1_mark == decoder->protocol->timings.bit0_mark);
 
-    bool analyze_timing = level ^ (bit1_mark == bit0_mark);
-    uint16_t bit1 = level ? bit1_mark : bit1_space;
-    uint16_t bit0 = level ? bit0_mark : bit0_space;
-    uint16_t no_info_timing = (bit1_mark == bit0_mark) ? bit1_mark : bit1_space;
+    bool analyze_timing = level ^ same_marks;
+    InfraredSymbol bit1 = level ? InfraredSymbolBit1Mark : InfraredSymbolBit1Space;
+    InfraredSymbol bit0 = level ? InfraredSymbolBit0Mark : InfraredSymbolBit0Space;
+    InfraredSymbol no_info_timing = same_marks ? InfraredSymbolBit1Mark : InfraredSymbolBit1Space;
 
     if(analyze_timing) {
-        if(MATCH_TIMING(timing, bit1, bit_tolerance)) {
+        if(symbol & bit1) {
             accumulate_lsb(decoder, 1);
-        } else if(MATCH_TIMING(timing, bit0, bit_tolerance)) {
+        } else if(symbol & bit0) {
             accumulate_lsb(decoder, 0);
         } else {
             status = InfraredStatusError;
         }
     } else {
-        if(!MATCH_TIMING(timing, no_info_timing, bit_tolerance)) {
+        if(!(symbol & no_info_timing)) {
             status = InfraredStatusError;
         }
     }
@@ -149,17 +149,19 @@ InfraredStatus
 }
 
 /* level switch detection goes in middle of time-quant */
-InfraredStatus
-    infrared_common_decode_manchester(InfraredCommonDecoder* decoder, bool level, uint32_t timing) {
+InfraredStatus infrared_common_decode_manchester(
+    InfraredCommonDecoder* decoder,
+    bool level,
+    uint32_t timing,
+    InfraredSymbol symbol) {
     furi_assert(decoder);
-    uint32_t bit = decoder->protocol->timings.bit1_mark;
-    uint32_t tolerance = decoder->protocol->timings.bit_tolerance;
+    UNUSED(timing);
 
     bool* switch_detect = &decoder->switch_detect;
     furi_assert((*switch_detect == true) || (*switch_detect == false));
 
-    bool single_timing = MATCH_TIMING(timing, bit, tolerance);
-    bool double_timing = MATCH_TIMING(timing, 2 * bit, tolerance);
+    bool single_timing = symbol & InfraredSymbolBit1Mark;
+    bool double_timing = symbol & InfraredSymbolBitDouble;
 
     if(!single_timing && !double_timing) {
         return InfraredStatusError;
@@ -217,8 +219,11 @@ InfraredMessage* infrared_common_decoder_check_ready(InfraredCommonDecoder* deco
     return message;
 }
 
-InfraredMessage*
-    infrared_common_decode(InfraredCommonDecoder* decoder, bool level, uint32_t duration) {
+InfraredMessage* infrared_common_decode(
+    InfraredCommonDecoder* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol) {
     furi_assert(decoder);
 
     InfraredMessage* message = 0;
@@ -230,6 +235,7 @@ InfraredMessage*
     decoder->level = level; // start with low level (Space timing)
 
     decoder->timings[decoder->timings_cnt] = duration;
+    decoder->symbols[decoder->timings_cnt] = symbol;
     decoder->timings_cnt++;
     furi_check(decoder->timings_cnt <= sizeof(decoder->timings));
 
@@ -275,6 +281,34 @@ InfraredMessage*
     return message;
 }
 
+/* Reference classification, infrared_decode() looks it up in a precomputed table */
+InfraredSymbol infrared_common_get_symbol(const InfraredTimings* timings, uint32_t duration) {
+    furi_assert(timings);
+
+    InfraredSymbol symbol = 0;
+    uint32_t preamble_tolerance = timings->preamble_tolerance;
+    uint32_t bit_tolerance = timings->bit_tolerance;
+
+    if(MATCH_TIMING(duration, timings->preamble_mark, preamble_tolerance))
+        symbol |= InfraredSymbolPreambleMark;
+    if(MATCH_TIMING(duration, timings->preamble_space, preamble_tolerance))
+        symbol |= InfraredSymbolPreambleSpace;
+    if(MATCH_TIMING(duration, timings->bit1_mark, bit_tolerance))
+        symbol |= InfraredSymbolBit1Mark;
+    if(MATCH_TIMING(duration, timings->bit1_space, bit_tolerance))
+        symbol |= InfraredSymbolBit1Space;
+    if(MATCH_TIMING(duration, timings->bit0_mark, bit_tolerance))
+        symbol |= InfraredSymbolBit0Mark;
+    if(MATCH_TIMING(duration, timings->bit0_space, bit_tolerance))
+        symbol |= InfraredSymbolBit0Space;
+    if(MATCH_TIMING(duration, 2 * timings->bit1_mark, bit_tolerance))
+        symbol |= InfraredSymbolBitDouble;
+    if(timings->min_split_time && (duration > timings->min_split_time))
+        symbol |= InfraredSymbolSplit;
+
+    return symbol;
+}
+
 void* infrared_common_decoder_alloc(const InfraredCommonProtocolSpec* protocol) {
     furi_assert(protocol);
 
@@ -303,7 +337,7 @@ void infrared_common_decoder_reset_state(InfraredCommonDecoder* decoder) {
     decoder->message.protocol = InfraredProtocolUnknown;
     if(decoder->protocol->timings.preamble_mark == 0) {
         if(decoder->timings_cnt > 0) {
-            decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 1);
+            decoder->timings_cnt = consume_samples(decoder, 1);
         }
     }
 }
@@ -9,7 +9,8 @@
 typedef struct InfraredCommonDecoder InfraredCommonDecoder;
 typedef struct InfraredCommonEncoder InfraredCommonEncoder;
 
-typedef InfraredStatus (*InfraredCommonDecode)(InfraredCommonDecoder*, bool, uint32_t);
+typedef InfraredStatus (
+    *InfraredCommonDecode)(InfraredCommonDecoder*, bool, uint32_t, InfraredSymbol);
 typedef InfraredStatus (*InfraredCommonDecodeRepeat)(InfraredCommonDecoder*);
 typedef bool (*InfraredCommonInterpret)(InfraredCommonDecoder*);
 typedef InfraredStatus (
@@ -44,6 +45,7 @@ struct InfraredCommonDecoder {
     const InfraredCommonProtocolSpec* protocol;
     void* context;
     uint32_t timings[6];
+    InfraredSymbol symbols[6];
     InfraredMessage message;
     InfraredCommonStateDecoder state;
     uint8_t timings_cnt;
@@ -65,12 +67,22 @@ struct InfraredCommonEncoder {
     uint8_t data[];
 };
 
-InfraredMessage*
-    infrared_common_decode(InfraredCommonDecoder* decoder, bool level, uint32_t duration);
-InfraredStatus
-    infrared_common_decode_pdwm(InfraredCommonDecoder* decoder, bool level, uint32_t timing);
-InfraredStatus
-    infrared_common_decode_manchester(InfraredCommonDecoder* decoder, bool level, uint32_t timing);
+InfraredMessage* infrared_common_decode(
+    InfraredCommonDecoder* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol);
+InfraredStatus infrared_common_decode_pdwm(
+    InfraredCommonDecoder* decoder,
+    bool level,
+    uint32_t timing,
+    InfraredSymbol symbol);
+InfraredStatus infrared_common_decode_manchester(
+    InfraredCommonDecoder* decoder,
+    bool level,
+    uint32_t timing,
+    InfraredSymbol symbol);
+InfraredSymbol infrared_common_get_symbol(const InfraredTimings* timings, uint32_t duration);
 void* infrared_common_decoder_alloc(const InfraredCommonProtocolSpec* protocol);
 void infrared_common_decoder_free(InfraredCommonDecoder* decoder);
 void infrared_common_decoder_reset(InfraredCommonDecoder* decoder);
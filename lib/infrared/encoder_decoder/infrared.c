@@ -13,12 +13,21 @@
 #include "kaseikyo/infrared_protocol_kaseikyo.h"
 #include "rca/infrared_protocol_rca.h"
 
+#include "nec/infrared_protocol_nec_i.h"
+#include "samsung/infrared_protocol_samsung_i.h"
+#include "rc5/infrared_protocol_rc5_i.h"
+#include "rc6/infrared_protocol_rc6_i.h"
+#include "sirc/infrared_protocol_sirc_i.h"
+#include "kaseikyo/infrared_protocol_kaseikyo_i.h"
+#include "rca/infrared_protocol_rca_i.h"
+
 typedef struct {
     InfraredAlloc alloc;
     InfraredDecode decode;
     InfraredDecoderReset reset;
     InfraredFree free;
     InfraredDecoderCheckReady check_ready;
+    const InfraredTimings* timings;
 } InfraredDecoders;
 
 typedef struct {
@@ -28,8 +37,15 @@ typedef struct {
     InfraredFree free;
 } InfraredEncoders;
 
+/**
+ * Durations between two neighbouring bounds match the same timing classes of every protocol,
+ * so each duration is classified once for all decoders by a binary search over the bounds.
+ */
 struct InfraredDecoderHandler {
     void** ctx;
+    uint32_t* bounds;
+    size_t bounds_count;
+    InfraredSymbol* symbols; /* (bounds_count + 1) rows, one symbol per decoder */
 };
 
 struct InfraredEncoderHandler {
@@ -50,7 +66,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_nec_decode,
              .reset = infrared_decoder_nec_reset,
              .check_ready = infrared_decoder_nec_check_ready,
-             .free = infrared_decoder_nec_free},
+             .free = infrared_decoder_nec_free,
+             .timings = &infrared_protocol_nec.timings},
         .encoder =
             {.alloc = infrared_encoder_nec_alloc,
              .encode = infrared_encoder_nec_encode,
@@ -64,7 +81,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_samsung32_decode,
              .reset = infrared_decoder_samsung32_reset,
              .check_ready = infrared_decoder_samsung32_check_ready,
-             .free = infrared_decoder_samsung32_free},
+             .free = infrared_decoder_samsung32_free,
+             .timings = &infrared_protocol_samsung32.timings},
         .encoder =
             {.alloc = infrared_encoder_samsung32_alloc,
              .encode = infrared_encoder_samsung32_encode,
@@ -78,7 +96,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_rc5_decode,
              .reset = infrared_decoder_rc5_reset,
              .check_ready = infrared_decoder_rc5_check_ready,
-             .free = infrared_decoder_rc5_free},
+             .free = infrared_decoder_rc5_free,
+             .timings = &infrared_protocol_rc5.timings},
         .encoder =
             {.alloc = infrared_encoder_rc5_alloc,
              .encode = infrared_encoder_rc5_encode,
@@ -92,7 +111,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_rc6_decode,
              .reset = infrared_decoder_rc6_reset,
              .check_ready = infrared_decoder_rc6_check_ready,
-             .free = infrared_decoder_rc6_free},
+             .free = infrared_decoder_rc6_free,
+             .timings = &infrared_protocol_rc6.timings},
         .encoder =
             {.alloc = infrared_encoder_rc6_alloc,
              .encode = infrared_encoder_rc6_encode,
@@ -106,7 +126,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_sirc_decode,
              .reset = infrared_decoder_sirc_reset,
              .check_ready = infrared_decoder_sirc_check_ready,
-             .free = infrared_decoder_sirc_free},
+             .free = infrared_decoder_sirc_free,
+             .timings = &infrared_protocol_sirc.timings},
         .encoder =
             {.alloc = infrared_encoder_sirc_alloc,
              .encode = infrared_encoder_sirc_encode,
@@ -120,7 +141,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_kaseikyo_decode,
              .reset = infrared_decoder_kaseikyo_reset,
              .check_ready = infrared_decoder_kaseikyo_check_ready,
-             .free = infrared_decoder_kaseikyo_free},
+             .free = infrared_decoder_kaseikyo_free,
+             .timings = &infrared_protocol_kaseikyo.timings},
         .encoder =
             {.alloc = infrared_encoder_kaseikyo_alloc,
              .encode = infrared_encoder_kaseikyo_encode,
@@ -134,7 +156,8 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
              .decode = infrared_decoder_rca_decode,
              .reset = infrared_decoder_rca_reset,
              .check_ready = infrared_decoder_rca_check_ready,
-             .free = infrared_decoder_rca_free},
+             .free = infrared_decoder_rca_free,
+             .timings = &infrared_protocol_rca.timings},
         .encoder =
             {.alloc = infrared_encoder_rca_alloc,
              .encode = infrared_encoder_rca_encode,
@@ -147,16 +170,36 @@ static const InfraredEncoderDecoder infrared_encoder_decoder[] = {
 static int infrared_find_index_by_protocol(InfraredProtocol protocol);
 static const InfraredProtocolVariant* infrared_get_variant_by_protocol(InfraredProtocol protocol);
 
+static const InfraredSymbol*
+    infrared_get_symbols(const InfraredDecoderHandler* handler, uint32_t duration) {
+    size_t low = 0;
+    size_t high = handler->bounds_count;
+
+    /* row index is the number of bounds not greater than duration */
+    while(low < high) {
+        size_t middle = (low + high) / 2;
+        if(handler->bounds[middle] <= duration) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return &handler->symbols[low * COUNT_OF(infrared_encoder_decoder)];
+}
+
 const InfraredMessage*
     infrared_decode(InfraredDecoderHandler* handler, bool level, uint32_t duration) {
     furi_assert(handler);
 
     InfraredMessage* message = NULL;
     InfraredMessage* result = NULL;
+    const InfraredSymbol* symbols = infrared_get_symbols(handler, duration);
 
     for(size_t i = 0; i < COUNT_OF(infrared_encoder_decoder); ++i) {
         if(infrared_encoder_decoder[i].decoder.decode) {
-            message = infrared_encoder_decoder[i].decoder.decode(handler->ctx[i], level, duration);
+            message = infrared_encoder_decoder[i].decoder.decode(
+                handler->ctx[i], level, duration, symbols[i]);
             if(!result && message) {
                 result = message;
             }
@@ -166,6 +209,65 @@ const InfraredMessage*
     return result;
 }
 
+static int infrared_compare_bounds(const void* a, const void* b) {
+    uint32_t bound_a = *(const uint32_t*)a;
+    uint32_t bound_b = *(const uint32_t*)b;
+    return (bound_a > bound_b) - (bound_a < bound_b);
+}
+
+static size_t infrared_add_bounds(uint32_t* bounds, size_t count, uint32_t value, uint32_t delta) {
+    /* MATCH_TIMING() range is (value - delta, value + delta) */
+    if(value >= delta) bounds[count++] = value - delta + 1;
+    bounds[count++] = value + delta;
+    return count;
+}
+
+static void infrared_alloc_symbols(InfraredDecoderHandler* handler) {
+    const size_t decoder_count = COUNT_OF(infrared_encoder_decoder);
+    /* 7 ranges with 2 bounds each and split time per protocol */
+    handler->bounds = malloc(sizeof(uint32_t) * 15 * decoder_count);
+
+    size_t count = 0;
+    for(size_t i = 0; i < decoder_count; ++i) {
+        const InfraredTimings* timings = infrared_encoder_decoder[i].decoder.timings;
+        if(!timings) continue;
+        uint32_t preamble_tolerance = timings->preamble_tolerance;
+        uint32_t bit_tolerance = timings->bit_tolerance;
+
+        count = infrared_add_bounds(
+            handler->bounds, count, timings->preamble_mark, preamble_tolerance);
+        count = infrared_add_bounds(
+            handler->bounds, count, timings->preamble_space, preamble_tolerance);
+        count = infrared_add_bounds(handler->bounds, count, timings->bit1_mark, bit_tolerance);
+        count = infrared_add_bounds(handler->bounds, count, timings->bit1_space, bit_tolerance);
+        count = infrared_add_bounds(handler->bounds, count, timings->bit0_mark, bit_tolerance);
+        count = infrared_add_bounds(handler->bounds, count, timings->bit0_space, bit_tolerance);
+        count =
+            infrared_add_bounds(handler->bounds, count, 2 * timings->bit1_mark, bit_tolerance);
+        handler->bounds[count++] = timings->min_split_time + 1;
+    }
+
+    qsort(handler->bounds, count, sizeof(uint32_t), infrared_compare_bounds);
+    size_t unique_count = 0;
+    for(size_t i = 0; i < count; ++i) {
+        if(!unique_count || (handler->bounds[unique_count - 1] != handler->bounds[i])) {
+            handler->bounds[unique_count++] = handler->bounds[i];
+        }
+    }
+    handler->bounds_count = unique_count;
+
+    /* every duration of a row matches the same classes as the lowest one */
+    handler->symbols = malloc(sizeof(InfraredSymbol) * (unique_count + 1) * decoder_count);
+    for(size_t row = 0; row <= unique_count; ++row) {
+        uint32_t duration = row ? handler->bounds[row - 1] : 0;
+        for(size_t i = 0; i < decoder_count; ++i) {
+            const InfraredTimings* timings = infrared_encoder_decoder[i].decoder.timings;
+            handler->symbols[row * decoder_count + i] =
+                timings ? infrared_common_get_symbol(timings, duration) : 0;
+        }
+    }
+}
+
 InfraredDecoderHandler* infrared_alloc_decoder(void) {
     InfraredDecoderHandler* handler = malloc(sizeof(InfraredDecoderHandler));
     handler->ctx = malloc(sizeof(void*) * COUNT_OF(infrared_encoder_decoder));
@@ -176,6 +278,7 @@ InfraredDecoderHandler* infrared_alloc_decoder(void) {
             handler->ctx[i] = infrared_encoder_decoder[i].decoder.alloc();
     }
 
+    infrared_alloc_symbols(handler);
     infrared_reset_decoder(handler);
     return handler;
 }
@@ -189,6 +292,8 @@ void infrared_free_decoder(InfraredDecoderHandler* handler) {
             infrared_encoder_decoder[i].decoder.free(handler->ctx[i]);
     }
 
+    free(handler->symbols);
+    free(handler->bounds);
     free(handler->ctx);
     free(handler);
 }
@@ -16,6 +16,20 @@ typedef struct {
     uint32_t bit_tolerance;
 } InfraredTimings;
 
+/** Timing classes a duration matches for one protocol, set of InfraredSymbolClass */
+typedef uint8_t InfraredSymbol;
+
+typedef enum {
+    InfraredSymbolPreambleMark = (1 << 0),
+    InfraredSymbolPreambleSpace = (1 << 1),
+    InfraredSymbolBit1Mark = (1 << 2),
+    InfraredSymbolBit1Space = (1 << 3),
+    InfraredSymbolBit0Mark = (1 << 4),
+    InfraredSymbolBit0Space = (1 << 5),
+    InfraredSymbolBitDouble = (1 << 6), /**< 2 * bit1_mark, manchester protocols */
+    InfraredSymbolSplit = (1 << 7), /**< longer than min_split_time */
+} InfraredSymbolClass;
+
 typedef struct {
     const char* name;
     uint8_t address_length;
@@ -31,7 +45,8 @@ typedef void* (*InfraredAlloc)(void);
 typedef void (*InfraredFree)(void*);
 
 typedef void (*InfraredDecoderReset)(void*);
-typedef InfraredMessage* (*InfraredDecode)(void* ctx, bool level, uint32_t duration);
+typedef InfraredMessage* (
+    *InfraredDecode)(void* ctx, bool level, uint32_t duration, InfraredSymbol symbol);
 typedef InfraredMessage* (*InfraredDecoderCheckReady)(void*);
 
 typedef void (*InfraredEncoderReset)(void* encoder, const InfraredMessage* message);
@@ -37,8 +37,12 @@ void* infrared_decoder_kaseikyo_alloc(void) {
     return infrared_common_decoder_alloc(&infrared_protocol_kaseikyo);
 }
 
-InfraredMessage* infrared_decoder_kaseikyo_decode(void* decoder, bool level, uint32_t duration) {
-    return infrared_common_decode(decoder, level, duration);
+InfraredMessage* infrared_decoder_kaseikyo_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol) {
+    return infrared_common_decode(decoder, level, duration, symbol);
 }
 
 void infrared_decoder_kaseikyo_free(void* decoder) {
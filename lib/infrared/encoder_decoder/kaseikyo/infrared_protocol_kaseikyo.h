@@ -20,7 +20,11 @@ void* infrared_decoder_kaseikyo_alloc(void);
 void infrared_decoder_kaseikyo_reset(void* decoder);
 void infrared_decoder_kaseikyo_free(void* decoder);
 InfraredMessage* infrared_decoder_kaseikyo_check_ready(void* decoder);
-InfraredMessage* infrared_decoder_kaseikyo_decode(void* decoder, bool level, uint32_t duration);
+InfraredMessage* infrared_decoder_kaseikyo_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol);
 
 void* infrared_encoder_kaseikyo_alloc(void);
 InfraredStatus
@@ -84,8 +84,12 @@ void* infrared_decoder_nec_alloc(void) {
     return infrared_common_decoder_alloc(&infrared_protocol_nec);
 }
 
-InfraredMessage* infrared_decoder_nec_decode(void* decoder, bool level, uint32_t duration) {
-    return infrared_common_decode(decoder, level, duration);
+InfraredMessage* infrared_decoder_nec_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol) {
+    return infrared_common_decode(decoder, level, duration, symbol);
 }
 
 void infrared_decoder_nec_free(void* decoder) {
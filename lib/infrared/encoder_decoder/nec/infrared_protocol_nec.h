@@ -20,7 +20,11 @@ void* infrared_decoder_nec_alloc(void);
 void infrared_decoder_nec_reset(void* decoder);
 void infrared_decoder_nec_free(void* decoder);
 InfraredMessage* infrared_decoder_nec_check_ready(void* decoder);
-InfraredMessage* infrared_decoder_nec_decode(void* decoder, bool level, uint32_t duration);
+InfraredMessage* infrared_decoder_nec_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol);
 
 void* infrared_encoder_nec_alloc(void);
 InfraredStatus infrared_encoder_nec_encode(void* encoder_ptr, uint32_t* duration, bool* level);
@@ -62,9 +62,13 @@ void* infrared_decoder_rc5_alloc(void) {
     return decoder;
 }
 
-InfraredMessage* infrared_decoder_rc5_decode(void* decoder, bool level, uint32_t duration) {
+InfraredMessage* infrared_decoder_rc5_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol) {
     InfraredRc5Decoder* decoder_rc5 = decoder;
-    return infrared_common_decode(decoder_rc5->common_decoder, level, duration);
+    return infrared_common_decode(decoder_rc5->common_decoder, level, duration, symbol);
 }
 
 void infrared_decoder_rc5_free(void* decoder) {
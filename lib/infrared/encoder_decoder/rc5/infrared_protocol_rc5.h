@@ -28,7 +28,11 @@ void* infrared_decoder_rc5_alloc(void);
 void infrared_decoder_rc5_reset(void* decoder);
 void infrared_decoder_rc5_free(void* decoder);
 InfraredMessage* infrared_decoder_rc5_check_ready(void* ctx);
-InfraredMessage* infrared_decoder_rc5_decode(void* decoder, bool level, uint32_t duration);
+InfraredMessage* infrared_decoder_rc5_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol);
 
 void* infrared_encoder_rc5_alloc(void);
 void infrared_encoder_rc5_reset(void* encoder_ptr, const InfraredMessage* message);
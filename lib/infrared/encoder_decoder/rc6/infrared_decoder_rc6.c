@@ -54,14 +54,15 @@ bool infrared_decoder_rc6_interpret(InfraredCommonDecoder* decoder) {
 InfraredStatus infrared_decoder_rc6_decode_manchester(
     InfraredCommonDecoder* decoder,
     bool level,
-    uint32_t timing) {
+    uint32_t timing,
+    InfraredSymbol symbol) {
     // 4th bit lasts 2x times more
     InfraredStatus status = InfraredStatusError;
     uint32_t bit = decoder->protocol->timings.bit1_mark;
     uint32_t tolerance = decoder->protocol->timings.bit_tolerance;
 
-    bool single_timing = MATCH_TIMING(timing, bit, tolerance);
-    bool double_timing = MATCH_TIMING(timing, 2 * bit, tolerance);
+    bool single_timing = symbol & InfraredSymbolBit1Mark;
+    bool double_timing = symbol & InfraredSymbolBitDouble;
     bool triple_timing = MATCH_TIMING(timing, 3 * bit, tolerance);
 
     if(decoder->databit_cnt == 4) {
@@ -74,14 +75,14 @@ InfraredStatus infrared_decoder_rc6_decode_manchester(
         }
     } else if(decoder->databit_cnt == 5) {
         if(single_timing || triple_timing) {
-            if(triple_timing) timing = bit;
+            if(triple_timing) symbol = InfraredSymbolBit1Mark;
             decoder->switch_detect = false;
-            status = infrared_common_decode_manchester(decoder, level, timing);
+            status = infrared_common_decode_manchester(decoder, level, timing, symbol);
         } else if(double_timing) {
             status = InfraredStatusOk;
         }
     } else {
-        status = infrared_common_decode_manchester(decoder, level, timing);
+        status = infrared_common_decode_manchester(decoder, level, timing, symbol);
     }
 
     return status;
@@ -95,9 +96,13 @@ void* infrared_decoder_rc6_alloc(void) {
     return decoder;
 }
 
-InfraredMessage* infrared_decoder_rc6_decode(void* decoder, bool level, uint32_t duration) {
+InfraredMessage* infrared_decoder_rc6_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol) {
     InfraredRc6Decoder* decoder_rc6 = decoder;
-    return infrared_common_decode(decoder_rc6->common_decoder, level, duration);
+    return infrared_common_decode(decoder_rc6->common_decoder, level, duration, symbol);
 }
 
 void infrared_decoder_rc6_free(void* decoder) {
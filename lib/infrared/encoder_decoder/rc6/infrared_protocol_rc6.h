@@ -27,7 +27,11 @@ void* infrared_decoder_rc6_alloc(void);
 void infrared_decoder_rc6_reset(void* decoder);
 void infrared_decoder_rc6_free(void* decoder);
 InfraredMessage* infrared_decoder_rc6_check_ready(void* ctx);
-InfraredMessage* infrared_decoder_rc6_decode(void* decoder, bool level, uint32_t duration);
+InfraredMessage* infrared_decoder_rc6_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol);
 
 void* infrared_encoder_rc6_alloc(void);
 void infrared_encoder_rc6_reset(void* encoder_ptr, const InfraredMessage* message);
@@ -21,7 +21,8 @@ bool infrared_decoder_rc6_interpret(InfraredCommonDecoder* decoder);
 InfraredStatus infrared_decoder_rc6_decode_manchester(
     InfraredCommonDecoder* decoder,
     bool level,
-    uint32_t timing);
+    uint32_t timing,
+    InfraredSymbol symbol);
 InfraredStatus infrared_encoder_rc6_encode_manchester(
     InfraredCommonEncoder* encoder_ptr,
     uint32_t* duration,
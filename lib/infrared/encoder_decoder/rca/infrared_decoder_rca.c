@@ -32,8 +32,12 @@ void* infrared_decoder_rca_alloc(void) {
     return infrared_common_decoder_alloc(&infrared_protocol_rca);
 }
 
-InfraredMessage* infrared_decoder_rca_decode(void* decoder, bool level, uint32_t duration) {
-    return infrared_common_decode(decoder, level, duration);
+InfraredMessage* infrared_decoder_rca_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol) {
+    return infrared_common_decode(decoder, level, duration, symbol);
 }
 
 void infrared_decoder_rca_free(void* decoder) {
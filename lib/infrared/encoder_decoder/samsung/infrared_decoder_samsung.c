@@ -56,8 +56,12 @@ void* infrared_decoder_samsung32_alloc(void) {
     return infrared_common_decoder_alloc(&infrared_protocol_samsung32);
 }
 
-InfraredMessage* infrared_decoder_samsung32_decode(void* decoder, bool level, uint32_t duration) {
-    return infrared_common_decode(decoder, level, duration);
+InfraredMessage* infrared_decoder_samsung32_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol) {
+    return infrared_common_decode(decoder, level, duration, symbol);
 }
 
 void infrared_decoder_samsung32_free(void* decoder) {
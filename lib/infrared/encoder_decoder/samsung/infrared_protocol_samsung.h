@@ -20,7 +20,11 @@ void* infrared_decoder_samsung32_alloc(void);
 void infrared_decoder_samsung32_reset(void* decoder);
 void infrared_decoder_samsung32_free(void* decoder);
 InfraredMessage* infrared_decoder_samsung32_check_ready(void* ctx);
-InfraredMessage* infrared_decoder_samsung32_decode(void* decoder, bool level, uint32_t duration);
+InfraredMessage* infrared_decoder_samsung32_decode(
+    void* decoder,
+    bool level,
+    uint32_t duration,
+    InfraredSymbol symbol);
 
 InfraredStatus
     infrared_encoder_samsung32_encode(void* encoder_ptr, uint32_t* duration, bool* level);
@@ -1,3 +1,4 @@
+#include "infrared_transmit.h"
 #include "infrared.h"
 #include <stdint.h>
 #include <stdbool.h>
@@ -5,6 +6,28 @@
 #include <furi.h>
 #include <furi_hal_infrared.h>
 
+#define TAG "InfraredTx"
+
+/* HAL pulls up to 200 timings per DMA buffer refill, a chunk must outlast one refill */
+#define INFRARED_TX_RAW_CHUNK_SIZE 256
+
+typedef struct {
+    InfraredRawTimingsCallback callback;
+    void* context;
+    FuriSemaphore* chunk_released;
+    uint32_t timings[2][INFRARED_TX_RAW_CHUNK_SIZE];
+    volatile size_t timings_cnt[2];
+    volatile bool is_chunk_ready[2];
+    volatile bool is_finished;
+    volatile bool is_underrun;
+    bool is_callback_finished;
+    bool start_from_mark;
+    volatile bool add_silence;
+    volatile uint8_t chunk;
+    volatile size_t chunk_index;
+    volatile uint32_t timings_sent;
+} InfraredTxRawStream;
+
 static uint32_t infrared_tx_number_of_transmissions = 0;
 static uint32_t infrared_tx_raw_timings_index = 0;
 static uint32_t infrared_tx_raw_timings_number = 0;
@@ -65,6 +88,125 @@ void infrared_send_raw(const uint32_t timings[], uint32_t timings_cnt, bool star
         INFRARED_COMMON_DUTY_CYCLE);
 }
 
+static FuriHalInfraredTxGetDataState
+    infrared_get_raw_stream_data_callback(void* context, uint32_t* duration, bool* level) {
+    furi_assert(duration);
+    furi_assert(level);
+    furi_assert(context);
+
+    InfraredTxRawStream* stream = context;
+
+    if(stream->add_silence) {
+        stream->add_silence = false;
+        *level = false;
+        *duration = INFRARED_RAW_TX_TIMING_DELAY_US;
+        return FuriHalInfraredTxGetDataStateOk;
+    }
+
+    const uint8_t chunk = stream->chunk;
+
+    *level = stream->start_from_mark ^ (stream->timings_sent % 2);
+    *duration = stream->timings[chunk][stream->chunk_index++];
+    ++stream->timings_sent;
+
+    if(stream->chunk_index < stream->timings_cnt[chunk]) {
+        return FuriHalInfraredTxGetDataStateOk;
+    }
+
+    /* current chunk is sent, switch to the other one and let the thread refill this one */
+    const uint8_t next = chunk ^ 1;
+    bool is_last = (stream->timings_cnt[chunk] < INFRARED_TX_RAW_CHUNK_SIZE);
+    if(!is_last && !stream->is_chunk_ready[next]) {
+        /* a gap inside the signal would corrupt it, the transmission is cut here instead */
+        stream->is_underrun = true;
+        is_last = true;
+    } else if(!is_last && (stream->timings_cnt[next] == 0)) {
+        is_last = true;
+    }
+
+    stream->is_chunk_ready[chunk] = false;
+    stream->chunk = next;
+    stream->chunk_index = 0;
+
+    if(is_last) {
+        stream->is_finished = true;
+    }
+    furi_semaphore_release(stream->chunk_released);
+
+    return is_last ? FuriHalInfraredTxGetDataStateLastDone : FuriHalInfraredTxGetDataStateOk;
+}
+
+static void infrared_tx_raw_stream_fill_chunk(InfraredTxRawStream* stream, uint8_t chunk) {
+    size_t timings_cnt = 0;
+
+    if(!stream->is_callback_finished) {
+        timings_cnt = stream->callback(
+            stream->context, stream->timings[chunk], INFRARED_TX_RAW_CHUNK_SIZE);
+        furi_check(timings_cnt <= INFRARED_TX_RAW_CHUNK_SIZE);
+        stream->is_callback_finished = (timings_cnt < INFRARED_TX_RAW_CHUNK_SIZE);
+    }
+
+    stream->timings_cnt[chunk] = timings_cnt;
+    stream->is_chunk_ready[chunk] = true;
+}
+
+bool infrared_send_raw_stream(
+    InfraredRawTimingsCallback callback,
+    void* context,
+    bool start_from_mark,
+    uint32_t frequency,
+    float duty_cycle) {
+    furi_assert(callback);
+
+    InfraredTxRawStream* stream = malloc(sizeof(InfraredTxRawStream));
+    stream->callback = callback;
+    stream->context = context;
+    stream->chunk_released = furi_semaphore_alloc(2, 0);
+    stream->start_from_mark = start_from_mark;
+    stream->add_silence = start_from_mark;
+
+    infrared_tx_raw_stream_fill_chunk(stream, 0);
+    infrared_tx_raw_stream_fill_chunk(stream, 1);
+
+    const bool is_empty = (stream->timings_cnt[0] == 0);
+
+    if(!is_empty) {
+        furi_hal_infrared_async_tx_set_data_isr_callback(
+            infrared_get_raw_stream_data_callback, stream);
+        furi_hal_infrared_async_tx_start(frequency, duty_cycle);
+
+        while(!stream->is_finished) {
+            furi_check(
+                furi_semaphore_acquire(stream->chunk_released, FuriWaitForever) == FuriStatusOk);
+            for(uint8_t chunk = 0; chunk < 2; ++chunk) {
+                if(!stream->is_finished && !stream->is_chunk_ready[chunk]) {
+                    infrared_tx_raw_stream_fill_chunk(stream, chunk);
+                }
+            }
+        }
+
+        furi_hal_infrared_async_tx_wait_termination();
+        furi_assert(!furi_hal_infrared_is_busy());
+    }
+
+    bool is_truncated = false;
+    if(stream->is_underrun) {
+        /* the signal was only cut if the chunk that came late has timings */
+        if(!stream->is_chunk_ready[stream->chunk]) {
+            infrared_tx_raw_stream_fill_chunk(stream, stream->chunk);
+        }
+        is_truncated = (stream->timings_cnt[stream->chunk] > 0);
+    }
+    if(is_truncated) {
+        FURI_LOG_E(TAG, "Timings were not ready in time, signal truncated");
+    }
+
+    furi_semaphore_free(stream->chunk_released);
+    free(stream);
+
+    return !is_empty && !is_truncated;
+}
+
 FuriHalInfraredTxGetDataState
     infrared_get_data_callback(void* context, uint32_t* duration, bool* level) {
     FuriHalInfraredTxGetDataState state;
@@ -41,6 +41,43 @@ void infrared_send_raw_ext(
     uint32_t frequency,
     float duty_cycle);
 
+/**
+ * Callback to get the next chunk of raw timings to send.
+ *
+ * \param[in]   context - context passed to infrared_send_raw_stream().
+ * \param[out]  timings - buffer to fill with timings.
+ * \param[in]   timings_cnt - buffer size.
+ * \return      number of timings written, less than timings_cnt only
+ *              when the signal is over.
+ */
+typedef size_t (*InfraredRawTimingsCallback)(void* context, uint32_t* timings, size_t timings_cnt);
+
+/**
+ * Send raw data through infrared port, pulling timings from a callback.
+ *
+ * Timings are requested in fixed-size chunks while the previous chunk
+ * is being sent, so memory usage does not depend on the signal length.
+ * The callback is called from the calling thread. Two chunks are read
+ * before the transmission starts, so short signals are always sent whole.
+ * If the callback falls behind on a longer signal, the transmission is cut
+ * at the end of the last ready chunk and false is returned.
+ *
+ * \param[in]   callback - callback to get timings from.
+ * \param[in]   context - context to pass to callback.
+ * \param[in]   start_from_mark - true if timings starts from mark,
+ *              otherwise from space
+ * \param[in]   frequency - frequency to generate on PWM
+ * \param[in]   duty_cycle - duty cycle to generate on PWM
+ * \return      true if the whole signal was sent, false if there was
+ *              nothing to send or the callback was too slow
+ */
+bool infrared_send_raw_stream(
+    InfraredRawTimingsCallback callback,
+    void* context,
+    bool start_from_mark,
+    uint32_t frequency,
+    float duty_cycle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,6 +2,7 @@
 
 #include <furi_hal_infrared.h>
 #include <float_tools.h>
+#include <toolbox/pulse_ring.h>
 
 #include <core/check.h>
 #include <core/common_defines.h>
@@ -9,6 +10,9 @@
 #include <notification/notification_messages.h>
 
 #define INFRARED_WORKER_RX_TIMEOUT INFRARED_RAW_RX_TIMING_DELAY_US
+#define INFRARED_WORKER_RX_RING_SIZE MAX_TIMINGS_AMOUNT
+#define INFRARED_WORKER_RX_BATCH_SIZE (32U)
+#define INFRARED_WORKER_TX_BATCH_SIZE (32U)
 
 #define INFRARED_WORKER_RX_RECEIVED 0x01
 #define INFRARED_WORKER_RX_TIMEOUT_RECEIVED 0x02
@@ -76,6 +80,7 @@ struct InfraredWorker {
         struct {
             InfraredWorkerReceivedSignalCallback received_signal_callback;
             void* received_signal_context;
+            PulseRing* ring;
             bool overrun;
         } rx;
     };
@@ -105,13 +110,19 @@ static void infrared_worker_rx_callback(void* context, bool level, uint32_t dura
     furi_assert(duration != 0);
     LevelDuration level_duration = level_duration_make(level, duration);
 
-    size_t ret =
-        furi_stream_buffer_send(instance->stream, &level_duration, sizeof(LevelDuration), 0);
-    uint32_t events = (ret == sizeof(LevelDuration)) ? INFRARED_WORKER_RX_RECEIVED :
-                                                       INFRARED_WORKER_OVERRUN;
+    // Worker drains the ring until it is empty, so it is only woken up by the first edge
+    size_t count = pulse_ring_push(instance->rx.ring, level_duration);
+    uint32_t events = 0;
+    if(count == 0) {
+        events = INFRARED_WORKER_OVERRUN;
+    } else if(count == 1) {
+        events = INFRARED_WORKER_RX_RECEIVED;
+    }
 
-    uint32_t flags_set = furi_thread_flags_set(furi_thread_get_id(instance->thread), events);
-    furi_check(flags_set & events);
+    if(events) {
+        uint32_t flags_set = furi_thread_flags_set(furi_thread_get_id(instance->thread), events);
+        furi_check(flags_set & events);
+    }
 }
 
 static void infrared_worker_process_timeout(InfraredWorker* instance) {
@@ -164,7 +175,7 @@ static void
 static int32_t infrared_worker_rx_thread(void* thread_context) {
     InfraredWorker* instance = thread_context;
     uint32_t events = 0;
-    LevelDuration level_duration;
+    LevelDuration batch[INFRARED_WORKER_RX_BATCH_SIZE];
     uint32_t last_blink_time = 0;
 
     while(1) {
@@ -179,12 +190,14 @@ static int32_t infrared_worker_rx_thread(void* thread_context) {
             }
             if(instance->signal.timings_cnt == 0)
                 notification_message(instance->notification, &sequence_display_backlight_on);
-            while(sizeof(LevelDuration) ==
-                  furi_stream_buffer_receive(
-                      instance->stream, &level_duration, sizeof(LevelDuration), 0)) {
-                if(!instance->rx.overrun) {
-                    bool level = level_duration_get_level(level_duration);
-                    uint32_t duration = level_duration_get_duration(level_duration);
+            size_t count;
+            while((count = pulse_ring_pop(instance->rx.ring, batch, COUNT_OF(batch))) > 0) {
+                if(instance->rx.overrun) continue;
+                for(size_t i = 0; i < count; i++) {
+                    // Overrun marker, decoder is reset by INFRARED_WORKER_OVERRUN
+                    if(level_duration_is_reset(batch[i])) continue;
+                    bool level = level_duration_get_level(batch[i]);
+                    uint32_t duration = level_duration_get_duration(batch[i]);
                     infrared_worker_process_timings(instance, duration, level);
                 }
             }
@@ -227,9 +240,7 @@ InfraredWorker* infrared_worker_alloc() {
 
     instance->thread = furi_thread_alloc_ex("InfraredWorker", 2048, NULL, instance);
 
-    size_t buffer_size =
-        MAX(sizeof(InfraredWorkerTiming) * (MAX_TIMINGS_AMOUNT + 1),
-            sizeof(LevelDuration) * MAX_TIMINGS_AMOUNT);
+    size_t buffer_size = sizeof(InfraredWorkerTiming) * (MAX_TIMINGS_AMOUNT + 1);
     instance->stream = furi_stream_buffer_alloc(buffer_size, sizeof(InfraredWorkerTiming));
     instance->infrared_decoder = infrared_alloc_decoder();
     instance->infrared_encoder = infrared_alloc_encoder();
@@ -258,7 +269,7 @@ void infrared_worker_rx_start(InfraredWorker* instance) {
     furi_assert(instance);
     furi_assert(instance->state == InfraredWorkerStateIdle);
 
-    furi_stream_set_trigger_level(instance->stream, sizeof(LevelDuration));
+    instance->rx.ring = pulse_ring_alloc(INFRARED_WORKER_RX_RING_SIZE);
 
     furi_thread_set_callback(instance->thread, infrared_worker_rx_thread);
     furi_thread_start(instance->thread);
@@ -284,9 +295,8 @@ void infrared_worker_rx_stop(InfraredWorker* instance) {
     furi_thread_flags_set(furi_thread_get_id(instance->thread), INFRARED_WORKER_EXIT);
     furi_thread_join(instance->thread);
 
-    FuriStatus status = furi_stream_buffer_reset(instance->stream);
-    furi_assert(status == FuriStatusOk);
-    (void)status;
+    pulse_ring_free(instance->rx.ring);
+    instance->rx.ring = NULL;
 
     instance->state = InfraredWorkerStateIdle;
 }
@@ -421,13 +431,28 @@ static bool infrared_get_new_signal(InfraredWorker* instance) {
     return new_signal_obtained;
 }
 
+static void infrared_worker_tx_send_batch(
+    InfraredWorker* instance,
+    const InfraredWorkerTiming* batch,
+    size_t batch_size) {
+    if(!batch_size) return;
+
+    const size_t size = sizeof(InfraredWorkerTiming) * batch_size;
+    size_t written_size = furi_stream_buffer_send(instance->stream, batch, size, 0);
+    furi_assert(size == written_size);
+    (void)written_size;
+}
+
 static bool infrared_worker_tx_fill_buffer(InfraredWorker* instance) {
     bool new_data_available = true;
-    InfraredWorkerTiming timing;
+    InfraredWorkerTiming batch[INFRARED_WORKER_TX_BATCH_SIZE];
+    size_t batch_size = 0;
+    size_t space_available =
+        furi_stream_buffer_spaces_available(instance->stream) / sizeof(InfraredWorkerTiming);
     InfraredStatus status = InfraredStatusError;
 
-    while(!furi_stream_buffer_is_full(instance->stream) && !instance->tx.need_reinitialization &&
-          new_data_available) {
+    while(space_available && !instance->tx.need_reinitialization && new_data_available) {
+        InfraredWorkerTiming timing;
         if(instance->signal.decoded) {
             status = infrared_encode(instance->infrared_encoder, &timing.duration, &timing.level);
         } else {
@@ -458,12 +483,18 @@ static bool infrared_worker_tx_fill_buffer(InfraredWorker* instance) {
         } else {
             furi_crash();
         }
-        uint32_t written_size =
-            furi_stream_buffer_send(instance->stream, &timing, sizeof(InfraredWorkerTiming), 0);
-        furi_assert(sizeof(InfraredWorkerTiming) == written_size);
-        (void)written_size;
+        batch[batch_size++] = timing;
+        --space_available;
+
+        /* timings are sent in batches instead of one by one */
+        if((batch_size == INFRARED_WORKER_TX_BATCH_SIZE) || !space_available) {
+            infrared_worker_tx_send_batch(instance, batch, batch_size);
+            batch_size = 0;
+        }
     }
 
+    infrared_worker_tx_send_batch(instance, batch, batch_size);
+
     return new_data_available;
 }
 
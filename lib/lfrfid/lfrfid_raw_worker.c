@@ -1,6 +1,6 @@
 #include <furi_hal_rfid.h>
 #include <toolbox/stream/file_stream.h>
-#include <toolbox/buffer_stream.h>
+#include <toolbox/pulse_ring.h>
 #include <toolbox/varint.h>
 #include "lfrfid_raw_worker.h"
 #include "lfrfid_raw_file.h"
@@ -8,7 +8,9 @@
 
 #define EMULATE_BUFFER_SIZE 1024
 #define RFID_DATA_BUFFER_SIZE 2048
-#define READ_DATA_BUFFER_COUNT 4
+#define READ_RING_SIZE 4096
+#define READ_BATCH_SIZE 64
+#define READ_POLL_MS 10
 
 #define TAG_EMULATE "RawEmulate"
 
@@ -33,8 +35,10 @@ typedef enum {
 #define READ_TEMP_DATA_SIZE 10
 
 typedef struct {
-    BufferStream* stream;
+    PulseRing* ring;
     VarintPair* pair;
+    uint8_t buffer[RFID_DATA_BUFFER_SIZE];
+    size_t buffer_size;
 } LFRFIDRawWorkerReadData;
 
 // main worker
@@ -120,14 +124,43 @@ void lfrfid_raw_worker_stop(LFRFIDRawWorker* worker) {
 
 static void lfrfid_raw_worker_capture(bool level, uint32_t duration, void* context) {
     LFRFIDRawWorkerReadData* ctx = context;
+    // Pairs are packed by the worker thread, the ISR only queues the edge
+    pulse_ring_push(ctx->ring, level_duration_make(level, duration));
+}
+
+static bool lfrfid_raw_worker_read_process(LFRFIDRawFile* file, LFRFIDRawWorkerReadData* ctx) {
+    LevelDuration batch[READ_BATCH_SIZE];
+    size_t count;
+    bool file_valid = true;
 
-    bool need_to_send = varint_pair_pack(ctx->pair, level, duration);
+    while(file_valid && (count = pulse_ring_pop(ctx->ring, batch, COUNT_OF(batch))) > 0) {
+        for(size_t i = 0; i < count; i++) {
+            // Edges were dropped, start over from the next pulse
+            if(level_duration_is_reset(batch[i])) {
+                varint_pair_reset(ctx->pair);
+                continue;
+            }
 
-    if(need_to_send) {
-        buffer_stream_send_from_isr(
-            ctx->stream, varint_pair_get_data(ctx->pair), varint_pair_get_size(ctx->pair));
-        varint_pair_reset(ctx->pair);
+            bool need_to_send = varint_pair_pack(
+                ctx->pair,
+                level_duration_get_level(batch[i]),
+                level_duration_get_duration(batch[i]));
+            if(!need_to_send) continue;
+
+            // Pairs must not span two buffers of the file
+            size_t pair_size = varint_pair_get_size(ctx->pair);
+            if(ctx->buffer_size + pair_size > RFID_DATA_BUFFER_SIZE) {
+                file_valid = lfrfid_raw_file_write_buffer(file, ctx->buffer, ctx->buffer_size);
+                ctx->buffer_size = 0;
+                if(!file_valid) break;
+            }
+            memcpy(&ctx->buffer[ctx->buffer_size], varint_pair_get_data(ctx->pair), pair_size);
+            ctx->buffer_size += pair_size;
+            varint_pair_reset(ctx->pair);
+        }
     }
+
+    return file_valid;
 }
 
 static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
@@ -140,7 +173,7 @@ static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
 
     LFRFIDRawWorkerReadData* data = malloc(sizeof(LFRFIDRawWorkerReadData));
 
-    data->stream = buffer_stream_alloc(RFID_DATA_BUFFER_SIZE, READ_DATA_BUFFER_COUNT);
+    data->ring = pulse_ring_alloc(READ_RING_SIZE);
     data->pair = varint_pair_alloc();
 
     if(file_valid) {
@@ -160,13 +193,9 @@ static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
         furi_hal_rfid_tim_read_capture_start(lfrfid_raw_worker_capture, data);
 
         while(1) {
-            Buffer* buffer = buffer_stream_receive(data->stream, 100);
+            furi_delay_ms(READ_POLL_MS);
 
-            if(buffer != NULL) {
-                file_valid = lfrfid_raw_file_write_buffer(
-                    file, buffer_get_data(buffer), buffer_get_size(buffer));
-                buffer_reset(buffer);
-            }
+            file_valid = lfrfid_raw_worker_read_process(file, data);
 
             if(!file_valid) {
                 if(worker->read_callback != NULL) {
@@ -176,7 +205,7 @@ static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
                 break;
             }
 
-            if(buffer_stream_get_overrun_count(data->stream) > 0 &&
+            if(pulse_ring_get_overrun_count(data->ring) > 0 &&
                worker->read_callback != NULL) {
                 // message overrun to worker
                 worker->read_callback(LFRFIDWorkerReadRawOverrun, worker->context);
@@ -190,6 +219,15 @@ static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
 
         furi_hal_rfid_tim_read_capture_stop();
         furi_hal_rfid_tim_read_stop();
+
+        // Pulses captured before the stop and the last partial buffer go to the file too
+        if(file_valid) {
+            file_valid = lfrfid_raw_worker_read_process(file, data);
+        }
+        if(file_valid && (data->buffer_size > 0)) {
+            file_valid = lfrfid_raw_file_write_buffer(file, data->buffer, data->buffer_size);
+            data->buffer_size = 0;
+        }
     } else {
         if(worker->read_callback != NULL) {
             // message file_error to worker
@@ -210,7 +248,7 @@ static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
     }
 
     varint_pair_free(data->pair);
-    buffer_stream_free(data->stream);
+    pulse_ring_free(data->ring);
     lfrfid_raw_file_free(file);
     furi_record_close(RECORD_STORAGE);
     free(data);
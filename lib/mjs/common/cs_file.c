@@ -50,6 +50,19 @@ char* cs_read_file(const char* path, size_t* size) {
     return data;
 }
 
+int cs_write_file(const char* path, const struct mg_str* parts, size_t parts_cnt) WEAK;
+int cs_write_file(const char* path, const struct mg_str* parts, size_t parts_cnt) {
+    FILE* fp;
+    size_t i;
+    int ok = 1;
+    if((fp = fopen(path, "wb")) == NULL) return 0;
+    for(i = 0; i < parts_cnt && ok; i++) {
+        if(parts[i].len > 0 && fwrite(parts[i].p, parts[i].len, 1, fp) != 1) ok = 0;
+    }
+    fclose(fp);
+    return ok;
+}
+
 char* cs_mmap_file(const char* path, size_t* size) WEAK;
 char* cs_mmap_file(const char* path, size_t* size) {
     char* r;
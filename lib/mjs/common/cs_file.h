@@ -19,6 +19,7 @@
 #define CS_COMMON_CS_FILE_H_
 
 #include "platform.h"
+#include "mg_str.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,13 @@ extern "C" {
  */
 char *cs_read_file(const char *path, size_t *size);
 
+/*
+ * Write `parts_cnt` memory chunks from `parts` one after another into file
+ * `path`, replacing its contents.
+ * Return: 1 on success, 0 on error.
+ */
+int cs_write_file(const char *path, const struct mg_str *parts, size_t parts_cnt);
+
 #ifdef CS_MMAP
 /*
  * Only on platforms which support mmapping: mmap file `path` to the returned
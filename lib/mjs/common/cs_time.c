@@ -59,6 +59,16 @@ double cs_time(void) {
     return now;
 }
 
+uint32_t cs_hrtime(void) WEAK;
+uint32_t cs_hrtime(void) {
+    return (uint32_t)(int64_t)(cs_time() * 1000000.0);
+}
+
+uint32_t cs_hrtime_ticks_per_us(void) WEAK;
+uint32_t cs_hrtime_ticks_per_us(void) {
+    return 1;
+}
+
 double cs_timegm(const struct tm* tm) {
     /* Month-to-day offset for non-leap-years. */
     static const int month_day[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
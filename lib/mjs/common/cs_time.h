@@ -35,6 +35,15 @@ double cs_time(void);
  */
 double cs_timegm(const struct tm* tm);
 
+/*
+ * Free-running high resolution tick counter for measuring short intervals:
+ * only the (unsigned) difference of two readings is meaningful.
+ */
+uint32_t cs_hrtime(void);
+
+/* Number of `cs_hrtime()` ticks per microsecond. */
+uint32_t cs_hrtime_ticks_per_us(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
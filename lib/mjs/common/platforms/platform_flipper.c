@@ -1,6 +1,9 @@
 #include <furi.h>
+#include <furi_hal_cortex.h>
 #include <toolbox/stream/file_stream.h>
 #include "../cs_dbg.h"
+#include "../cs_file.h"
+#include "../cs_time.h"
 #include "../frozen/frozen.h"
 
 char* cs_read_file(const char* path, size_t* size) {
@@ -29,6 +32,32 @@ char* cs_read_file(const char* path, size_t* size) {
     return data;
 }
 
+int cs_write_file(const char* path, const struct mg_str* parts, size_t parts_cnt) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = file_stream_alloc(storage);
+    int ok = 0;
+    if(file_stream_open(stream, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        ok = 1;
+        for(size_t i = 0; i < parts_cnt && ok; i++) {
+            if(stream_write(stream, (const uint8_t*)parts[i].p, parts[i].len) != parts[i].len) {
+                ok = 0;
+            }
+        }
+    }
+    file_stream_close(stream);
+    furi_record_close(RECORD_STORAGE);
+    stream_free(stream);
+    return ok;
+}
+
+uint32_t cs_hrtime(void) {
+    return DWT->CYCCNT;
+}
+
+uint32_t cs_hrtime_ticks_per_us(void) {
+    return furi_hal_cortex_instructions_per_microsecond();
+}
+
 char* json_fread(const char* path) {
     UNUSED(path);
     return NULL;
@@ -75,6 +75,11 @@ unsigned long mjs_array_length(struct mjs* mjs, mjs_val_t v) {
         goto clean;
     }
 
+    /* Large arrays keep the length in their property index */
+    if(mjs_object_get_indexed_array_length(get_object_struct(v), &len)) {
+        goto clean;
+    }
+
     for(p = get_object_struct(v)->properties; p != NULL; p = p->next) {
         int ok = 0;
         unsigned long n = 0;
@@ -111,6 +111,20 @@ static void mjs_do_gc(struct mjs* mjs) {
     mjs_return(mjs, arg0);
 }
 
+static void mjs_gc_stats(struct mjs* mjs) {
+    struct mjs_gc_stats stats;
+    mjs_val_t res = mjs_mk_object(mjs);
+
+    mjs_get_gc_stats(mjs, &stats);
+    mjs_set(mjs, res, "minor", ~0, mjs_mk_number(mjs, stats.minor_collections));
+    mjs_set(mjs, res, "major", ~0, mjs_mk_number(mjs, stats.major_collections));
+    mjs_set(mjs, res, "steps", ~0, mjs_mk_number(mjs, stats.sweep_steps));
+    mjs_set(mjs, res, "lastPause", ~0, mjs_mk_number(mjs, stats.last_pause_us));
+    mjs_set(mjs, res, "maxPause", ~0, mjs_mk_number(mjs, stats.max_pause_us));
+    mjs_set(mjs, res, "totalPause", ~0, mjs_mk_number(mjs, stats.total_pause_us));
+    mjs_return(mjs, res);
+}
+
 static void mjs_s2o(struct mjs* mjs) {
     mjs_return(
         mjs,
@@ -133,6 +147,7 @@ void mjs_init_builtin(struct mjs* mjs, mjs_val_t obj) {
     mjs_set(mjs, obj, "getMJS", ~0, mjs_mk_foreign_func(mjs, (mjs_func_ptr_t)mjs_get_mjs));
     mjs_set(mjs, obj, "die", ~0, mjs_mk_foreign_func(mjs, (mjs_func_ptr_t)mjs_die));
     mjs_set(mjs, obj, "gc", ~0, mjs_mk_foreign_func(mjs, (mjs_func_ptr_t)mjs_do_gc));
+    mjs_set(mjs, obj, "gcStats", ~0, mjs_mk_foreign_func(mjs, (mjs_func_ptr_t)mjs_gc_stats));
     mjs_set(mjs, obj, "chr", ~0, mjs_mk_foreign_func(mjs, (mjs_func_ptr_t)mjs_chr));
     mjs_set(mjs, obj, "s2o", ~0, mjs_mk_foreign_func(mjs, (mjs_func_ptr_t)mjs_s2o));
 
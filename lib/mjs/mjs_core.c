@@ -61,6 +61,7 @@ void mjs_destroy(struct mjs* mjs) {
     mbuf_free(&mjs->loop_addresses);
     mbuf_free(&mjs->json_visited_stack);
     mbuf_free(&mjs->array_buffers);
+    mbuf_free(&mjs->gc_remembered);
     free(mjs->error_msg);
     free(mjs->stack_trace);
     mjs_ffi_args_free_list(mjs);
@@ -86,6 +87,7 @@ struct mjs* mjs_create(void* context) {
     mbuf_init(&mjs->loop_addresses, 0);
     mbuf_init(&mjs->json_visited_stack, 0);
     mbuf_init(&mjs->array_buffers, 0);
+    mbuf_init(&mjs->gc_remembered, 0);
 
     mjs->bcode_len = 0;
 
@@ -114,6 +116,7 @@ struct mjs* mjs_create(void* context) {
         MJS_FUNC_FFI_ARENA_SIZE,
         MJS_FUNC_FFI_ARENA_INC_SIZE);
     mjs->ffi_sig_arena.destructor = mjs_ffi_sig_destructor;
+    mjs->object_arena.destructor = mjs_object_destructor;
 
     global_object = mjs_mk_object(mjs);
     mjs_init_builtin(mjs, global_object);
@@ -8,6 +8,7 @@
 
 #include "mjs_ffi.h"
 #include "mjs_gc.h"
+#include "mjs_gc_public.h"
 #include "mjs_internal.h"
 
 #if defined(__cplusplus)
@@ -60,6 +61,21 @@ struct mjs_bcode_part {
     unsigned in_rom : 1;
 };
 
+/*
+ * Monomorphic inline cache of own property lookups done by OP_GET and
+ * assignments. Entries are keyed by the address of the instruction, the
+ * bcode itself is never modified.
+ */
+#ifndef MJS_INLINE_CACHE_SIZE
+#define MJS_INLINE_CACHE_SIZE 32 /* Must be a power of 2 */
+#endif
+
+struct mjs_inline_cache_entry {
+    const uint8_t* site;
+    struct mjs_object* obj;
+    struct mjs_property* prop;
+};
+
 struct mjs {
     struct mbuf bcode_gen;
     struct mbuf bcode_parts;
@@ -89,9 +105,19 @@ struct mjs {
     struct gc_arena property_arena;
     struct gc_arena ffi_sig_arena;
 
+    struct mjs_inline_cache_entry inline_cache[MJS_INLINE_CACHE_SIZE];
+
+    struct mbuf gc_remembered; /* Old objects which may point to young cells */
+    struct mjs_gc_stats gc_stats;
+    unsigned gc_minors_since_major;
+    size_t gc_strings_len; /* Length of owned strings after the last major GC */
+
     unsigned inhibit_gc : 1;
     unsigned need_gc : 1;
     unsigned generate_jsc : 1;
+    unsigned gc_incremental : 1;
+    unsigned gc_minor : 1; /* The current collection is a minor one */
+    unsigned gc_sweeping : 1; /* Some arenas are not swept yet */
 };
 
 /*
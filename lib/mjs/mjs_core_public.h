@@ -258,7 +258,8 @@ const char* mjs_get_stack_trace(struct mjs* mjs);
  * default it's 0.
  *
  * If either `MJS_GENERATE_JSC` or `CS_MMAP` is off, then this function has no
- * effect.
+ * effect, unless `MJS_JSC_CACHE` is on: then .jsc files are used as a cache
+ * of precompiled bcode, which is loaded into RAM instead of parsing the source.
  */
 void mjs_set_generate_jsc(struct mjs* mjs, int generate_jsc);
 
@@ -232,7 +232,7 @@ static int check_equal(struct mjs* mjs, mjs_val_t a, mjs_val_t b) {
     return ret;
 }
 
-static void exec_expr(struct mjs* mjs, int op) {
+static void exec_expr(struct mjs* mjs, const uint8_t* site, int op) {
     switch(op) {
     case TOK_DOT:
         break;
@@ -316,7 +316,15 @@ static void exec_expr(struct mjs* mjs, int op) {
         mjs_val_t obj = mjs_pop(mjs);
         mjs_val_t key = mjs_pop(mjs);
         if(mjs_is_object(obj)) {
-            mjs_set_v(mjs, obj, key, val);
+            struct mjs_property* p = mjs_get_own_property_cached(mjs, site, obj, key);
+            if(p != NULL) {
+                if(mjs_is_object_based(val) || mjs_is_ffi_sig(val)) {
+                    gc_write_barrier(mjs, get_object_struct(obj));
+                }
+                p->value = val;
+            } else {
+                mjs_set_v(mjs, obj, key, val);
+            }
         } else if(mjs_is_data_view(obj)) {
             mjs_err_t err = mjs_dataview_set_prop(mjs, obj, key, val);
             if(err != MJS_OK) {
@@ -629,7 +637,9 @@ MJS_PRIVATE mjs_err_t mjs_execute(struct mjs* mjs, size_t off, mjs_val_t* res) {
     for(i = off; i < bp.data.len; i++) {
         mjs->cur_bcode_offset = i;
 
-        if(mjs->need_gc) {
+        if(mjs->gc_sweeping) {
+            gc_sweep_step(mjs);
+        } else if(mjs->need_gc) {
             if(maybe_gc(mjs)) {
                 mjs->need_gc = 0;
             }
@@ -744,7 +754,8 @@ MJS_PRIVATE mjs_err_t mjs_execute(struct mjs* mjs, size_t off, mjs_val_t* res) {
 
             if(!getprop_builtin(mjs, obj, key, &val)) {
                 if(mjs_is_object(obj)) {
-                    val = mjs_get_v_proto(mjs, obj, key);
+                    struct mjs_property* p = mjs_get_own_property_cached(mjs, code + i, obj, key);
+                    val = p != NULL ? p->value : mjs_get_v_proto(mjs, obj, key);
                 } else if((mjs_is_data_view(obj) && (mjs_is_number(key)))) {
                     val = mjs_dataview_get_prop(mjs, obj, key);
                 } else {
@@ -937,7 +948,7 @@ MJS_PRIVATE mjs_err_t mjs_execute(struct mjs* mjs, size_t off, mjs_val_t* res) {
         }
         case OP_EXPR: {
             int op = code[i + 1];
-            exec_expr(mjs, op);
+            exec_expr(mjs, code + i, op);
             i++;
             break;
         }
@@ -1149,6 +1160,148 @@ mjs_err_t mjs_exec(struct mjs* mjs, const char* src, mjs_val_t* res) {
     return mjs_exec_internal(mjs, "<stdin>", src, 0 /* generate_jsc */, res);
 }
 
+#if MJS_JSC_CACHE
+/*
+ * .jsc cache file layout: `struct mjs_jsc_header` followed by the bcode part
+ * exactly as committed by `mjs_parse()`. Bcode parts are relocatable (all
+ * offsets are relative to the part start), so they can be loaded at any
+ * global bcode offset.
+ */
+#define MJS_JSC_MAGIC 0x43534a4dU /* "MJSC" */
+
+/* Increment whenever the bcode format or opcodes change */
+#define MJS_JSC_VERSION 1
+
+struct mjs_jsc_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t source_size;
+    uint32_t source_hash;
+    uint32_t bcode_size;
+};
+
+/* FNV-1a, we only need to detect changes of the source */
+static uint32_t mjs_jsc_source_hash(const char* src, size_t size) {
+    uint32_t hash = 2166136261U;
+    size_t i;
+    for(i = 0; i < size; i++) {
+        hash ^= (uint8_t)src[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/* Returns malloc-ed .jsc path for the .js `path`, or NULL for other files */
+static char* mjs_jsc_path(const char* path) {
+    const char* jsext = ".js";
+    size_t path_len = strlen(path);
+    char* jsc_path;
+
+    if(path_len <= strlen(jsext) || strcmp(path + path_len - strlen(jsext), jsext) != 0) {
+        return NULL;
+    }
+
+    jsc_path = malloc(path_len + 2 /* 'c' and nul-term */);
+    memcpy(jsc_path, path, path_len);
+    jsc_path[path_len] = 'c';
+    jsc_path[path_len + 1] = '\0';
+    return jsc_path;
+}
+
+/*
+ * Loads bcode from `jsc_path` and commits it as a next bcode part, if the
+ * cache header matches `expected`. Returns 1 if bcode was loaded.
+ */
+static int
+    mjs_jsc_load(struct mjs* mjs, const char* jsc_path, const struct mjs_jsc_header* expected) {
+    struct mjs_jsc_header header;
+    size_t size;
+    char* data = cs_read_file(jsc_path, &size);
+
+    if(data == NULL) return 0;
+
+    if(size <= sizeof(header)) {
+        free(data);
+        return 0;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if(header.magic != expected->magic || header.version != expected->version ||
+       header.source_size != expected->source_size ||
+       header.source_hash != expected->source_hash ||
+       header.bcode_size != size - sizeof(header) ||
+       (uint8_t)data[sizeof(header)] != OP_BCODE_HEADER) {
+        LOG(LL_DEBUG, ("%s is outdated", jsc_path));
+        free(data);
+        return 0;
+    }
+
+    memmove(data, data + sizeof(header), header.bcode_size);
+    mjs_bcode_commit_data(mjs, data, header.bcode_size);
+    return 1;
+}
+
+/* Writes the last committed bcode part into `jsc_path` */
+static void mjs_jsc_save(struct mjs* mjs, const char* jsc_path, struct mjs_jsc_header* header) {
+    struct mjs_bcode_part* bp = mjs_bcode_part_get(mjs, mjs_bcode_parts_cnt(mjs) - 1);
+    struct mg_str parts[2];
+
+    header->bcode_size = bp->data.len;
+    parts[0] = mg_mk_str_n((const char*)header, sizeof(*header));
+    parts[1] = mg_mk_str_n(bp->data.p, bp->data.len);
+
+    if(!cs_write_file(jsc_path, parts, 2)) {
+        LOG(LL_WARN, ("Failed to write %s", jsc_path));
+    }
+}
+
+/*
+ * Executes .js file using .jsc cache. Source and bcode never stay in RAM
+ * together: the source is dropped right after hashing or parsing it.
+ */
+static mjs_err_t mjs_exec_file_cached(
+    struct mjs* mjs,
+    const char* path,
+    char* jsc_path,
+    char* source_code,
+    size_t size,
+    mjs_val_t* res) {
+    size_t off = mjs->bcode_len;
+    mjs_val_t r = MJS_UNDEFINED;
+    struct mjs_jsc_header header;
+
+    header.magic = MJS_JSC_MAGIC;
+    header.version = MJS_JSC_VERSION;
+    header.source_size = size;
+    header.source_hash = mjs_jsc_source_hash(source_code, size);
+    header.bcode_size = 0;
+
+    free(source_code);
+
+    if(mjs_jsc_load(mjs, jsc_path, &header)) {
+        mjs->error = MJS_OK;
+    } else {
+        source_code = cs_read_file(path, &size);
+        if(source_code == NULL) {
+            mjs_prepend_errorf(mjs, MJS_FILE_READ_ERROR, "failed to read file \"%s\"", path);
+            *res = r;
+            return MJS_FILE_READ_ERROR;
+        }
+        mjs->error = mjs_parse(path, source_code, mjs);
+        free(source_code);
+        if(mjs->error == MJS_OK) {
+            mjs_jsc_save(mjs, jsc_path, &header);
+        }
+    }
+
+    if(mjs->error == MJS_OK) {
+        mjs_execute(mjs, off, &r);
+    }
+    *res = r;
+    return mjs->error;
+}
+#endif
+
 mjs_err_t mjs_exec_file(struct mjs* mjs, const char* path, mjs_val_t* res) {
     mjs_err_t error = MJS_FILE_READ_ERROR;
     mjs_val_t r = MJS_UNDEFINED;
@@ -1161,6 +1314,17 @@ mjs_err_t mjs_exec_file(struct mjs* mjs, const char* path, mjs_val_t* res) {
         goto clean;
     }
 
+#if MJS_JSC_CACHE
+    if(mjs->generate_jsc) {
+        char* jsc_path = mjs_jsc_path(path);
+        if(jsc_path != NULL) {
+            error = mjs_exec_file_cached(mjs, path, jsc_path, source_code, size, &r);
+            free(jsc_path);
+            goto clean;
+        }
+    }
+#endif
+
     r = MJS_UNDEFINED;
     error = mjs_exec_internal(mjs, path, source_code, -1, &r);
     free(source_code);
@@ -14,6 +14,18 @@
 #define MJS_MEMORY_STATS 0
 #endif
 
+/*
+ * Incremental GC tuning: number of cells swept per interpreter step, and
+ * number of minor collections between two major ones.
+ */
+#if !defined(MJS_GC_STEP_CELLS)
+#define MJS_GC_STEP_CELLS 64
+#endif
+
+#if !defined(MJS_GC_MINORS_PER_MAJOR)
+#define MJS_GC_MINORS_PER_MAJOR 8
+#endif
+
 /*
  * MJS_GENERATE_JSC: if enabled, and if mmapping is also enabled (CS_MMAP),
  * then execution of any .js file will result in creation of a .jsc file with
@@ -30,4 +42,20 @@
 #endif
 #endif
 
+/*
+ * MJS_JSC_CACHE: if enabled, and mmapping is not available, execution of a
+ * .js file with `generate_jsc` set loads precompiled bcode from the .jsc
+ * file next to it, skipping tokenizing and parsing. The .jsc file is
+ * (re)created whenever it doesn't match the source or the bcode version.
+ *
+ * By default it's enabled when CS_MMAP is not defined
+ */
+#if !defined(MJS_JSC_CACHE)
+#if defined(CS_MMAP)
+#define MJS_JSC_CACHE 0
+#else
+#define MJS_JSC_CACHE 1
+#endif
+#endif
+
 #endif /* MJS_FEATURES_H_ */
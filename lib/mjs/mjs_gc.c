@@ -5,6 +5,7 @@
 
 #include <stdio.h>
 
+#include "common/cs_time.h"
 #include "common/cs_varint.h"
 #include "common/mbuf.h"
 
@@ -17,16 +18,9 @@
 #include "mjs_string.h"
 
 /*
- * Macros for marking reachable things: use bit 0.
- */
-#define MARK(p) (((struct gc_cell*)(p))->head.word |= 1)
-#define UNMARK(p) (((struct gc_cell*)(p))->head.word &= ~1)
-#define MARKED(p) (((struct gc_cell*)(p))->head.word & 1)
-
-/*
- * Similar to `MARK()` / `UNMARK()` / `MARKED()`, but `.._FREE` counterparts
- * are intended to mark free cells (as opposed to used ones), so they use
- * bit 1.
+ * Reachable cells are marked with GC_CELL_MARK in the block flags. Free cells
+ * are marked in the cell itself right before sweeping (nobody touches them
+ * until they're swept), using bit 1 of the link.
  */
 #define MARK_FREE(p) (((struct gc_cell*)(p))->head.word |= 2)
 #define UNMARK_FREE(p) (((struct gc_cell*)(p))->head.word &= ~2)
@@ -40,6 +34,8 @@
 static struct gc_block* gc_new_block(struct gc_arena* a, size_t size);
 static void gc_free_block(struct gc_block* b);
 static void gc_mark_mbuf_pt(struct mjs* mjs, const struct mbuf* mbuf);
+static size_t gc_sweep_block(struct mjs* mjs, struct gc_arena* a);
+static void gc_sweep_begin(struct gc_arena* a);
 
 MJS_PRIVATE struct mjs_object* new_object(struct mjs* mjs) {
     return (struct mjs_object*)gc_alloc_cell(mjs, &mjs->object_arena);
@@ -71,7 +67,13 @@ MJS_PRIVATE void gc_arena_destroy(struct mjs* mjs, struct gc_arena* a) {
     struct gc_block* b;
 
     if(a->blocks != NULL) {
-        gc_sweep(mjs, a, 0);
+        /* Finish the pending sweep, then sweep once more with nothing marked */
+        while(gc_sweep_block(mjs, a) > 0) {
+        }
+        mjs->gc_minor = 0;
+        gc_sweep_begin(a);
+        while(gc_sweep_block(mjs, a) > 0) {
+        }
         for(b = a->blocks; b != NULL;) {
             struct gc_block* tmp;
             tmp = b;
@@ -94,8 +96,9 @@ static struct gc_block* gc_new_block(struct gc_arena* a, size_t size) {
     if(b == NULL) abort();
 
     b->size = size;
-    b->base = (struct gc_cell*)calloc(a->cell_size, b->size);
+    b->base = (struct gc_cell*)calloc(a->cell_size + sizeof(*b->flags), b->size);
     if(b->base == NULL) abort();
+    b->flags = (uint8_t*)GC_CELL_OP(a, b->base, +, b->size);
 
     for(cur = GC_CELL_OP(a, b->base, +, 0); cur < GC_CELL_OP(a, b->base, +, b->size);
         cur = GC_CELL_OP(a, cur, +, 1)) {
@@ -131,6 +134,14 @@ MJS_PRIVATE int gc_strings_is_gc_needed(struct mjs* mjs) {
 MJS_PRIVATE void* gc_alloc_cell(struct mjs* mjs, struct gc_arena* a) {
     struct gc_cell* r;
 
+    /*
+     * Sweep lazily before growing the arena. This also guarantees that new
+     * blocks are never added while the arena is being swept.
+     */
+    while(a->free == NULL && a->sweep_pos != NULL) {
+        gc_sweep_block(mjs, a);
+    }
+
     if(a->free == NULL) {
         struct gc_block* b = gc_new_block(a, a->size_increment);
         b->next = a->blocks;
@@ -138,8 +149,6 @@ MJS_PRIVATE void* gc_alloc_cell(struct mjs* mjs, struct gc_arena* a) {
     }
     r = a->free;
 
-    UNMARK(r);
-
     a->free = r->head.link;
 
 #if MJS_MEMORY_STATS
@@ -147,8 +156,8 @@ MJS_PRIVATE void* gc_alloc_cell(struct mjs* mjs, struct gc_arena* a) {
     a->alive++;
 #endif
 
-    /* Schedule GC if needed */
-    if(gc_arena_is_gc_needed(a)) {
+    /* Schedule GC if needed; the free list is incomplete until swept */
+    if(a->sweep_pos == NULL && gc_arena_is_gc_needed(a)) {
         mjs->need_gc = 1;
     }
 
@@ -161,15 +170,10 @@ MJS_PRIVATE void* gc_alloc_cell(struct mjs* mjs, struct gc_arena* a) {
 }
 
 /*
- * Scans the arena and add all unmarked cells to the free list.
- *
- * Empty blocks get deallocated. The head of the free list will contais cells
- * from the last (oldest) block. Cells will thus be allocated in block order.
+ * Prepares the arena for sweeping: all unmarked cells will be added to the
+ * free list, block by block, by `gc_sweep_block()`.
  */
-void gc_sweep(struct mjs* mjs, struct gc_arena* a, size_t start) {
-    struct gc_block* b;
-    struct gc_cell* cur;
-    struct gc_block** prevp = &a->blocks;
+static void gc_sweep_begin(struct gc_arena* a) {
 #if MJS_MEMORY_STATS
     a->alive = 0;
 #endif
@@ -179,6 +183,7 @@ void gc_sweep(struct mjs* mjs, struct gc_arena* a, size_t start) {
    * distinguishable from marked used cells.
    */
     {
+        struct gc_cell* cur;
         struct gc_cell* next;
         for(cur = a->free; cur != NULL; cur = next) {
             next = cur->head.link;
@@ -190,124 +195,162 @@ void gc_sweep(struct mjs* mjs, struct gc_arena* a, size_t start) {
    * We'll rebuild the whole `free` list, so initially we just reset it
    */
     a->free = NULL;
+    a->sweep_pos = &a->blocks;
+}
 
-    for(b = a->blocks; b != NULL;) {
-        size_t freed_in_block = 0;
-        /*
+/*
+ * Sweeps the next block of the arena: adds all unmarked cells to the free
+ * list, and promotes marked ones to the old generation. During a minor
+ * collection old cells are kept whether marked or not.
+ *
+ * Empty blocks get deallocated. The head of the free list will contais cells
+ * from the last (oldest) block. Cells will thus be allocated in block order.
+ *
+ * Returns the number of cells visited, 0 if the arena is completely swept.
+ */
+static size_t gc_sweep_block(struct mjs* mjs, struct gc_arena* a) {
+    struct gc_block* b;
+    struct gc_cell* cur;
+    size_t i, freed_in_block = 0, garbage_in_block = 0;
+    /*
      * if it turns out that this block is 100% garbage
      * we can release the whole block, but the addition
      * of it's cells to the free list has to be undone.
      */
-        struct gc_cell* prev_free = a->free;
+    struct gc_cell* prev_free = a->free;
 
-        for(cur = GC_CELL_OP(a, b->base, +, start); cur < GC_CELL_OP(a, b->base, +, b->size);
-            cur = GC_CELL_OP(a, cur, +, 1)) {
-            if(MARKED(cur)) {
-                /* The cell is used and marked  */
-                UNMARK(cur);
+    if(a->sweep_pos == NULL) return 0;
+
+    b = *a->sweep_pos;
+    if(b == NULL) {
+        a->sweep_pos = NULL;
+        return 0;
+    }
+
+    for(i = 0, cur = b->base; i < b->size; i++, cur = GC_CELL_OP(a, cur, +, 1)) {
+        uint8_t* flags = &b->flags[i];
+        if(*flags & GC_CELL_MARK) {
+            /* The cell is used and marked: it survives and becomes old */
+            *flags = (*flags & ~GC_CELL_MARK) | GC_CELL_OLD;
+#if MJS_MEMORY_STATS
+            a->alive++;
+#endif
+        } else if(mjs->gc_minor && (*flags & GC_CELL_OLD)) {
+            /* Old cells are not traced by minor collections */
 #if MJS_MEMORY_STATS
-                a->alive++;
+            a->alive++;
 #endif
+        } else {
+            /*
+             * The cell is either:
+             * - free
+             * - garbage that's about to be freed
+             */
+
+            if(MARKED_FREE(cur)) {
+                /* The cell is free, so, just unmark it */
+                UNMARK_FREE(cur);
             } else {
                 /*
-         * The cell is either:
-         * - free
-         * - garbage that's about to be freed
-         */
-
-                if(MARKED_FREE(cur)) {
-                    /* The cell is free, so, just unmark it */
-                    UNMARK_FREE(cur);
-                } else {
-                    /*
-           * The cell is used and should be freed: call the destructor and
-           * reset the memory
-           */
-                    if(a->destructor != NULL) {
-                        a->destructor(mjs, cur);
-                    }
-                    memset(cur, 0, a->cell_size);
+                 * The cell is used and should be freed: call the destructor and
+                 * reset the memory
+                 */
+                if(a->destructor != NULL) {
+                    a->destructor(mjs, cur);
                 }
+                memset(cur, 0, a->cell_size);
+                garbage_in_block++;
+            }
+            *flags = 0;
 
-                /* Add this cell to the `free` list */
-                cur->head.link = a->free;
-                a->free = cur;
-                freed_in_block++;
+            /* Add this cell to the `free` list */
+            cur->head.link = a->free;
+            a->free = cur;
+            freed_in_block++;
 #if MJS_MEMORY_STATS
-                a->garbage++;
+            a->garbage++;
 #endif
-            }
         }
+    }
 
-        /*
+    /*
      * don't free the initial block, which is at the tail
      * because it has a special size aimed at reducing waste
      * and simplifying initial startup. TODO(mkm): improve
      * */
-        if(b->next != NULL && freed_in_block == b->size) {
-            *prevp = b->next;
-            gc_free_block(b);
-            b = *prevp;
-            a->free = prev_free;
-        } else {
-            prevp = &b->next;
-            b = b->next;
-        }
+    if(b->next != NULL && freed_in_block == b->size) {
+        *a->sweep_pos = b->next;
+        gc_free_block(b);
+        a->free = prev_free;
+    } else {
+        a->sweep_pos = &b->next;
     }
-}
 
-/* Mark an FFI signature */
-static void gc_mark_ffi_sig(struct mjs* mjs, mjs_val_t* v) {
-    struct mjs_ffi_sig* psig;
+    /* Freed cells may be reused for other objects and properties */
+    if(garbage_in_block > 0) {
+        mjs_inline_cache_reset(mjs);
+    }
 
-    assert(mjs_is_ffi_sig(*v));
+    return i;
+}
 
-    psig = mjs_get_ffi_sig_struct(*v);
+/* Returns the block of the arena the cell belongs to, or NULL */
+static struct gc_block* gc_find_block(const struct gc_arena* a, const void* ptr) {
+    const struct gc_cell* p = (const struct gc_cell*)ptr;
+    struct gc_block* b;
+    for(b = a->blocks; b != NULL; b = b->next) {
+        if(p >= b->base && p < GC_CELL_OP(a, b->base, +, b->size)) {
+            return b;
+        }
+    }
+    return NULL;
+}
 
-    /*
-   * we treat all object like things like objects but they might be functions,
-   * gc_check_val checks the appropriate arena per actual value type.
-   */
-    if(!gc_check_val(mjs, *v)) {
+/* Returns GC flags of the cell, aborts if it doesn't belong to the arena */
+static uint8_t* gc_cell_flags(const struct gc_arena* a, const void* ptr) {
+    struct gc_block* b = gc_find_block(a, ptr);
+    if(b == NULL) {
         abort();
     }
+    return &b->flags[((const char*)ptr - (const char*)b->base) / a->cell_size];
+}
 
-    if(MARKED(psig)) return;
+/*
+ * Marks the cell, returns whether it has to be traced: that is, it wasn't
+ * marked before, and it's not an old cell skipped by a minor collection.
+ */
+static int gc_mark_cell(struct mjs* mjs, const struct gc_arena* a, const void* cell) {
+    uint8_t* flags = gc_cell_flags(a, cell);
 
-    MARK(psig);
-}
+    if(*flags & GC_CELL_MARK) return 0;
+    if(mjs->gc_minor && (*flags & (GC_CELL_OLD | GC_CELL_REMEMBERED)) == GC_CELL_OLD) return 0;
 
-/* Mark an object */
-static void gc_mark_object(struct mjs* mjs, mjs_val_t* v) {
-    struct mjs_object* obj_base;
-    struct mjs_property* prop;
-    struct mjs_property* next;
+    *flags |= GC_CELL_MARK;
+    return 1;
+}
 
-    assert(mjs_is_object_based(*v));
+/* Mark an FFI signature */
+static void gc_mark_ffi_sig(struct mjs* mjs, mjs_val_t* v) {
+    assert(mjs_is_ffi_sig(*v));
 
-    obj_base = get_object_struct(*v);
+    gc_mark_cell(mjs, &mjs->ffi_sig_arena, mjs_get_ffi_sig_struct(*v));
+}
 
-    /*
-   * we treat all object like things like objects but they might be functions,
-   * gc_check_val checks the appropriate arena per actual value type.
-   */
-    if(!gc_check_val(mjs, *v)) {
-        abort();
-    }
+/* Mark an object and its properties */
+static void gc_mark_object_struct(struct mjs* mjs, struct mjs_object* obj_base) {
+    struct mjs_property* prop;
 
-    if(MARKED(obj_base)) return;
+    if(!gc_mark_cell(mjs, &mjs->object_arena, obj_base)) return;
 
-    /* mark object itself, and its properties */
-    for((prop = obj_base->properties), MARK(obj_base); prop != NULL; prop = next) {
-        if(!gc_check_ptr(&mjs->property_arena, prop)) {
-            abort();
-        }
+    for(prop = obj_base->properties; prop != NULL; prop = prop->next) {
+        /*
+         * Old properties of a remembered object have to be traced as well,
+         * since they might have got young values
+         */
+        *gc_cell_flags(&mjs->property_arena, prop) |= GC_CELL_MARK;
 
         gc_mark(mjs, &prop->name);
         gc_mark(mjs, &prop->value);
-
-        next = prop->next;
-        MARK(prop);
     }
 
     /* mark object's prototype */
@@ -318,6 +361,13 @@ static void gc_mark_object(struct mjs* mjs, mjs_val_t* v) {
     /* gc_mark(mjs, mjs_get_proto(mjs, v)); */
 }
 
+/* Mark an object */
+static void gc_mark_object(struct mjs* mjs, mjs_val_t* v) {
+    assert(mjs_is_object_based(*v));
+
+    gc_mark_object_struct(mjs, get_object_struct(*v));
+}
+
 /* Mark a string value */
 static void gc_mark_string(struct mjs* mjs, mjs_val_t* v) {
     mjs_val_t h, tmp = 0;
@@ -373,7 +423,8 @@ MJS_PRIVATE void gc_mark(struct mjs* mjs, mjs_val_t* v) {
     if(mjs_is_ffi_sig(*v)) {
         gc_mark_ffi_sig(mjs, v);
     }
-    if((*v & MJS_TAG_MASK) == MJS_TAG_STRING_O) {
+    /* Strings are only collected, and relocated, by major collections */
+    if((*v & MJS_TAG_MASK) == MJS_TAG_STRING_O && !mjs->gc_minor) {
         gc_mark_string(mjs, v);
     }
 }
@@ -441,13 +492,6 @@ void gc_compact_strings(struct mjs* mjs) {
     mjs->owned_strings.len = head;
 }
 
-MJS_PRIVATE int maybe_gc(struct mjs* mjs) {
-    if(!mjs->inhibit_gc) {
-        mjs_gc(mjs, 0);
-        return 1;
-    }
-    return 0;
-}
 
 /*
  * mark an array of `mjs_val_t` values (*not pointers* to them)
@@ -483,8 +527,50 @@ static void gc_mark_ffi_cbargs_list(struct mjs* mjs, ffi_cb_args_t* cbargs) {
     }
 }
 
-/* Perform garbage collection */
-void mjs_gc(struct mjs* mjs, int full) {
+/*
+ * Old objects which got references to young cells are traced by minor
+ * collections as roots
+ */
+static void gc_mark_remembered(struct mjs* mjs) {
+    struct mjs_object** op;
+    for(op = (struct mjs_object**)mjs->gc_remembered.buf;
+        (char*)op < mjs->gc_remembered.buf + mjs->gc_remembered.len;
+        op++) {
+        gc_mark_object_struct(mjs, *op);
+    }
+}
+
+/* Survivors of the collection become old, so nothing has to be remembered */
+static void gc_reset_remembered(struct mjs* mjs) {
+    struct mjs_object** op;
+    for(op = (struct mjs_object**)mjs->gc_remembered.buf;
+        (char*)op < mjs->gc_remembered.buf + mjs->gc_remembered.len;
+        op++) {
+        *gc_cell_flags(&mjs->object_arena, *op) &= ~GC_CELL_REMEMBERED;
+    }
+    mjs->gc_remembered.len = 0;
+}
+
+MJS_PRIVATE void gc_write_barrier(struct mjs* mjs, struct mjs_object* o) {
+    uint8_t* flags;
+
+    if(!mjs->gc_incremental) return;
+
+    /* Marked cells awaiting sweep are about to become old as well */
+    flags = gc_cell_flags(&mjs->object_arena, o);
+    if((*flags & (GC_CELL_OLD | GC_CELL_MARK)) && !(*flags & GC_CELL_REMEMBERED)) {
+        *flags |= GC_CELL_REMEMBERED;
+        mbuf_append(&mjs->gc_remembered, &o, sizeof(o));
+    }
+}
+
+/*
+ * Marks everything reachable and starts sweeping. Minor collections only
+ * trace young cells and the remembered set, leaving strings alone.
+ */
+static void gc_collect(struct mjs* mjs, int major) {
+    mjs->gc_minor = !major;
+
     gc_mark_val_array(mjs, (mjs_val_t*)&mjs->vals, sizeof(mjs->vals) / sizeof(mjs_val_t));
 
     gc_mark_mbuf_pt(mjs, &mjs->owned_values);
@@ -494,11 +580,106 @@ void mjs_gc(struct mjs* mjs, int full) {
 
     gc_mark_ffi_cbargs_list(mjs, mjs->ffi_cb_args);
 
-    gc_compact_strings(mjs);
+    if(major) {
+        gc_compact_strings(mjs);
+        mjs->gc_strings_len = mjs->owned_strings.len;
+        mjs->gc_stats.major_collections++;
+        mjs->gc_minors_since_major = 0;
+    } else {
+        gc_mark_remembered(mjs);
+        mjs->gc_stats.minor_collections++;
+        mjs->gc_minors_since_major++;
+    }
+    gc_reset_remembered(mjs);
+
+    gc_sweep_begin(&mjs->object_arena);
+    gc_sweep_begin(&mjs->property_arena);
+    gc_sweep_begin(&mjs->ffi_sig_arena);
+    mjs->gc_sweeping = 1;
+}
 
-    gc_sweep(mjs, &mjs->object_arena, 0);
-    gc_sweep(mjs, &mjs->property_arena, 0);
-    gc_sweep(mjs, &mjs->ffi_sig_arena, 0);
+/*
+ * Sweeps up to `budget` cells, returns whether all arenas are swept.
+ */
+static int gc_sweep_some(struct mjs* mjs, size_t budget) {
+    struct gc_arena* arenas[] = {
+        &mjs->object_arena,
+        &mjs->property_arena,
+        &mjs->ffi_sig_arena,
+    };
+    size_t i, swept = 0;
+
+    if(!mjs->gc_sweeping) return 1;
+
+    for(i = 0; i < sizeof(arenas) / sizeof(arenas[0]); i++) {
+        while(swept < budget) {
+            size_t n = gc_sweep_block(mjs, arenas[i]);
+            if(n == 0) break;
+            swept += n;
+        }
+        if(swept >= budget) return 0;
+    }
+
+    /* Everything is swept: schedule the next GC if we're still short on cells */
+    mjs->gc_sweeping = 0;
+    mjs->need_gc = 0;
+    for(i = 0; i < sizeof(arenas) / sizeof(arenas[0]); i++) {
+        if(gc_arena_is_gc_needed(arenas[i])) {
+            mjs->need_gc = 1;
+        }
+    }
+    return 1;
+}
+
+static void gc_sweep_finish(struct mjs* mjs) {
+    while(!gc_sweep_some(mjs, (size_t)~0)) {
+    }
+}
+
+static void gc_pause_end(struct mjs* mjs, uint32_t start) {
+    struct mjs_gc_stats* stats = &mjs->gc_stats;
+    uint32_t pause_us = (cs_hrtime() - start) / cs_hrtime_ticks_per_us();
+
+    stats->last_pause_us = pause_us;
+    if(pause_us > stats->max_pause_us) {
+        stats->max_pause_us = pause_us;
+    }
+    stats->total_pause_us += pause_us;
+}
+
+MJS_PRIVATE void gc_sweep_step(struct mjs* mjs) {
+    uint32_t start = cs_hrtime();
+    gc_sweep_some(mjs, MJS_GC_STEP_CELLS);
+    mjs->gc_stats.sweep_steps++;
+    gc_pause_end(mjs, start);
+}
+
+MJS_PRIVATE int maybe_gc(struct mjs* mjs) {
+    if(!mjs->inhibit_gc) {
+        if(mjs->gc_incremental) {
+            uint32_t start = cs_hrtime();
+            /* Live strings alone might keep the buffer full, so check for new ones */
+            int major = (gc_strings_is_gc_needed(mjs) &&
+                         mjs->owned_strings.len >= mjs->gc_strings_len + _MJS_STRING_BUF_RESERVE) ||
+                        mjs->gc_minors_since_major >= MJS_GC_MINORS_PER_MAJOR;
+            gc_sweep_finish(mjs);
+            gc_collect(mjs, major);
+            gc_pause_end(mjs, start);
+        } else {
+            mjs_gc(mjs, 0);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/* Perform garbage collection */
+void mjs_gc(struct mjs* mjs, int full) {
+    uint32_t start = cs_hrtime();
+
+    gc_sweep_finish(mjs);
+    gc_collect(mjs, 1);
+    gc_sweep_finish(mjs);
 
     if(full) {
         /*
@@ -511,6 +692,23 @@ void mjs_gc(struct mjs* mjs, int full) {
             mbuf_resize(&mjs->owned_strings, trimmed_size);
         }
     }
+
+    gc_pause_end(mjs, start);
+}
+
+void mjs_set_gc_incremental(struct mjs* mjs, int incremental) {
+    /*
+     * Stores done while the write barrier was off aren't remembered: make
+     * sure the next collection traces everything
+     */
+    if(incremental && !mjs->gc_incremental) {
+        mjs->gc_minors_since_major = MJS_GC_MINORS_PER_MAJOR;
+    }
+    mjs->gc_incremental = incremental;
+}
+
+void mjs_get_gc_stats(struct mjs* mjs, struct mjs_gc_stats* stats) {
+    *stats = mjs->gc_stats;
 }
 
 MJS_PRIVATE int gc_check_val(struct mjs* mjs, mjs_val_t v) {
@@ -524,12 +722,5 @@ MJS_PRIVATE int gc_check_val(struct mjs* mjs, mjs_val_t v) {
 }
 
 MJS_PRIVATE int gc_check_ptr(const struct gc_arena* a, const void* ptr) {
-    const struct gc_cell* p = (const struct gc_cell*)ptr;
-    struct gc_block* b;
-    for(b = a->blocks; b != NULL; b = b->next) {
-        if(p >= b->base && p < GC_CELL_OP(a, b->base, +, b->size)) {
-            return 1;
-        }
-    }
-    return 0;
+    return gc_find_block(a, ptr) != NULL;
 }
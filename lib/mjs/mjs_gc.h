@@ -42,9 +42,21 @@ MJS_PRIVATE void gc_mark(struct mjs* mjs, mjs_val_t* val);
 
 MJS_PRIVATE void gc_arena_init(struct gc_arena*, size_t, size_t, size_t);
 MJS_PRIVATE void gc_arena_destroy(struct mjs*, struct gc_arena* a);
-MJS_PRIVATE void gc_sweep(struct mjs*, struct gc_arena*, size_t);
 MJS_PRIVATE void* gc_alloc_cell(struct mjs*, struct gc_arena*);
 
+/*
+ * Does a bounded amount of pending sweeping work, called by the interpreter
+ * between instructions while `mjs->gc_sweeping` is set.
+ */
+MJS_PRIVATE void gc_sweep_step(struct mjs* mjs);
+
+/*
+ * Write barrier of the generational mode: has to be called whenever a
+ * reference to a GC cell is stored into an existing object, or a new
+ * property is linked into it.
+ */
+MJS_PRIVATE void gc_write_barrier(struct mjs* mjs, struct mjs_object* o);
+
 MJS_PRIVATE uint64_t gc_string_mjs_val_to_offset(mjs_val_t v);
 
 /* return 0 if v is an object/function with a bad pointer */
@@ -18,6 +18,35 @@ extern "C" {
  */
 void mjs_gc(struct mjs* mjs, int full);
 
+/*
+ * Enables or disables incremental generational collection. By default it's 0.
+ *
+ * When enabled, collections triggered by the interpreter are minor ones: only
+ * cells allocated since the previous collection are traced and swept, while
+ * older cells are kept until the next major collection (every
+ * `MJS_GC_MINORS_PER_MAJOR` minors, or when the string heap is full).
+ * Sweeping is done in bounded steps of `MJS_GC_STEP_CELLS` cells between
+ * instructions, so the pause is mostly the mark phase.
+ *
+ * `mjs_gc()` is always a complete stop-the-world major collection.
+ */
+void mjs_set_gc_incremental(struct mjs* mjs, int incremental);
+
+struct mjs_gc_stats {
+    unsigned long minor_collections;
+    unsigned long major_collections;
+    unsigned long sweep_steps; /* Incremental sweep steps */
+    uint32_t last_pause_us;
+    uint32_t max_pause_us;
+    uint64_t total_pause_us;
+};
+
+/*
+ * Returns GC statistics collected since the instance was created. Every
+ * collection start, sweep step and `mjs_gc()` call counts as one pause.
+ */
+void mjs_get_gc_stats(struct mjs* mjs, struct mjs_gc_stats* stats);
+
 #if defined(__cplusplus)
 }
 #endif /* __cplusplus */
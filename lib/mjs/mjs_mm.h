@@ -16,9 +16,15 @@ struct mjs;
 
 typedef void (*gc_cell_destructor_t)(struct mjs* mjs, void*);
 
+/* Per-cell GC flags, kept aside so that the mutator can't clobber them */
+#define GC_CELL_MARK 0x01 /* reachable, the cell awaits sweeping */
+#define GC_CELL_OLD 0x02 /* survived a collection */
+#define GC_CELL_REMEMBERED 0x04 /* old object in the remembered set */
+
 struct gc_block {
     struct gc_block* next;
     struct gc_cell* base;
+    uint8_t* flags; /* GC_CELL_* of each cell, allocated right after cells */
     size_t size;
 };
 
@@ -27,6 +33,7 @@ struct gc_arena {
     size_t size_increment;
     struct gc_cell* free; /* head of free list */
     size_t cell_size;
+    struct gc_block** sweep_pos; /* next block to sweep, NULL if swept */
 
 #if MJS_MEMORY_STATS
     unsigned long allocations; /* cumulative counter of allocations */
@@ -38,6 +38,7 @@ mjs_val_t mjs_mk_object(struct mjs* mjs) {
     }
     (void)mjs;
     o->properties = NULL;
+    o->index = NULL;
     return mjs_object_to_value(o);
 }
 
@@ -50,10 +51,139 @@ int mjs_is_object_based(mjs_val_t v) {
            ((v & MJS_TAG_MASK) == MJS_TAG_ARRAY_BUF_VIEW);
 }
 
+/*
+ * Property index: open addressing hash table with linear probing over the
+ * properties of a single object. The linked list stays the primary storage
+ * (GC, iteration and JSON use it), the index only speeds up lookups.
+ */
+struct mjs_property_index_slot {
+    uint32_t hash;
+    struct mjs_property* prop;
+};
+
+struct mjs_property_index {
+    size_t count; /* Number of indexed properties */
+    size_t mask; /* Number of slots - 1 */
+    unsigned long array_length; /* Same as `mjs_array_length()` would return */
+    struct mjs_property_index_slot slots[];
+};
+
+/* FNV-1a */
+static uint32_t mjs_property_name_hash(const char* name, size_t len) {
+    uint32_t hash = 2166136261U;
+    size_t i;
+    for(i = 0; i < len; i++) {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+static void mjs_property_index_track_array_length(
+    struct mjs* mjs,
+    struct mjs_property_index* index,
+    struct mjs_property* p) {
+    int ok = 0;
+    unsigned long n = 0;
+    str_to_ulong(mjs, p->name, &ok, &n);
+    if(ok && n >= index->array_length && n < 0xffffffff) {
+        index->array_length = n + 1;
+    }
+}
+
+static void mjs_property_index_insert(
+    struct mjs* mjs,
+    struct mjs_property_index* index,
+    struct mjs_property* p,
+    uint32_t hash) {
+    size_t i = hash & index->mask;
+    while(index->slots[i].prop != NULL) {
+        i = (i + 1) & index->mask;
+    }
+    index->slots[i].hash = hash;
+    index->slots[i].prop = p;
+    index->count++;
+    mjs_property_index_track_array_length(mjs, index, p);
+}
+
+static void mjs_property_index_free(struct mjs_object* o) {
+    free(o->index);
+    o->index = NULL;
+}
+
+/*
+ * (Re)builds the index for all properties of the object, keeping load factor
+ * at or below 1/2. On allocation failure the object just stays unindexed.
+ */
+static void mjs_property_index_build(struct mjs* mjs, struct mjs_object* o) {
+    struct mjs_property* p;
+    size_t count = 0, slots_cnt = MJS_PROPERTY_INDEX_THRESHOLD * 2;
+
+    mjs_property_index_free(o);
+
+    for(p = o->properties; p != NULL; p = p->next) count++;
+    while(slots_cnt < count * 2) slots_cnt *= 2;
+
+    o->index = calloc(
+        1, sizeof(struct mjs_property_index) + slots_cnt * sizeof(struct mjs_property_index_slot));
+    if(o->index == NULL) return;
+    o->index->mask = slots_cnt - 1;
+
+    for(p = o->properties; p != NULL; p = p->next) {
+        size_t n;
+        const char* s = mjs_get_string(mjs, &p->name, &n);
+        mjs_property_index_insert(mjs, o->index, p, mjs_property_name_hash(s, n));
+    }
+}
+
+static void mjs_property_index_add(struct mjs* mjs, struct mjs_object* o, struct mjs_property* p) {
+    if((o->index->count + 1) * 2 > o->index->mask + 1) {
+        /* The property is already linked, so the rebuild picks it up */
+        mjs_property_index_build(mjs, o);
+    } else {
+        size_t n;
+        const char* s = mjs_get_string(mjs, &p->name, &n);
+        mjs_property_index_insert(mjs, o->index, p, mjs_property_name_hash(s, n));
+    }
+}
+
+static struct mjs_property* mjs_property_index_find(
+    struct mjs* mjs,
+    struct mjs_property_index* index,
+    const char* name,
+    size_t len) {
+    uint32_t hash = mjs_property_name_hash(name, len);
+    size_t i;
+
+    for(i = hash & index->mask; index->slots[i].prop != NULL; i = (i + 1) & index->mask) {
+        if(index->slots[i].hash == hash) {
+            struct mjs_property* p = index->slots[i].prop;
+            size_t n;
+            const char* s = mjs_get_string(mjs, &p->name, &n);
+            if(n == len && memcmp(s, name, len) == 0) return p;
+        }
+    }
+
+    return NULL;
+}
+
+MJS_PRIVATE int mjs_object_get_indexed_array_length(struct mjs_object* o, unsigned long* len) {
+    if(o == NULL || o->index == NULL) return 0;
+    *len = o->index->array_length;
+    return 1;
+}
+
+MJS_PRIVATE void mjs_object_destructor(struct mjs* mjs, void* cell) {
+    struct mjs_object* o = (struct mjs_object*)cell;
+    (void)mjs;
+    mjs_property_index_free(o);
+}
+
 MJS_PRIVATE struct mjs_property*
     mjs_get_own_property(struct mjs* mjs, mjs_val_t obj, const char* name, size_t len) {
     struct mjs_property* p;
     struct mjs_object* o;
+    size_t visited = 0;
 
     if(!mjs_is_object_based(obj)) {
         return NULL;
@@ -61,19 +191,27 @@ MJS_PRIVATE struct mjs_property*
 
     o = get_object_struct(obj);
 
+    if(o->index != NULL) {
+        if(len == (size_t)~0) len = strlen(name);
+        return mjs_property_index_find(mjs, o->index, name, len);
+    }
+
     if(len <= 5) {
         mjs_val_t ss = mjs_mk_string(mjs, name, len, 1);
-        for(p = o->properties; p != NULL; p = p->next) {
-            if(p->name == ss) return p;
+        for(p = o->properties; p != NULL; p = p->next, visited++) {
+            if(p->name == ss) break;
         }
     } else {
-        for(p = o->properties; p != NULL; p = p->next) {
-            if(mjs_strcmp(mjs, &p->name, name, len) == 0) return p;
+        for(p = o->properties; p != NULL; p = p->next, visited++) {
+            if(mjs_strcmp(mjs, &p->name, name, len) == 0) break;
         }
-        return p;
     }
 
-    return NULL;
+    if(visited >= MJS_PROPERTY_INDEX_THRESHOLD) {
+        mjs_property_index_build(mjs, o);
+    }
+
+    return p;
 }
 
 MJS_PRIVATE struct mjs_property*
@@ -90,6 +228,43 @@ MJS_PRIVATE struct mjs_property*
     return p;
 }
 
+MJS_PRIVATE struct mjs_property* mjs_get_own_property_cached(
+    struct mjs* mjs,
+    const uint8_t* site,
+    mjs_val_t obj,
+    mjs_val_t key) {
+    struct mjs_inline_cache_entry* entry;
+    struct mjs_object* o;
+    struct mjs_property* p;
+
+    if(!mjs_is_object_based(obj) || !mjs_is_string(key)) {
+        return mjs_get_own_property_v(mjs, obj, key);
+    }
+
+    o = get_object_struct(obj);
+    entry = &mjs->inline_cache
+                 [((uintptr_t)site ^ ((uintptr_t)site >> 5)) & (MJS_INLINE_CACHE_SIZE - 1)];
+
+    /* Short names are inlined into the value, so they can be compared directly */
+    if(entry->site == site && entry->obj == o &&
+       (entry->prop->name == key || s_cmp(mjs, entry->prop->name, key) == 0)) {
+        return entry->prop;
+    }
+
+    p = mjs_get_own_property_v(mjs, obj, key);
+    if(p != NULL) {
+        entry->site = site;
+        entry->obj = o;
+        entry->prop = p;
+    }
+
+    return p;
+}
+
+MJS_PRIVATE void mjs_inline_cache_reset(struct mjs* mjs) {
+    memset(mjs->inline_cache, 0, sizeof(mjs->inline_cache));
+}
+
 MJS_PRIVATE struct mjs_property*
     mjs_mk_property(struct mjs* mjs, mjs_val_t name, mjs_val_t value) {
     struct mjs_property* p = new_property(mjs);
@@ -199,6 +374,14 @@ MJS_PRIVATE mjs_err_t mjs_set_internal(
         o = get_object_struct(obj);
         p->next = o->properties;
         o->properties = p;
+
+        if(o->index != NULL) {
+            mjs_property_index_add(mjs, o, p);
+        }
+
+        gc_write_barrier(mjs, o);
+    } else if(mjs_is_object_based(val) || mjs_is_ffi_sig(val)) {
+        gc_write_barrier(mjs, get_object_struct(obj));
     }
 
     p->value = val;
@@ -237,6 +420,9 @@ int mjs_del(struct mjs* mjs, mjs_val_t obj, const char* name, size_t len) {
             } else {
                 get_object_struct(obj)->properties = prop->next;
             }
+            /* Deletions are rare: drop the index, it's rebuilt on demand */
+            mjs_property_index_free(get_object_struct(obj));
+            mjs_inline_cache_reset(mjs);
             mjs_destroy_property(&prop);
             return 0;
         }
@@ -21,10 +21,22 @@ struct mjs_property {
     mjs_val_t value; /* Property value */
 };
 
+struct mjs_property_index;
+
 struct mjs_object {
     struct mjs_property* properties;
+    /* Hash index of properties, built once the list gets long enough */
+    struct mjs_property_index* index;
 };
 
+/*
+ * Objects whose property list lookups walk at least that many nodes get a
+ * hashed property index
+ */
+#ifndef MJS_PROPERTY_INDEX_THRESHOLD
+#define MJS_PROPERTY_INDEX_THRESHOLD 8
+#endif
+
 MJS_PRIVATE struct mjs_object* get_object_struct(mjs_val_t v);
 MJS_PRIVATE struct mjs_property*
     mjs_get_own_property(struct mjs* mjs, mjs_val_t obj, const char* name, size_t len);
@@ -32,6 +44,33 @@ MJS_PRIVATE struct mjs_property*
 MJS_PRIVATE struct mjs_property*
     mjs_get_own_property_v(struct mjs* mjs, mjs_val_t obj, mjs_val_t key);
 
+/*
+ * Same as `mjs_get_own_property_v()` for string keys, but first consults
+ * the inline cache entry of the instruction at `site`.
+ */
+MJS_PRIVATE struct mjs_property* mjs_get_own_property_cached(
+    struct mjs* mjs,
+    const uint8_t* site,
+    mjs_val_t obj,
+    mjs_val_t key);
+
+/*
+ * Drops all inline cache entries; must be called whenever properties might
+ * be unlinked or freed.
+ */
+MJS_PRIVATE void mjs_inline_cache_reset(struct mjs* mjs);
+
+/*
+ * If the object has a property index, writes the array length tracked by it
+ * to `len` and returns 1; otherwise returns 0.
+ */
+MJS_PRIVATE int mjs_object_get_indexed_array_length(struct mjs_object* o, unsigned long* len);
+
+/*
+ * Object arena destructor: frees the property index
+ */
+MJS_PRIVATE void mjs_object_destructor(struct mjs* mjs, void* cell);
+
 /*
  * A worker function for `mjs_set()` and `mjs_set_v()`: it takes name as both
  * ptr+len and mjs_val_t. If `name` pointer is not NULL, it takes precedence
@@ -7,16 +7,33 @@
 #define ISO14443_4_BLOCK_PCB_R (5U << 5)
 #define ISO14443_4_BLOCK_PCB_S (3U << 6)
 
+#define ISO14443_4_BLOCK_PCB_I_MASK (3U << 6)
+#define ISO14443_4_BLOCK_PCB_R_MASK (7U << 5)
+#define ISO14443_4_BLOCK_PCB_S_MASK (3U << 6)
+
+#define ISO14443_4_BLOCK_PCB_BN (1U << 0)
+#define ISO14443_4_BLOCK_PCB_NAD (1U << 2)
+#define ISO14443_4_BLOCK_PCB_CID (1U << 3)
+#define ISO14443_4_BLOCK_PCB_I_RFU (1U << 5)
+#define ISO14443_4_BLOCK_PCB_I_CHAINING (1U << 4)
+#define ISO14443_4_BLOCK_PCB_R_NAK (1U << 4)
+#define ISO14443_4_BLOCK_PCB_S_WTX (3U << 4)
+
+#define ISO14443_4_BLOCK_OVERHEAD (3U) // PCB and CRC
+#define ISO14443_4_FSC_MIN (16U)
+
+#define ISO14443_4_WTXM_MASK (0x3FU)
+#define ISO14443_4_WTXM_MAX (59U)
+
 struct Iso14443_4Layer {
-    uint8_t pcb;
-    uint8_t pcb_prev;
+    uint8_t block_number;
+    uint16_t fsc;
+    uint8_t wtxm;
+    uint8_t wtx_count;
+    const BitBuffer* tx_data;
+    size_t tx_offset;
 };
 
-static inline void iso14443_4_layer_update_pcb(Iso14443_4Layer* instance) {
-    instance->pcb_prev = instance->pcb;
-    instance->pcb ^= (uint8_t)0x01;
-}
-
 Iso14443_4Layer* iso14443_4_layer_alloc() {
     Iso14443_4Layer* instance = malloc(sizeof(Iso14443_4Layer));
 
@@ -31,34 +48,182 @@ void iso14443_4_layer_free(Iso14443_4Layer* instance) {
 
 void iso14443_4_layer_reset(Iso14443_4Layer* instance) {
     furi_assert(instance);
-    instance->pcb = ISO14443_4_BLOCK_PCB_I | ISO14443_4_BLOCK_PCB;
+    instance->block_number = 0;
+    instance->fsc = ISO14443_4_LAYER_FSC_DEFAULT;
+    instance->wtxm = 1;
+    instance->wtx_count = 0;
+    instance->tx_data = NULL;
+    instance->tx_offset = 0;
 }
 
-void iso14443_4_layer_encode_block(
+void iso14443_4_layer_set_fsc(Iso14443_4Layer* instance, uint16_t fsc) {
+    furi_assert(instance);
+
+    // RFU frame size codes are interpreted as the largest defined one
+    if(fsc == 0) {
+        fsc = ISO14443_4_LAYER_FSC_MAX;
+    }
+    instance->fsc = CLAMP(fsc, ISO14443_4_LAYER_FSC_MAX, ISO14443_4_FSC_MIN);
+}
+
+static inline bool iso14443_4_layer_is_tx_chaining(const Iso14443_4Layer* instance) {
+    return instance->tx_data &&
+           (instance->tx_offset < bit_buffer_get_size_bytes(instance->tx_data));
+}
+
+static void iso14443_4_layer_encode_i_block(Iso14443_4Layer* instance, BitBuffer* block_data) {
+    const size_t tx_size = bit_buffer_get_size_bytes(instance->tx_data);
+    const size_t inf_size_max = instance->fsc - ISO14443_4_BLOCK_OVERHEAD;
+    const size_t inf_size = MIN(tx_size - instance->tx_offset, inf_size_max);
+
+    uint8_t pcb = ISO14443_4_BLOCK_PCB_I | ISO14443_4_BLOCK_PCB | instance->block_number;
+    if(instance->tx_offset + inf_size < tx_size) {
+        pcb |= ISO14443_4_BLOCK_PCB_I_CHAINING;
+    }
+
+    bit_buffer_reset(block_data);
+    bit_buffer_append_byte(block_data, pcb);
+    bit_buffer_append_bytes(
+        block_data, bit_buffer_get_data(instance->tx_data) + instance->tx_offset, inf_size);
+
+    instance->tx_offset += inf_size;
+}
+
+void iso14443_4_layer_encode_command(
     Iso14443_4Layer* instance,
     const BitBuffer* input_data,
     BitBuffer* block_data) {
     furi_assert(instance);
+    furi_assert(input_data);
+    furi_assert(block_data);
+
+    instance->tx_data = input_data;
+    instance->tx_offset = 0;
+    instance->wtxm = 1;
+    instance->wtx_count = 0;
+
+    iso14443_4_layer_encode_i_block(instance, block_data);
+}
+
+static Iso14443_4LayerResult iso14443_4_layer_decode_s_block(
+    Iso14443_4Layer* instance,
+    const BitBuffer* rx_block,
+    BitBuffer* block_data) {
+    const uint8_t pcb = bit_buffer_get_byte(rx_block, 0);
+
+    // Only waiting time extension requests are expected from the card
+    if((pcb & ISO14443_4_BLOCK_PCB_S_WTX) != ISO14443_4_BLOCK_PCB_S_WTX) {
+        return Iso14443_4LayerResultError;
+    }
+    if(bit_buffer_get_size_bytes(rx_block) != 2) return Iso14443_4LayerResultError;
+
+    const uint8_t wtxm = bit_buffer_get_byte(rx_block, 1) & ISO14443_4_WTXM_MASK;
+    if((wtxm == 0) || (wtxm > ISO14443_4_WTXM_MAX)) return Iso14443_4LayerResultError;
 
-    bit_buffer_append_byte(block_data, instance->pcb);
-    bit_buffer_append(block_data, input_data);
+    // A card that keeps asking for more time would hold the poller forever
+    if(instance->wtx_count >= ISO14443_4_LAYER_WTX_MAX) return Iso14443_4LayerResultTimeout;
+    instance->wtx_count++;
+    instance->wtxm = wtxm;
 
-    iso14443_4_layer_update_pcb(instance);
+    bit_buffer_reset(block_data);
+    bit_buffer_append_byte(
+        block_data, ISO14443_4_BLOCK_PCB_S | ISO14443_4_BLOCK_PCB_S_WTX | ISO14443_4_BLOCK_PCB);
+    bit_buffer_append_byte(block_data, wtxm);
+
+    return Iso14443_4LayerResultSend;
 }
 
-bool iso14443_4_layer_decode_block(
+static Iso14443_4LayerResult iso14443_4_layer_decode_r_block(
+    Iso14443_4Layer* instance,
+    const BitBuffer* rx_block,
+    BitBuffer* block_data) {
+    const uint8_t pcb = bit_buffer_get_byte(rx_block, 0);
+
+    // Card acknowledges a chained command block
+    if(!iso14443_4_layer_is_tx_chaining(instance)) return Iso14443_4LayerResultError;
+    if(pcb & ISO14443_4_BLOCK_PCB_R_NAK) return Iso14443_4LayerResultError;
+    if((pcb & ISO14443_4_BLOCK_PCB_BN) != instance->block_number) {
+        return Iso14443_4LayerResultError;
+    }
+
+    instance->block_number ^= ISO14443_4_BLOCK_PCB_BN;
+    iso14443_4_layer_encode_i_block(instance, block_data);
+
+    return Iso14443_4LayerResultSend;
+}
+
+static Iso14443_4LayerResult iso14443_4_layer_decode_i_block(
     Iso14443_4Layer* instance,
     BitBuffer* output_data,
-    const BitBuffer* block_data) {
+    const BitBuffer* rx_block,
+    BitBuffer* block_data) {
+    const uint8_t pcb = bit_buffer_get_byte(rx_block, 0);
+
+    if(iso14443_4_layer_is_tx_chaining(instance)) return Iso14443_4LayerResultError;
+    if((pcb & ISO14443_4_BLOCK_PCB_BN) != instance->block_number) {
+        return Iso14443_4LayerResultError;
+    }
+
+    const size_t inf_size = bit_buffer_get_size_bytes(rx_block) - 1;
+    const size_t output_size = bit_buffer_get_size_bytes(output_data);
+    if(output_size + inf_size > bit_buffer_get_capacity_bytes(output_data)) {
+        return Iso14443_4LayerResultError;
+    }
+
+    bit_buffer_append_right(output_data, rx_block, 1);
+    instance->block_number ^= ISO14443_4_BLOCK_PCB_BN;
+
+    if((pcb & ISO14443_4_BLOCK_PCB_I_CHAINING) == 0) {
+        instance->tx_data = NULL;
+        return Iso14443_4LayerResultSuccess;
+    }
+
+    // Request the next part of the response
+    bit_buffer_reset(block_data);
+    bit_buffer_append_byte(
+        block_data, ISO14443_4_BLOCK_PCB_R | ISO14443_4_BLOCK_PCB | instance->block_number);
+
+    return Iso14443_4LayerResultSend;
+}
+
+Iso14443_4LayerResult iso14443_4_layer_decode_response(
+    Iso14443_4Layer* instance,
+    BitBuffer* output_data,
+    const BitBuffer* rx_block,
+    BitBuffer* block_data) {
     furi_assert(instance);
+    furi_assert(output_data);
+    furi_assert(rx_block);
+    furi_assert(block_data);
 
-    bool ret = false;
+    Iso14443_4LayerResult result = Iso14443_4LayerResultError;
+    instance->wtxm = 1;
 
     do {
-        if(!bit_buffer_starts_with_byte(block_data, instance->pcb_prev)) break;
-        bit_buffer_copy_right(output_data, block_data, 1);
-        ret = true;
+        if(bit_buffer_get_size_bytes(rx_block) == 0) break;
+
+        const uint8_t pcb = bit_buffer_get_byte(rx_block, 0);
+        if((pcb & ISO14443_4_BLOCK_PCB) == 0) break;
+
+        // CID and NAD are never used by the pollers
+        if((pcb & ISO14443_4_BLOCK_PCB_I_MASK) == ISO14443_4_BLOCK_PCB_I) {
+            if(pcb & (ISO14443_4_BLOCK_PCB_I_RFU | ISO14443_4_BLOCK_PCB_CID |
+                      ISO14443_4_BLOCK_PCB_NAD))
+                break;
+            result = iso14443_4_layer_decode_i_block(instance, output_data, rx_block, block_data);
+        } else if((pcb & ISO14443_4_BLOCK_PCB_R_MASK) == ISO14443_4_BLOCK_PCB_R) {
+            if(pcb & ISO14443_4_BLOCK_PCB_CID) break;
+            result = iso14443_4_layer_decode_r_block(instance, rx_block, block_data);
+        } else if((pcb & ISO14443_4_BLOCK_PCB_S_MASK) == ISO14443_4_BLOCK_PCB_S) {
+            if(pcb & ISO14443_4_BLOCK_PCB_CID) break;
+            result = iso14443_4_layer_decode_s_block(instance, rx_block, block_data);
+        }
     } while(false);
 
-    return ret;
+    return result;
+}
+
+uint8_t iso14443_4_layer_get_wtxm(const Iso14443_4Layer* instance) {
+    furi_assert(instance);
+    return instance->wtxm;
 }
@@ -6,23 +6,77 @@
 extern "C" {
 #endif
 
+/** Frame size assumed until the card reports its own (FSCI = 2) */
+#define ISO14443_4_LAYER_FSC_DEFAULT (32U)
+/** Largest frame supported by the pollers */
+#define ISO14443_4_LAYER_FSC_MAX (256U)
+/** Waiting time extensions granted to the card per command */
+#define ISO14443_4_LAYER_WTX_MAX (32U)
+
 typedef struct Iso14443_4Layer Iso14443_4Layer;
 
+typedef enum {
+    Iso14443_4LayerResultSuccess, /**< Response is complete. */
+    Iso14443_4LayerResultSend, /**< Next block is ready and must be exchanged. */
+    Iso14443_4LayerResultError, /**< Protocol error. */
+    Iso14443_4LayerResultTimeout, /**< Card requested too many waiting time extensions. */
+} Iso14443_4LayerResult;
+
 Iso14443_4Layer* iso14443_4_layer_alloc();
 
 void iso14443_4_layer_free(Iso14443_4Layer* instance);
 
 void iso14443_4_layer_reset(Iso14443_4Layer* instance);
 
-void iso14443_4_layer_encode_block(
+/** Set maximum frame size accepted by the card
+ *
+ * @param      instance  Iso14443_4Layer instance
+ * @param      fsc       frame size including PCB and CRC, as reported in ATS or ATQB,
+ *                       0 for RFU codes
+ */
+void iso14443_4_layer_set_fsc(Iso14443_4Layer* instance, uint16_t fsc);
+
+/** Start a new command and encode its first block
+ *
+ * Commands that do not fit in a single frame are chained, the remaining blocks are
+ * produced by iso14443_4_layer_decode_response() as the card acknowledges them.
+ * input_data must stay valid until the response is complete.
+ *
+ * @param      instance    Iso14443_4Layer instance
+ * @param      input_data  command data
+ * @param      block_data  first block to be sent
+ */
+void iso14443_4_layer_encode_command(
     Iso14443_4Layer* instance,
     const BitBuffer* input_data,
     BitBuffer* block_data);
 
-bool iso14443_4_layer_decode_block(
+/** Decode a block received from the card
+ *
+ * Chained response data is appended to output_data, which must be empty when
+ * the command is started. Chaining acknowledgements and waiting time extension
+ * responses are written to block_data.
+ *
+ * @param      instance     Iso14443_4Layer instance
+ * @param      output_data  response data
+ * @param      rx_block     received block
+ * @param      block_data   next block to be sent if Iso14443_4LayerResultSend is returned
+ *
+ * @return     Iso14443_4LayerResult
+ */
+Iso14443_4LayerResult iso14443_4_layer_decode_response(
     Iso14443_4Layer* instance,
     BitBuffer* output_data,
-    const BitBuffer* block_data);
+    const BitBuffer* rx_block,
+    BitBuffer* block_data);
+
+/** Get frame waiting time multiplier for the next exchange
+ *
+ * @param      instance  Iso14443_4Layer instance
+ *
+ * @return     WTXM requested by the card, 1 if no extension was requested
+ */
+uint8_t iso14443_4_layer_get_wtxm(const Iso14443_4Layer* instance);
 
 #ifdef __cplusplus
 }
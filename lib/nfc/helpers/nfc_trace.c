@@ -0,0 +1,354 @@
+#include "nfc_trace.h"
+
+#include <furi.h>
+#include <furi_hal.h>
+
+#define NFC_TRACE_FILE_MAGIC (0x5443464EU) // "NFCT"
+#define NFC_TRACE_FILE_VERSION (1U)
+
+#define NFC_TRACE_DATA_SIZE_MAX (256U)
+#define NFC_TRACE_PARITY_SIZE_MAX (NFC_TRACE_DATA_SIZE_MAX / 8U)
+
+// Cycle counter wraps in about a minute, longer gaps are measured in ticks
+#define NFC_TRACE_CYCLES_GAP_MS_MAX (30000U)
+
+typedef struct FURI_PACKED {
+    uint32_t timestamp_us;
+    uint16_t size_bits;
+    uint8_t direction;
+    uint8_t flags;
+} NfcTraceFrameHeader;
+
+typedef struct FURI_PACKED {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t count;
+} NfcTraceFileHeader;
+
+struct NfcTrace {
+    uint8_t* buffer;
+    size_t size;
+    size_t head;
+    size_t used;
+    size_t count;
+    size_t lost;
+
+    size_t read_offset;
+    size_t read_count;
+
+    uint32_t time_us;
+    uint32_t tick_last;
+    uint32_t cycles_last;
+};
+
+static inline size_t nfc_trace_get_data_size(size_t size_bits) {
+    return (size_bits + 7) / 8;
+}
+
+static inline size_t nfc_trace_get_frame_size(const NfcTraceFrameHeader* header) {
+    const size_t data_size = nfc_trace_get_data_size(header->size_bits);
+    const size_t parity_size =
+        (header->flags & NfcTraceFlagParity) ? nfc_trace_get_data_size(data_size) : 0;
+
+    return sizeof(NfcTraceFrameHeader) + data_size + parity_size;
+}
+
+static void nfc_trace_copy_in(NfcTrace* instance, size_t offset, const void* src, size_t size) {
+    const size_t pos = (instance->head + offset) % instance->size;
+    const size_t part = MIN(size, instance->size - pos);
+
+    memcpy(&instance->buffer[pos], src, part);
+    memcpy(instance->buffer, (const uint8_t*)src + part, size - part);
+}
+
+static void nfc_trace_copy_out(const NfcTrace* instance, size_t offset, void* dst, size_t size) {
+    const size_t pos = (instance->head + offset) % instance->size;
+    const size_t part = MIN(size, instance->size - pos);
+
+    memcpy(dst, &instance->buffer[pos], part);
+    memcpy((uint8_t*)dst + part, instance->buffer, size - part);
+}
+
+static void nfc_trace_drop_oldest(NfcTrace* instance) {
+    NfcTraceFrameHeader header;
+    nfc_trace_copy_out(instance, 0, &header, sizeof(header));
+
+    const size_t frame_size = nfc_trace_get_frame_size(&header);
+    instance->head = (instance->head + frame_size) % instance->size;
+    instance->used -= frame_size;
+    instance->count--;
+    instance->lost++;
+
+    // Read position is relative to the oldest frame
+    if(instance->read_count > 0) {
+        instance->read_offset -= frame_size;
+        instance->read_count--;
+    }
+}
+
+static uint32_t nfc_trace_get_timestamp(NfcTrace* instance) {
+    const uint32_t tick = furi_get_tick();
+    const uint32_t cycles = DWT->CYCCNT;
+    const uint32_t ticks_passed = tick - instance->tick_last;
+
+    if(ticks_passed > NFC_TRACE_CYCLES_GAP_MS_MAX) {
+        instance->time_us += ticks_passed * 1000U;
+        instance->cycles_last = cycles;
+    } else {
+        // Remainder is kept so that the time does not drift
+        const uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+        const uint32_t us_passed = (cycles - instance->cycles_last) / cycles_per_us;
+        instance->time_us += us_passed;
+        instance->cycles_last += us_passed * cycles_per_us;
+    }
+    instance->tick_last = tick;
+
+    return instance->time_us;
+}
+
+static void nfc_trace_push(
+    NfcTrace* instance,
+    const NfcTraceFrameHeader* header,
+    const uint8_t* data,
+    const uint8_t* parity) {
+    const size_t frame_size = nfc_trace_get_frame_size(header);
+    if(frame_size > instance->size) {
+        instance->lost++;
+        return;
+    }
+
+    while(instance->size - instance->used < frame_size) {
+        nfc_trace_drop_oldest(instance);
+    }
+
+    const size_t data_size = nfc_trace_get_data_size(header->size_bits);
+    size_t offset = instance->used;
+
+    nfc_trace_copy_in(instance, offset, header, sizeof(NfcTraceFrameHeader));
+    offset += sizeof(NfcTraceFrameHeader);
+    if(data_size > 0) {
+        nfc_trace_copy_in(instance, offset, data, data_size);
+        offset += data_size;
+    }
+    if(header->flags & NfcTraceFlagParity) {
+        nfc_trace_copy_in(instance, offset, parity, nfc_trace_get_data_size(data_size));
+    }
+
+    instance->used += frame_size;
+    instance->count++;
+}
+
+NfcTrace* nfc_trace_alloc(size_t size) {
+    furi_check(size > sizeof(NfcTraceFrameHeader));
+
+    NfcTrace* instance = malloc(sizeof(NfcTrace));
+    instance->buffer = malloc(size);
+    instance->size = size;
+
+    nfc_trace_reset(instance);
+
+    return instance;
+}
+
+void nfc_trace_free(NfcTrace* instance) {
+    furi_check(instance);
+
+    free(instance->buffer);
+    free(instance);
+}
+
+void nfc_trace_reset(NfcTrace* instance) {
+    furi_check(instance);
+
+    instance->head = 0;
+    instance->used = 0;
+    instance->count = 0;
+    instance->lost = 0;
+    instance->read_offset = 0;
+    instance->read_count = 0;
+
+    instance->time_us = 0;
+    instance->tick_last = furi_get_tick();
+    instance->cycles_last = DWT->CYCCNT;
+}
+
+void nfc_trace_add(
+    NfcTrace* instance,
+    NfcTraceDirection direction,
+    uint8_t flags,
+    const BitBuffer* data) {
+    furi_check(instance);
+    furi_check(data || (flags & NfcTraceFlagTimeout));
+
+    const size_t size_bits = data ? bit_buffer_get_size(data) : 0;
+
+    NfcTraceFrameHeader header = {
+        .timestamp_us = nfc_trace_get_timestamp(instance),
+        .size_bits = MIN(size_bits, NFC_TRACE_DATA_SIZE_MAX * 8U),
+        .direction = direction,
+        .flags = flags,
+    };
+
+    if(data) {
+        nfc_trace_push(instance, &header, bit_buffer_get_data(data), bit_buffer_get_parity(data));
+    } else {
+        header.flags &= ~NfcTraceFlagParity;
+        nfc_trace_push(instance, &header, NULL, NULL);
+    }
+}
+
+void nfc_trace_add_bytes(
+    NfcTrace* instance,
+    NfcTraceDirection direction,
+    uint8_t flags,
+    const uint8_t* data,
+    size_t size_bits) {
+    furi_check(instance);
+    furi_check(data);
+    furi_check((flags & NfcTraceFlagParity) == 0);
+
+    const NfcTraceFrameHeader header = {
+        .timestamp_us = nfc_trace_get_timestamp(instance),
+        .size_bits = MIN(size_bits, NFC_TRACE_DATA_SIZE_MAX * 8U),
+        .direction = direction,
+        .flags = flags,
+    };
+
+    nfc_trace_push(instance, &header, data, NULL);
+}
+
+size_t nfc_trace_get_count(const NfcTrace* instance) {
+    furi_check(instance);
+    return instance->count;
+}
+
+size_t nfc_trace_get_lost_count(const NfcTrace* instance) {
+    furi_check(instance);
+    return instance->lost;
+}
+
+void nfc_trace_rewind(NfcTrace* instance) {
+    furi_check(instance);
+
+    instance->read_offset = 0;
+    instance->read_count = 0;
+}
+
+bool nfc_trace_read(NfcTrace* instance, NfcTraceRecord* record, BitBuffer* data) {
+    furi_check(instance);
+    furi_check(record);
+
+    if(instance->read_count >= instance->count) return false;
+
+    NfcTraceFrameHeader header;
+    nfc_trace_copy_out(instance, instance->read_offset, &header, sizeof(header));
+
+    record->timestamp_us = header.timestamp_us;
+    record->direction = header.direction;
+    record->flags = header.flags;
+
+    if(data) {
+        uint8_t frame_data[NFC_TRACE_DATA_SIZE_MAX];
+        uint8_t frame_parity[NFC_TRACE_PARITY_SIZE_MAX];
+        const size_t data_size = nfc_trace_get_data_size(header.size_bits);
+        const size_t data_offset = instance->read_offset + sizeof(NfcTraceFrameHeader);
+
+        nfc_trace_copy_out(instance, data_offset, frame_data, data_size);
+        bit_buffer_copy_bits(data, frame_data, header.size_bits);
+
+        if(header.flags & NfcTraceFlagParity) {
+            nfc_trace_copy_out(
+                instance,
+                data_offset + data_size,
+                frame_parity,
+                nfc_trace_get_data_size(data_size));
+            for(size_t i = 0; i < header.size_bits / 8; i++) {
+                bit_buffer_set_byte_with_parity(
+                    data, i, frame_data[i], FURI_BIT(frame_parity[i / 8], i % 8));
+            }
+        }
+    }
+
+    instance->read_offset += nfc_trace_get_frame_size(&header);
+    instance->read_count++;
+
+    return true;
+}
+
+bool nfc_trace_save(const NfcTrace* instance, Stream* stream) {
+    furi_check(instance);
+    furi_check(stream);
+
+    const NfcTraceFileHeader file_header = {
+        .magic = NFC_TRACE_FILE_MAGIC,
+        .version = NFC_TRACE_FILE_VERSION,
+        .count = instance->count,
+    };
+
+    bool saved = false;
+
+    do {
+        if(stream_write(stream, (const uint8_t*)&file_header, sizeof(file_header)) !=
+           sizeof(file_header))
+            break;
+
+        // Frames are stored oldest first, in at most two parts of the ring
+        const size_t part = MIN(instance->used, instance->size - instance->head);
+        if(stream_write(stream, &instance->buffer[instance->head], part) != part) break;
+        if(stream_write(stream, instance->buffer, instance->used - part) !=
+           instance->used - part)
+            break;
+
+        saved = true;
+    } while(false);
+
+    return saved;
+}
+
+bool nfc_trace_load(NfcTrace* instance, Stream* stream) {
+    furi_check(instance);
+    furi_check(stream);
+
+    nfc_trace_reset(instance);
+
+    uint8_t frame_data[NFC_TRACE_DATA_SIZE_MAX];
+    uint8_t frame_parity[NFC_TRACE_PARITY_SIZE_MAX];
+    bool loaded = false;
+
+    do {
+        NfcTraceFileHeader file_header;
+        if(stream_read(stream, (uint8_t*)&file_header, sizeof(file_header)) !=
+           sizeof(file_header))
+            break;
+        if(file_header.magic != NFC_TRACE_FILE_MAGIC) break;
+        if(file_header.version != NFC_TRACE_FILE_VERSION) break;
+
+        uint32_t i = 0;
+        for(; i < file_header.count; i++) {
+            NfcTraceFrameHeader header;
+            if(stream_read(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) break;
+            if(header.direction > NfcTraceDirectionCard) break;
+            if(header.size_bits > NFC_TRACE_DATA_SIZE_MAX * 8U) break;
+
+            const size_t data_size = nfc_trace_get_data_size(header.size_bits);
+            if(stream_read(stream, frame_data, data_size) != data_size) break;
+
+            if(header.flags & NfcTraceFlagParity) {
+                const size_t parity_size = nfc_trace_get_data_size(data_size);
+                if(stream_read(stream, frame_parity, parity_size) != parity_size) break;
+            }
+
+            nfc_trace_push(instance, &header, frame_data, frame_parity);
+        }
+        if(i != file_header.count) break;
+
+        loaded = true;
+    } while(false);
+
+    if(!loaded) {
+        nfc_trace_reset(instance);
+    }
+
+    return loaded;
+}
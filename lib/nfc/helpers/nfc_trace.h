@@ -0,0 +1,158 @@
+/**
+ * @file nfc_trace.h
+ * @brief Frame trace of an Nfc session.
+ *
+ * Frames exchanged by a poller or a listener are kept with their timestamps in a
+ * ring buffer of fixed size, the oldest frames are overwritten when it is full.
+ * A trace can be saved to a compact binary file and loaded back to be replayed.
+ *
+ * The trace is not thread safe, it must only be read while the Nfc instance
+ * it is attached to is stopped.
+ */
+#pragma once
+
+#include <toolbox/bit_buffer.h>
+#include <toolbox/stream/stream.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct NfcTrace NfcTrace;
+
+/**
+ * @brief Enumeration of frame directions.
+ */
+typedef enum {
+    NfcTraceDirectionReader, /**< Frame sent by the reader to the card. */
+    NfcTraceDirectionCard, /**< Frame sent by the card to the reader. */
+} NfcTraceDirection;
+
+/**
+ * @brief Enumeration of frame flags.
+ */
+typedef enum {
+    NfcTraceFlagNone = 0, /**< Regular frame. */
+    NfcTraceFlagParity = (1U << 0), /**< Frame parity bits are stored as well. */
+    NfcTraceFlagTimeout = (1U << 1), /**< No valid response was received, the frame is empty. */
+} NfcTraceFlag;
+
+/**
+ * @brief Frame record.
+ */
+typedef struct {
+    uint32_t timestamp_us; /**< Time since the trace was reset. */
+    NfcTraceDirection direction; /**< Frame direction. */
+    uint8_t flags; /**< Combination of NfcTraceFlag values. */
+} NfcTraceRecord;
+
+/**
+ * @brief Allocate an NfcTrace instance.
+ *
+ * @param[in] size ring buffer size in bytes, each frame takes 8 bytes plus its data.
+ * @returns pointer to the allocated instance.
+ */
+NfcTrace* nfc_trace_alloc(size_t size);
+
+/**
+ * @brief Delete an NfcTrace instance.
+ *
+ * @param[in,out] instance pointer to the instance to be deleted.
+ */
+void nfc_trace_free(NfcTrace* instance);
+
+/**
+ * @brief Remove all frames and restart the trace time.
+ *
+ * @param[in,out] instance pointer to the instance to be reset.
+ */
+void nfc_trace_reset(NfcTrace* instance);
+
+/**
+ * @brief Add a frame to the trace.
+ *
+ * Parity bits are only stored if NfcTraceFlagParity is set.
+ *
+ * @param[in,out] instance pointer to the instance to be modified.
+ * @param[in] direction frame direction.
+ * @param[in] flags combination of NfcTraceFlag values.
+ * @param[in] data pointer to the frame data, may be NULL for NfcTraceFlagTimeout.
+ */
+void nfc_trace_add(
+    NfcTrace* instance,
+    NfcTraceDirection direction,
+    uint8_t flags,
+    const BitBuffer* data);
+
+/**
+ * @brief Add a frame given as raw bytes to the trace.
+ *
+ * @param[in,out] instance pointer to the instance to be modified.
+ * @param[in] direction frame direction.
+ * @param[in] flags combination of NfcTraceFlag values, except NfcTraceFlagParity.
+ * @param[in] data pointer to the frame data.
+ * @param[in] size_bits frame size in bits.
+ */
+void nfc_trace_add_bytes(
+    NfcTrace* instance,
+    NfcTraceDirection direction,
+    uint8_t flags,
+    const uint8_t* data,
+    size_t size_bits);
+
+/**
+ * @brief Get the number of frames in the trace.
+ *
+ * @param[in] instance pointer to the instance to be queried.
+ * @returns number of frames.
+ */
+size_t nfc_trace_get_count(const NfcTrace* instance);
+
+/**
+ * @brief Get the number of frames overwritten since the trace was reset.
+ *
+ * @param[in] instance pointer to the instance to be queried.
+ * @returns number of lost frames.
+ */
+size_t nfc_trace_get_lost_count(const NfcTrace* instance);
+
+/**
+ * @brief Move the read position to the oldest frame.
+ *
+ * @param[in,out] instance pointer to the instance to be modified.
+ */
+void nfc_trace_rewind(NfcTrace* instance);
+
+/**
+ * @brief Read the frame at the read position and advance it.
+ *
+ * @param[in,out] instance pointer to the instance to be read.
+ * @param[out] record pointer to the frame record.
+ * @param[out] data pointer to the BitBuffer receiving the frame data, may be NULL.
+ * @returns true if a frame was read, false at the end of the trace.
+ */
+bool nfc_trace_read(NfcTrace* instance, NfcTraceRecord* record, BitBuffer* data);
+
+/**
+ * @brief Write the trace to a stream.
+ *
+ * @param[in] instance pointer to the instance to be saved.
+ * @param[in,out] stream pointer to the stream open for writing.
+ * @returns true on success, false otherwise.
+ */
+bool nfc_trace_save(const NfcTrace* instance, Stream* stream);
+
+/**
+ * @brief Read a trace from a stream.
+ *
+ * Oldest frames are dropped if the trace does not fit in the ring buffer.
+ *
+ * @param[in,out] instance pointer to the instance to be loaded.
+ * @param[in,out] stream pointer to the stream open for reading.
+ * @returns true on success, false otherwise.
+ */
+bool nfc_trace_load(NfcTrace* instance, Stream* stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,6 +9,10 @@
 
 #define NFC_MAX_BUFFER_SIZE (256)
 
+#define NFC_ISO14443A_SHORT_FRAME_BITS (7)
+#define NFC_ISO14443A_ALL_REQA (0x52)
+#define NFC_ISO14443A_REQA (0x26)
+
 typedef enum {
     NfcStateIdle,
     NfcStateRunning,
@@ -59,6 +63,7 @@ struct Nfc {
     size_t rx_bits;
 
     FuriThread* worker_thread;
+    NfcTrace* trace;
 };
 
 typedef bool (*NfcWorkerPollerStateHandler)(Nfc* instance);
@@ -101,6 +106,29 @@ static NfcError nfc_process_hal_error(FuriHalNfcError error) {
     return ret;
 }
 
+static inline void nfc_add_trace(
+    Nfc* instance,
+    NfcTraceDirection direction,
+    uint8_t flags,
+    const BitBuffer* data) {
+    if(instance->trace) {
+        nfc_trace_add(instance->trace, direction, flags, data);
+    }
+}
+
+// Failed exchanges are traced as if the card did not respond
+static inline void nfc_add_trace_response(
+    Nfc* instance,
+    NfcError error,
+    uint8_t flags,
+    const BitBuffer* rx_buffer) {
+    if(error == NfcErrorNone) {
+        nfc_add_trace(instance, NfcTraceDirectionCard, flags, rx_buffer);
+    } else {
+        nfc_add_trace(instance, NfcTraceDirectionCard, NfcTraceFlagTimeout, NULL);
+    }
+}
+
 static int32_t nfc_worker_listener(void* context) {
     furi_assert(context);
 
@@ -144,6 +172,8 @@ static int32_t nfc_worker_listener(void* context) {
             furi_hal_nfc_listener_rx(
                 instance->rx_buffer, sizeof(instance->rx_buffer), &instance->rx_bits);
             bit_buffer_copy_bits(event_data.buffer, instance->rx_buffer, instance->rx_bits);
+            nfc_add_trace(
+                instance, NfcTraceDirectionReader, NfcTraceFlagNone, event_data.buffer);
             command = instance->callback(nfc_event, instance->context);
             if(command == NfcCommandStop) {
                 break;
@@ -306,6 +336,13 @@ void nfc_set_mask_receive_time_fc(Nfc* instance, uint32_t mask_rx_time_fc) {
     instance->mask_rx_time_fc = mask_rx_time_fc;
 }
 
+void nfc_set_trace(Nfc* instance, NfcTrace* trace) {
+    furi_assert(instance);
+    furi_assert(instance->state == NfcStateIdle);
+
+    instance->trace = trace;
+}
+
 void nfc_start(Nfc* instance, NfcEventCallback callback, void* context) {
     furi_assert(instance);
     furi_assert(instance->worker_thread);
@@ -350,6 +387,7 @@ NfcError nfc_listener_tx(Nfc* instance, const BitBuffer* tx_buffer) {
         FURI_LOG_D(TAG, "Failed in listener TX");
         ret = nfc_process_hal_error(error);
     }
+    nfc_add_trace(instance, NfcTraceDirectionCard, NfcTraceFlagNone, tx_buffer);
 
     return ret;
 }
@@ -424,6 +462,7 @@ NfcError nfc_iso14443a_poller_trx_custom_parity(
                 furi_hal_nfc_poller_wait_event(FURI_HAL_NFC_EVENT_WAIT_FOREVER);
             if(event & FuriHalNfcEventTimerBlockTxExpired) break;
         }
+        nfc_add_trace(instance, NfcTraceDirectionReader, NfcTraceFlagParity, tx_buffer);
         bit_buffer_write_bytes_with_parity(
             tx_buffer, instance->tx_buffer, sizeof(instance->tx_buffer), &instance->tx_bits);
         error =
@@ -456,6 +495,7 @@ NfcError nfc_iso14443a_poller_trx_custom_parity(
 
         bit_buffer_copy_bytes_with_parity(rx_buffer, instance->rx_buffer, instance->rx_bits);
     } while(false);
+    nfc_add_trace_response(instance, ret, NfcTraceFlagParity, rx_buffer);
 
     return ret;
 }
@@ -477,6 +517,7 @@ NfcError
                 furi_hal_nfc_poller_wait_event(FURI_HAL_NFC_EVENT_WAIT_FOREVER);
             if(event & FuriHalNfcEventTimerBlockTxExpired) break;
         }
+        nfc_add_trace(instance, NfcTraceDirectionReader, NfcTraceFlagNone, tx_buffer);
         error =
             furi_hal_nfc_poller_tx(bit_buffer_get_data(tx_buffer), bit_buffer_get_size(tx_buffer));
         if(error != FuriHalNfcErrorNone) {
@@ -501,6 +542,7 @@ NfcError
 
         bit_buffer_copy_bits(rx_buffer, instance->rx_buffer, instance->rx_bits);
     } while(false);
+    nfc_add_trace_response(instance, ret, NfcTraceFlagNone, rx_buffer);
 
     return ret;
 }
@@ -542,6 +584,17 @@ NfcError nfc_iso14443a_poller_trx_short_frame(
                 furi_hal_nfc_poller_wait_event(FURI_HAL_NFC_EVENT_WAIT_FOREVER);
             if(event & FuriHalNfcEventTimerBlockTxExpired) break;
         }
+        if(instance->trace) {
+            const uint8_t frame_data = (frame == NfcIso14443aShortFrameAllReqa) ?
+                                           NFC_ISO14443A_ALL_REQA :
+                                           NFC_ISO14443A_REQA;
+            nfc_trace_add_bytes(
+                instance->trace,
+                NfcTraceDirectionReader,
+                NfcTraceFlagNone,
+                &frame_data,
+                NFC_ISO14443A_SHORT_FRAME_BITS);
+        }
         error = furi_hal_nfc_iso14443a_poller_trx_short_frame(short_frame);
         if(error != FuriHalNfcErrorNone) {
             FURI_LOG_D(TAG, "Failed in poller TX");
@@ -565,6 +618,7 @@ NfcError nfc_iso14443a_poller_trx_short_frame(
 
         bit_buffer_copy_bits(rx_buffer, instance->rx_buffer, instance->rx_bits);
     } while(false);
+    nfc_add_trace_response(instance, ret, NfcTraceFlagNone, rx_buffer);
 
     return ret;
 }
@@ -589,6 +643,7 @@ NfcError nfc_iso14443a_poller_trx_sdd_frame(
                 furi_hal_nfc_poller_wait_event(FURI_HAL_NFC_EVENT_WAIT_FOREVER);
             if(event & FuriHalNfcEventTimerBlockTxExpired) break;
         }
+        nfc_add_trace(instance, NfcTraceDirectionReader, NfcTraceFlagNone, tx_buffer);
         error = furi_hal_nfc_iso14443a_tx_sdd_frame(
             bit_buffer_get_data(tx_buffer), bit_buffer_get_size(tx_buffer));
         if(error != FuriHalNfcErrorNone) {
@@ -613,6 +668,7 @@ NfcError nfc_iso14443a_poller_trx_sdd_frame(
 
         bit_buffer_copy_bits(rx_buffer, instance->rx_buffer, instance->rx_bits);
     } while(false);
+    nfc_add_trace_response(instance, ret, NfcTraceFlagNone, rx_buffer);
 
     return ret;
 }
@@ -630,6 +686,7 @@ NfcError nfc_iso14443a_listener_tx_custom_parity(Nfc* instance, const BitBuffer*
 
     error = furi_hal_nfc_iso14443a_listener_tx_custom_parity(tx_data, tx_parity, tx_bits);
     ret = nfc_process_hal_error(error);
+    nfc_add_trace(instance, NfcTraceDirectionCard, NfcTraceFlagParity, tx_buffer);
 
     return ret;
 }
@@ -19,6 +19,8 @@
 
 #include <toolbox/bit_buffer.h>
 
+#include "helpers/nfc_trace.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -192,6 +194,18 @@ void nfc_set_fdt_poll_poll_us(Nfc* instance, uint32_t fdt_poll_poll_us);
  */
 void nfc_set_guard_time_us(Nfc* instance, uint32_t guard_time_us);
 
+/**
+ * @brief Attach a frame trace to the Nfc instance.
+ *
+ * All frames sent and received while the instance is running are added to the trace.
+ * Tracing takes a few microseconds per frame, which may matter to listeners
+ * with tight response timings.
+ *
+ * @param[in,out] instance pointer to the instance to be modified.
+ * @param[in] trace pointer to the trace to be filled, NULL to stop tracing.
+ */
+void nfc_set_trace(Nfc* instance, NfcTrace* trace);
+
 /**
  * @brief Start the Nfc instance.
  *
@@ -2,6 +2,11 @@
 
 #include <storage/storage.h>
 #include <flipper_format/flipper_format.h>
+#include <toolbox/stream/file_stream.h>
+#include <toolbox/crc32_calc.h>
+#include <toolbox/version.h>
+
+#include <m-array.h>
 
 #include "nfc_common.h"
 #include "protocols/nfc_device_defs.h"
@@ -14,6 +19,32 @@
 
 #define NFC_DEVICE_UID_MAX_LEN (10U)
 
+#define NFC_DEVICE_CACHE_MAGIC (0x4343464EUL) // "NFCC"
+#define NFC_DEVICE_CACHE_VERSION (2U)
+#define NFC_DEVICE_CACHE_DIR ".cache"
+#define NFC_DEVICE_CACHE_SUFFIX ".cache"
+#define NFC_DEVICE_CACHE_NAME_LEN (256U)
+
+ARRAY_DEF(NfcDeviceCachePathArray, FuriString*, FURI_STRING_OPLIST)
+
+/**
+ * Binary cache of a .nfc file, stored as .cache/<name>.cache in the directory of the file.
+ *
+ * Caches are written by nfc_device_save() and nfc_device_update_cache(). A cache is used
+ * while the size and modification time of the .nfc file are the same as when the cache was
+ * written, and it was written by the same firmware build with the same protocol data size.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t protocol;
+    uint8_t reserved;
+    uint32_t data_size;
+    uint32_t firmware_id;
+    uint32_t source_size;
+    uint32_t source_timestamp;
+} NfcDeviceCacheHeader;
+
 NfcDevice* nfc_device_alloc() {
     NfcDevice* instance = malloc(sizeof(NfcDevice));
     instance->protocol = NfcProtocolInvalid;
@@ -147,6 +178,210 @@ void nfc_device_set_loading_callback(
     instance->loading_callback_context = context;
 }
 
+static void nfc_device_get_cache_dir(const char* path, FuriString* cache_dir) {
+    const char* name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+
+    furi_string_set_strn(cache_dir, path, name - path);
+    furi_string_cat_str(cache_dir, NFC_DEVICE_CACHE_DIR);
+}
+
+static void nfc_device_get_cache_path(const char* path, FuriString* cache_path) {
+    const char* name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+
+    nfc_device_get_cache_dir(path, cache_path);
+    furi_string_cat_printf(cache_path, "/%s%s", name, NFC_DEVICE_CACHE_SUFFIX);
+}
+
+static uint32_t nfc_device_get_firmware_id(void) {
+    const char* githash = version_get_githash(NULL);
+    const char* builddate = version_get_builddate(NULL);
+    const bool dirty = version_get_dirty_flag(NULL);
+
+    uint32_t id = crc32_calc_buffer(0, githash, strlen(githash));
+    id = crc32_calc_buffer(id, builddate, strlen(builddate));
+    return crc32_calc_buffer(id, &dirty, sizeof(dirty));
+}
+
+static bool nfc_device_get_cache_header(
+    Storage* storage,
+    const char* path,
+    NfcProtocol protocol,
+    NfcDeviceCacheHeader* header) {
+    FileInfo file_info;
+    uint32_t timestamp = 0;
+
+    if(storage_common_stat(storage, path, &file_info) != FSE_OK) return false;
+    if(storage_common_timestamp(storage, path, &timestamp) != FSE_OK) return false;
+
+    memset(header, 0, sizeof(NfcDeviceCacheHeader));
+    header->magic = NFC_DEVICE_CACHE_MAGIC;
+    header->version = NFC_DEVICE_CACHE_VERSION;
+    header->protocol = protocol;
+    header->data_size = nfc_devices[protocol]->binary_data_size;
+    header->firmware_id = nfc_device_get_firmware_id();
+    header->source_size = file_info.size;
+    header->source_timestamp = timestamp;
+
+    return true;
+}
+
+static bool nfc_device_is_cache_orphaned(
+    Storage* storage,
+    const char* cache_name,
+    const FuriString* cache_dir,
+    FuriString* source_path) {
+    const size_t name_len = strlen(cache_name);
+    const size_t suffix_len = strlen(NFC_DEVICE_CACHE_SUFFIX);
+    if(name_len <= suffix_len) return true;
+    if(strcmp(cache_name + name_len - suffix_len, NFC_DEVICE_CACHE_SUFFIX) != 0) return true;
+
+    furi_string_set_strn(
+        source_path,
+        furi_string_get_cstr(cache_dir),
+        furi_string_size(cache_dir) - strlen(NFC_DEVICE_CACHE_DIR));
+    furi_string_cat_printf(source_path, "%.*s", (int)(name_len - suffix_len), cache_name);
+
+    return !storage_common_exists(storage, furi_string_get_cstr(source_path));
+}
+
+// Caches of .nfc files that were deleted or renamed since the caches were written
+static void nfc_device_remove_orphaned_caches(Storage* storage, const char* path) {
+    FuriString* cache_dir = furi_string_alloc();
+    FuriString* file_path = furi_string_alloc();
+    File* dir = storage_file_alloc(storage);
+    char* name = malloc(NFC_DEVICE_CACHE_NAME_LEN);
+    NfcDeviceCachePathArray_t orphans;
+    NfcDeviceCachePathArray_init(orphans);
+
+    nfc_device_get_cache_dir(path, cache_dir);
+
+    // Files are removed after the scan, with the directory closed
+    if(storage_dir_open(dir, furi_string_get_cstr(cache_dir))) {
+        FileInfo file_info;
+        while(storage_dir_read(dir, &file_info, name, NFC_DEVICE_CACHE_NAME_LEN)) {
+            if(file_info_is_dir(&file_info)) continue;
+            if(nfc_device_is_cache_orphaned(storage, name, cache_dir, file_path)) {
+                furi_string_printf(file_path, "%s/%s", furi_string_get_cstr(cache_dir), name);
+                NfcDeviceCachePathArray_push_back(orphans, file_path);
+            }
+        }
+    }
+    storage_dir_close(dir);
+
+    NfcDeviceCachePathArray_it_t it;
+    for(NfcDeviceCachePathArray_it(it, orphans); !NfcDeviceCachePathArray_end_p(it);
+        NfcDeviceCachePathArray_next(it)) {
+        storage_simply_remove(storage, furi_string_get_cstr(*NfcDeviceCachePathArray_cref(it)));
+    }
+
+    NfcDeviceCachePathArray_clear(orphans);
+    free(name);
+    storage_file_free(dir);
+    furi_string_free(file_path);
+    furi_string_free(cache_dir);
+}
+
+static bool nfc_device_save_cache(NfcDevice* instance, Storage* storage, const char* path) {
+    const NfcDeviceBase* device = nfc_devices[instance->protocol];
+
+    FuriString* cache_path = furi_string_alloc();
+    Stream* stream = file_stream_alloc(storage);
+    bool saved = false;
+
+    do {
+        if(device->save_binary == NULL) break;
+
+        nfc_device_get_cache_dir(path, cache_path);
+        storage_simply_mkdir(storage, furi_string_get_cstr(cache_path));
+        nfc_device_get_cache_path(path, cache_path);
+
+        NfcDeviceCacheHeader header;
+        if(!nfc_device_get_cache_header(storage, path, instance->protocol, &header)) break;
+
+        if(!file_stream_open(
+               stream, furi_string_get_cstr(cache_path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        if(stream_write(stream, (const uint8_t*)&header, sizeof(header)) != sizeof(header)) break;
+        if(!device->save_binary(instance->protocol_data, stream)) break;
+
+        saved = true;
+    } while(false);
+
+    stream_free(stream);
+
+    // Incomplete or outdated cache must not be picked up later
+    if(!saved) {
+        nfc_device_get_cache_path(path, cache_path);
+        storage_common_remove(storage, furi_string_get_cstr(cache_path));
+    }
+
+    furi_string_free(cache_path);
+
+    return saved;
+}
+
+// Leaves the stream at the protocol data if the cache is up to date
+static bool nfc_device_open_cache(
+    Stream* stream,
+    Storage* storage,
+    const char* path,
+    NfcDeviceCacheHeader* header) {
+    FuriString* cache_path = furi_string_alloc();
+    bool opened = false;
+
+    do {
+        nfc_device_get_cache_path(path, cache_path);
+        if(!file_stream_open(
+               stream, furi_string_get_cstr(cache_path), FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+
+        if(stream_read(stream, (uint8_t*)header, sizeof(NfcDeviceCacheHeader)) !=
+           sizeof(NfcDeviceCacheHeader))
+            break;
+        if(header->protocol >= NfcProtocolNum) break;
+
+        NfcDeviceCacheHeader expected;
+        if(!nfc_device_get_cache_header(storage, path, header->protocol, &expected)) break;
+        if(memcmp(header, &expected, sizeof(NfcDeviceCacheHeader)) != 0) break;
+
+        opened = true;
+    } while(false);
+
+    furi_string_free(cache_path);
+
+    return opened;
+}
+
+static bool nfc_device_load_cache(NfcDevice* instance, Storage* storage, const char* path) {
+    Stream* stream = file_stream_alloc(storage);
+    bool loaded = false;
+
+    do {
+        NfcDeviceCacheHeader header;
+        if(!nfc_device_open_cache(stream, storage, path, &header)) break;
+
+        const NfcDeviceBase* device = nfc_devices[header.protocol];
+        if(device->load_binary == NULL) break;
+
+        nfc_device_clear(instance);
+        instance->protocol = header.protocol;
+        instance->protocol_data = device->alloc();
+
+        if(!device->load_binary(instance->protocol_data, stream)) {
+            nfc_device_clear(instance);
+            break;
+        }
+
+        loaded = true;
+    } while(false);
+
+    stream_free(stream);
+
+    return loaded;
+}
+
 bool nfc_device_save(NfcDevice* instance, const char* path) {
     furi_assert(instance);
     furi_assert(instance->protocol < NfcProtocolNum);
@@ -199,12 +434,18 @@ bool nfc_device_save(NfcDevice* instance, const char* path) {
         saved = true;
     } while(false);
 
+    furi_string_free(temp_str);
+    flipper_format_free(ff);
+
+    // File must be closed to have its final size and modification time
+    if(saved) {
+        nfc_device_save_cache(instance, storage, path);
+    }
+
     if(instance->loading_callback) {
         instance->loading_callback(instance->loading_callback_context, false);
     }
 
-    furi_string_free(temp_str);
-    flipper_format_free(ff);
     furi_record_close(RECORD_STORAGE);
 
     return saved;
@@ -327,7 +568,14 @@ bool nfc_device_load(NfcDevice* instance, const char* path) {
         instance->loading_callback(instance->loading_callback_context, true);
     }
 
+    bool cache_loaded = nfc_device_load_cache(instance, storage, path);
+
     do {
+        if(cache_loaded) {
+            loaded = true;
+            break;
+        }
+
         if(!flipper_format_buffered_file_open_existing(ff, path)) break;
 
         // Read and verify file header
@@ -344,13 +592,38 @@ bool nfc_device_load(NfcDevice* instance, const char* path) {
 
     } while(false);
 
+    furi_string_free(temp_str);
+    flipper_format_free(ff);
+
     if(instance->loading_callback) {
         instance->loading_callback(instance->loading_callback_context, false);
     }
 
-    furi_string_free(temp_str);
-    flipper_format_free(ff);
     furi_record_close(RECORD_STORAGE);
 
     return loaded;
 }
+
+bool nfc_device_update_cache(NfcDevice* instance, const char* path) {
+    furi_assert(instance);
+    furi_assert(instance->protocol < NfcProtocolNum);
+    furi_assert(path);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = file_stream_alloc(storage);
+
+    NfcDeviceCacheHeader header;
+    bool updated = nfc_device_open_cache(stream, storage, path, &header) &&
+                   header.protocol == instance->protocol;
+    stream_free(stream);
+
+    // Cache miss: the file came from outside, files may have been deleted the same way
+    if(!updated && nfc_devices[instance->protocol]->save_binary) {
+        nfc_device_remove_orphaned_caches(storage, path);
+        updated = nfc_device_save_cache(instance, storage, path);
+    }
+
+    furi_record_close(RECORD_STORAGE);
+
+    return updated;
+}
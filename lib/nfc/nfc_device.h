@@ -246,6 +246,9 @@ void nfc_device_set_loading_callback(
 /**
  * @brief Save NFC device data form an NfcDevice instance to a file.
  *
+ * A binary cache of the file is written to the .cache directory next to it, if the
+ * protocol supports it.
+ *
  * @param[in] instance pointer to the instance to be saved.
  * @param[in] path pointer to a character string with a full file path.
  * @returns true if the data was successfully saved, false otherwise.
@@ -255,12 +258,29 @@ bool nfc_device_save(NfcDevice* instance, const char* path);
 /**
  * @brief Load NFC device data to an NfcDevice instance from a file.
  *
+ * The binary cache of the file is used while it is up to date.
+ * The function does not write anything to the storage, see nfc_device_update_cache().
+ *
  * @param[in,out] instance pointer to the instance to be loaded into.
  * @param[in] path pointer to a character string with a full file path.
  * @returns true if the data was successfully loaded, false otherwise.
  */
 bool nfc_device_load(NfcDevice* instance, const char* path);
 
+/**
+ * @brief Write the binary cache of a file that was loaded into an NfcDevice instance.
+ *
+ * Meant to be called after nfc_device_load(), so that files copied to the storage
+ * by other means (e.g. over USB) get a cache too. Nothing is written while the cache
+ * is up to date. Otherwise, caches of files that no longer exist in the same directory
+ * are removed, then the cache is written.
+ *
+ * @param[in] instance pointer to the instance holding the data loaded from the file.
+ * @param[in] path pointer to a character string with a full file path.
+ * @returns true if the cache is up to date, false otherwise.
+ */
+bool nfc_device_update_cache(NfcDevice* instance, const char* path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,6 @@
 #include "nfc_scanner.h"
 #include "nfc_poller.h"
+#include "nfc_device.h"
 
 #include <nfc/protocols/nfc_poller_defs.h>
 
@@ -7,6 +8,29 @@
 
 #define TAG "NfcScanner"
 
+#define NFC_SCANNER_STATS_CHAINS_NUM (8U)
+// Chain must be detected this many times before its protocols are probed first
+#define NFC_SCANNER_STATS_CONFIDENCE (2U)
+
+typedef uint32_t NfcScannerProtocolSet;
+
+static_assert(NfcProtocolNum <= sizeof(NfcScannerProtocolSet) * 8, "Protocol set is too small");
+
+typedef struct {
+    NfcProtocol first_protocol;
+    NfcScannerProtocolSet protocols;
+    uint16_t hits;
+    uint32_t last_seen;
+} NfcScannerChain;
+
+typedef struct {
+    NfcScannerChain chains[NFC_SCANNER_STATS_CHAINS_NUM];
+    uint32_t scans;
+} NfcScannerStats;
+
+// Outlives scanner instances, so card families seen recently are probed first
+static NfcScannerStats nfc_scanner_stats;
+
 typedef enum {
     NfcScannerStateIdle,
     NfcScannerStateTryBasePollers,
@@ -51,6 +75,12 @@ struct NfcScanner {
 
     NfcProtocol current_protocol;
 
+    NfcScannerProtocolSet expected_protocols;
+    NfcScannerProtocolSet probed_protocols;
+    bool stats_updated;
+    uint32_t detect_start;
+    size_t probes_num;
+
     FuriThread* scan_worker;
 };
 
@@ -65,6 +95,110 @@ static void nfc_scanner_reset(NfcScanner* instance) {
     instance->detected_base_protocols_num = 0;
 
     instance->current_protocol = 0;
+
+    instance->expected_protocols = 0;
+    instance->probed_protocols = 0;
+    instance->stats_updated = false;
+    instance->probes_num = 0;
+}
+
+static uint32_t nfc_scanner_stats_get_score(NfcProtocol protocol) {
+    uint32_t score = 0;
+    for(size_t i = 0; i < NFC_SCANNER_STATS_CHAINS_NUM; i++) {
+        const NfcScannerChain* chain = &nfc_scanner_stats.chains[i];
+        if((chain->hits > 0) && (chain->first_protocol == protocol)) {
+            score += chain->hits;
+        }
+    }
+    return score;
+}
+
+static const NfcScannerChain* nfc_scanner_stats_find(NfcProtocol first_protocol) {
+    const NfcScannerChain* found = NULL;
+    for(size_t i = 0; i < NFC_SCANNER_STATS_CHAINS_NUM; i++) {
+        const NfcScannerChain* chain = &nfc_scanner_stats.chains[i];
+        if(chain->first_protocol != first_protocol) continue;
+        if(chain->hits < NFC_SCANNER_STATS_CONFIDENCE) continue;
+        if(found && ((chain->hits < found->hits) ||
+                     ((chain->hits == found->hits) && (chain->last_seen < found->last_seen)))) {
+            continue;
+        }
+        found = chain;
+    }
+    return found;
+}
+
+static void nfc_scanner_stats_update(NfcProtocol first_protocol, NfcScannerProtocolSet protocols) {
+    NfcScannerChain* chain = NULL;
+    NfcScannerChain* victim = &nfc_scanner_stats.chains[0];
+
+    for(size_t i = 0; i < NFC_SCANNER_STATS_CHAINS_NUM; i++) {
+        NfcScannerChain* iter = &nfc_scanner_stats.chains[i];
+        if((iter->hits > 0) && (iter->first_protocol == first_protocol) &&
+           (iter->protocols == protocols)) {
+            chain = iter;
+            break;
+        }
+        // Least detected chain is replaced, the oldest one among equals
+        if((iter->hits < victim->hits) ||
+           ((iter->hits == victim->hits) && (iter->last_seen < victim->last_seen))) {
+            victim = iter;
+        }
+    }
+
+    if(chain == NULL) {
+        chain = victim;
+        chain->first_protocol = first_protocol;
+        chain->protocols = protocols;
+        chain->hits = 0;
+    }
+
+    // Older history fades out instead of saturating
+    if(chain->hits == UINT16_MAX) {
+        for(size_t i = 0; i < NFC_SCANNER_STATS_CHAINS_NUM; i++) {
+            nfc_scanner_stats.chains[i].hits /= 2;
+        }
+    }
+    chain->hits++;
+    chain->last_seen = ++nfc_scanner_stats.scans;
+}
+
+static NfcScannerProtocolSet nfc_scanner_get_detected_set(const NfcScanner* instance) {
+    NfcScannerProtocolSet protocols = 0;
+    for(size_t i = 0; i < instance->detected_protocols_num; i++) {
+        protocols |= 1UL << instance->detected_protocols[i];
+    }
+    return protocols;
+}
+
+static bool nfc_scanner_is_expected(const NfcScanner* instance, NfcProtocol protocol) {
+    return (instance->expected_protocols & (1UL << protocol)) != 0;
+}
+
+static bool nfc_scanner_is_parent_missing(const NfcScanner* instance, NfcProtocol protocol) {
+    const NfcProtocol parent_protocol = nfc_protocol_get_parent(protocol);
+    const NfcScannerProtocolSet parent = 1UL << parent_protocol;
+    return (instance->probed_protocols & parent) &&
+           !(nfc_scanner_get_detected_set(instance) & parent);
+}
+
+static bool nfc_scanner_detect(NfcScanner* instance, NfcProtocol protocol) {
+    const uint32_t start = furi_get_tick();
+
+    NfcPoller* poller = nfc_poller_alloc(instance->nfc, protocol);
+    bool protocol_detected = nfc_poller_detect(poller);
+    nfc_poller_free(poller);
+
+    instance->probes_num++;
+    instance->probed_protocols |= 1UL << protocol;
+    FURI_LOG_T(
+        TAG,
+        "%s %s in %lu ms",
+        nfc_device_get_protocol_name(protocol),
+        protocol_detected ? "detected" : "not detected",
+        furi_get_tick() - start);
+
+    return protocol_detected;
 }
 
 typedef void (*NfcScannerStateHandler)(NfcScanner* instance);
@@ -79,6 +213,16 @@ void nfc_scanner_state_handler_idle(NfcScanner* instance) {
     }
     FURI_LOG_D(TAG, "Found %zu base protocols", instance->base_protocols_num);
 
+    // Most often detected technologies go first, ties keep the protocol order
+    uint32_t scores[NfcProtocolNum] = {};
+    for(size_t i = 0; i < instance->base_protocols_num; i++) {
+        scores[i] = nfc_scanner_stats_get_score(instance->base_protocols[i]);
+        for(size_t j = i; (j > 0) && (scores[j] > scores[j - 1]); j--) {
+            FURI_SWAP(scores[j], scores[j - 1]);
+            FURI_SWAP(instance->base_protocols[j], instance->base_protocols[j - 1]);
+        }
+    }
+
     instance->first_detected_protocol = NfcProtocolInvalid;
     instance->state = NfcScannerStateTryBasePollers;
 }
@@ -92,9 +236,8 @@ void nfc_scanner_state_handler_try_base_pollers(NfcScanner* instance) {
             break;
         }
 
-        NfcPoller* poller = nfc_poller_alloc(instance->nfc, instance->current_protocol);
-        bool protocol_detected = nfc_poller_detect(poller);
-        nfc_poller_free(poller);
+        const uint32_t start = furi_get_tick();
+        bool protocol_detected = nfc_scanner_detect(instance, instance->current_protocol);
 
         if(protocol_detected) {
             instance->detected_protocols[instance->detected_protocols_num] =
@@ -108,6 +251,15 @@ void nfc_scanner_state_handler_try_base_pollers(NfcScanner* instance) {
             if(instance->first_detected_protocol == NfcProtocolInvalid) {
                 instance->first_detected_protocol = instance->current_protocol;
                 instance->current_protocol = NfcProtocolInvalid;
+                instance->detect_start = start;
+                instance->probes_num = 1;
+
+                const NfcScannerChain* chain =
+                    nfc_scanner_stats_find(instance->first_detected_protocol);
+                if(chain) {
+                    instance->expected_protocols = chain->protocols;
+                    FURI_LOG_D(TAG, "Expecting chain seen %u times", chain->hits);
+                }
             }
         }
 
@@ -126,6 +278,18 @@ void nfc_scanner_state_handler_find_children_protocols(NfcScanner* instance) {
         }
     }
 
+    // Protocols of the expected chain are probed first, the rest keep their order.
+    // The chain only reorders probes: a card may have more protocols than it learned.
+    size_t expected_num = 0;
+    for(size_t i = 0; i < instance->children_protocols_num; i++) {
+        if(nfc_scanner_is_expected(instance, instance->children_protocols[i])) {
+            for(size_t j = i; j > expected_num; j--) {
+                FURI_SWAP(instance->children_protocols[j], instance->children_protocols[j - 1]);
+            }
+            expected_num++;
+        }
+    }
+
     if(instance->children_protocols_num > 0) {
         instance->state = NfcScannerStateDetectChildrenProtocols;
     } else {
@@ -139,14 +303,15 @@ void nfc_scanner_state_handler_detect_children_protocols(NfcScanner* instance) {
 
     instance->current_protocol = instance->children_protocols[instance->children_protocols_idx];
 
-    NfcPoller* poller = nfc_poller_alloc(instance->nfc, instance->current_protocol);
-    bool protocol_detected = nfc_poller_detect(poller);
-    nfc_poller_free(poller);
+    // A protocol only runs on top of its parent, no need to probe it if the parent is absent
+    if(!nfc_scanner_is_parent_missing(instance, instance->current_protocol)) {
+        bool protocol_detected = nfc_scanner_detect(instance, instance->current_protocol);
 
-    if(protocol_detected) {
-        instance->detected_protocols[instance->detected_protocols_num] =
-            instance->current_protocol;
-        instance->detected_protocols_num++;
+        if(protocol_detected) {
+            instance->detected_protocols[instance->detected_protocols_num] =
+                instance->current_protocol;
+            instance->detected_protocols_num++;
+        }
     }
 
     instance->children_protocols_idx++;
@@ -173,10 +338,24 @@ static void nfc_scanner_filter_detected_protocols(NfcScanner* instance) {
     }
 
     instance->detected_protocols_num = filtered_protocols_num;
-    memcpy(instance->detected_protocols, filtered_protocols, filtered_protocols_num);
+    memcpy(
+        instance->detected_protocols,
+        filtered_protocols,
+        filtered_protocols_num * sizeof(NfcProtocol));
 }
 
 void nfc_scanner_state_handler_complete(NfcScanner* instance) {
+    if(!instance->stats_updated) {
+        nfc_scanner_stats_update(
+            instance->first_detected_protocol, nfc_scanner_get_detected_set(instance));
+        instance->stats_updated = true;
+        FURI_LOG_D(
+            TAG,
+            "Detection took %lu ms, %zu probes",
+            furi_get_tick() - instance->detect_start,
+            instance->probes_num);
+    }
+
     if(instance->detected_protocols_num > 1) {
         nfc_scanner_filter_detected_protocols(instance);
     }
@@ -9,6 +9,11 @@
  * a just one protocol and will try others as well until all possibilities are exhausted.
  * This is to allow for multi-protocol card support.
  *
+ * Protocol chains detected in previous scans are remembered until reboot. Technologies
+ * that answered most often are probed first, and once a chain has been seen repeatedly,
+ * its protocols are probed first. Every protocol is still probed, except those whose
+ * parent protocol did not answer.
+ *
  * If no supported cards are in the vicinity, the scanning process will continue
  * until stopped explicitly.
  */
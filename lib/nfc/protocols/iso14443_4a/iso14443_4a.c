@@ -214,7 +214,8 @@ Iso14443_3aData* iso14443_4a_get_base_data(const Iso14443_4aData* data) {
 uint16_t iso14443_4a_get_frame_size_max(const Iso14443_4aData* data) {
     furi_assert(data);
 
-    const uint8_t fsci = data->ats_data.t0 & 0x0F;
+    // Default FSCI applies if T0 is absent
+    const uint8_t fsci = (data->ats_data.tl > 1) ? (data->ats_data.t0 & 0x0F) : 2;
 
     if(fsci < 5) {
         return fsci * 8 + 16;
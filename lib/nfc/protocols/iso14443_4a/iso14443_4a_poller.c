@@ -58,6 +58,8 @@ static NfcCommand iso14443_4a_poller_handler_read_ats(Iso14443_4aPoller* instanc
     Iso14443_4aError error = iso14443_4a_poller_read_ats(instance, &instance->data->ats_data);
     if(error == Iso14443_4aErrorNone) {
         FURI_LOG_D(TAG, "Read ATS success");
+        iso14443_4_layer_set_fsc(
+            instance->iso14443_4_layer, iso14443_4a_get_frame_size_max(instance->data));
         instance->poller_state = Iso14443_4aPollerStateReady;
     } else {
         FURI_LOG_D(TAG, "Failed to read ATS");
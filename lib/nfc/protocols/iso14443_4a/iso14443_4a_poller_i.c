@@ -56,28 +56,37 @@ Iso14443_4aError iso14443_4a_poller_send_block(
     BitBuffer* rx_buffer) {
     furi_assert(instance);
 
-    bit_buffer_reset(instance->tx_buffer);
-    iso14443_4_layer_encode_block(instance->iso14443_4_layer, tx_buffer, instance->tx_buffer);
+    bit_buffer_reset(rx_buffer);
+    iso14443_4_layer_encode_command(instance->iso14443_4_layer, tx_buffer, instance->tx_buffer);
 
     Iso14443_4aError error = Iso14443_4aErrorNone;
 
-    do {
+    // Exchange blocks until the chained command is sent and the chained response is received
+    while(true) {
+        const uint32_t fwt_fc = iso14443_4a_get_fwt_fc_max(instance->data) *
+                                iso14443_4_layer_get_wtxm(instance->iso14443_4_layer);
+
         Iso14443_3aError iso14443_3a_error = iso14443_3a_poller_send_standard_frame(
-            instance->iso14443_3a_poller,
-            instance->tx_buffer,
-            instance->rx_buffer,
-            iso14443_4a_get_fwt_fc_max(instance->data));
+            instance->iso14443_3a_poller, instance->tx_buffer, instance->rx_buffer, fwt_fc);
 
         if(iso14443_3a_error != Iso14443_3aErrorNone) {
             error = iso14443_4a_process_error(iso14443_3a_error);
             break;
+        }
+
+        Iso14443_4LayerResult result = iso14443_4_layer_decode_response(
+            instance->iso14443_4_layer, rx_buffer, instance->rx_buffer, instance->tx_buffer);
 
-        } else if(!iso14443_4_layer_decode_block(
-                      instance->iso14443_4_layer, rx_buffer, instance->rx_buffer)) {
+        if(result == Iso14443_4LayerResultSuccess) {
+            break;
+        } else if(result == Iso14443_4LayerResultError) {
             error = Iso14443_4aErrorProtocol;
             break;
+        } else if(result == Iso14443_4LayerResultTimeout) {
+            error = Iso14443_4aErrorTimeout;
+            break;
         }
-    } while(false);
+    }
 
     return error;
 }
@@ -49,6 +49,9 @@ static NfcCommand iso14443_4b_poller_handler_idle(Iso14443_4bPoller* instance) {
         iso14443_3b_poller_get_data(instance->iso14443_3b_poller));
 
     iso14443_4_layer_reset(instance->iso14443_4_layer);
+    iso14443_4_layer_set_fsc(
+        instance->iso14443_4_layer,
+        iso14443_3b_get_frame_size_max(instance->data->iso14443_3b_data));
     instance->poller_state = Iso14443_4bPollerStateReady;
     return NfcCommandContinue;
 }
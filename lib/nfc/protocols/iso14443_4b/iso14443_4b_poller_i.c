@@ -21,25 +21,34 @@ Iso14443_4bError iso14443_4b_poller_send_block(
     BitBuffer* rx_buffer) {
     furi_assert(instance);
 
-    bit_buffer_reset(instance->tx_buffer);
-    iso14443_4_layer_encode_block(instance->iso14443_4_layer, tx_buffer, instance->tx_buffer);
+    bit_buffer_reset(rx_buffer);
+    iso14443_4_layer_encode_command(instance->iso14443_4_layer, tx_buffer, instance->tx_buffer);
 
     Iso14443_4bError error = Iso14443_4bErrorNone;
 
-    do {
+    // Exchange blocks until the chained command is sent and the chained response is received
+    while(true) {
         Iso14443_3bError iso14443_3b_error = iso14443_3b_poller_send_frame(
             instance->iso14443_3b_poller, instance->tx_buffer, instance->rx_buffer);
 
         if(iso14443_3b_error != Iso14443_3bErrorNone) {
             error = iso14443_4b_process_error(iso14443_3b_error);
             break;
+        }
+
+        Iso14443_4LayerResult result = iso14443_4_layer_decode_response(
+            instance->iso14443_4_layer, rx_buffer, instance->rx_buffer, instance->tx_buffer);
 
-        } else if(!iso14443_4_layer_decode_block(
-                      instance->iso14443_4_layer, rx_buffer, instance->rx_buffer)) {
+        if(result == Iso14443_4LayerResultSuccess) {
+            break;
+        } else if(result == Iso14443_4LayerResultError) {
             error = Iso14443_4bErrorProtocol;
             break;
+        } else if(result == Iso14443_4LayerResultTimeout) {
+            error = Iso14443_4bErrorTimeout;
+            break;
         }
-    } while(false);
+    }
 
     return error;
 }
@@ -16,6 +16,9 @@ typedef struct {
 
 static const uint32_t mf_classic_data_format_version = 2;
 
+static bool mf_classic_load_binary(MfClassicData* data, Stream* stream);
+static bool mf_classic_save_binary(const MfClassicData* data, Stream* stream);
+
 static const MfClassicFeatures mf_classic_features[MfClassicTypeNum] = {
     [MfClassicTypeMini] =
         {
@@ -54,6 +57,9 @@ const NfcDeviceBase nfc_device_mf_classic = {
     .get_uid = (NfcDeviceGetUid)mf_classic_get_uid,
     .set_uid = (NfcDeviceSetUid)mf_classic_set_uid,
     .get_base_data = (NfcDeviceGetBaseData)mf_classic_get_base_data,
+    .load_binary = (NfcDeviceLoadBinary)mf_classic_load_binary,
+    .save_binary = (NfcDeviceSaveBinary)mf_classic_save_binary,
+    .binary_data_size = sizeof(Iso14443_3aData) + sizeof(MfClassicData),
 };
 
 MfClassicData* mf_classic_alloc() {
@@ -181,12 +187,14 @@ bool mf_classic_load(MfClassicData* data, FlipperFormat* ff, uint32_t version) {
         }
 
         // Read Mifare Classic blocks
+        // Blocks are stored in order, so each key is found on the next line
         bool block_read = true;
         FuriString* block_str = furi_string_alloc();
+        char block_key[sizeof("Block 255")];
         uint16_t blocks_total = mf_classic_get_total_block_num(data->type);
         for(size_t i = 0; i < blocks_total; i++) {
-            furi_string_printf(temp_str, "Block %d", i);
-            if(!flipper_format_read_string(ff, furi_string_get_cstr(temp_str), block_str)) {
+            snprintf(block_key, sizeof(block_key), "Block %zu", i);
+            if(!flipper_format_read_string(ff, block_key, block_str)) {
                 block_read = false;
                 break;
             }
@@ -296,6 +304,75 @@ bool mf_classic_save(const MfClassicData* data, FlipperFormat* ff) {
     return saved;
 }
 
+static bool mf_classic_load_binary(MfClassicData* data, Stream* stream) {
+    furi_assert(data);
+    furi_assert(stream);
+
+    bool loaded = false;
+
+    do {
+        if(stream_read(stream, (uint8_t*)data->iso14443_3a_data, sizeof(Iso14443_3aData)) !=
+           sizeof(Iso14443_3aData))
+            break;
+
+        uint8_t type = 0;
+        if(stream_read(stream, &type, sizeof(type)) != sizeof(type)) break;
+        if(type >= MfClassicTypeNum) break;
+        data->type = type;
+
+        if(stream_read(stream, (uint8_t*)data->block_read_mask, sizeof(data->block_read_mask)) !=
+           sizeof(data->block_read_mask))
+            break;
+        if(stream_read(stream, (uint8_t*)&data->key_a_mask, sizeof(data->key_a_mask)) !=
+           sizeof(data->key_a_mask))
+            break;
+        if(stream_read(stream, (uint8_t*)&data->key_b_mask, sizeof(data->key_b_mask)) !=
+           sizeof(data->key_b_mask))
+            break;
+
+        size_t blocks_size = mf_classic_get_total_block_num(data->type) * sizeof(MfClassicBlock);
+        if(stream_read(stream, (uint8_t*)data->block, blocks_size) != blocks_size) break;
+
+        loaded = true;
+    } while(false);
+
+    return loaded;
+}
+
+static bool mf_classic_save_binary(const MfClassicData* data, Stream* stream) {
+    furi_assert(data);
+    furi_assert(stream);
+
+    bool saved = false;
+
+    do {
+        if(stream_write(stream, (const uint8_t*)data->iso14443_3a_data, sizeof(Iso14443_3aData)) !=
+           sizeof(Iso14443_3aData))
+            break;
+
+        uint8_t type = data->type;
+        if(stream_write(stream, &type, sizeof(type)) != sizeof(type)) break;
+
+        if(stream_write(
+               stream, (const uint8_t*)data->block_read_mask, sizeof(data->block_read_mask)) !=
+           sizeof(data->block_read_mask))
+            break;
+        if(stream_write(stream, (const uint8_t*)&data->key_a_mask, sizeof(data->key_a_mask)) !=
+           sizeof(data->key_a_mask))
+            break;
+        if(stream_write(stream, (const uint8_t*)&data->key_b_mask, sizeof(data->key_b_mask)) !=
+           sizeof(data->key_b_mask))
+            break;
+
+        size_t blocks_size = mf_classic_get_total_block_num(data->type) * sizeof(MfClassicBlock);
+        if(stream_write(stream, (const uint8_t*)data->block, blocks_size) != blocks_size) break;
+
+        saved = true;
+    } while(false);
+
+    return saved;
+}
+
 bool mf_classic_is_equal(const MfClassicData* data, const MfClassicData* other) {
     bool is_equal = false;
     bool data_array_is_equal = true;
@@ -52,11 +52,25 @@ static NfcCommand mf_desfire_poller_handler_idle(MfDesfirePoller* instance) {
     bit_buffer_reset(instance->tx_buffer);
     bit_buffer_reset(instance->rx_buffer);
 
-    iso14443_4a_copy(
-        instance->data->iso14443_4a_data,
-        iso14443_4a_poller_get_data(instance->iso14443_4a_poller));
+    const Iso14443_4aData* iso14443_4a_data =
+        iso14443_4a_poller_get_data(instance->iso14443_4a_poller);
+
+    // Data read before an error is kept while the same card is being read
+    if((instance->resume_state > MfDesfirePollerStateReadVersion) &&
+       iso14443_4a_is_equal(instance->data->iso14443_4a_data, iso14443_4a_data)) {
+        FURI_LOG_D(TAG, "Resuming read");
+        instance->stats.resumed++;
+        instance->state = instance->resume_state;
+    } else {
+        iso14443_4a_copy(instance->data->iso14443_4a_data, iso14443_4a_data);
+        memset(&instance->stats, 0, sizeof(MfDesfirePollerStats));
+        instance->applications_read = 0;
+        instance->state = MfDesfirePollerStateReadVersion;
+    }
+
+    instance->phase = MfDesfirePollerPhaseCard;
+    instance->phase_start = furi_get_tick();
 
-    instance->state = MfDesfirePollerStateReadVersion;
     return NfcCommandContinue;
 }
 
@@ -121,6 +135,7 @@ static NfcCommand mf_desfire_poller_handler_read_master_key_version(MfDesfirePol
 }
 
 static NfcCommand mf_desfire_poller_handler_read_application_ids(MfDesfirePoller* instance) {
+    mf_desfire_poller_set_phase(instance, MfDesfirePollerPhaseApplicationIds);
     instance->error =
         mf_desfire_poller_read_application_ids(instance, instance->data->application_ids);
     if(instance->error == MfDesfireErrorNone) {
@@ -136,8 +151,15 @@ static NfcCommand mf_desfire_poller_handler_read_application_ids(MfDesfirePoller
 }
 
 static NfcCommand mf_desfire_poller_handler_read_applications(MfDesfirePoller* instance) {
-    instance->error = mf_desfire_poller_read_applications(
-        instance, instance->data->application_ids, instance->data->applications);
+    // Applications read before a failure are not read again
+    instance->error = mf_desfire_poller_read_applications_from(
+        instance,
+        instance->data->application_ids,
+        instance->data->applications,
+        &instance->applications_read);
+    // Account the time of the last phase
+    mf_desfire_poller_set_phase(instance, instance->phase);
+
     if(instance->error == MfDesfireErrorNone) {
         FURI_LOG_D(TAG, "Read applications success");
         instance->state = MfDesfirePollerStateReadSuccess;
@@ -153,6 +175,7 @@ static NfcCommand mf_desfire_poller_handler_read_applications(MfDesfirePoller* i
 static NfcCommand mf_desfire_poller_handler_read_fail(MfDesfirePoller* instance) {
     FURI_LOG_D(TAG, "Read Failed");
     iso14443_4a_poller_halt(instance->iso14443_4a_poller);
+    instance->mf_desfire_event.type = MfDesfirePollerEventTypeReadFailed;
     instance->mf_desfire_event.data->error = instance->error;
     NfcCommand command = instance->callback(instance->general_event, instance->context);
     instance->state = MfDesfirePollerStateIdle;
@@ -162,7 +185,10 @@ static NfcCommand mf_desfire_poller_handler_read_fail(MfDesfirePoller* instance)
 static NfcCommand mf_desfire_poller_handler_read_success(MfDesfirePoller* instance) {
     FURI_LOG_D(TAG, "Read success.");
     iso14443_4a_poller_halt(instance->iso14443_4a_poller);
+    // Next read starts over, even for the same card
+    instance->resume_state = MfDesfirePollerStateIdle;
     instance->mf_desfire_event.type = MfDesfirePollerEventTypeReadSuccess;
+    instance->mf_desfire_event.data->stats = &instance->stats;
     NfcCommand command = instance->callback(instance->general_event, instance->context);
     return command;
 }
@@ -205,6 +231,10 @@ static NfcCommand mf_desfire_poller_run(NfcGenericEvent event, void* context) {
 
     if(iso14443_4a_event->type == Iso14443_4aPollerEventTypeReady) {
         command = mf_desfire_poller_read_handler[instance->state](instance);
+        if((instance->state > MfDesfirePollerStateReadVersion) &&
+           (instance->state < MfDesfirePollerStateReadFailed)) {
+            instance->resume_state = instance->state;
+        }
     } else if(iso14443_4a_event->type == Iso14443_4aPollerEventTypeError) {
         instance->mf_desfire_event.type = MfDesfirePollerEventTypeReadFailed;
         command = instance->callback(instance->general_event, instance->context);
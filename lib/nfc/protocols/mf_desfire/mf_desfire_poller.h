@@ -21,11 +21,36 @@ typedef enum {
     MfDesfirePollerEventTypeReadFailed, /**< Poller failed to read card. */
 } MfDesfirePollerEventType;
 
+/**
+ * @brief Phases of reading a MfDesfire card.
+ */
+typedef enum {
+    MfDesfirePollerPhaseCard, /**< Version, free memory and master key. */
+    MfDesfirePollerPhaseApplicationIds, /**< Application identifiers. */
+    MfDesfirePollerPhaseApplicationSelect, /**< Application selection. */
+    MfDesfirePollerPhaseApplicationKeys, /**< Application key settings and versions. */
+    MfDesfirePollerPhaseFileSettings, /**< File identifiers and settings. */
+    MfDesfirePollerPhaseFileData, /**< File contents. */
+
+    MfDesfirePollerPhaseNum,
+} MfDesfirePollerPhase;
+
+/**
+ * @brief MfDesfire card read statistics.
+ */
+typedef struct {
+    uint32_t time_ms[MfDesfirePollerPhaseNum]; /**< Time spent in each phase. */
+    uint32_t frames[MfDesfirePollerPhaseNum]; /**< Frames exchanged in each phase. */
+    uint32_t files_skipped; /**< Files not read because they require authentication. */
+    uint32_t resumed; /**< Times the read was resumed after an error. */
+} MfDesfirePollerStats;
+
 /**
  * @brief MfDesfire poller event data.
  */
 typedef union {
     MfDesfireError error; /**< Error code indicating card reading fail reason. */
+    const MfDesfirePollerStats* stats; /**< Read statistics, valid on read success. */
 } MfDesfirePollerEventData;
 
 /**
@@ -247,6 +272,10 @@ MfDesfireError mf_desfire_poller_read_file_data_multi(
  *
  * Must ONLY be used inside the callback function.
  *
+ * Data of files that can not be read without authentication is left empty
+ * and no request is sent for them. Files larger than a single response are
+ * read in several requests.
+ *
  * @param[in, out] instance pointer to the instance to be used in the transaction.
  * @param[out] data pointer to the MfDesfireApplication structure to be filled with application data.
  * @return MfDesfireErrorNone on success, an error code on failure.
@@ -259,6 +288,8 @@ MfDesfireError
  *
  * Must ONLY be used inside the callback function.
  *
+ * Reading stops at the first application that fails.
+ *
  * @param[in, out] instance pointer to the instance to be used in the transaction.
  * @param[in] app_ids pointer to the SimpleArray structure array with application ids to read data from.
  * @param[out] data pointer to the SimpleArray structure array to be filled with applications data.
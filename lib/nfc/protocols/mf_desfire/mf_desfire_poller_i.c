@@ -6,6 +6,11 @@
 
 #define TAG "MfDesfirePoller"
 
+#define MF_DESFIRE_ACCESS_FREE (0xE)
+#define MF_DESFIRE_ACCESS_READ(access_rights) (((access_rights) >> 12) & 0xF)
+#define MF_DESFIRE_ACCESS_WRITE(access_rights) (((access_rights) >> 8) & 0xF)
+#define MF_DESFIRE_ACCESS_READ_WRITE(access_rights) (((access_rights) >> 4) & 0xF)
+
 MfDesfireError mf_desfire_process_error(Iso14443_4aError error) {
     switch(error) {
     case Iso14443_4aErrorNone:
@@ -19,6 +24,16 @@ MfDesfireError mf_desfire_process_error(Iso14443_4aError error) {
     }
 }
 
+void mf_desfire_poller_set_phase(MfDesfirePoller* instance, MfDesfirePollerPhase phase) {
+    furi_assert(instance);
+    furi_assert(phase < MfDesfirePollerPhaseNum);
+
+    const uint32_t now = furi_get_tick();
+    instance->stats.time_ms[instance->phase] += now - instance->phase_start;
+    instance->phase = phase;
+    instance->phase_start = now;
+}
+
 MfDesfireError mf_desfire_send_chunks(
     MfDesfirePoller* instance,
     const BitBuffer* tx_buffer,
@@ -35,6 +50,7 @@ MfDesfireError mf_desfire_send_chunks(
     do {
         Iso14443_4aError iso14443_4a_error = iso14443_4a_poller_send_block(
             instance->iso14443_4a_poller, tx_buffer, instance->rx_buffer);
+        instance->stats.frames[instance->phase]++;
 
         if(iso14443_4a_error != Iso14443_4aErrorNone) {
             error = mf_desfire_process_error(iso14443_4a_error);
@@ -53,6 +69,7 @@ MfDesfireError mf_desfire_send_chunks(
         while(bit_buffer_starts_with_byte(instance->rx_buffer, MF_DESFIRE_FLAG_HAS_NEXT)) {
             Iso14443_4aError iso14443_4a_error = iso14443_4a_poller_send_block(
                 instance->iso14443_4a_poller, instance->tx_buffer, instance->rx_buffer);
+            instance->stats.frames[instance->phase]++;
 
             if(iso14443_4a_error != Iso14443_4aErrorNone) {
                 error = mf_desfire_process_error(iso14443_4a_error);
@@ -377,6 +394,61 @@ MfDesfireError mf_desfire_poller_read_file_records(
     return error;
 }
 
+// Reads larger than the result buffer are split, the card chains each part by itself
+static MfDesfireError mf_desfire_poller_read_file_data_split(
+    MfDesfirePoller* instance,
+    MfDesfireFileId id,
+    size_t size,
+    MfDesfireFileData* data) {
+    const size_t part_size_max = bit_buffer_get_capacity_bytes(instance->result_buffer);
+    if(size <= part_size_max) {
+        return mf_desfire_poller_read_file_data(instance, id, 0, size, data);
+    }
+
+    MfDesfireError error = MfDesfireErrorNone;
+    simple_array_init(data->data, size);
+    uint8_t* file_data = simple_array_get_data(data->data);
+
+    for(size_t offset = 0; offset < size;) {
+        const size_t part_size = MIN(size - offset, part_size_max);
+
+        bit_buffer_reset(instance->input_buffer);
+        bit_buffer_append_byte(instance->input_buffer, MF_DESFIRE_CMD_READ_DATA);
+        bit_buffer_append_byte(instance->input_buffer, id);
+        bit_buffer_append_bytes(instance->input_buffer, (const uint8_t*)&offset, 3);
+        bit_buffer_append_bytes(instance->input_buffer, (const uint8_t*)&part_size, 3);
+
+        error = mf_desfire_send_chunks(instance, instance->input_buffer, instance->result_buffer);
+        if(error != MfDesfireErrorNone) break;
+
+        if(bit_buffer_get_size_bytes(instance->result_buffer) != part_size) {
+            error = MfDesfireErrorProtocol;
+            break;
+        }
+        bit_buffer_write_bytes(instance->result_buffer, &file_data[offset], part_size);
+        offset += part_size;
+    }
+
+    if(error != MfDesfireErrorNone) {
+        simple_array_reset(data->data);
+    }
+
+    return error;
+}
+
+static bool mf_desfire_poller_is_file_readable(const MfDesfireFileSettings* settings) {
+    const MfDesfireFileAccessRights access_rights = settings->access_rights;
+
+    bool readable = (MF_DESFIRE_ACCESS_READ(access_rights) == MF_DESFIRE_ACCESS_FREE) ||
+                    (MF_DESFIRE_ACCESS_READ_WRITE(access_rights) == MF_DESFIRE_ACCESS_FREE);
+    // Value can also be read with write access
+    if(settings->type == MfDesfireFileTypeValue) {
+        readable |= MF_DESFIRE_ACCESS_WRITE(access_rights) == MF_DESFIRE_ACCESS_FREE;
+    }
+
+    return readable;
+}
+
 MfDesfireError mf_desfire_poller_read_file_data_multi(
     MfDesfirePoller* instance,
     const SimpleArray* file_ids,
@@ -399,9 +471,15 @@ MfDesfireError mf_desfire_poller_read_file_data_multi(
 
         MfDesfireFileData* file_data = simple_array_get(data, i);
 
+        // Card would only answer with an authentication error
+        if(!mf_desfire_poller_is_file_readable(file_settings_cur)) {
+            instance->stats.files_skipped++;
+            continue;
+        }
+
         if(file_type == MfDesfireFileTypeStandard || file_type == MfDesfireFileTypeBackup) {
-            error = mf_desfire_poller_read_file_data(
-                instance, file_id, 0, file_settings_cur->data.size, file_data);
+            error = mf_desfire_poller_read_file_data_split(
+                instance, file_id, file_settings_cur->data.size, file_data);
         } else if(file_type == MfDesfireFileTypeValue) {
             error = mf_desfire_poller_read_file_value(instance, file_id, file_data);
         } else if(
@@ -425,6 +503,7 @@ MfDesfireError
     MfDesfireError error;
 
     do {
+        mf_desfire_poller_set_phase(instance, MfDesfirePollerPhaseApplicationKeys);
         error = mf_desfire_poller_read_key_settings(instance, &data->key_settings);
         if(error != MfDesfireErrorNone) break;
 
@@ -432,6 +511,7 @@ MfDesfireError
             instance, data->key_versions, data->key_settings.max_keys);
         if(error != MfDesfireErrorNone) break;
 
+        mf_desfire_poller_set_phase(instance, MfDesfirePollerPhaseFileSettings);
         error = mf_desfire_poller_read_file_ids(instance, data->file_ids);
         if(error != MfDesfireErrorNone) break;
 
@@ -439,6 +519,7 @@ MfDesfireError
             instance, data->file_ids, data->file_settings);
         if(error != MfDesfireErrorNone) break;
 
+        mf_desfire_poller_set_phase(instance, MfDesfirePollerPhaseFileData);
         error = mf_desfire_poller_read_file_data_multi(
             instance, data->file_ids, data->file_settings, data->file_data);
         if(error != MfDesfireErrorNone) break;
@@ -448,29 +529,45 @@ MfDesfireError
     return error;
 }
 
-MfDesfireError mf_desfire_poller_read_applications(
+MfDesfireError mf_desfire_poller_read_applications_from(
     MfDesfirePoller* instance,
     const SimpleArray* app_ids,
-    SimpleArray* data) {
+    SimpleArray* data,
+    uint32_t* applications_read) {
     furi_assert(instance);
+    furi_assert(applications_read);
 
     MfDesfireError error = MfDesfireErrorNone;
 
     const uint32_t app_id_count = simple_array_get_count(app_ids);
-    if(app_id_count > 0) {
+    if((*applications_read == 0) && (app_id_count > 0)) {
         simple_array_init(data, app_id_count);
     }
 
-    for(uint32_t i = 0; i < app_id_count; ++i) {
-        do {
-            error = mf_desfire_poller_select_application(instance, simple_array_cget(app_ids, i));
-            if(error != MfDesfireErrorNone) break;
+    // Only applications read completely are counted, a failed one is read again
+    while(*applications_read < app_id_count) {
+        const uint32_t i = *applications_read;
+
+        mf_desfire_poller_set_phase(instance, MfDesfirePollerPhaseApplicationSelect);
+        error = mf_desfire_poller_select_application(instance, simple_array_cget(app_ids, i));
+        if(error != MfDesfireErrorNone) break;
 
-            MfDesfireApplication* current_app = simple_array_get(data, i);
-            error = mf_desfire_poller_read_application(instance, current_app);
+        MfDesfireApplication* current_app = simple_array_get(data, i);
+        error = mf_desfire_poller_read_application(instance, current_app);
+        if(error != MfDesfireErrorNone) break;
 
-        } while(false);
+        (*applications_read)++;
     }
 
     return error;
 }
+
+MfDesfireError mf_desfire_poller_read_applications(
+    MfDesfirePoller* instance,
+    const SimpleArray* app_ids,
+    SimpleArray* data) {
+    furi_assert(instance);
+
+    uint32_t applications_read = 0;
+    return mf_desfire_poller_read_applications_from(instance, app_ids, data, &applications_read);
+}
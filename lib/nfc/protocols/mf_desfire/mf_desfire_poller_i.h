@@ -34,6 +34,11 @@ struct MfDesfirePoller {
     MfDesfirePollerState state;
     MfDesfireError error;
     MfDesfireData* data;
+    MfDesfirePollerState resume_state;
+    uint32_t applications_read;
+    MfDesfirePollerPhase phase;
+    uint32_t phase_start;
+    MfDesfirePollerStats stats;
     BitBuffer* tx_buffer;
     BitBuffer* rx_buffer;
     BitBuffer* input_buffer;
@@ -47,6 +52,14 @@ struct MfDesfirePoller {
 
 MfDesfireError mf_desfire_process_error(Iso14443_4aError error);
 
+void mf_desfire_poller_set_phase(MfDesfirePoller* instance, MfDesfirePollerPhase phase);
+
+MfDesfireError mf_desfire_poller_read_applications_from(
+    MfDesfirePoller* instance,
+    const SimpleArray* app_ids,
+    SimpleArray* data,
+    uint32_t* applications_read);
+
 const MfDesfireData* mf_desfire_poller_get_data(MfDesfirePoller* instance);
 
 #ifdef __cplusplus
@@ -25,6 +25,9 @@ typedef struct {
 
 static const uint32_t mf_ultralight_data_format_version = 2;
 
+static bool mf_ultralight_load_binary(MfUltralightData* data, Stream* stream);
+static bool mf_ultralight_save_binary(const MfUltralightData* data, Stream* stream);
+
 static const MfUltralightFeatures mf_ultralight_features[MfUltralightTypeNum] = {
     [MfUltralightTypeUnknown] =
         {
@@ -166,6 +169,9 @@ const NfcDeviceBase nfc_device_mf_ultralight = {
     .get_uid = (NfcDeviceGetUid)mf_ultralight_get_uid,
     .set_uid = (NfcDeviceSetUid)mf_ultralight_set_uid,
     .get_base_data = (NfcDeviceGetBaseData)mf_ultralight_get_base_data,
+    .load_binary = (NfcDeviceLoadBinary)mf_ultralight_load_binary,
+    .save_binary = (NfcDeviceSaveBinary)mf_ultralight_save_binary,
+    .binary_data_size = sizeof(Iso14443_3aData) + sizeof(MfUltralightData),
 };
 
 MfUltralightData* mf_ultralight_alloc() {
@@ -309,14 +315,13 @@ bool mf_ultralight_load(MfUltralightData* data, FlipperFormat* ff, uint32_t vers
         if((pages_read > MF_ULTRALIGHT_MAX_PAGE_NUM) || (pages_total > MF_ULTRALIGHT_MAX_PAGE_NUM))
             break;
 
+        // Pages are stored in order, so each key is found on the next line
         bool pages_parsed = true;
+        char page_key[sizeof(MF_ULTRALIGHT_PAGE_KEY " 65535")];
         for(size_t i = 0; i < pages_total; i++) {
-            furi_string_printf(temp_str, "%s %d", MF_ULTRALIGHT_PAGE_KEY, i);
+            snprintf(page_key, sizeof(page_key), "%s %zu", MF_ULTRALIGHT_PAGE_KEY, i);
             if(!flipper_format_read_hex(
-                   ff,
-                   furi_string_get_cstr(temp_str),
-                   data->page[i].data,
-                   sizeof(MfUltralightPage))) {
+                   ff, page_key, data->page[i].data, sizeof(MfUltralightPage))) {
                 pages_parsed = false;
                 break;
             }
@@ -418,6 +423,103 @@ bool mf_ultralight_save(const MfUltralightData* data, FlipperFormat* ff) {
     return saved;
 }
 
+static bool mf_ultralight_load_binary(MfUltralightData* data, Stream* stream) {
+    furi_assert(data);
+    furi_assert(stream);
+
+    bool loaded = false;
+
+    do {
+        if(stream_read(stream, (uint8_t*)data->iso14443_3a_data, sizeof(Iso14443_3aData)) !=
+           sizeof(Iso14443_3aData))
+            break;
+
+        uint8_t type = 0;
+        if(stream_read(stream, &type, sizeof(type)) != sizeof(type)) break;
+        if(type >= MfUltralightTypeNum) break;
+        data->type = type;
+
+        if(stream_read(stream, (uint8_t*)&data->version, sizeof(data->version)) !=
+           sizeof(data->version))
+            break;
+        if(stream_read(stream, (uint8_t*)&data->signature, sizeof(data->signature)) !=
+           sizeof(data->signature))
+            break;
+        if(stream_read(stream, (uint8_t*)data->counter, sizeof(data->counter)) !=
+           sizeof(data->counter))
+            break;
+        if(stream_read(stream, (uint8_t*)data->tearing_flag, sizeof(data->tearing_flag)) !=
+           sizeof(data->tearing_flag))
+            break;
+        if(stream_read(stream, (uint8_t*)&data->pages_read, sizeof(data->pages_read)) !=
+           sizeof(data->pages_read))
+            break;
+        if(stream_read(stream, (uint8_t*)&data->pages_total, sizeof(data->pages_total)) !=
+           sizeof(data->pages_total))
+            break;
+        if(stream_read(stream, (uint8_t*)&data->auth_attempts, sizeof(data->auth_attempts)) !=
+           sizeof(data->auth_attempts))
+            break;
+
+        if((data->pages_read > MF_ULTRALIGHT_MAX_PAGE_NUM) ||
+           (data->pages_total > MF_ULTRALIGHT_MAX_PAGE_NUM))
+            break;
+
+        size_t pages_size = data->pages_total * sizeof(MfUltralightPage);
+        if(stream_read(stream, (uint8_t*)data->page, pages_size) != pages_size) break;
+
+        loaded = true;
+    } while(false);
+
+    return loaded;
+}
+
+static bool mf_ultralight_save_binary(const MfUltralightData* data, Stream* stream) {
+    furi_assert(data);
+    furi_assert(stream);
+
+    bool saved = false;
+
+    do {
+        if(stream_write(stream, (const uint8_t*)data->iso14443_3a_data, sizeof(Iso14443_3aData)) !=
+           sizeof(Iso14443_3aData))
+            break;
+
+        uint8_t type = data->type;
+        if(stream_write(stream, &type, sizeof(type)) != sizeof(type)) break;
+
+        if(stream_write(stream, (const uint8_t*)&data->version, sizeof(data->version)) !=
+           sizeof(data->version))
+            break;
+        if(stream_write(stream, (const uint8_t*)&data->signature, sizeof(data->signature)) !=
+           sizeof(data->signature))
+            break;
+        if(stream_write(stream, (const uint8_t*)data->counter, sizeof(data->counter)) !=
+           sizeof(data->counter))
+            break;
+        if(stream_write(stream, (const uint8_t*)data->tearing_flag, sizeof(data->tearing_flag)) !=
+           sizeof(data->tearing_flag))
+            break;
+        if(stream_write(stream, (const uint8_t*)&data->pages_read, sizeof(data->pages_read)) !=
+           sizeof(data->pages_read))
+            break;
+        if(stream_write(stream, (const uint8_t*)&data->pages_total, sizeof(data->pages_total)) !=
+           sizeof(data->pages_total))
+            break;
+        if(stream_write(
+               stream, (const uint8_t*)&data->auth_attempts, sizeof(data->auth_attempts)) !=
+           sizeof(data->auth_attempts))
+            break;
+
+        size_t pages_size = data->pages_total * sizeof(MfUltralightPage);
+        if(stream_write(stream, (const uint8_t*)data->page, pages_size) != pages_size) break;
+
+        saved = true;
+    } while(false);
+
+    return saved;
+}
+
 bool mf_ultralight_is_equal(const MfUltralightData* data, const MfUltralightData* other) {
     bool is_equal = false;
     bool data_array_is_equal = true;
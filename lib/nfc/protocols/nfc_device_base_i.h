@@ -10,6 +10,7 @@
 #include "nfc_device_base.h"
 
 #include <flipper_format.h>
+#include <toolbox/stream/stream.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -80,6 +81,28 @@ typedef bool (*NfcDeviceLoad)(NfcDeviceData* data, FlipperFormat* ff, uint32_t v
  */
 typedef bool (*NfcDeviceSave)(const NfcDeviceData* data, FlipperFormat* ff);
 
+/**
+ * @brief Load NFC device data from a binary cache stream.
+ *
+ * The binary layout is private to the protocol and may change between firmware versions,
+ * the caller is responsible for discarding outdated caches. A change of binary_data_size
+ * or of the firmware build invalidates them.
+ *
+ * @param[in,out] data pointer to the instance to be loaded into.
+ * @param[in] stream pointer to the stream positioned at the protocol data.
+ * @returns true if loaded successfully, false otherwise.
+ */
+typedef bool (*NfcDeviceLoadBinary)(NfcDeviceData* data, Stream* stream);
+
+/**
+ * @brief Save NFC device data to a binary cache stream.
+ *
+ * @param[in] data pointer to the instance to be saved.
+ * @param[in] stream pointer to the stream to write the protocol data to.
+ * @returns true if saved successfully, false otherwise.
+ */
+typedef bool (*NfcDeviceSaveBinary)(const NfcDeviceData* data, Stream* stream);
+
 /**
  * @brief Compare two NFC device data instances.
  *
@@ -154,6 +177,9 @@ typedef struct {
     NfcDeviceGetUid get_uid; /**< Pointer to the get_uid() function. */
     NfcDeviceSetUid set_uid; /**< Pointer to the set_uid() function. */
     NfcDeviceGetBaseData get_base_data; /**< Pointer to the get_base_data() function. */
+    NfcDeviceLoadBinary load_binary; /**< Optional pointer to the load_binary() function. */
+    NfcDeviceSaveBinary save_binary; /**< Optional pointer to the save_binary() function. */
+    size_t binary_data_size; /**< Size of the structures saved by save_binary(). */
 } NfcDeviceBase;
 
 #ifdef __cplusplus
@@ -5,9 +5,21 @@
 #include <furi/furi.h>
 
 #define ISO15693_PARSER_SIGNAL_READER_BUFF_SIZE (2)
-#define ISO15693_PARSER_BITSTREAM_BUFF_SIZE (32)
+// Power of two, bytes are consumed in bulk while the reader keeps filling it
+#define ISO15693_PARSER_BITSTREAM_BUFF_SIZE (128)
+#define ISO15693_PARSER_BITSTREAM_BUFF_MASK (ISO15693_PARSER_BITSTREAM_BUFF_SIZE - 1)
+#define ISO15693_PARSER_BITSTREAM_NOTIFY_SIZE (32)
 #define ISO15693_PARSER_BITRATE_F64MHZ (603U)
 
+#define ISO15693_PARSER_SOF_1_OUT_OF_4 (0x21)
+#define ISO15693_PARSER_SOF_1_OUT_OF_256 (0x81)
+#define ISO15693_PARSER_EOF_SINGLE (0x01)
+#define ISO15693_PARSER_EOF (0x04)
+
+#define ISO15693_PARSER_SYMBOL_INVALID (0xFF)
+#define ISO15693_PARSER_SYMBOL_EMPTY (0x10)
+#define ISO15693_PARSER_1_OUT_OF_256_PARTS (64)
+
 #define TAG "Iso15693Parser"
 
 typedef enum {
@@ -29,22 +41,16 @@ struct Iso15693Parser {
 
     SignalReader* signal_reader;
 
+    // Written by the signal reader callback only, read by the parser
     uint8_t bitstream_buff[ISO15693_PARSER_BITSTREAM_BUFF_SIZE];
-    size_t bitstream_idx;
-    uint8_t last_byte;
-
-    bool signal_detected;
-    bool bit_offset_calculated;
-    uint8_t bit_offset;
-    size_t byte_idx;
-    size_t bytes_to_process;
+    volatile size_t bitstream_head;
+    size_t bitstream_tail;
 
     uint8_t next_byte;
     uint16_t next_byte_part;
-    bool zero_found;
 
     BitBuffer* parsed_frame;
-    bool eof_received;
+    volatile bool eof_received;
     bool frame_parsed;
 
     Iso15693ParserCallback callback;
@@ -60,6 +66,46 @@ typedef enum {
 
 typedef Iso15693ParserCommand (*Iso15693ParserStateHandler)(Iso15693Parser* instance);
 
+// Bitstream byte to the 2 bit symbol it encodes
+static const uint8_t iso15693_parser_1_out_of_4_symbols[256] = {
+    0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// Bitstream byte to the slot of its pulse, a byte holds 4 out of 256 slots
+static const uint8_t iso15693_parser_1_out_of_256_slots[256] = {
+    0x10, 0x00, 0x00, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
 Iso15693Parser* iso15693_parser_alloc(const GpioPin* pin, size_t max_frame_size) {
     Iso15693Parser* instance = malloc(sizeof(Iso15693Parser));
     instance->parsed_frame = bit_buffer_alloc(max_frame_size);
@@ -87,73 +133,75 @@ void iso15693_parser_reset(Iso15693Parser* instance) {
 
     instance->state = Iso15693ParserStateParseSoF;
     instance->mode = Iso15693ParserMode1OutOf4;
-    memset(instance->bitstream_buff, 0x00, sizeof(instance->bitstream_buff));
-    instance->bitstream_idx = 0;
+    instance->bitstream_head = 0;
+    instance->bitstream_tail = 0;
 
     instance->next_byte = 0;
     instance->next_byte_part = 0;
 
-    instance->bit_offset = 0;
-    instance->byte_idx = 0;
-    instance->bytes_to_process = 0;
-    instance->signal_detected = false;
-    instance->bit_offset_calculated = false;
-
-    instance->last_byte = 0x00;
-    instance->zero_found = false;
     instance->eof_received = false;
 
     bit_buffer_reset(instance->parsed_frame);
     instance->frame_parsed = false;
 }
 
-static void signal_reader_callback(SignalReaderEvent event, void* context) {
-    furi_assert(context);
-    furi_assert(event.data->data);
-    furi_assert(event.data->len == ISO15693_PARSER_SIGNAL_READER_BUFF_SIZE / 2);
+static void iso15693_parser_push_data(Iso15693Parser* instance, uint8_t data) {
+    const size_t head = instance->bitstream_head;
+    if(head - instance->bitstream_tail == ISO15693_PARSER_BITSTREAM_BUFF_SIZE) {
+        instance->state = Iso15693ParserStateFail;
+    } else {
+        instance->bitstream_buff[head & ISO15693_PARSER_BITSTREAM_BUFF_MASK] = data;
+        instance->bitstream_head = head + 1;
+    }
+}
 
-    Iso15693Parser* instance = context;
-    furi_assert(instance->callback);
+// Returns true when the parser has to be run
+static bool iso15693_parser_push(Iso15693Parser* instance, uint8_t data) {
+    bool notify = false;
 
-    const uint8_t sof_1_out_of_4 = 0x21;
-    const uint8_t sof_1_out_of_256 = 0x81;
-    const uint8_t eof_single = 0x01;
-    const uint8_t eof = 0x04;
+    // Idle line after the frame is not a part of it
+    if(instance->eof_received) return notify;
 
+    // Reader starts sampling on the first edge, so the SoF also aligns the whole frame
     if(instance->state == Iso15693ParserStateParseSoF) {
-        if(event.data->data[0] == sof_1_out_of_4) {
+        if(data == ISO15693_PARSER_SOF_1_OUT_OF_4) {
             instance->mode = Iso15693ParserMode1OutOf4;
             instance->state = Iso15693ParserStateParseFrame;
-        } else if(event.data->data[0] == sof_1_out_of_256) {
+        } else if(data == ISO15693_PARSER_SOF_1_OUT_OF_256) {
             instance->mode = Iso15693ParserMode1OutOf256;
             instance->state = Iso15693ParserStateParseFrame;
-        } else if(event.data->data[0] == eof_single) {
+        } else if(data == ISO15693_PARSER_EOF_SINGLE) {
             instance->eof_received = true;
-            instance->callback(Iso15693ParserEventDataReceived, instance->context);
+            notify = true;
         } else {
             instance->state = Iso15693ParserStateFail;
-            instance->callback(Iso15693ParserEventDataReceived, instance->context);
+            notify = true;
         }
-    } else {
-        if(instance->mode == Iso15693ParserMode1OutOf4) {
-            if(event.data->data[0] == eof) {
-                instance->eof_received = true;
-                instance->callback(Iso15693ParserEventDataReceived, instance->context);
-            } else {
-                instance->bitstream_buff[instance->bytes_to_process] = event.data->data[0];
-                instance->bytes_to_process++;
-                if(instance->bytes_to_process == ISO15693_PARSER_BITSTREAM_BUFF_SIZE) {
-                    instance->callback(Iso15693ParserEventDataReceived, instance->context);
-                }
-            }
+    } else if(instance->state == Iso15693ParserStateParseFrame) {
+        if((instance->mode == Iso15693ParserMode1OutOf4) && (data == ISO15693_PARSER_EOF)) {
+            instance->eof_received = true;
+            notify = true;
         } else {
-            instance->bitstream_buff[instance->bytes_to_process] = event.data->data[0];
-            instance->bytes_to_process++;
-            if(instance->bytes_to_process == ISO15693_PARSER_BITSTREAM_BUFF_SIZE) {
-                instance->callback(Iso15693ParserEventDataReceived, instance->context);
-            }
+            iso15693_parser_push_data(instance, data);
+            notify = (instance->state == Iso15693ParserStateFail) ||
+                     ((instance->bitstream_head % ISO15693_PARSER_BITSTREAM_NOTIFY_SIZE) == 0);
         }
     }
+
+    return notify;
+}
+
+static void signal_reader_callback(SignalReaderEvent event, void* context) {
+    furi_assert(context);
+    furi_assert(event.data->data);
+    furi_assert(event.data->len == ISO15693_PARSER_SIGNAL_READER_BUFF_SIZE / 2);
+
+    Iso15693Parser* instance = context;
+    furi_assert(instance->callback);
+
+    if(iso15693_parser_push(instance, event.data->data[0])) {
+        instance->callback(Iso15693ParserEventDataReceived, instance->context);
+    }
 }
 
 static void iso15693_parser_start_signal_reader(Iso15693Parser* instance) {
@@ -179,30 +227,61 @@ void iso15693_parser_stop(Iso15693Parser* instance) {
     signal_reader_stop(instance->signal_reader);
 }
 
-static Iso15693ParserCommand iso15693_parser_parse_1_out_of_4(Iso15693Parser* instance) {
+size_t iso15693_parser_feed(Iso15693Parser* instance, const uint8_t* data, size_t data_size) {
+    furi_assert(instance);
+    furi_assert(data);
+
+    size_t fed = 0;
+    while((fed < data_size) && (instance->state != Iso15693ParserStateFail)) {
+        const bool notify = iso15693_parser_push(instance, data[fed++]);
+        if(notify) break;
+    }
+
+    return fed;
+}
+
+static inline uint8_t iso15693_parser_get_bitstream(Iso15693Parser* instance, size_t offset) {
+    return instance->bitstream_buff
+        [(instance->bitstream_tail + offset) & ISO15693_PARSER_BITSTREAM_BUFF_MASK];
+}
+
+static Iso15693ParserCommand
+    iso15693_parser_parse_1_out_of_4(Iso15693Parser* instance, size_t bytes_to_process) {
     Iso15693ParserCommand command = Iso15693ParserCommandWaitData;
-    const uint8_t bit_patterns_1_out_of_4[] = {0x02, 0x08, 0x20, 0x80};
-
-    for(size_t i = 0; i < instance->bytes_to_process; i++) {
-        // Check next pattern
-        size_t j = 0;
-        for(j = 0; j < COUNT_OF(bit_patterns_1_out_of_4); j++) {
-            if(instance->bitstream_buff[i] == bit_patterns_1_out_of_4[j]) {
-                instance->next_byte |= j << (instance->next_byte_part * 2);
-                instance->next_byte_part++;
-                if(instance->next_byte_part == 4) {
-                    instance->next_byte_part = 0;
-                    bit_buffer_append_byte(instance->parsed_frame, instance->next_byte);
-                    instance->next_byte = 0;
-                }
+    const uint8_t* symbols = iso15693_parser_1_out_of_4_symbols;
+
+    size_t i = 0;
+    while(i < bytes_to_process) {
+        // Whole bytes are decoded at once, invalid patterns set the high bits
+        if((instance->next_byte_part == 0) && (bytes_to_process - i >= 4)) {
+            const uint8_t s0 = symbols[iso15693_parser_get_bitstream(instance, i)];
+            const uint8_t s1 = symbols[iso15693_parser_get_bitstream(instance, i + 1)];
+            const uint8_t s2 = symbols[iso15693_parser_get_bitstream(instance, i + 2)];
+            const uint8_t s3 = symbols[iso15693_parser_get_bitstream(instance, i + 3)];
+            if((s0 | s1 | s2 | s3) & ~0x03U) {
+                command = Iso15693ParserCommandFail;
                 break;
             }
-        }
-        if(j == COUNT_OF(bit_patterns_1_out_of_4)) {
-            command = Iso15693ParserCommandFail;
-            break;
+            bit_buffer_append_byte(
+                instance->parsed_frame, s0 | (s1 << 2) | (s2 << 4) | (s3 << 6));
+            i += 4;
+        } else {
+            const uint8_t symbol = symbols[iso15693_parser_get_bitstream(instance, i)];
+            if(symbol == ISO15693_PARSER_SYMBOL_INVALID) {
+                command = Iso15693ParserCommandFail;
+                break;
+            }
+            instance->next_byte |= symbol << (instance->next_byte_part * 2);
+            instance->next_byte_part++;
+            if(instance->next_byte_part == 4) {
+                instance->next_byte_part = 0;
+                bit_buffer_append_byte(instance->parsed_frame, instance->next_byte);
+                instance->next_byte = 0;
+            }
+            i++;
         }
     }
+    instance->bitstream_tail += i;
 
     if(command != Iso15693ParserCommandFail) {
         if(instance->eof_received) {
@@ -211,64 +290,61 @@ static Iso15693ParserCommand iso15693_parser_parse_1_out_of_4(Iso15693Parser* in
         }
     }
 
-    instance->bytes_to_process = 0;
-
     return command;
 }
 
-static Iso15693ParserCommand iso15693_parser_parse_1_out_of_256(Iso15693Parser* instance) {
+static Iso15693ParserCommand
+    iso15693_parser_parse_1_out_of_256(Iso15693Parser* instance, size_t bytes_to_process) {
     Iso15693ParserCommand command = Iso15693ParserCommandWaitData;
-    const uint8_t eof = 0x04;
-
-    for(size_t i = instance->byte_idx; i < instance->bytes_to_process; i++) {
-        // Check EoF
-        if(instance->next_byte_part == 0) {
-            if(instance->bitstream_buff[i] == eof) {
-                instance->frame_parsed = true;
-                command = Iso15693ParserCommandSuccess;
-                break;
-            }
+    const uint8_t* slots = iso15693_parser_1_out_of_256_slots;
+
+    size_t i = 0;
+    for(; i < bytes_to_process; i++) {
+        const uint8_t data = iso15693_parser_get_bitstream(instance, i);
+
+        if((instance->next_byte_part == 0) && (data == ISO15693_PARSER_EOF)) {
+            instance->frame_parsed = true;
+            command = Iso15693ParserCommandSuccess;
+            break;
         }
 
-        if(instance->zero_found) {
-            if(instance->bitstream_buff[i] != 0x00) {
-                command = Iso15693ParserCommandFail;
-                break;
-            }
-        } else {
-            if(instance->bitstream_buff[i] != 0x00) {
-                for(size_t j = 0; j < 8; j++) {
-                    if(FURI_BIT(instance->bitstream_buff[i], j) == 1) {
-                        bit_buffer_append_byte(
-                            instance->parsed_frame, instance->next_byte_part * 4 + j / 2);
-                    }
-                }
-            }
+        const uint8_t slot = slots[data];
+        if(slot == ISO15693_PARSER_SYMBOL_INVALID) {
+            command = Iso15693ParserCommandFail;
+            break;
+        } else if(slot != ISO15693_PARSER_SYMBOL_EMPTY) {
+            bit_buffer_append_byte(instance->parsed_frame, instance->next_byte_part * 4 + slot);
         }
-        instance->next_byte_part = (instance->next_byte_part + 1) % 64;
+        instance->next_byte_part =
+            (instance->next_byte_part + 1) % ISO15693_PARSER_1_OUT_OF_256_PARTS;
     }
-    instance->bytes_to_process = 0;
-    instance->byte_idx = 0;
+    instance->bitstream_tail += i;
 
     return command;
 }
 
-static const Iso15693ParserStateHandler iso15693_parser_state_handlers[Iso15693ParserModeNum] = {
+typedef Iso15693ParserCommand (*Iso15693ParserModeHandler)(
+    Iso15693Parser* instance,
+    size_t bytes_to_process);
+
+static const Iso15693ParserModeHandler iso15693_parser_mode_handlers[Iso15693ParserModeNum] = {
     [Iso15693ParserMode1OutOf4] = iso15693_parser_parse_1_out_of_4,
     [Iso15693ParserMode1OutOf256] = iso15693_parser_parse_1_out_of_256,
 };
 
 bool iso15693_parser_run(Iso15693Parser* instance) {
+    // EoF is flagged after the data preceding it is stored
+    const bool eof_received = instance->eof_received;
+    const size_t bytes_to_process = instance->bitstream_head - instance->bitstream_tail;
+
     if(instance->state == Iso15693ParserStateFail) {
         iso15693_parser_stop(instance);
         iso15693_parser_start_signal_reader(instance);
-    } else if((instance->state == Iso15693ParserStateParseSoF) && (instance->eof_received)) {
+    } else if((instance->state == Iso15693ParserStateParseSoF) && eof_received) {
         instance->frame_parsed = true;
-    } else if(instance->bytes_to_process) {
-        Iso15693ParserCommand command = Iso15693ParserCommandProcessed;
-        while(command == Iso15693ParserCommandProcessed) {
-            command = iso15693_parser_state_handlers[instance->mode](instance);
-        }
+    } else if(bytes_to_process || eof_received) {
+        Iso15693ParserCommand command =
+            iso15693_parser_mode_handlers[instance->mode](instance, bytes_to_process);
 
         if(command == Iso15693ParserCommandFail) {
             iso15693_parser_stop(instance);
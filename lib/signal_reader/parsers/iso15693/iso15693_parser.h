@@ -29,6 +29,18 @@ void iso15693_parser_stop(Iso15693Parser* instance);
 
 bool iso15693_parser_run(Iso15693Parser* instance);
 
+/** Feed bitstream sampled elsewhere instead of the signal reader
+ *
+ * Bytes are accepted until the parser has to be run, e.g. to replay a recorded frame.
+ *
+ * @param      instance   Iso15693Parser instance
+ * @param      data       bitstream, one byte per 8 samples
+ * @param      data_size  bitstream size in bytes
+ *
+ * @return     number of bytes accepted
+ */
+size_t iso15693_parser_feed(Iso15693Parser* instance, const uint8_t* data, size_t data_size);
+
 size_t iso15693_parser_get_data_size_bytes(Iso15693Parser* instance);
 
 void iso15693_parser_get_data(
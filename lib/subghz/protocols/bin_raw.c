@@ -23,6 +23,8 @@
 #define BIN_RAW_TE_MIN_COUNT 40
 #define BIN_RAW_BUF_MIN_DATA_COUNT 128
 #define BIN_RAW_MAX_MARKUP_COUNT 20
+#define BIN_RAW_CLASSIFY_COUNT 512
+#define BIN_RAW_CLASSIFY_TAIL 100
 
 //#define BIN_RAW_DEBUG
 
@@ -65,6 +67,12 @@ struct BinRAW_Markup {
 };
 typedef struct BinRAW_Markup BinRAW_Markup;
 
+struct BinRAW_Class {
+    float data;
+    uint16_t count;
+};
+typedef struct BinRAW_Class BinRAW_Class;
+
 struct SubGhzProtocolDecoderBinRAW {
     SubGhzProtocolDecoderBase base;
 
@@ -76,6 +84,13 @@ struct SubGhzProtocolDecoderBinRAW {
     size_t data_raw_ind;
     uint32_t te;
     float adaptive_threshold_rssi;
+
+    BinRAW_Class classes[BIN_RAW_SEARCH_CLASSES];
+    size_t classes_ind;
+    bool te_found;
+    uint32_t gap;
+    uint16_t gap_delta;
+    BinRAWType type;
 };
 
 struct SubGhzProtocolEncoderBinRAW {
@@ -380,77 +395,48 @@ void subghz_protocol_decoder_bin_raw_reset(void* context) {
 #endif
 }
 
-void subghz_protocol_decoder_bin_raw_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    SubGhzProtocolDecoderBinRAW* instance = context;
-
-    if(instance->decoder.parser_step == BinRAWDecoderStepWrite) {
-        if(instance->data_raw_ind == BIN_RAW_BUF_RAW_SIZE) {
-            instance->decoder.parser_step = BinRAWDecoderStepBufFull;
-        } else {
-            instance->data_raw[instance->data_raw_ind++] = (level ? duration : -duration);
-        }
-    }
-}
-
 /** 
- * Analysis of received data
+ * Sort durations from the beginning of the record into classes
  * @param instance Pointer to a SubGhzProtocolDecoderBinRAW* instance
+ * @param count Number of durations that must be classified
  */
-static bool
-    subghz_protocol_bin_raw_check_remote_controller(SubGhzProtocolDecoderBinRAW* instance) {
-    struct {
-        float data;
-        uint16_t count;
-    } classes[BIN_RAW_SEARCH_CLASSES];
-
-    size_t ind = 0;
-
-    memset(classes, 0x00, sizeof(classes));
-
-    uint16_t data_markup_ind = 0;
-    memset(instance->data_markup, 0x00, BIN_RAW_MAX_MARKUP_COUNT * sizeof(BinRAW_Markup));
-
-    if(instance->data_raw_ind < 512) {
-        ind =
-            instance->data_raw_ind -
-            100; //there is usually garbage at the end of the record, we exclude it from the classification
-    } else {
-        ind = 512;
-    }
+static void subghz_protocol_bin_raw_classify(SubGhzProtocolDecoderBinRAW* instance, size_t count) {
+    BinRAW_Class* classes = instance->classes;
 
     //sort the durations to find the shortest correlated interval
-    for(size_t i = 0; i < ind; i++) {
+    for(; instance->classes_ind < count; instance->classes_ind++) {
+        float duration = (float)(abs(instance->data_raw[instance->classes_ind]));
         for(size_t k = 0; k < BIN_RAW_SEARCH_CLASSES; k++) {
             if(classes[k].count == 0) {
-                classes[k].data = (float)(abs(instance->data_raw[i]));
+                classes[k].data = duration;
                 classes[k].count++;
                 break;
             } else if(
-                DURATION_DIFF((float)(abs(instance->data_raw[i])), (classes[k].data)) <
+                DURATION_DIFF(duration, (classes[k].data)) <
                 (classes[k].data / 4)) { //if the test value does not differ by more than 25%
-                classes[k].data += ((float)(abs(instance->data_raw[i])) - classes[k].data) *
-                                   0.05f; //running average k=0.05
+                classes[k].data += (duration - classes[k].data) * 0.05f; //running average k=0.05
                 classes[k].count++;
                 break;
             }
         }
     }
+}
 
-    // if(classes[BIN_RAW_SEARCH_CLASSES - 1].count != 0) {
-    //     //filling the classifier, it means that they received an unclean signal
-    //     return false;
-    // }
+/** 
+ * Search te and gap among the duration classes, the classes are sorted by count
+ * @param instance Pointer to a SubGhzProtocolDecoderBinRAW* instance
+ * @return true if a correlated te is found
+ */
+static bool subghz_protocol_bin_raw_check_te(SubGhzProtocolDecoderBinRAW* instance) {
+    BinRAW_Class* classes = instance->classes;
 
     //looking for the minimum te with an occurrence greater than BIN_RAW_TE_MIN_COUNT
     instance->te = subghz_protocol_bin_raw_const.te_long * 2;
 
     bool te_ok = false;
-    uint16_t gap_ind = 0;
-    uint16_t gap_delta = 0;
-    uint32_t gap = 0;
-    int data_temp = 0;
-    BinRAWType bin_raw_type = BinRAWTypeUnknown;
+    instance->gap = 0;
+    instance->gap_delta = 0;
+    instance->type = BinRAWTypeUnknown;
 
     //sort by number of occurrences
     bool swap = true;
@@ -480,7 +466,7 @@ static bool
         //adopted only the preamble
         instance->te = (uint32_t)classes[0].data;
         te_ok = true;
-        gap = 0; //gap no
+        instance->gap = 0; //gap no
     } else {
         //take the 2 most common durations
         //check that there are enough
@@ -515,26 +501,91 @@ static bool
 
         //looking for a gap
         for(size_t k = 2; k < BIN_RAW_SEARCH_CLASSES; k++) {
-            if((classes[k].count > 2) && (classes[k].data > gap)) {
-                gap = (uint32_t)classes[k].data;
-                gap_delta = gap / 5; //calculate 20% deviation from ideal value
+            if((classes[k].count > 2) && (classes[k].data > instance->gap)) {
+                instance->gap = (uint32_t)classes[k].data;
+                instance->gap_delta = instance->gap / 5; //calculate 20% deviation from ideal value
             }
         }
 
-        if((gap / instance->te) <
+        if((instance->gap / instance->te) <
            10) { //make an assumption, the longest gap should be more than 10 TE
-            gap = 0; //check that our signal has a gap greater than 10*TE
-            bin_raw_type = BinRAWTypeNoGap;
+            instance->gap = 0; //check that our signal has a gap greater than 10*TE
+            instance->type = BinRAWTypeNoGap;
+        } else {
+            instance->type = BinRAWTypeGap;
+        }
+    }
+
+    return te_ok;
+}
+
+void subghz_protocol_decoder_bin_raw_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    SubGhzProtocolDecoderBinRAW* instance = context;
+
+    if(instance->decoder.parser_step == BinRAWDecoderStepWrite) {
+        if(instance->data_raw_ind == BIN_RAW_BUF_RAW_SIZE) {
+            instance->decoder.parser_step = BinRAWDecoderStepBufFull;
         } else {
-            bin_raw_type = BinRAWTypeGap;
-            //looking for the last occurrence of gap
-            ind = instance->data_raw_ind - 1;
-            while((ind > 0) && (DURATION_DIFF(abs(instance->data_raw[ind]), gap) > gap_delta)) {
-                ind--;
+            instance->data_raw[instance->data_raw_ind++] = (level ? duration : -duration);
+
+            //classify while receiving, behind the end of the record where garbage usually is
+            if((instance->classes_ind < BIN_RAW_CLASSIFY_COUNT) &&
+               (instance->data_raw_ind > BIN_RAW_CLASSIFY_TAIL)) {
+                subghz_protocol_bin_raw_classify(
+                    instance, instance->data_raw_ind - BIN_RAW_CLASSIFY_TAIL);
+                if(instance->classes_ind == BIN_RAW_CLASSIFY_COUNT) {
+                    //the classes are final, stop recording if there is no correlated te
+                    instance->te_found = subghz_protocol_bin_raw_check_te(instance);
+                    if(!instance->te_found) {
+                        instance->decoder.parser_step = BinRAWDecoderStepNoParse;
+                        instance->generic.data_count_bit = 0;
+                    }
+                }
             }
-            gap_ind = ind;
         }
     }
+}
+
+/** 
+ * Analysis of received data
+ * @param instance Pointer to a SubGhzProtocolDecoderBinRAW* instance
+ */
+static bool
+    subghz_protocol_bin_raw_check_remote_controller(SubGhzProtocolDecoderBinRAW* instance) {
+    BinRAW_Class classes[BIN_RAW_SEARCH_CLASSES];
+
+    size_t ind = 0;
+
+    uint16_t data_markup_ind = 0;
+    memset(instance->data_markup, 0x00, BIN_RAW_MAX_MARKUP_COUNT * sizeof(BinRAW_Markup));
+
+    if(!instance->te_found) {
+        //there is usually garbage at the end of the record, we exclude it from the classification
+        if(instance->data_raw_ind < BIN_RAW_CLASSIFY_COUNT) {
+            ind = instance->data_raw_ind - BIN_RAW_CLASSIFY_TAIL;
+        } else {
+            ind = BIN_RAW_CLASSIFY_COUNT;
+        }
+        //classify what the feed has not classified yet
+        subghz_protocol_bin_raw_classify(instance, ind);
+        if(!subghz_protocol_bin_raw_check_te(instance)) return false;
+    }
+
+    uint16_t gap_ind = 0;
+    uint16_t gap_delta = instance->gap_delta;
+    uint32_t gap = instance->gap;
+    int data_temp = 0;
+    BinRAWType bin_raw_type = instance->type;
+
+    if(bin_raw_type == BinRAWTypeGap) {
+        //looking for the last occurrence of gap
+        ind = instance->data_raw_ind - 1;
+        while((ind > 0) && (DURATION_DIFF(abs(instance->data_raw[ind]), gap) > gap_delta)) {
+            ind--;
+        }
+        gap_ind = ind;
+    }
 
     //if we consider that there is a gap, then we divide the signal with respect to this gap
     //processing input data from the end
@@ -889,8 +940,10 @@ void subghz_protocol_decoder_bin_raw_data_input_rssi(
         bin_raw_debug("%ld %ld :", (int32_t)rssi, (int32_t)instance->adaptive_threshold_rssi);
         if(rssi > (instance->adaptive_threshold_rssi + BIN_RAW_DELTA_RSSI)) {
             instance->data_raw_ind = 0;
-            memset(instance->data_raw, 0x00, BIN_RAW_BUF_RAW_SIZE * sizeof(int32_t));
             memset(instance->data, 0x00, BIN_RAW_BUF_RAW_SIZE * sizeof(uint8_t));
+            memset(instance->classes, 0x00, sizeof(instance->classes));
+            instance->classes_ind = 0;
+            instance->te_found = false;
             instance->decoder.parser_step = BinRAWDecoderStepWrite;
             bin_raw_debug_tag(TAG, "RSSI\r\n");
         } else {
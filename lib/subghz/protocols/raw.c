@@ -1,6 +1,7 @@
 #include "raw.h"
 #include <lib/flipper_format/flipper_format.h>
 #include "../subghz_file_encoder_worker.h"
+#include "../subghz_raw_file.h"
 
 #include "../blocks/const.h"
 #include "../blocks/decoder.h"
@@ -13,6 +14,8 @@
 
 #define TAG "SubGhzProtocolRaw"
 #define SUBGHZ_DOWNLOAD_MAX_SIZE 512
+#define SUBGHZ_RAW_WRITER_BUFFER_COUNT 3
+#define SUBGHZ_RAW_WRITER_STACK_SIZE 2048
 
 static const SubGhzBlockConst subghz_protocol_raw_const = {
     .te_short = 50,
@@ -21,16 +24,28 @@ static const SubGhzBlockConst subghz_protocol_raw_const = {
     .min_count_bit_for_found = 0,
 };
 
+typedef struct {
+    int32_t data[SUBGHZ_DOWNLOAD_MAX_SIZE];
+    size_t size;
+} SubGhzProtocolRawBuffer;
+
 struct SubGhzProtocolDecoderRAW {
     SubGhzProtocolDecoderBase base;
 
-    int32_t* upload_raw;
-    uint16_t ind_write;
+    SubGhzProtocolRawBuffer* buffers;
+    SubGhzProtocolRawBuffer* upload_raw;
+    FuriMessageQueue* free_queue;
+    FuriMessageQueue* write_queue;
+    FuriThread* writer;
+    SubGhzProtocolRawWriteStats stats;
     Storage* storage;
     FlipperFormat* flipper_file;
+    SubGhzProtocolRawFileFormat file_format;
+    SubGhzRawFileWriter* raw_writer;
     uint32_t file_is_open;
     FuriString* file_name;
     size_t sample_write;
+    int32_t dropped_span;
     bool last_level;
     bool pause;
 };
@@ -83,6 +98,94 @@ const SubGhzProtocol subghz_protocol_raw = {
     .encoder = &subghz_protocol_raw_encoder,
 };
 
+static int32_t subghz_protocol_raw_writer_thread(void* context) {
+    SubGhzProtocolDecoderRAW* instance = context;
+    SubGhzProtocolRawBuffer* buffer = NULL;
+
+    while(true) {
+        furi_check(
+            furi_message_queue_get(instance->write_queue, &buffer, FuriWaitForever) ==
+            FuriStatusOk);
+        // NULL buffer is the stop request, everything queued before it is written by now
+        if(!buffer) break;
+
+        const uint32_t start = furi_get_tick();
+        if(instance->raw_writer) {
+            if(!subghz_raw_file_writer_add(instance->raw_writer, buffer->data, buffer->size)) {
+                FURI_LOG_E(TAG, "Unable to add RAW chunk");
+            }
+        } else if(!flipper_format_write_int32(
+                      instance->flipper_file, "RAW_Data", buffer->data, buffer->size)) {
+            FURI_LOG_E(TAG, "Unable to add RAW_Data");
+        }
+        const uint32_t write_ms = furi_get_tick() - start;
+
+        // Statistics are copied by the GUI thread, they are updated as a whole
+        FURI_CRITICAL_ENTER();
+        instance->stats.write_ms_last = write_ms;
+        instance->stats.write_ms_max = MAX(instance->stats.write_ms_max, write_ms);
+        instance->stats.buffers_written++;
+        FURI_CRITICAL_EXIT();
+
+        buffer->size = 0;
+        furi_message_queue_put(instance->free_queue, &buffer, FuriWaitForever);
+    }
+
+    return 0;
+}
+
+static void subghz_protocol_raw_writer_start(SubGhzProtocolDecoderRAW* instance) {
+    instance->buffers = malloc(sizeof(SubGhzProtocolRawBuffer) * SUBGHZ_RAW_WRITER_BUFFER_COUNT);
+    instance->free_queue = furi_message_queue_alloc(
+        SUBGHZ_RAW_WRITER_BUFFER_COUNT, sizeof(SubGhzProtocolRawBuffer*));
+    // One more slot for the stop request
+    instance->write_queue = furi_message_queue_alloc(
+        SUBGHZ_RAW_WRITER_BUFFER_COUNT + 1, sizeof(SubGhzProtocolRawBuffer*));
+
+    instance->upload_raw = &instance->buffers[0];
+    for(size_t i = 1; i < SUBGHZ_RAW_WRITER_BUFFER_COUNT; i++) {
+        SubGhzProtocolRawBuffer* buffer = &instance->buffers[i];
+        furi_message_queue_put(instance->free_queue, &buffer, 0);
+    }
+    memset(&instance->stats, 0, sizeof(instance->stats));
+
+    instance->writer = furi_thread_alloc_ex(
+        "SubGhzRawWriter",
+        SUBGHZ_RAW_WRITER_STACK_SIZE,
+        subghz_protocol_raw_writer_thread,
+        instance);
+    furi_thread_set_priority(instance->writer, FuriThreadPriorityLow);
+    furi_thread_start(instance->writer);
+}
+
+static void subghz_protocol_raw_writer_stop(SubGhzProtocolDecoderRAW* instance) {
+    SubGhzProtocolRawBuffer* stop = NULL;
+    furi_message_queue_put(instance->write_queue, &stop, FuriWaitForever);
+    furi_thread_join(instance->writer);
+    furi_thread_free(instance->writer);
+    instance->writer = NULL;
+
+    FURI_LOG_I(
+        TAG,
+        "Buffers written: %zu, write max: %lums, samples dropped: %zu",
+        instance->stats.buffers_written,
+        instance->stats.write_ms_max,
+        instance->stats.samples_dropped);
+
+    furi_message_queue_free(instance->write_queue);
+    furi_message_queue_free(instance->free_queue);
+    free(instance->buffers);
+    instance->buffers = NULL;
+    instance->upload_raw = NULL;
+}
+
+void subghz_protocol_raw_save_to_file_set_format(
+    SubGhzProtocolDecoderRAW* instance,
+    SubGhzProtocolRawFileFormat format) {
+    furi_assert(instance);
+    instance->file_format = format;
+}
+
 bool subghz_protocol_raw_save_to_file_init(
     SubGhzProtocolDecoderRAW* instance,
     const char* dev_name,
@@ -122,8 +225,11 @@ bool subghz_protocol_raw_save_to_file_init(
             break;
         }
 
+        const bool is_binary = instance->file_format == SubGhzProtocolRawFileFormatBinary;
         if(!flipper_format_write_header_cstr(
-               instance->flipper_file, SUBGHZ_RAW_FILE_TYPE, SUBGHZ_RAW_FILE_VERSION)) {
+               instance->flipper_file,
+               is_binary ? SUBGHZ_RAW_BIN_FILE_TYPE : SUBGHZ_RAW_FILE_TYPE,
+               SUBGHZ_RAW_FILE_VERSION)) {
             FURI_LOG_E(TAG, "Unable to add header");
             break;
         }
@@ -158,9 +264,16 @@ bool subghz_protocol_raw_save_to_file_init(
             break;
         }
 
-        instance->upload_raw = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
+        // Binary samples follow the Protocol line
+        if(is_binary) {
+            Stream* stream = flipper_format_get_raw_stream(instance->flipper_file);
+            instance->raw_writer = subghz_raw_file_writer_alloc(stream);
+        }
+
+        subghz_protocol_raw_writer_start(instance);
         instance->file_is_open = RAWFileIsOpenWrite;
         instance->sample_write = 0;
+        instance->dropped_span = 0;
         instance->last_level = false;
         instance->pause = false;
         init = true;
@@ -171,31 +284,32 @@ bool subghz_protocol_raw_save_to_file_init(
     return init;
 }
 
-static bool subghz_protocol_raw_save_to_file_write(SubGhzProtocolDecoderRAW* instance) {
+static void subghz_protocol_raw_save_to_file_write(SubGhzProtocolDecoderRAW* instance) {
     furi_assert(instance);
 
-    bool is_write = false;
-    if(instance->file_is_open == RAWFileIsOpenWrite) {
-        if(!flipper_format_write_int32(
-               instance->flipper_file, "RAW_Data", instance->upload_raw, instance->ind_write)) {
-            FURI_LOG_E(TAG, "Unable to add RAW_Data");
-        } else {
-            instance->sample_write += instance->ind_write;
-            instance->ind_write = 0;
-            is_write = true;
-        }
-    }
-    return is_write;
+    // Hand the buffer over to the writer, capture continues in the next free one
+    furi_check(
+        furi_message_queue_put(instance->write_queue, &instance->upload_raw, 0) == FuriStatusOk);
+    instance->upload_raw = NULL;
+    furi_message_queue_get(instance->free_queue, &instance->upload_raw, 0);
 }
 
 void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance) {
     furi_assert(instance);
 
-    if(instance->file_is_open == RAWFileIsOpenWrite && instance->ind_write)
-        subghz_protocol_raw_save_to_file_write(instance);
+    if(instance->file_is_open == RAWFileIsOpenWrite) {
+        if(instance->upload_raw && instance->upload_raw->size)
+            subghz_protocol_raw_save_to_file_write(instance);
+        subghz_protocol_raw_writer_stop(instance);
+        if(instance->raw_writer) {
+            if(!subghz_raw_file_writer_finish(instance->raw_writer)) {
+                FURI_LOG_E(TAG, "Unable to add RAW index");
+            }
+            subghz_raw_file_writer_free(instance->raw_writer);
+            instance->raw_writer = NULL;
+        }
+    }
     if(instance->file_is_open != RAWFileIsOpenClose) {
-        free(instance->upload_raw);
-        instance->upload_raw = NULL;
         flipper_format_file_close(instance->flipper_file);
         flipper_format_free(instance->flipper_file);
         furi_record_close(RECORD_STORAGE);
@@ -213,7 +327,19 @@ void subghz_protocol_raw_save_to_file_pause(SubGhzProtocolDecoderRAW* instance,
 }
 
 size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolDecoderRAW* instance) {
-    return instance->sample_write + instance->ind_write;
+    furi_assert(instance);
+    // Called from the GUI thread, a single counter is read in one access
+    return instance->sample_write;
+}
+
+void subghz_protocol_raw_get_write_stats(
+    SubGhzProtocolDecoderRAW* instance,
+    SubGhzProtocolRawWriteStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    FURI_CRITICAL_ENTER();
+    *stats = instance->stats;
+    FURI_CRITICAL_EXIT();
 }
 
 void* subghz_protocol_decoder_raw_alloc(SubGhzEnvironment* environment) {
@@ -221,7 +347,6 @@ void* subghz_protocol_decoder_raw_alloc(SubGhzEnvironment* environment) {
     SubGhzProtocolDecoderRAW* instance = malloc(sizeof(SubGhzProtocolDecoderRAW));
     instance->base.protocol = &subghz_protocol_raw;
     instance->upload_raw = NULL;
-    instance->ind_write = 0;
     instance->last_level = false;
     instance->file_is_open = RAWFileIsOpenClose;
     instance->file_name = furi_string_alloc();
@@ -239,23 +364,63 @@ void subghz_protocol_decoder_raw_free(void* context) {
 void subghz_protocol_decoder_raw_reset(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderRAW* instance = context;
-    instance->ind_write = 0;
+    if(instance->upload_raw) {
+        instance->sample_write -= instance->upload_raw->size;
+        instance->upload_raw->size = 0;
+    }
+    instance->dropped_span = 0;
     instance->last_level = false;
 }
 
+// Dropped samples are merged into one space, their levels are lost
+static void subghz_protocol_raw_drop_sample(SubGhzProtocolDecoderRAW* instance, int32_t sample) {
+    instance->dropped_span -= abs(sample);
+
+    FURI_CRITICAL_ENTER();
+    instance->stats.samples_dropped++;
+    FURI_CRITICAL_EXIT();
+}
+
+static void subghz_protocol_raw_add_sample(SubGhzProtocolDecoderRAW* instance, int32_t sample) {
+    SubGhzProtocolRawBuffer* buffer = instance->upload_raw;
+
+    // The space is written first, or merged with the sample if that is a space too
+    if(instance->dropped_span) {
+        if(sample < 0) {
+            sample += instance->dropped_span;
+        } else {
+            buffer->data[buffer->size++] = instance->dropped_span;
+            instance->sample_write++;
+        }
+        instance->dropped_span = 0;
+    }
+
+    buffer->data[buffer->size++] = sample;
+    instance->sample_write++;
+}
+
 void subghz_protocol_decoder_raw_feed(void* context, bool level, uint32_t duration) {
     furi_assert(context);
     SubGhzProtocolDecoderRAW* instance = context;
 
-    if(!instance->pause && (instance->upload_raw != NULL)) {
+    if(!instance->pause && (instance->file_is_open == RAWFileIsOpenWrite)) {
         if(duration > subghz_protocol_raw_const.te_short) {
             if(instance->last_level != level) {
                 instance->last_level = (level ? true : false);
-                instance->upload_raw[instance->ind_write++] = (level ? duration : -duration);
+                // Pick up a buffer released by the writer, never wait for it
+                if(!instance->upload_raw) {
+                    furi_message_queue_get(instance->free_queue, &instance->upload_raw, 0);
+                }
+                const int32_t sample = level ? (int32_t)duration : -(int32_t)duration;
+                if(instance->upload_raw) {
+                    subghz_protocol_raw_add_sample(instance, sample);
+                } else {
+                    subghz_protocol_raw_drop_sample(instance, sample);
+                }
             }
         }
 
-        if(instance->ind_write == SUBGHZ_DOWNLOAD_MAX_SIZE) {
+        if(instance->upload_raw && instance->upload_raw->size == SUBGHZ_DOWNLOAD_MAX_SIZE) {
             subghz_protocol_raw_save_to_file_write(instance);
         }
     }
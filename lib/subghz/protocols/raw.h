@@ -13,10 +13,37 @@ typedef void (*SubGhzProtocolEncoderRAWCallbackEnd)(void* context);
 typedef struct SubGhzProtocolDecoderRAW SubGhzProtocolDecoderRAW;
 typedef struct SubGhzProtocolEncoderRAW SubGhzProtocolEncoderRAW;
 
+/** RAW recording statistics, samples are written to the file by a background thread
+ *
+ * Time of dropped samples is kept in the recording as a single space, so a replay stays
+ * silent where the recording has a gap.
+ */
+typedef struct {
+    size_t samples_dropped; /**< Samples lost because all buffers were waiting for the file */
+    size_t buffers_written; /**< Buffers written to the file */
+    uint32_t write_ms_last; /**< Duration of the last buffer write */
+    uint32_t write_ms_max; /**< Longest buffer write */
+} SubGhzProtocolRawWriteStats;
+
+/** RAW recording file format */
+typedef enum {
+    SubGhzProtocolRawFileFormatText, /**< RAW_Data lines, SUBGHZ_RAW_FILE_TYPE */
+    SubGhzProtocolRawFileFormatBinary, /**< Varint chunks, SUBGHZ_RAW_BIN_FILE_TYPE */
+} SubGhzProtocolRawFileFormat;
+
 extern const SubGhzProtocolDecoder subghz_protocol_raw_decoder;
 extern const SubGhzProtocolEncoder subghz_protocol_raw_encoder;
 extern const SubGhzProtocol subghz_protocol_raw;
 
+/**
+ * Set the file format used by the next subghz_protocol_raw_save_to_file_init.
+ * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
+ * @param format File format, SubGhzProtocolRawFileFormatText by default
+ */
+void subghz_protocol_raw_save_to_file_set_format(
+    SubGhzProtocolDecoderRAW* instance,
+    SubGhzProtocolRawFileFormat format);
+
 /**
  * Open file for writing
  * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
@@ -42,6 +69,15 @@ void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance);
  */
 size_t subghz_protocol_raw_get_sample_write(SubGhzProtocolDecoderRAW* instance);
 
+/**
+ * Get the recording statistics SubGhzProtocolDecoderRAW.
+ * @param instance Pointer to a SubGhzProtocolDecoderRAW instance
+ * @param stats Pointer to a SubGhzProtocolRawWriteStats to be filled
+ */
+void subghz_protocol_raw_get_write_stats(
+    SubGhzProtocolDecoderRAW* instance,
+    SubGhzProtocolRawWriteStats* stats);
+
 /**
  * Allocate SubGhzProtocolDecoderRAW.
  * @param environment Pointer to a SubGhzEnvironment instance
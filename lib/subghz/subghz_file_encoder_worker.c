@@ -1,4 +1,6 @@
 #include "subghz_file_encoder_worker.h"
+#include "subghz_raw_file.h"
+#include "types.h"
 
 #include <toolbox/stream/stream.h>
 #include <flipper_format/flipper_format.h>
@@ -21,6 +23,8 @@ struct SubGhzFileEncoderWorker {
     bool is_storage_slow;
     FuriString* str_data;
     FuriString* file_path;
+    int32_t* samples;
+    SubGhzRawFileReader* reader;
     const SubGhzDevice* device;
 
     SubGhzFileEncoderWorkerCallbackEnd callback_end;
@@ -44,8 +48,17 @@ void subghz_file_encoder_worker_add_level_duration(
     if(sizeof(int32_t) != ret) FURI_LOG_E(TAG, "Invalid add duration in the stream");
 }
 
+static void subghz_file_encoder_worker_add_samples(
+    SubGhzFileEncoderWorker* instance,
+    const int32_t* samples,
+    size_t count) {
+    const size_t size = sizeof(int32_t) * count;
+    size_t ret = furi_stream_buffer_send(instance->stream, samples, size, 100);
+    if(size != ret) FURI_LOG_E(TAG, "Invalid add samples in the stream");
+}
+
 bool subghz_file_encoder_worker_data_parse(SubGhzFileEncoderWorker* instance, const char* strStart) {
-    char* str1;
+    const char* str1;
     bool res = false;
     // Line sample: "RAW_Data: -1, 2, -2..."
 
@@ -56,19 +69,42 @@ bool subghz_file_encoder_worker_data_parse(SubGhzFileEncoderWorker* instance, co
         // Skip key
         str1 = strchr(str1, ' ');
 
-        // Check that there is still an element in the line
+        // Values are sent in batches instead of one by one
+        size_t count = 0;
         while(strchr(str1, ' ') != NULL) {
             str1 = strchr(str1, ' ');
 
             // Skip space
             str1 += 1;
-            subghz_file_encoder_worker_add_level_duration(instance, atoi(str1));
+            instance->samples[count++] = atoi(str1);
+            if(count == SUBGHZ_FILE_ENCODER_LOAD) {
+                subghz_file_encoder_worker_add_samples(instance, instance->samples, count);
+                count = 0;
+            }
+        }
+        if(count > 0) {
+            subghz_file_encoder_worker_add_samples(instance, instance->samples, count);
         }
         res = true;
     }
     return res;
 }
 
+static bool subghz_file_encoder_worker_load(SubGhzFileEncoderWorker* instance, Stream* stream) {
+    if(instance->reader) {
+        const size_t count = subghz_raw_file_reader_read(
+            instance->reader, instance->samples, SUBGHZ_FILE_ENCODER_LOAD);
+        if(count == 0) return false;
+        subghz_file_encoder_worker_add_samples(instance, instance->samples, count);
+        return true;
+    }
+
+    if(!stream_read_line(stream, instance->str_data)) return false;
+    furi_string_trim(instance->str_data);
+    return subghz_file_encoder_worker_data_parse(
+        instance, furi_string_get_cstr(instance->str_data));
+}
+
 LevelDuration subghz_file_encoder_worker_get_level_duration(void* context) {
     furi_assert(context);
     SubGhzFileEncoderWorker* instance = context;
@@ -103,6 +139,7 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
     bool res = false;
     instance->is_storage_slow = false;
     Stream* stream = flipper_format_get_raw_stream(instance->flipper_format);
+    uint32_t version;
     do {
         if(!flipper_format_file_open_existing(
                instance->flipper_format, furi_string_get_cstr(instance->file_path))) {
@@ -112,6 +149,11 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
                 furi_string_get_cstr(instance->file_path));
             break;
         }
+        if(!flipper_format_read_header(instance->flipper_format, instance->str_data, &version)) {
+            FURI_LOG_E(TAG, "Missing or incorrect header");
+            break;
+        }
+        const bool is_binary = !furi_string_cmp_str(instance->str_data, SUBGHZ_RAW_BIN_FILE_TYPE);
         if(!flipper_format_read_string(instance->flipper_format, "Protocol", instance->str_data)) {
             FURI_LOG_E(TAG, "Missing Protocol");
             break;
@@ -119,6 +161,9 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
 
         //skip the end of the previous line "\n"
         stream_seek(stream, 1, StreamOffsetFromCurrent);
+        if(is_binary) {
+            instance->reader = subghz_raw_file_reader_alloc(stream);
+        }
         res = true;
         instance->worker_stoping = false;
         FURI_LOG_I(TAG, "Start transmission");
@@ -127,14 +172,7 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
     while(res && instance->worker_running) {
         size_t stream_free_byte = furi_stream_buffer_spaces_available(instance->stream);
         if((stream_free_byte / sizeof(int32_t)) >= SUBGHZ_FILE_ENCODER_LOAD) {
-            if(stream_read_line(stream, instance->str_data)) {
-                furi_string_trim(instance->str_data);
-                if(!subghz_file_encoder_worker_data_parse(
-                       instance, furi_string_get_cstr(instance->str_data))) {
-                    subghz_file_encoder_worker_add_level_duration(instance, LEVEL_DURATION_RESET);
-                    break;
-                }
-            } else {
+            if(!subghz_file_encoder_worker_load(instance, stream)) {
                 subghz_file_encoder_worker_add_level_duration(instance, LEVEL_DURATION_RESET);
                 break;
             }
@@ -160,6 +198,10 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
         }
         furi_delay_ms(50);
     }
+    if(instance->reader) {
+        subghz_raw_file_reader_free(instance->reader);
+        instance->reader = NULL;
+    }
     flipper_format_file_close(instance->flipper_format);
 
     FURI_LOG_I(TAG, "Worker stop");
@@ -178,6 +220,7 @@ SubGhzFileEncoderWorker* subghz_file_encoder_worker_alloc() {
 
     instance->str_data = furi_string_alloc();
     instance->file_path = furi_string_alloc();
+    instance->samples = malloc(sizeof(int32_t) * SUBGHZ_FILE_ENCODER_LOAD);
     instance->worker_stoping = true;
 
     return instance;
@@ -191,6 +234,7 @@ void subghz_file_encoder_worker_free(SubGhzFileEncoderWorker* instance) {
 
     furi_string_free(instance->str_data);
     furi_string_free(instance->file_path);
+    free(instance->samples);
 
     flipper_format_free(instance->flipper_format);
     furi_record_close(RECORD_STORAGE);
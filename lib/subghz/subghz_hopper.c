@@ -0,0 +1,151 @@
+#include "subghz_hopper.h"
+
+#include <furi.h>
+
+#define TAG "SubGhzHopper"
+
+/** Score added by a tick with RSSI above the threshold */
+#define SUBGHZ_HOPPER_SCORE_HIT (0xC000U)
+/** Score that adds one to the frequency weight, the weight is at most 8 */
+#define SUBGHZ_HOPPER_SCORE_PER_WEIGHT (0x2000U)
+/** Every tick each score loses 1/2^shift of itself, about 18 s half-life at 10 ticks/s */
+#define SUBGHZ_HOPPER_SCORE_DECAY_SHIFT (8U)
+
+typedef struct {
+    SubGhzHopperStats stats;
+    uint16_t score;
+    int32_t credit;
+} SubGhzHopperFrequency;
+
+struct SubGhzHopper {
+    SubGhzHopperFrequency* frequencies;
+    size_t count;
+    size_t current;
+    uint8_t hold_ticks;
+    bool adaptive;
+};
+
+SubGhzHopper* subghz_hopper_alloc(const uint32_t* frequencies, size_t count) {
+    furi_check(frequencies);
+    furi_check(count);
+
+    SubGhzHopper* instance = malloc(sizeof(SubGhzHopper));
+    instance->frequencies = malloc(sizeof(SubGhzHopperFrequency) * count);
+    instance->count = count;
+    for(size_t i = 0; i < count; i++) {
+        instance->frequencies[i].stats.frequency = frequencies[i];
+    }
+    instance->adaptive = true;
+    subghz_hopper_reset(instance);
+
+    return instance;
+}
+
+void subghz_hopper_free(SubGhzHopper* instance) {
+    furi_check(instance);
+    free(instance->frequencies);
+    free(instance);
+}
+
+void subghz_hopper_set_adaptive(SubGhzHopper* instance, bool adaptive) {
+    furi_check(instance);
+    instance->adaptive = adaptive;
+}
+
+void subghz_hopper_reset(SubGhzHopper* instance) {
+    furi_check(instance);
+
+    for(size_t i = 0; i < instance->count; i++) {
+        SubGhzHopperFrequency* item = &instance->frequencies[i];
+        uint32_t frequency = item->stats.frequency;
+        memset(item, 0, sizeof(SubGhzHopperFrequency));
+        item->stats.frequency = frequency;
+    }
+    instance->current = 0;
+    instance->hold_ticks = 0;
+    instance->frequencies[0].stats.visits = 1;
+}
+
+uint32_t subghz_hopper_get_frequency(SubGhzHopper* instance) {
+    furi_check(instance);
+    return instance->frequencies[instance->current].stats.frequency;
+}
+
+static inline int32_t subghz_hopper_get_weight(SubGhzHopper* instance, size_t index) {
+    if(!instance->adaptive) return 1;
+    return 1 + instance->frequencies[index].score / SUBGHZ_HOPPER_SCORE_PER_WEIGHT;
+}
+
+/** Smooth weighted round robin: every frequency earns its weight in credit per hop,
+ * the richest one is picked and pays the total. Equal weights give plain round robin,
+ * a heavy frequency gets several picks per cycle spread between the others.
+ */
+static size_t subghz_hopper_select(SubGhzHopper* instance) {
+    int32_t total = 0;
+    size_t next = 0;
+
+    for(size_t i = 0; i < instance->count; i++) {
+        SubGhzHopperFrequency* item = &instance->frequencies[i];
+        int32_t weight = subghz_hopper_get_weight(instance, i);
+        item->credit += weight;
+        total += weight;
+        if(item->credit > instance->frequencies[next].credit) {
+            next = i;
+        }
+    }
+    instance->frequencies[next].credit -= total;
+
+    return next;
+}
+
+SubGhzHopperStep subghz_hopper_tick(SubGhzHopper* instance, float rssi) {
+    furi_check(instance);
+
+    // Activity fades with time on all frequencies, whether they are visited or not
+    for(size_t i = 0; i < instance->count; i++) {
+        SubGhzHopperFrequency* item = &instance->frequencies[i];
+        item->score -= (item->score + (1U << SUBGHZ_HOPPER_SCORE_DECAY_SHIFT) - 1) >>
+                       SUBGHZ_HOPPER_SCORE_DECAY_SHIFT;
+    }
+
+    SubGhzHopperFrequency* item = &instance->frequencies[instance->current];
+    item->stats.ticks++;
+    const bool active = rssi > SUBGHZ_HOPPER_RSSI_THRESHOLD;
+    if(active) {
+        item->stats.active_ticks++;
+        item->score = MIN(item->score + SUBGHZ_HOPPER_SCORE_HIT, 0xFFFFU);
+    }
+
+    if(instance->hold_ticks) {
+        // Move on when the hold is over, even if the frequency is still busy
+        if(--instance->hold_ticks) return SubGhzHopperStepHold;
+    } else if(active) {
+        instance->hold_ticks = SUBGHZ_HOPPER_HOLD_TICKS;
+        return SubGhzHopperStepHold;
+    }
+
+    size_t next = subghz_hopper_select(instance);
+    if(next == instance->current) {
+        return SubGhzHopperStepStay;
+    }
+
+    instance->current = next;
+    instance->frequencies[next].stats.visits++;
+    FURI_LOG_T(TAG, "Retune to %lu", instance->frequencies[next].stats.frequency);
+
+    return SubGhzHopperStepRetune;
+}
+
+size_t subghz_hopper_get_count(SubGhzHopper* instance) {
+    furi_check(instance);
+    return instance->count;
+}
+
+void subghz_hopper_get_stats(SubGhzHopper* instance, size_t index, SubGhzHopperStats* stats) {
+    furi_check(instance);
+    furi_check(index < instance->count);
+    furi_check(stats);
+
+    *stats = instance->frequencies[index].stats;
+    stats->activity = instance->frequencies[index].score >> 8;
+}
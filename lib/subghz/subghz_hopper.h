@@ -0,0 +1,108 @@
+/**
+ * @file subghz_hopper.h
+ * @brief Scan scheduler for the Sub-GHz frequency hopper.
+ *
+ * The scheduler does not touch the radio: it is fed the RSSI measured on the current
+ * frequency once per tick and tells when and where to retune. Frequencies with recent
+ * RSSI activity get a bigger share of the listening time, spread over the whole scan
+ * cycle so that short bursts on them are more likely to be caught, while idle
+ * frequencies are still visited at least once per cycle.
+ *
+ * When a tick sees RSSI above the threshold the scheduler stays on the frequency for
+ * SUBGHZ_HOPPER_HOLD_TICKS ticks to let the receiver decode the signal.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** RSSI level considered as activity, dBm */
+#define SUBGHZ_HOPPER_RSSI_THRESHOLD (-90.0f)
+
+/** Number of ticks to stay on a frequency after activity is detected */
+#define SUBGHZ_HOPPER_HOLD_TICKS (10U)
+
+typedef struct SubGhzHopper SubGhzHopper;
+
+/** Result of a scheduler tick */
+typedef enum {
+    SubGhzHopperStepStay, /**< Keep listening on the current frequency */
+    SubGhzHopperStepHold, /**< Activity detected, keep listening without hopping */
+    SubGhzHopperStepRetune, /**< Tune the radio to subghz_hopper_get_frequency() */
+} SubGhzHopperStep;
+
+/** Activity statistics of one frequency */
+typedef struct {
+    uint32_t frequency; /**< Frequency, Hz */
+    uint32_t visits; /**< Number of times the radio was tuned to the frequency */
+    uint32_t ticks; /**< Number of ticks spent on the frequency */
+    uint32_t active_ticks; /**< Number of ticks with RSSI above the threshold */
+    uint8_t activity; /**< Recent activity score, 0 when idle */
+} SubGhzHopperStats;
+
+/**
+ * Allocate SubGhzHopper.
+ * @param frequencies Frequencies to scan, Hz, copied
+ * @param count Number of frequencies, at least 1
+ * @return SubGhzHopper* pointer to a SubGhzHopper instance
+ */
+SubGhzHopper* subghz_hopper_alloc(const uint32_t* frequencies, size_t count);
+
+/**
+ * Free SubGhzHopper.
+ * @param instance Pointer to a SubGhzHopper instance
+ */
+void subghz_hopper_free(SubGhzHopper* instance);
+
+/**
+ * Enable adaptive scheduling, enabled by default.
+ * When disabled frequencies are scanned one after another with a fixed dwell of one tick.
+ * @param instance Pointer to a SubGhzHopper instance
+ * @param adaptive true to weight frequencies by their activity
+ */
+void subghz_hopper_set_adaptive(SubGhzHopper* instance, bool adaptive);
+
+/**
+ * Clear statistics and restart the scan from the first frequency.
+ * @param instance Pointer to a SubGhzHopper instance
+ */
+void subghz_hopper_reset(SubGhzHopper* instance);
+
+/**
+ * Get the frequency the radio should be tuned to.
+ * @param instance Pointer to a SubGhzHopper instance
+ * @return uint32_t frequency, Hz
+ */
+uint32_t subghz_hopper_get_frequency(SubGhzHopper* instance);
+
+/**
+ * Account one tick spent on the current frequency and select where to listen next.
+ * @param instance Pointer to a SubGhzHopper instance
+ * @param rssi RSSI measured on the current frequency during the tick, dBm
+ * @return SubGhzHopperStep what to do until the next tick
+ */
+SubGhzHopperStep subghz_hopper_tick(SubGhzHopper* instance, float rssi);
+
+/**
+ * Get number of scanned frequencies.
+ * @param instance Pointer to a SubGhzHopper instance
+ * @return size_t frequency count
+ */
+size_t subghz_hopper_get_count(SubGhzHopper* instance);
+
+/**
+ * Get activity statistics of a frequency.
+ * @param instance Pointer to a SubGhzHopper instance
+ * @param index Frequency index, in the order given to subghz_hopper_alloc()
+ * @param stats Output statistics
+ */
+void subghz_hopper_get_stats(SubGhzHopper* instance, size_t index, SubGhzHopperStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,491 @@
+#include "subghz_raw_file.h"
+#include "types.h"
+#include "protocols/raw.h"
+
+#include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+#include <toolbox/varint.h>
+
+#define TAG "SubGhzRawFile"
+
+#define SUBGHZ_RAW_FILE_FOOTER_MAGIC (0x49524753U) // "SGRI"
+#define SUBGHZ_RAW_FILE_VARINT_SIZE_MAX (5U)
+#define SUBGHZ_RAW_FILE_CHUNK_DATA_SIZE_MAX \
+    (SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX * SUBGHZ_RAW_FILE_VARINT_SIZE_MAX)
+// Index entries kept while writing, the index gets sparser as the file grows
+#define SUBGHZ_RAW_FILE_INDEX_SIZE (256U)
+
+typedef struct FURI_PACKED {
+    uint16_t sample_count;
+    uint16_t size;
+} SubGhzRawFileChunkHeader;
+
+typedef struct FURI_PACKED {
+    uint32_t offset;
+    uint32_t sample;
+} SubGhzRawFileIndexEntry;
+
+typedef struct FURI_PACKED {
+    uint32_t index_offset;
+    uint32_t index_count;
+    uint32_t sample_count;
+    uint32_t magic;
+} SubGhzRawFileFooter;
+
+struct SubGhzRawFileWriter {
+    Stream* stream;
+    uint8_t data[SUBGHZ_RAW_FILE_CHUNK_DATA_SIZE_MAX];
+
+    SubGhzRawFileIndexEntry index[SUBGHZ_RAW_FILE_INDEX_SIZE];
+    size_t index_count;
+    size_t index_stride;
+
+    size_t chunk_count;
+    size_t sample_count;
+};
+
+struct SubGhzRawFileReader {
+    Stream* stream;
+    uint8_t data[SUBGHZ_RAW_FILE_CHUNK_DATA_SIZE_MAX];
+
+    size_t data_start;
+    size_t data_end;
+    SubGhzRawFileFooter footer;
+    bool indexed;
+
+    // Current chunk
+    size_t chunk_size;
+    size_t chunk_pos;
+    size_t chunk_samples_left;
+    // Malformed data was found, nothing more is read
+    bool failed;
+};
+
+SubGhzRawFileWriter* subghz_raw_file_writer_alloc(Stream* stream) {
+    furi_assert(stream);
+    SubGhzRawFileWriter* instance = malloc(sizeof(SubGhzRawFileWriter));
+    instance->stream = stream;
+    instance->index_stride = 1;
+    return instance;
+}
+
+void subghz_raw_file_writer_free(SubGhzRawFileWriter* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+static void subghz_raw_file_writer_add_index(SubGhzRawFileWriter* instance, size_t offset) {
+    if(instance->chunk_count % instance->index_stride) return;
+
+    if(instance->index_count == SUBGHZ_RAW_FILE_INDEX_SIZE) {
+        // Keep every other entry
+        for(size_t i = 0; i < SUBGHZ_RAW_FILE_INDEX_SIZE / 2; i++) {
+            instance->index[i] = instance->index[i * 2];
+        }
+        instance->index_count = SUBGHZ_RAW_FILE_INDEX_SIZE / 2;
+        instance->index_stride *= 2;
+        if(instance->chunk_count % instance->index_stride) return;
+    }
+
+    instance->index[instance->index_count].offset = offset;
+    instance->index[instance->index_count].sample = instance->sample_count;
+    instance->index_count++;
+}
+
+bool subghz_raw_file_writer_add(
+    SubGhzRawFileWriter* instance,
+    const int32_t* samples,
+    size_t count) {
+    furi_assert(instance);
+    furi_assert(samples);
+
+    while(count > 0) {
+        const size_t chunk_count = MIN(count, SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX);
+
+        size_t size = 0;
+        for(size_t i = 0; i < chunk_count; i++) {
+            size += varint_int32_pack(samples[i], &instance->data[size]);
+        }
+
+        const SubGhzRawFileChunkHeader header = {
+            .sample_count = chunk_count,
+            .size = size,
+        };
+
+        subghz_raw_file_writer_add_index(instance, stream_tell(instance->stream));
+
+        if(stream_write(instance->stream, (const uint8_t*)&header, sizeof(header)) !=
+           sizeof(header)) {
+            return false;
+        }
+        if(stream_write(instance->stream, instance->data, size) != size) {
+            return false;
+        }
+
+        instance->chunk_count++;
+        instance->sample_count += chunk_count;
+        samples += chunk_count;
+        count -= chunk_count;
+    }
+
+    return true;
+}
+
+bool subghz_raw_file_writer_finish(SubGhzRawFileWriter* instance) {
+    furi_assert(instance);
+
+    const SubGhzRawFileFooter footer = {
+        .index_offset = stream_tell(instance->stream),
+        .index_count = instance->index_count,
+        .sample_count = instance->sample_count,
+        .magic = SUBGHZ_RAW_FILE_FOOTER_MAGIC,
+    };
+
+    const size_t index_size = sizeof(SubGhzRawFileIndexEntry) * instance->index_count;
+    if(stream_write(instance->stream, (const uint8_t*)instance->index, index_size) != index_size) {
+        return false;
+    }
+
+    return stream_write(instance->stream, (const uint8_t*)&footer, sizeof(footer)) ==
+           sizeof(footer);
+}
+
+static bool subghz_raw_file_reader_load_footer(SubGhzRawFileReader* instance) {
+    if(instance->data_end < instance->data_start + sizeof(SubGhzRawFileFooter)) return false;
+
+    const size_t footer_offset = instance->data_end - sizeof(SubGhzRawFileFooter);
+    SubGhzRawFileFooter* footer = &instance->footer;
+    if(!stream_seek(instance->stream, footer_offset, StreamOffsetFromStart)) return false;
+    if(stream_read(instance->stream, (uint8_t*)footer, sizeof(SubGhzRawFileFooter)) !=
+       sizeof(SubGhzRawFileFooter)) {
+        return false;
+    }
+
+    // Index is right before the footer
+    const size_t index_size = footer->index_count * sizeof(SubGhzRawFileIndexEntry);
+    return footer->magic == SUBGHZ_RAW_FILE_FOOTER_MAGIC &&
+           footer->index_offset >= instance->data_start &&
+           footer->index_offset + index_size == footer_offset;
+}
+
+SubGhzRawFileReader* subghz_raw_file_reader_alloc(Stream* stream) {
+    furi_assert(stream);
+    SubGhzRawFileReader* instance = malloc(sizeof(SubGhzRawFileReader));
+    instance->stream = stream;
+    instance->data_start = stream_tell(stream);
+    instance->data_end = stream_size(stream);
+
+    // Footer is only there if the file was finished
+    if(subghz_raw_file_reader_load_footer(instance)) {
+        instance->indexed = true;
+        instance->data_end = instance->footer.index_offset;
+    }
+
+    stream_seek(stream, instance->data_start, StreamOffsetFromStart);
+
+    return instance;
+}
+
+void subghz_raw_file_reader_free(SubGhzRawFileReader* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+/**
+ * Strict zigzag varint decoder, unlike toolbox varint it rejects truncated, overlong
+ * and out of range encodings instead of returning garbage.
+ * @return size_t number of bytes used, 0 if the data is malformed
+ */
+static size_t subghz_raw_file_varint_unpack(int32_t* value, const uint8_t* input, size_t size) {
+    uint32_t parsed = 0;
+
+    for(size_t i = 0; i < MIN(size, SUBGHZ_RAW_FILE_VARINT_SIZE_MAX); i++) {
+        // Last byte of 5 only has room for the 4 remaining bits
+        if(i == SUBGHZ_RAW_FILE_VARINT_SIZE_MAX - 1 && input[i] > 0x0F) return 0;
+
+        parsed |= (uint32_t)(input[i] & 0x7F) << (7 * i);
+        if(!(input[i] & 0x80)) {
+            // Zero in the last byte means the value fits in fewer bytes
+            if(i > 0 && input[i] == 0) return 0;
+            *value = (int32_t)((parsed >> 1) ^ -(parsed & 1));
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+static bool subghz_raw_file_reader_read_chunk_header(
+    SubGhzRawFileReader* instance,
+    SubGhzRawFileChunkHeader* header) {
+    if(stream_tell(instance->stream) + sizeof(SubGhzRawFileChunkHeader) > instance->data_end) {
+        return false;
+    }
+    if(stream_read(instance->stream, (uint8_t*)header, sizeof(SubGhzRawFileChunkHeader)) !=
+       sizeof(SubGhzRawFileChunkHeader)) {
+        return false;
+    }
+    if(header->sample_count > SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX ||
+       header->size > SUBGHZ_RAW_FILE_CHUNK_DATA_SIZE_MAX ||
+       header->size < header->sample_count) {
+        FURI_LOG_E(TAG, "Invalid chunk header");
+        instance->failed = true;
+        return false;
+    }
+    return true;
+}
+
+static bool subghz_raw_file_reader_load_chunk(SubGhzRawFileReader* instance) {
+    SubGhzRawFileChunkHeader header;
+    if(!subghz_raw_file_reader_read_chunk_header(instance, &header)) return false;
+    if(stream_read(instance->stream, instance->data, header.size) != header.size) return false;
+
+    instance->chunk_size = header.size;
+    instance->chunk_pos = 0;
+    instance->chunk_samples_left = header.sample_count;
+
+    return true;
+}
+
+size_t subghz_raw_file_reader_read(SubGhzRawFileReader* instance, int32_t* samples, size_t count) {
+    furi_assert(instance);
+    furi_assert(samples);
+
+    if(instance->failed) return 0;
+
+    // Empty chunks are skipped
+    while(instance->chunk_samples_left == 0) {
+        if(!subghz_raw_file_reader_load_chunk(instance)) return 0;
+    }
+
+    count = MIN(count, instance->chunk_samples_left);
+    for(size_t i = 0; i < count; i++) {
+        const size_t size = subghz_raw_file_varint_unpack(
+            &samples[i],
+            &instance->data[instance->chunk_pos],
+            instance->chunk_size - instance->chunk_pos);
+        if(size == 0) {
+            FURI_LOG_E(TAG, "Malformed sample");
+            instance->failed = true;
+            return 0;
+        }
+        instance->chunk_pos += size;
+    }
+    instance->chunk_samples_left -= count;
+
+    // Chunk size must match its samples exactly
+    if(instance->chunk_samples_left == 0 && instance->chunk_pos != instance->chunk_size) {
+        FURI_LOG_E(TAG, "Chunk has trailing data");
+        instance->failed = true;
+        return 0;
+    }
+
+    return count;
+}
+
+bool subghz_raw_file_reader_is_failed(SubGhzRawFileReader* instance) {
+    furi_assert(instance);
+    return instance->failed;
+}
+
+bool subghz_raw_file_reader_seek(SubGhzRawFileReader* instance, size_t sample) {
+    furi_assert(instance);
+
+    SubGhzRawFileIndexEntry entry = {.offset = instance->data_start, .sample = 0};
+
+    if(instance->indexed) {
+        // Last index entry at or before the sample
+        size_t low = 0;
+        size_t high = instance->footer.index_count;
+        while(low < high) {
+            const size_t mid = (low + high) / 2;
+            SubGhzRawFileIndexEntry mid_entry;
+            if(!stream_seek(
+                   instance->stream,
+                   instance->footer.index_offset + mid * sizeof(SubGhzRawFileIndexEntry),
+                   StreamOffsetFromStart) ||
+               stream_read(instance->stream, (uint8_t*)&mid_entry, sizeof(mid_entry)) !=
+                   sizeof(mid_entry)) {
+                return false;
+            }
+            if(mid_entry.sample <= sample) {
+                entry = mid_entry;
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+    }
+
+    if(!stream_seek(instance->stream, entry.offset, StreamOffsetFromStart)) return false;
+
+    // Skip whole chunks by their headers
+    size_t position = entry.sample;
+    while(true) {
+        const size_t chunk_offset = stream_tell(instance->stream);
+        SubGhzRawFileChunkHeader header;
+        if(!subghz_raw_file_reader_read_chunk_header(instance, &header)) return false;
+        if(position + header.sample_count > sample) {
+            stream_seek(instance->stream, chunk_offset, StreamOffsetFromStart);
+            break;
+        }
+        position += header.sample_count;
+        if(!stream_seek(instance->stream, header.size, StreamOffsetFromCurrent)) return false;
+    }
+
+    if(!subghz_raw_file_reader_load_chunk(instance)) return false;
+
+    // Skip the samples before the requested one
+    int32_t skipped;
+    while(position < sample) {
+        if(subghz_raw_file_reader_read(instance, &skipped, 1) != 1) return false;
+        position++;
+    }
+
+    return true;
+}
+
+size_t subghz_raw_file_reader_get_sample_count(SubGhzRawFileReader* instance) {
+    furi_assert(instance);
+    return instance->indexed ? instance->footer.sample_count : 0;
+}
+
+static bool subghz_raw_file_copy_header(
+    FlipperFormat* src,
+    FlipperFormat* dst,
+    const char* src_file_type,
+    const char* dst_file_type) {
+    FuriString* temp_str = furi_string_alloc();
+    uint32_t temp_data32;
+    uint8_t* preset_data = NULL;
+    bool result = false;
+
+    do {
+        if(!flipper_format_read_header(src, temp_str, &temp_data32)) break;
+        if(furi_string_cmp_str(temp_str, src_file_type) ||
+           temp_data32 != SUBGHZ_RAW_FILE_VERSION) {
+            FURI_LOG_E(TAG, "Type or version mismatch");
+            break;
+        }
+        if(!flipper_format_write_header_cstr(dst, dst_file_type, SUBGHZ_RAW_FILE_VERSION)) break;
+
+        if(!flipper_format_read_uint32(src, "Frequency", &temp_data32, 1)) break;
+        if(!flipper_format_write_uint32(dst, "Frequency", &temp_data32, 1)) break;
+
+        if(!flipper_format_read_string(src, "Preset", temp_str)) break;
+        if(!flipper_format_write_string(dst, "Preset", temp_str)) break;
+
+        if(!furi_string_cmp_str(temp_str, "FuriHalSubGhzPresetCustom")) {
+            if(!flipper_format_read_string(src, "Custom_preset_module", temp_str)) break;
+            if(!flipper_format_write_string(dst, "Custom_preset_module", temp_str)) break;
+
+            if(!flipper_format_get_value_count(src, "Custom_preset_data", &temp_data32)) break;
+            preset_data = malloc(temp_data32);
+            if(!flipper_format_read_hex(src, "Custom_preset_data", preset_data, temp_data32))
+                break;
+            if(!flipper_format_write_hex(dst, "Custom_preset_data", preset_data, temp_data32))
+                break;
+        }
+
+        if(!flipper_format_read_string(src, "Protocol", temp_str)) break;
+        if(furi_string_cmp_str(temp_str, SUBGHZ_PROTOCOL_RAW_NAME)) {
+            FURI_LOG_E(TAG, "Not a RAW file");
+            break;
+        }
+        if(!flipper_format_write_string(dst, "Protocol", temp_str)) break;
+
+        result = true;
+    } while(false);
+
+    free(preset_data);
+    furi_string_free(temp_str);
+
+    return result;
+}
+
+bool subghz_raw_file_text_to_binary(Storage* storage, const char* src_path, const char* dst_path) {
+    furi_assert(storage);
+    furi_assert(src_path);
+    furi_assert(dst_path);
+
+    FlipperFormat* src = flipper_format_buffered_file_alloc(storage);
+    FlipperFormat* dst = flipper_format_file_alloc(storage);
+    SubGhzRawFileWriter* writer = NULL;
+    int32_t* samples = NULL;
+    uint32_t samples_size = 0;
+    bool result = false;
+
+    do {
+        if(!flipper_format_buffered_file_open_existing(src, src_path)) break;
+        if(!flipper_format_file_open_always(dst, dst_path)) break;
+        if(!subghz_raw_file_copy_header(src, dst, SUBGHZ_RAW_FILE_TYPE, SUBGHZ_RAW_BIN_FILE_TYPE))
+            break;
+
+        writer = subghz_raw_file_writer_alloc(flipper_format_get_raw_stream(dst));
+
+        // Each line is written as is, long lines are split into several chunks
+        uint32_t count;
+        bool line_valid = true;
+        while(flipper_format_get_value_count(src, "RAW_Data", &count)) {
+            if(count > samples_size) {
+                samples = realloc(samples, count * sizeof(int32_t)); //-V701
+                samples_size = count;
+            }
+            line_valid = flipper_format_read_int32(src, "RAW_Data", samples, count) &&
+                         subghz_raw_file_writer_add(writer, samples, count);
+            if(!line_valid) break;
+        }
+        if(!line_valid) break;
+
+        result = subghz_raw_file_writer_finish(writer);
+    } while(false);
+
+    if(writer) subghz_raw_file_writer_free(writer);
+    free(samples);
+    flipper_format_free(dst);
+    flipper_format_free(src);
+
+    return result;
+}
+
+bool subghz_raw_file_binary_to_text(Storage* storage, const char* src_path, const char* dst_path) {
+    furi_assert(storage);
+    furi_assert(src_path);
+    furi_assert(dst_path);
+
+    FlipperFormat* src = flipper_format_file_alloc(storage);
+    FlipperFormat* dst = flipper_format_file_alloc(storage);
+    SubGhzRawFileReader* reader = NULL;
+    int32_t* samples = malloc(SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX * sizeof(int32_t));
+    bool result = false;
+
+    do {
+        if(!flipper_format_file_open_existing(src, src_path)) break;
+        if(!flipper_format_file_open_always(dst, dst_path)) break;
+        if(!subghz_raw_file_copy_header(src, dst, SUBGHZ_RAW_BIN_FILE_TYPE, SUBGHZ_RAW_FILE_TYPE))
+            break;
+
+        // Samples start right after the end of the Protocol line
+        Stream* stream = flipper_format_get_raw_stream(src);
+        if(!stream_seek(stream, 1, StreamOffsetFromCurrent)) break;
+        reader = subghz_raw_file_reader_alloc(stream);
+
+        // Every chunk is read at once, so it becomes exactly one line
+        size_t count;
+        bool line_valid = true;
+        while((count = subghz_raw_file_reader_read(
+                   reader, samples, SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX)) > 0) {
+            line_valid = flipper_format_write_int32(dst, "RAW_Data", samples, count);
+            if(!line_valid) break;
+        }
+
+        result = line_valid && !subghz_raw_file_reader_is_failed(reader);
+    } while(false);
+
+    if(reader) subghz_raw_file_reader_free(reader);
+    free(samples);
+    flipper_format_free(dst);
+    flipper_format_free(src);
+
+    return result;
+}
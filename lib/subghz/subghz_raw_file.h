@@ -0,0 +1,127 @@
+/**
+ * @file subghz_raw_file.h
+ * @brief Binary container for Sub-GHz RAW recordings.
+ *
+ * A binary RAW file starts with the same text header as a text RAW file, except for
+ * the SUBGHZ_RAW_BIN_FILE_TYPE file type: Frequency, Preset, optional custom preset
+ * and Protocol. Right after the Protocol line come the samples, split into chunks of
+ * zigzag varint encoded durations, followed by a sparse chunk index for seeking and
+ * a fixed size footer.
+ *
+ * A file without index, e.g. from an interrupted recording, can still be read from
+ * the beginning.
+ */
+#pragma once
+
+#include <storage/storage.h>
+#include <toolbox/stream/stream.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest number of samples in a chunk */
+#define SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX (512U)
+
+typedef struct SubGhzRawFileWriter SubGhzRawFileWriter;
+
+typedef struct SubGhzRawFileReader SubGhzRawFileReader;
+
+/**
+ * Allocate SubGhzRawFileWriter.
+ * @param stream Stream positioned right after the Protocol line
+ * @return SubGhzRawFileWriter* pointer to a SubGhzRawFileWriter instance
+ */
+SubGhzRawFileWriter* subghz_raw_file_writer_alloc(Stream* stream);
+
+/**
+ * Free SubGhzRawFileWriter.
+ * @param instance Pointer to a SubGhzRawFileWriter instance
+ */
+void subghz_raw_file_writer_free(SubGhzRawFileWriter* instance);
+
+/**
+ * Append samples, one chunk is written per SUBGHZ_RAW_FILE_CHUNK_SIZE_MAX samples.
+ * @param instance Pointer to a SubGhzRawFileWriter instance
+ * @param samples Signed durations, positive for high level, negative for low level
+ * @param count Number of samples
+ * @return true On success
+ */
+bool subghz_raw_file_writer_add(
+    SubGhzRawFileWriter* instance,
+    const int32_t* samples,
+    size_t count);
+
+/**
+ * Write the chunk index and the footer, no samples can be added afterwards.
+ * @param instance Pointer to a SubGhzRawFileWriter instance
+ * @return true On success
+ */
+bool subghz_raw_file_writer_finish(SubGhzRawFileWriter* instance);
+
+/**
+ * Allocate SubGhzRawFileReader.
+ * @param stream Stream positioned right after the Protocol line
+ * @return SubGhzRawFileReader* pointer to a SubGhzRawFileReader instance
+ */
+SubGhzRawFileReader* subghz_raw_file_reader_alloc(Stream* stream);
+
+/**
+ * Free SubGhzRawFileReader.
+ * @param instance Pointer to a SubGhzRawFileReader instance
+ */
+void subghz_raw_file_reader_free(SubGhzRawFileReader* instance);
+
+/**
+ * Read the next samples, never more than what is left of the current chunk.
+ * @param instance Pointer to a SubGhzRawFileReader instance
+ * @param samples Output array
+ * @param count Output array size
+ * @return size_t number of samples read, 0 at the end of the data or on error
+ */
+size_t subghz_raw_file_reader_read(SubGhzRawFileReader* instance, int32_t* samples, size_t count);
+
+/**
+ * Check whether malformed data was found, e.g. a truncated or overlong varint.
+ * Reading stops for good once it happens.
+ * @param instance Pointer to a SubGhzRawFileReader instance
+ * @return true If the data is malformed
+ */
+bool subghz_raw_file_reader_is_failed(SubGhzRawFileReader* instance);
+
+/**
+ * Move to a sample, using the chunk index when the file has one.
+ * @param instance Pointer to a SubGhzRawFileReader instance
+ * @param sample Sample number from the beginning of the data
+ * @return true On success
+ */
+bool subghz_raw_file_reader_seek(SubGhzRawFileReader* instance, size_t sample);
+
+/**
+ * Get the number of samples in the file.
+ * @param instance Pointer to a SubGhzRawFileReader instance
+ * @return size_t number of samples, 0 if the file has no index
+ */
+size_t subghz_raw_file_reader_get_sample_count(SubGhzRawFileReader* instance);
+
+/**
+ * Convert a text RAW file to a binary RAW file.
+ * @param storage Pointer to a Storage instance
+ * @param src_path Text RAW file path
+ * @param dst_path Binary RAW file path, overwritten
+ * @return true On success
+ */
+bool subghz_raw_file_text_to_binary(Storage* storage, const char* src_path, const char* dst_path);
+
+/**
+ * Convert a binary RAW file to a text RAW file, each chunk becomes a RAW_Data line.
+ * @param storage Pointer to a Storage instance
+ * @param src_path Binary RAW file path
+ * @param dst_path Text RAW file path, overwritten
+ * @return true On success
+ */
+bool subghz_raw_file_binary_to_text(Storage* storage, const char* src_path, const char* dst_path);
+
+#ifdef __cplusplus
+}
+#endif
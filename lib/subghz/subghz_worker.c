@@ -1,15 +1,21 @@
 #include "subghz_worker.h"
 
 #include <furi.h>
+#include <toolbox/pulse_ring.h>
 
 #define TAG "SubGhzWorker"
 
+#define SUBGHZ_WORKER_RING_SIZE (4096U)
+#define SUBGHZ_WORKER_BATCH_SIZE (64U)
+#define SUBGHZ_WORKER_POLL_MS (10U)
+
+#define SUBGHZ_WORKER_EVENT_RX (0x01U)
+
 struct SubGhzWorker {
     FuriThread* thread;
-    FuriStreamBuffer* stream;
+    PulseRing* ring;
 
     volatile bool running;
-    volatile bool overrun;
 
     LevelDuration filter_level_duration;
     uint16_t filter_duration;
@@ -28,14 +34,37 @@ struct SubGhzWorker {
 void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
     SubGhzWorker* instance = context;
 
-    LevelDuration level_duration = level_duration_make(level, duration);
-    if(instance->overrun) {
-        instance->overrun = false;
-        level_duration = level_duration_reset();
+    // Worker is woken up once per batch, stragglers are picked up on poll timeout
+    size_t count = pulse_ring_push(instance->ring, level_duration_make(level, duration));
+    if(count == SUBGHZ_WORKER_BATCH_SIZE) {
+        furi_thread_flags_set(furi_thread_get_id(instance->thread), SUBGHZ_WORKER_EVENT_RX);
+    }
+}
+
+static inline void
+    subghz_worker_process_level_duration(SubGhzWorker* instance, LevelDuration level_duration) {
+    if(level_duration_is_reset(level_duration)) {
+        FURI_LOG_E(TAG, "Overrun buffer");
+        if(instance->overrun_callback) instance->overrun_callback(instance->context);
+    } else {
+        bool level = level_duration_get_level(level_duration);
+        uint32_t duration = level_duration_get_duration(level_duration);
+
+        if((duration < instance->filter_duration) ||
+           (instance->filter_level_duration.level == level)) {
+            instance->filter_level_duration.duration += duration;
+
+        } else if(instance->filter_level_duration.level != level) {
+            if(instance->pair_callback)
+                instance->pair_callback(
+                    instance->context,
+                    instance->filter_level_duration.level,
+                    instance->filter_level_duration.duration);
+
+            instance->filter_level_duration.duration = duration;
+            instance->filter_level_duration.level = level;
+        }
     }
-    size_t ret =
-        furi_stream_buffer_send(instance->stream, &level_duration, sizeof(LevelDuration), 0);
-    if(sizeof(LevelDuration) != ret) instance->overrun = true;
 }
 
 /** Worker callback thread
@@ -46,32 +75,14 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
 static int32_t subghz_worker_thread_callback(void* context) {
     SubGhzWorker* instance = context;
 
-    LevelDuration level_duration;
+    LevelDuration batch[SUBGHZ_WORKER_BATCH_SIZE];
     while(instance->running) {
-        int ret = furi_stream_buffer_receive(
-            instance->stream, &level_duration, sizeof(LevelDuration), 10);
-        if(ret == sizeof(LevelDuration)) {
-            if(level_duration_is_reset(level_duration)) {
-                FURI_LOG_E(TAG, "Overrun buffer");
-                if(instance->overrun_callback) instance->overrun_callback(instance->context);
-            } else {
-                bool level = level_duration_get_level(level_duration);
-                uint32_t duration = level_duration_get_duration(level_duration);
-
-                if((duration < instance->filter_duration) ||
-                   (instance->filter_level_duration.level == level)) {
-                    instance->filter_level_duration.duration += duration;
-
-                } else if(instance->filter_level_duration.level != level) {
-                    if(instance->pair_callback)
-                        instance->pair_callback(
-                            instance->context,
-                            instance->filter_level_duration.level,
-                            instance->filter_level_duration.duration);
-
-                    instance->filter_level_duration.duration = duration;
-                    instance->filter_level_duration.level = level;
-                }
+        furi_thread_flags_wait(SUBGHZ_WORKER_EVENT_RX, FuriFlagWaitAny, SUBGHZ_WORKER_POLL_MS);
+
+        size_t count;
+        while((count = pulse_ring_pop(instance->ring, batch, COUNT_OF(batch))) > 0) {
+            for(size_t i = 0; i < count; i++) {
+                subghz_worker_process_level_duration(instance, batch[i]);
             }
         }
     }
@@ -85,8 +96,7 @@ SubGhzWorker* subghz_worker_alloc() {
     instance->thread =
         furi_thread_alloc_ex("SubGhzWorker", 2048, subghz_worker_thread_callback, instance);
 
-    instance->stream =
-        furi_stream_buffer_alloc(sizeof(LevelDuration) * 4096, sizeof(LevelDuration));
+    instance->ring = pulse_ring_alloc(SUBGHZ_WORKER_RING_SIZE);
 
     //setting default filter in us
     instance->filter_duration = 30;
@@ -97,7 +107,7 @@ SubGhzWorker* subghz_worker_alloc() {
 void subghz_worker_free(SubGhzWorker* instance) {
     furi_assert(instance);
 
-    furi_stream_buffer_free(instance->stream);
+    pulse_ring_free(instance->ring);
     furi_thread_free(instance->thread);
 
     free(instance);
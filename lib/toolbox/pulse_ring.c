@@ -0,0 +1,110 @@
+#include "pulse_ring.h"
+
+#include <furi.h>
+
+/*
+ * Head and tail are free running counters, each written by one side only.
+ * Release stores publish the edges (or the free space) to the other side,
+ * acquire loads make sure they are seen before the buffer is accessed.
+ */
+struct PulseRing {
+    LevelDuration* buffer;
+    size_t mask;
+
+    size_t head; // written by the producer
+    size_t tail; // written by the consumer
+
+    size_t overrun_count; // written by the producer
+    bool overrun; // marker is pending, producer only
+};
+
+PulseRing* pulse_ring_alloc(size_t capacity) {
+    furi_check(capacity > 1);
+
+    size_t size = 2;
+    while(size < capacity) {
+        size <<= 1;
+    }
+
+    PulseRing* instance = malloc(sizeof(PulseRing));
+    instance->buffer = malloc(sizeof(LevelDuration) * size);
+    instance->mask = size - 1;
+
+    return instance;
+}
+
+void pulse_ring_free(PulseRing* instance) {
+    furi_check(instance);
+
+    free(instance->buffer);
+    free(instance);
+}
+
+void pulse_ring_reset(PulseRing* instance) {
+    furi_check(instance);
+
+    __atomic_store_n(&instance->head, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&instance->tail, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&instance->overrun_count, 0, __ATOMIC_RELAXED);
+    instance->overrun = false;
+}
+
+size_t pulse_ring_push(PulseRing* instance, LevelDuration level_duration) {
+    size_t head = instance->head;
+    const size_t tail = __atomic_load_n(&instance->tail, __ATOMIC_ACQUIRE);
+    const size_t space = instance->mask + 1 - (head - tail);
+
+    // Marker takes a slot of its own
+    if(space < (instance->overrun ? 2U : 1U)) {
+        instance->overrun = true;
+        __atomic_store_n(&instance->overrun_count, instance->overrun_count + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    const size_t count = head - tail;
+
+    if(instance->overrun) {
+        instance->overrun = false;
+        instance->buffer[head & instance->mask] = level_duration_reset();
+        head++;
+    }
+
+    instance->buffer[head & instance->mask] = level_duration;
+    head++;
+
+    __atomic_store_n(&instance->head, head, __ATOMIC_RELEASE);
+
+    return count + 1;
+}
+
+size_t pulse_ring_pop(PulseRing* instance, LevelDuration* items, size_t count) {
+    const size_t tail = instance->tail;
+    const size_t head = __atomic_load_n(&instance->head, __ATOMIC_ACQUIRE);
+
+    count = MIN(count, head - tail);
+    if(count == 0) return 0;
+
+    // Copy in at most two parts, the ring may wrap
+    const size_t pos = tail & instance->mask;
+    const size_t part = MIN(count, instance->mask + 1 - pos);
+    memcpy(items, &instance->buffer[pos], sizeof(LevelDuration) * part);
+    memcpy(&items[part], instance->buffer, sizeof(LevelDuration) * (count - part));
+
+    __atomic_store_n(&instance->tail, tail + count, __ATOMIC_RELEASE);
+
+    return count;
+}
+
+size_t pulse_ring_get_count(const PulseRing* instance) {
+    furi_check(instance);
+
+    const size_t tail = __atomic_load_n(&instance->tail, __ATOMIC_ACQUIRE);
+    const size_t head = __atomic_load_n(&instance->head, __ATOMIC_ACQUIRE);
+
+    return head - tail;
+}
+
+size_t pulse_ring_get_overrun_count(const PulseRing* instance) {
+    furi_check(instance);
+    return __atomic_load_n(&instance->overrun_count, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file pulse_ring.h
+ * @brief Lock-free ring of captured pulses.
+ *
+ * Single producer, single consumer ring of LevelDuration values. The producer is
+ * normally a capture ISR pushing one edge at a time, the consumer is a worker thread
+ * popping edges in batches. No locks or critical sections are taken on either side.
+ *
+ * When the ring is full, pushed edges are dropped and counted. The first edge pushed
+ * after a drop is preceded by a level_duration_reset() marker, so the consumer can
+ * resynchronize its decoders at the right position.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "level_duration.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PulseRing PulseRing;
+
+/**
+ * @brief Allocate a PulseRing instance
+ * @param capacity number of edges, rounded up to a power of two
+ * @return PulseRing*
+ */
+PulseRing* pulse_ring_alloc(size_t capacity);
+
+/**
+ * @brief Free a PulseRing instance
+ * @param instance
+ */
+void pulse_ring_free(PulseRing* instance);
+
+/**
+ * @brief Remove all edges and clear the overrun count
+ * Must not be called while the producer is active.
+ * @param instance
+ */
+void pulse_ring_reset(PulseRing* instance);
+
+/**
+ * @brief Push an edge, producer side, ISR safe
+ * The returned fill level lets the producer wake up the consumer once per batch
+ * instead of once per edge. It does not count the overrun marker, so 1 always means
+ * the ring was empty before the push, even when a marker went in with the edge.
+ * @param instance
+ * @param level_duration edge to push
+ * @return size_t number of edges in the ring before the push plus one, 0 if the edge
+ * was dropped
+ */
+size_t pulse_ring_push(PulseRing* instance, LevelDuration level_duration);
+
+/**
+ * @brief Pop up to count edges, consumer side
+ * @param instance
+ * @param items destination array
+ * @param count destination array size
+ * @return size_t number of edges popped
+ */
+size_t pulse_ring_pop(PulseRing* instance, LevelDuration* items, size_t count);
+
+/**
+ * @brief Get number of edges in the ring
+ * @param instance
+ * @return size_t
+ */
+size_t pulse_ring_get_count(const PulseRing* instance);
+
+/**
+ * @brief Get number of edges dropped since the last reset
+ * @param instance
+ * @return size_t
+ */
+size_t pulse_ring_get_overrun_count(const PulseRing* instance);
+
+#ifdef __cplusplus
+}
+#endif
@@ -300,6 +300,48 @@ bool furi_hal_hid_kb_release(uint16_t button) {
     return hid_send_report(ReportIdKeyboard);
 }
 
+bool furi_hal_hid_kb_press_multi(const uint16_t* buttons, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+            if(hid_report.keyboard.boot.btn[key_nb] == 0) {
+                hid_report.keyboard.boot.btn[key_nb] = buttons[i] & 0xFF;
+                break;
+            }
+        }
+        hid_report.keyboard.boot.mods |= (buttons[i] >> 8);
+    }
+    return hid_send_report(ReportIdKeyboard);
+}
+
+bool furi_hal_hid_kb_release_multi(const uint16_t* buttons, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+            if(hid_report.keyboard.boot.btn[key_nb] == (buttons[i] & 0xFF)) {
+                hid_report.keyboard.boot.btn[key_nb] = 0;
+                break;
+            }
+        }
+        hid_report.keyboard.boot.mods &= ~(buttons[i] >> 8);
+    }
+    return hid_send_report(ReportIdKeyboard);
+}
+
+bool furi_hal_hid_kb_roll(uint16_t release_button, uint16_t press_button) {
+    uint8_t* slot = NULL;
+    for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+        if(hid_report.keyboard.boot.btn[key_nb] == (release_button & 0xFF)) {
+            slot = &hid_report.keyboard.boot.btn[key_nb];
+            break;
+        } else if((slot == NULL) && (hid_report.keyboard.boot.btn[key_nb] == 0)) {
+            slot = &hid_report.keyboard.boot.btn[key_nb];
+        }
+    }
+    if(slot) *slot = press_button & 0xFF;
+    hid_report.keyboard.boot.mods &= ~(release_button >> 8);
+    hid_report.keyboard.boot.mods |= (press_button >> 8);
+    return hid_send_report(ReportIdKeyboard);
+}
+
 bool furi_hal_hid_kb_release_all() {
     for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
         hid_report.keyboard.boot.btn[key_nb] = 0;
@@ -217,6 +217,30 @@ bool furi_hal_hid_kb_press(uint16_t button);
  */
 bool furi_hal_hid_kb_release(uint16_t button);
 
+/** Set several keys to pressed state and send them in a single HID report
+ *
+ * @param      buttons  key codes
+ * @param      count    number of key codes
+ */
+bool furi_hal_hid_kb_press_multi(const uint16_t* buttons, size_t count);
+
+/** Set several keys to released state and send a single HID report
+ *
+ * @param      buttons  key codes
+ * @param      count    number of key codes
+ */
+bool furi_hal_hid_kb_release_multi(const uint16_t* buttons, size_t count);
+
+/** Replace a pressed key with another one and send a single HID report
+ *
+ * The host sees exactly one new key in the report, so keys typed this way
+ * keep their order.
+ *
+ * @param      release_button  key code to release
+ * @param      press_button    key code to press
+ */
+bool furi_hal_hid_kb_roll(uint16_t release_button, uint16_t press_button);
+
 /** Clear all pressed keys and send HID report
  *
  */